@@ -0,0 +1,65 @@
+#pragma once
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+
+/***
+* Timing helpers of the benchmark harnesses (no window, GL context or audio device).
+*
+* The old implementations a harness compares against live in bench/reference/, reduced to what is measured.
+* Measure() runs setup & func a few times & returns the best time of func in milliseconds:
+*
+*    auto const before = gamedev::bench::Measure([&] { old.Clear(); }, [&] { Fill(old); });
+*    auto const after = gamedev::bench::Measure([&] { now.Clear(); }, [&] { Fill(now); });
+*    gamedev::bench::Report("insert 20k", before, after);
+*
+* Results are fed to Consume(), so the compiler can't drop the measured work.
+*
+***/
+namespace gamedev
+{
+namespace bench
+{
+inline volatile uint64_t& Sink()
+{
+    static volatile uint64_t sink = 0;
+    return sink;
+}
+
+inline void Consume(uint64_t value) { Sink() = Sink() + value; }
+
+template <typename Setup, typename Func>
+double Measure(Setup&& setup, Func&& func, int runs = 5)
+{
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+        setup();
+
+        auto const start = std::chrono::steady_clock::now();
+        func();
+        auto const end = std::chrono::steady_clock::now();
+
+        best = std::min(best, std::chrono::duration<double, std::milli>(end - start).count());
+    }
+    return best;
+}
+
+template <typename Func>
+double Measure(Func&& func, int runs = 5)
+{
+    return Measure([] {}, func, runs);
+}
+
+inline void Header(const char* title, const char* before, const char* after)
+{
+    std::printf("\n%s\n%-32s %12s %12s %8s\n", title, "", before, after, "speedup");
+}
+
+inline void Report(const char* name, double before, double after)
+{
+    std::printf("%-32s %9.3f ms %9.3f ms %7.1fx\n", name, before, after, before / after);
+}
+}
+}
@@ -0,0 +1,94 @@
+#include "Bench.hh"
+#include "ecs/ComponentArray.hh"
+#include "components/PhysicsComp.hh"
+#include "reference/ComponentArray.hh"
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+struct Timings
+{
+    double insert = 0;
+    double lookup = 0;
+    double remove = 0;
+};
+
+// Inserts, looks up & removes one Physics component per handle
+template <typename Array, typename Create>
+Timings Measure(Create&& create, const std::vector<InstanceHandle>& inserts, const std::vector<InstanceHandle>& lookups, const std::vector<InstanceHandle>& removals)
+{
+    std::unique_ptr<Array> array;
+    auto const fill = [&]
+    {
+        Physics physics;
+        for (auto const handle : inserts)
+            array->InsertData(handle, physics);
+    };
+
+    Timings timings;
+    timings.insert = bench::Measure([&] { array = create(); }, fill);
+
+    timings.lookup = bench::Measure([&]
+    {
+        uint64_t hits = 0;
+        for (auto const handle : lookups)
+            if (auto physics = array->TryGetData(handle))
+                hits += physics->forceGround;
+        bench::Consume(hits);
+    });
+
+    timings.remove = bench::Measure([&]
+    {
+        array = create();
+        fill();
+    }, [&]
+    {
+        for (auto const handle : removals)
+            array->RemoveData(handle);
+    });
+
+    return timings;
+}
+
+void Run(uint32_t count)
+{
+    std::mt19937 rng(count);
+
+    // Instances are created in slot order, the systems look their components up in any order
+    std::vector<InstanceHandle> handles(count);
+    for (uint32_t i = 0; i < count; ++i)
+        handles[i] = InstanceHandle{i};
+
+    auto lookups = handles;
+    std::shuffle(lookups.begin(), lookups.end(), rng);
+    auto removals = handles;
+    std::shuffle(removals.begin(), removals.end(), rng);
+
+    using Old = reference::ComponentArray<Physics>;
+    using New = ComponentArray<Physics>;
+    auto const old = Measure<Old>([&] { return std::make_unique<Old>(count); }, handles, lookups, removals);
+    auto const now = Measure<New>([&] { return std::make_unique<New>(); }, handles, lookups, removals);
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "insert %u", count);
+    bench::Report(name, old.insert, now.insert);
+    std::snprintf(name, sizeof(name), "lookup %u (random order)", count);
+    bench::Report(name, old.lookup, now.lookup);
+    std::snprintf(name, sizeof(name), "remove %u (random order)", count);
+    bench::Report(name, old.remove, now.remove);
+}
+}
+
+int main()
+{
+    bench::Header("ComponentArray<Physics>: unordered_map storage against the sparse set", "maps", "sparse set");
+
+    for (uint32_t count : {2000u, 20000u, 200000u})
+        Run(count);
+
+    return 0;
+}
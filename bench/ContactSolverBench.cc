@@ -0,0 +1,197 @@
+#include "Bench.hh"
+#include "utility/ContactSolver.hh"
+#include "utility/Narrowphase.hh"
+#include "utility/ThreadPool.hh"
+#include <cstring>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+constexpr int Frames = 30; // simulated before measuring & for the determinism check
+constexpr unsigned ThreadCounts[] = {1, 2, 4, 8, 16};
+
+// A wave of monsters (circles) packed in rows, the left half marching left & the right half right into a wall of boxes.
+// Contacts come from a uniform grid of 1 x 1 cells, as the CollisionSystem gathers its pairs before solving.
+struct Scene
+{
+    std::vector<tg::pos2> positions;
+    std::vector<float> radii;
+    std::vector<float> directions;
+    std::vector<WorldShape> walls;
+    std::vector<std::pair<uint32_t, uint32_t>> contacts;
+
+    explicit Scene(int numMonsters)
+    {
+        std::mt19937 rng(21);
+        std::uniform_real_distribution<float> unit(0, 1);
+
+        auto const side = int(std::sqrt(float(numMonsters)));
+        for (int i = 0; i < numMonsters; ++i)
+        {
+            auto const x = float(i % side) * 0.9f - float(side) * 0.45f + 0.1f * unit(rng);
+            auto const z = float(i / side) * 0.9f + 0.1f * unit(rng);
+            positions.push_back({x, z});
+            radii.push_back(0.4f + 0.1f * unit(rng));
+            directions.push_back(x < 0 ? -1.f : 1.f);
+        }
+
+        auto const half = float(side) * 0.45f + 2.f;
+        for (int k = 0; k < side; ++k)
+            for (float sign : {-1.f, 1.f})
+            {
+                WorldShape wall;
+                wall.type = ShapeType::Box;
+                wall.center = {sign * (half + 0.5f), float(k) * 0.9f + 0.45f};
+                wall.axis0 = {0.5f, 0};
+                wall.axis1 = {0, 0.45f};
+                walls.push_back(wall);
+            }
+    }
+
+    WorldShape Monster(uint32_t i) const
+    {
+        WorldShape shape;
+        shape.type = ShapeType::Circle;
+        shape.center = positions[i];
+        shape.radius = radii[i];
+        return shape;
+    }
+
+    // Moves the monsters & finds the overlapping pairs of the frame
+    void Step()
+    {
+        for (size_t i = 0; i < positions.size(); ++i)
+            positions[i].x += 0.05f * directions[i];
+
+        auto const key = [](int x, int z) { return (int64_t(x) << 32) ^ uint32_t(z); };
+        std::unordered_map<int64_t, std::vector<uint32_t>> cells;
+        for (uint32_t i = 0; i < positions.size(); ++i)
+            cells[key(int(std::floor(positions[i].x)), int(std::floor(positions[i].y)))].push_back(i);
+
+        auto const numMonsters = uint32_t(positions.size());
+        contacts.clear();
+        for (uint32_t i = 0; i < numMonsters; ++i)
+        {
+            auto const shape = Monster(i);
+            auto const x = int(std::floor(positions[i].x));
+            auto const z = int(std::floor(positions[i].y));
+            for (int dx = -1; dx <= 1; ++dx)
+                for (int dz = -1; dz <= 1; ++dz)
+                {
+                    auto const cell = cells.find(key(x + dx, z + dz));
+                    if (cell == cells.end())
+                        continue;
+
+                    for (auto const j : cell->second)
+                        if (j > i && Narrowphase::Push(shape, Monster(j)) != tg::vec2::zero)
+                            contacts.push_back({i, j});
+                }
+
+            for (uint32_t w = 0; w < walls.size(); ++w)
+                if (Narrowphase::Push(shape, walls[w]) != tg::vec2::zero)
+                    contacts.push_back({i, numMonsters + w});
+        }
+    }
+
+    // Hands the bodies & contacts of the frame to the solver (the walls follow the monsters)
+    void Fill(ContactSolver& solver) const
+    {
+        solver.Clear();
+        for (uint32_t i = 0; i < positions.size(); ++i)
+            solver.AddBody(Monster(i), true);
+        for (auto const& wall : walls)
+            solver.AddBody(wall, false);
+        for (auto const& [first, second] : contacts)
+            solver.AddContact(first, second);
+    }
+
+    void Apply(const ContactSolver& solver)
+    {
+        for (uint32_t i = 0; i < positions.size(); ++i)
+            positions[i] += solver.GetCorrection(i);
+    }
+
+    uint64_t Hash() const
+    {
+        uint64_t hash = 1469598103934665603ull;
+        for (auto const& p : positions)
+        {
+            uint32_t bits[2];
+            std::memcpy(bits, &p, sizeof(bits));
+            hash = (hash ^ bits[0]) * 1099511628211ull;
+            hash = (hash ^ bits[1]) * 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+// Final positions after simulating all frames with the given pool
+uint64_t Simulate(int numMonsters, ThreadPool* pool)
+{
+    Scene scene(numMonsters);
+    ContactSolver solver;
+    for (int frame = 0; frame < Frames; ++frame)
+    {
+        scene.Step();
+        scene.Fill(solver);
+        solver.Solve(pool);
+        scene.Apply(solver);
+    }
+    return scene.Hash();
+}
+
+// Returns false if a pool changed the final positions
+bool Run(int numMonsters)
+{
+    // The pile-up after some frames against the walls
+    Scene scene(numMonsters);
+    ContactSolver solver;
+    for (int frame = 0; frame < Frames; ++frame)
+    {
+        scene.Step();
+        scene.Fill(solver);
+        solver.Solve();
+        scene.Apply(solver);
+    }
+    scene.Step();
+
+    // The corrections add up, so every run solves a freshly filled frame
+    auto const refill = [&] { scene.Fill(solver); };
+    auto const inlineTime = bench::Measure(refill, [&] { solver.Solve(); });
+    auto const reference = Simulate(numMonsters, nullptr);
+
+    bool deterministic = true;
+    std::printf("%d monsters, %zu contacts, %zu islands, %zu colours\n", numMonsters, solver.GetNumContacts(), solver.GetNumIslands(), solver.GetNumColors());
+    for (auto const threads : ThreadCounts)
+    {
+        ThreadPool pool(threads);
+        auto const time = bench::Measure(refill, [&] { solver.Solve(&pool); });
+        auto const same = Simulate(numMonsters, &pool) == reference;
+        deterministic &= same;
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "  %2u threads%s", threads, same ? "" : " (DIFFERENT)");
+        bench::Report(name, inlineTime, time);
+    }
+
+    return deterministic;
+}
+}
+
+int main()
+{
+    char header[128];
+    std::snprintf(header, sizeof(header), "Contact solver, one frame of a pile-up at two walls (%u hardware threads): inline against a pool", std::thread::hardware_concurrency());
+    bench::Header(header, "inline", "pool");
+
+    bool deterministic = true;
+    for (int numMonsters : {4000, 16000})
+        deterministic &= Run(numMonsters);
+
+    return deterministic ? 0 : 1;
+}
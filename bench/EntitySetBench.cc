@@ -0,0 +1,88 @@
+#include "Bench.hh"
+#include "ecs/EntitySet.hh"
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+constexpr uint32_t NumEntities = 10000;
+constexpr int Frames = 100; // iterations per measurement
+
+// A system's entity list after some play: entities joined in any order, some left & others took their slots
+template <typename Set>
+void Populate(Set& set, std::mt19937 rng)
+{
+    std::vector<InstanceHandle> handles(NumEntities);
+    for (uint32_t i = 0; i < NumEntities; ++i)
+        handles[i] = InstanceHandle{i};
+
+    std::shuffle(handles.begin(), handles.end(), rng);
+    for (auto const handle : handles)
+        set.insert(handle);
+
+    for (uint32_t k = 0; k < NumEntities / 2; ++k)
+    {
+        auto const i = rng() % NumEntities;
+        set.erase(handles[i]);
+        handles[i] = InstanceHandle{handles[i]._value + (1u << 20)}; // next generation of the slot
+        set.insert(handles[i]);
+    }
+}
+
+template <typename Set>
+double Iterate(const Set& set)
+{
+    return bench::Measure([&]
+    {
+        uint64_t sum = 0;
+        for (int frame = 0; frame < Frames; ++frame)
+            for (auto const handle : set)
+                sum += handle._value;
+        bench::Consume(sum);
+    });
+}
+
+// Signature changes: every entity leaves & joins again, then the system iterates once
+template <typename Set>
+double Churn(Set& set, const std::vector<InstanceHandle>& handles)
+{
+    return bench::Measure([&]
+    {
+        for (auto const handle : handles)
+            set.erase(handle);
+        for (auto const handle : handles)
+            set.insert(handle);
+
+        uint64_t sum = 0;
+        for (auto const handle : set)
+            sum += handle._value;
+        bench::Consume(sum);
+    });
+}
+}
+
+int main()
+{
+    std::mt19937 rng(4);
+
+    std::set<InstanceHandle> tree;
+    EntitySet unordered;
+    EntitySet ordered(true);
+    Populate(tree, rng);
+    Populate(unordered, rng);
+    Populate(ordered, rng);
+
+    std::vector<InstanceHandle> handles(tree.begin(), tree.end());
+    std::shuffle(handles.begin(), handles.end(), rng);
+
+    bench::Header("System entity list, 10k entities: std::set against EntitySet", "std::set", "EntitySet");
+    bench::Report("iterate x100", Iterate(tree), Iterate(unordered));
+    bench::Report("iterate x100 (ordered)", Iterate(tree), Iterate(ordered));
+    bench::Report("re-add all, iterate", Churn(tree, handles), Churn(unordered, handles));
+    bench::Report("re-add all, iterate (ordered)", Churn(tree, handles), Churn(ordered, handles));
+
+    return 0;
+}
@@ -0,0 +1,153 @@
+#include "Bench.hh"
+#include "reference/Hash2D.hh"
+#include "utility/HashMap.hh"
+#include <random>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+constexpr int NumUnits = 5000;
+constexpr int Frames = 20; // per measurement
+
+// Units walking around a 200 x 200 map, every unit moves & looks for others within 3 units each frame
+struct Crowd
+{
+    std::vector<tg::vec3> positions;
+    std::vector<std::vector<tg::vec3>> steps; // by frame
+};
+
+Crowd MakeCrowd()
+{
+    std::mt19937 rng(16);
+    std::uniform_real_distribution<float> position(-95, 95), step(-0.05f, 0.05f);
+
+    Crowd crowd;
+    crowd.positions.resize(NumUnits);
+    for (auto& p : crowd.positions)
+        p = {position(rng), 0, position(rng)};
+
+    crowd.steps.resize(Frames);
+    for (auto& frame : crowd.steps)
+    {
+        frame.resize(NumUnits);
+        for (auto& s : frame)
+            s = {step(rng), 0, step(rng)};
+    }
+    return crowd;
+}
+
+tg::aabb3 const UnitBounds({-0.5f, 0, -0.5f}, {0.5f, 2, 0.5f});
+tg::pos3 const Range(3, 0, 3);
+
+template <typename Index>
+void Fill(Index& index, const Crowd& crowd)
+{
+    index.Clear();
+    index.Init(tg::size2(200, 200), tg::aabb2({-100, -100}, {100, 100}));
+    for (int i = 0; i < NumUnits; ++i)
+        index.AddInstance(InstanceHandle{uint32_t(i)}, crowd.positions[i], UnitBounds);
+}
+
+template <typename Index>
+void Move(Index& index, std::vector<tg::vec3>& positions, const std::vector<tg::vec3>& steps)
+{
+    for (int i = 0; i < NumUnits; ++i)
+    {
+        positions[i] += steps[i];
+        index.UpdateInstance(InstanceHandle{uint32_t(i)}, positions[i]);
+    }
+}
+
+uint64_t Query(reference::Hash2D& index, const std::vector<tg::vec3>& positions, std::vector<InstanceHandle>&)
+{
+    uint64_t found = 0;
+    for (auto const& p : positions)
+        found += index.FindNear(p, -Range, Range).size();
+    return found;
+}
+
+uint64_t Query(Hash2D& index, const std::vector<tg::vec3>& positions, std::vector<InstanceHandle>& nearby)
+{
+    uint64_t found = 0;
+    for (auto const& p : positions)
+    {
+        index.FindNear(p, -Range, Range, nearby);
+        found += nearby.size();
+    }
+    return found;
+}
+
+struct Timings
+{
+    double move = 0;  // per frame
+    double query = 0; // per frame
+    double churn = 0; // per frame
+    uint64_t found = 0;
+};
+
+template <typename Index>
+Timings Measure(const Crowd& crowd)
+{
+    Index index;
+    std::vector<tg::vec3> positions;
+    std::vector<InstanceHandle> nearby;
+    Timings timings;
+
+    auto const reset = [&]
+    {
+        Fill(index, crowd);
+        positions = crowd.positions;
+    };
+
+    timings.move = bench::Measure(reset, [&]
+    {
+        for (auto const& steps : crowd.steps)
+            Move(index, positions, steps);
+    }) / Frames;
+
+    timings.query = bench::Measure(reset, [&]
+    {
+        for (int frame = 0; frame < Frames; ++frame)
+            timings.found = Query(index, positions, nearby);
+        bench::Consume(timings.found);
+    }) / Frames;
+
+    // A tenth of the units dies, new ones are spawned at the same place (in the same slots, next generation)
+    timings.churn = bench::Measure(reset, [&]
+    {
+        std::vector<InstanceHandle> handles(NumUnits);
+        for (int i = 0; i < NumUnits; ++i)
+            handles[i] = InstanceHandle{uint32_t(i)};
+
+        for (int frame = 0; frame < Frames; ++frame)
+        {
+            for (int i = frame % 10; i < NumUnits; i += 10)
+            {
+                index.RemoveInstance(handles[i]);
+                handles[i] = InstanceHandle{handles[i]._value + (1u << 20)};
+                index.AddInstance(handles[i], positions[i], UnitBounds);
+            }
+        }
+    }) / Frames;
+
+    return timings;
+}
+}
+
+int main()
+{
+    auto const crowd = MakeCrowd();
+    auto const old = Measure<reference::Hash2D>(crowd);
+    auto const now = Measure<Hash2D>(crowd);
+
+    bench::Header("Hash2D, 5000 units on a 200 x 200 grid, per frame: old bins against the flat grid", "old", "flat grid");
+    bench::Report("move all", old.move, now.move);
+    bench::Report("query all (+-3 units)", old.query, now.query);
+    bench::Report("move & query all", old.move + old.query, now.move + now.query);
+    bench::Report("remove & add 500", old.churn, now.churn);
+    std::printf("instances found per frame: %llu old, %llu flat grid\n", (unsigned long long)old.found, (unsigned long long)now.found);
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+#include "Bench.hh"
+#include "reference/ScalarNarrowphase.hh"
+#include "utility/Narrowphase.hh"
+#include "utility/SweepAndPrune.hh"
+#include <random>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+constexpr int NumStatics = 1500;
+constexpr int Passes = 10; // per measurement
+
+using Candidates = std::vector<std::pair<InstanceHandle, InstanceHandle>>; // (dynamic, any)
+
+// Units (30% boxes) crowding among walls, towers & trees (80% boxes), random yaw & scale.
+// The candidates are the overlapping bounds of a sweep-and-prune, as in the CollisionSystem.
+struct Scene
+{
+    std::shared_ptr<EngineECS> ecs;
+    Candidates candidates;
+
+    explicit Scene(int numUnits)
+    {
+        auto& world = *new World; // owned by the ECS
+        world.initialize(numUnits + NumStatics);
+
+        ecs = std::make_shared<EngineECS>();
+        ecs->Init(world);
+        ecs->RegisterComponent<Prototype>();
+        ecs->RegisterComponent<BoxShape>();
+        ecs->RegisterComponent<CircleShape>();
+
+        std::mt19937 rng(20);
+        std::uniform_real_distribution<float> unit(0, 1);
+        SweepAndPrune broadphase;
+
+        for (int i = 0; i < numUnits + NumStatics; ++i)
+        {
+            bool const dynamic = i < numUnits;
+            auto const handle = ecs->CreateInstance(nullptr, nullptr, nullptr, nullptr);
+
+            auto& xform = ecs->GetInstanceTransform(handle);
+            auto const r = (dynamic ? 25.f : 22.f) * std::sqrt(unit(rng));
+            auto const a = 6.2831853f * unit(rng);
+            auto const scale = 0.5f + unit(rng);
+            xform.translation = {r * std::cos(a), 0, r * std::sin(a)};
+            xform.rotation = tg::quat::from_axis_angle(tg::dir3::pos_y, tg::degree(360.f * unit(rng)));
+            xform.scaling = {scale, scale, scale};
+
+            auto const extent = dynamic ? 0.4f : 0.5f + 1.5f * unit(rng);
+            if (unit(rng) < (dynamic ? 0.3f : 0.8f))
+                ecs->CreateComponent<BoxShape>(handle)->box = tg::box3(tg::pos3::zero, tg::mat3::diag(tg::vec3(extent, 0.5f, extent * (0.5f + unit(rng)))));
+            else
+                ecs->CreateComponent<CircleShape>(handle)->circle = tg::sphere3(tg::pos3::zero, extent);
+
+            auto const reach = 1.5f * extent * scale;
+            broadphase.Add(handle, tg::aabb2({xform.translation.x - reach, xform.translation.z - reach}, {xform.translation.x + reach, xform.translation.z + reach}), dynamic);
+        }
+
+        broadphase.Update();
+        for (auto const& pair : broadphase.GetPairs())
+            candidates.push_back(pair.dynamicA ? std::pair{pair.a, pair.b} : std::pair{pair.b, pair.a});
+    }
+
+    // World space shape, as CollisionSystem::ShapeOf_()
+    WorldShape ShapeOf(InstanceHandle handle) const
+    {
+        auto const& xform = ecs->GetInstanceTransform(handle);
+        WorldShape shape;
+
+        if (auto box = ecs->TryGetComponent<BoxShape>(handle))
+        {
+            auto const M = xform.transform_mat2D();
+            auto const center = M * box->box.center;
+            auto const axis0 = M * box->box.half_extents[0];
+            auto const axis1 = M * box->box.half_extents[2];
+
+            shape.type = ShapeType::Box;
+            shape.center = {center.x, center.z};
+            shape.axis0 = {axis0.x, axis0.z};
+            shape.axis1 = {axis1.x, axis1.z};
+        }
+        else if (auto circle = ecs->TryGetComponent<CircleShape>(handle))
+        {
+            auto const center = xform.transform_mat2D() * circle->circle.center;
+
+            shape.type = ShapeType::Circle;
+            shape.center = {center.x, center.z};
+            shape.radius = tg::max(xform.scaling.width, xform.scaling.depth) * circle->circle.radius;
+        }
+        return shape;
+    }
+};
+
+void Run(int numUnits)
+{
+    Scene scene(numUnits);
+    auto const& candidates = scene.candidates;
+
+    // Scalar: one dispatch per pair
+    reference::ScalarNarrowphase scalar(scene.ecs);
+    std::vector<tg::vec2> scalarPush(candidates.size());
+    auto const scalarTime = bench::Measure([&]
+    {
+        for (int pass = 0; pass < Passes; ++pass)
+            for (size_t i = 0; i < candidates.size(); ++i)
+            {
+                auto const push = scalar.Collide(candidates[i].first, candidates[i].second) ? scalar.GetLastPush() : tg::vec3::zero;
+                scalarPush[i] = {push.x, push.z};
+            }
+    }) / Passes;
+
+    // Batched: every shape once per pass, then all pairs at once
+    Narrowphase narrowphase;
+    std::vector<WorldShape> shapes;
+    std::vector<uint32_t> shapeOf; // by InstanceHandle::index()
+    auto const batchedTime = bench::Measure([&]
+    {
+        for (int pass = 0; pass < Passes; ++pass)
+        {
+            shapes.clear();
+            shapeOf.assign(numUnits + NumStatics, uint32_t(-1));
+            auto const shape = [&](InstanceHandle handle) -> const WorldShape&
+            {
+                auto& slot = shapeOf[handle.index()];
+                if (slot == uint32_t(-1))
+                {
+                    slot = uint32_t(shapes.size());
+                    shapes.push_back(scene.ShapeOf(handle));
+                }
+                return shapes[slot];
+            };
+
+            narrowphase.Clear();
+            for (uint32_t i = 0; i < candidates.size(); ++i)
+                narrowphase.Add(i, shape(candidates[i].first), shape(candidates[i].second));
+            narrowphase.Run();
+        }
+    }) / Passes;
+
+    auto const kernelTime = bench::Measure([&]
+    {
+        for (int pass = 0; pass < Passes; ++pass)
+            narrowphase.Run();
+    }) / Passes;
+
+    // Agreement: same push where both hit, the batched box-circle kernel finds contacts the old test missed
+    size_t scalarHits = 0, batchedHits = 0, differentPush = 0;
+    for (uint32_t i = 0; i < candidates.size(); ++i)
+    {
+        auto const a = scalarPush[i];
+        auto const b = narrowphase.GetPush(i);
+        scalarHits += a != tg::vec2::zero;
+        batchedHits += b != tg::vec2::zero;
+        if (a != tg::vec2::zero && b != tg::vec2::zero && tg::length(a - b) > 1e-3f * (1 + tg::length(a)))
+            ++differentPush;
+    }
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "%d units, %zuk pairs", numUnits, candidates.size() / 1000);
+    bench::Report(name, scalarTime, batchedTime);
+    std::printf("%32s kernels only %.3f ms, contacts %zu scalar / %zu batched, %zu different pushes\n", "", kernelTime, scalarHits, batchedHits, differentPush);
+}
+}
+
+int main()
+{
+    bench::Header("Narrowphase pass over all candidate pairs (1500 statics): scalar Collide() against batched kernels", "scalar", "batched");
+
+    for (int numUnits : {2000, 5000, 10000})
+        Run(numUnits);
+
+    return 0;
+}
@@ -0,0 +1,164 @@
+#include "Bench.hh"
+#include "utility/SpatialIndex.hh"
+#include <random>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+constexpr int NumUnits = 5000;
+constexpr int NumStatics = 1000;
+constexpr int Frames = 10; // per measurement
+tg::aabb2 const Map({-100, -100}, {100, 100});
+
+// A late wave: 90% of the units crowd the fort (within 15 units of it), the rest is spread over the map.
+// Every frame each unit moves, queries an area around itself (FindNear) & searches the nearest enemy within 10 units.
+struct Wave
+{
+    std::vector<tg::vec3> positions;
+    std::vector<SpatialMask> categories;
+    std::vector<std::vector<tg::vec3>> steps; // by frame
+};
+
+Wave MakeWave()
+{
+    std::mt19937 rng(18);
+    std::uniform_real_distribution<float> map(-95, 95), angle(0, 6.2831853f), unit(0, 1), step(-0.05f, 0.05f);
+    tg::vec3 const fort(20, 0, -10);
+
+    Wave wave;
+    for (int i = 0; i < NumUnits; ++i)
+    {
+        if (i % 10)
+        {
+            auto const r = 15.f * std::sqrt(unit(rng));
+            auto const a = angle(rng);
+            wave.positions.push_back(fort + tg::vec3(r * std::cos(a), 0, r * std::sin(a)));
+        }
+        else
+            wave.positions.push_back({map(rng), 0, map(rng)});
+
+        wave.categories.push_back(SpatialUnit | (i % 3 ? SpatialHostile : SpatialFriendly));
+    }
+
+    wave.steps.resize(Frames);
+    for (auto& frame : wave.steps)
+    {
+        frame.resize(NumUnits);
+        for (auto& s : frame)
+            s = {step(rng), 0, step(rng)};
+    }
+    return wave;
+}
+
+tg::aabb3 const UnitBounds({-0.5f, 0, -0.5f}, {0.5f, 2, 0.5f});
+
+// Milliseconds per frame
+double MeasureWave(SpatialIndexType type, tg::size2 cells, const tg::aabb3& area, const Wave& wave)
+{
+    auto index = CreateSpatialIndex(type);
+    std::vector<tg::vec3> positions;
+    std::vector<InstanceHandle> nearby;
+    std::vector<SpatialHit> nearest;
+
+    auto const reset = [&]
+    {
+        index->Clear();
+        index->Init(cells, Map);
+        positions = wave.positions;
+        for (int i = 0; i < NumUnits; ++i)
+            index->AddInstance(InstanceHandle{uint32_t(i)}, positions[i], UnitBounds, wave.categories[i]);
+    };
+
+    return bench::Measure(reset, [&]
+    {
+        uint64_t found = 0;
+        for (auto const& steps : wave.steps)
+        {
+            for (int i = 0; i < NumUnits; ++i)
+            {
+                positions[i] += steps[i];
+                index->UpdateInstance(InstanceHandle{uint32_t(i)}, positions[i]);
+            }
+
+            for (int i = 0; i < NumUnits; ++i)
+            {
+                index->FindNear(positions[i], area, nearby);
+                found += nearby.size();
+
+                auto const enemy = wave.categories[i] & SpatialHostile ? SpatialFriendly : SpatialHostile;
+                index->FindNearest(tg::pos3(positions[i]), 10.f, SpatialUnit | enemy, 1, nearest);
+                found += nearest.size();
+            }
+        }
+        bench::Consume(found);
+    }) / Frames;
+}
+
+// Static colliders of mixed sizes (trees to 10 x 10 buildings): building the index & one query per unit
+void MeasureStatics(SpatialIndexType type, const Wave& wave, double& build, double& query)
+{
+    std::mt19937 rng(180);
+    std::uniform_real_distribution<float> map(-95, 95), size(0.3f, 5.f);
+
+    std::vector<std::pair<tg::vec3, tg::aabb3>> statics;
+    for (int i = 0; i < NumStatics; ++i)
+    {
+        auto const half = i % 10 ? size(rng) * 0.2f : size(rng);
+        statics.push_back({{map(rng), 0, map(rng)}, tg::aabb3({-half, 0, -half}, {half, 3, half})});
+    }
+
+    auto index = CreateSpatialIndex(type);
+    build = bench::Measure([&] { index->Clear(); }, [&]
+    {
+        index->Init(tg::size2(200, 200), Map);
+        for (int i = 0; i < NumStatics; ++i)
+            index->AddInstance(InstanceHandle{uint32_t(i)}, statics[i].first, statics[i].second, SpatialStatic);
+    });
+
+    std::vector<InstanceHandle> nearby;
+    query = bench::Measure([&]
+    {
+        uint64_t found = 0;
+        for (auto const& p : wave.positions)
+        {
+            index->FindNear(p, UnitBounds, nearby);
+            found += nearby.size();
+        }
+        bench::Consume(found);
+    });
+}
+}
+
+int main()
+{
+    auto const wave = MakeWave();
+
+    // Own bounds: contacts & placement, +-3 units: looking around
+    std::pair<const char*, tg::aabb3> const areas[] = {{"own bounds", UnitBounds}, {"+-3 units", tg::aabb3({-3, 0, -3}, {3, 2, 3})}};
+    for (auto const& [title, area] : areas)
+    {
+        char header[128];
+        std::snprintf(header, sizeof(header), "Late wave, 5000 units (90%% around the fort), FindNear of %s, ms per frame", title);
+        bench::Header(header, "grid", "quadtree");
+
+        for (int cells : {200, 100, 50, 25})
+        {
+            char name[64];
+            std::snprintf(name, sizeof(name), "%d x %d cells", cells, cells);
+            auto const size = tg::size2(float(cells), float(cells));
+            bench::Report(name, MeasureWave(SpatialIndexType::Grid, size, area, wave), MeasureWave(SpatialIndexType::LooseQuadTree, size, area, wave));
+        }
+    }
+
+    double gridBuild, gridQuery, treeBuild, treeQuery;
+    MeasureStatics(SpatialIndexType::Grid, wave, gridBuild, gridQuery);
+    MeasureStatics(SpatialIndexType::LooseQuadTree, wave, treeBuild, treeQuery);
+
+    bench::Header("1000 static colliders of mixed sizes, 200 x 200 cells", "grid", "quadtree");
+    bench::Report("build", gridBuild, treeBuild);
+    bench::Report("5000 unit queries", gridQuery, treeQuery);
+
+    return 0;
+}
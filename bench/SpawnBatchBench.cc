@@ -0,0 +1,159 @@
+#include "Bench.hh"
+#include "systems/CollisionSystem.hh"
+#include "components/AnimationComp.hh"
+#include "components/RenderComp.hh"
+#include <random>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+// Stands in for the systems of the game which only keep an entity list (render, physics, gamelogic, animation)
+template <int N>
+class ListSystem : public System
+{
+};
+
+struct Scene
+{
+    std::shared_ptr<EngineECS> ecs;
+    std::shared_ptr<CollisionSystem> collision;
+    InstanceHandle prototype;
+    PrefabHandle prefab;
+
+    explicit Scene(int capacity)
+    {
+        auto& world = *new World; // owned by the ECS
+        world.initialize(capacity);
+
+        ecs = std::make_shared<EngineECS>();
+        ecs->Init(world);
+        ecs->InitSpatialIndex(tg::size2(200, 200), tg::aabb2({-100, -100}, {100, 100}));
+
+        ecs->RegisterComponent<Prototype>();
+        ecs->RegisterComponent<Collider>();
+        ecs->RegisterComponent<CircleShape>();
+        ecs->RegisterComponent<BoxShape>();
+        ecs->RegisterComponent<Render>();
+        ecs->RegisterComponent<Physics>();
+        ecs->RegisterComponent<Living>();
+        ecs->RegisterComponent<Mortal>();
+        ecs->RegisterComponent<Destructible>();
+        ecs->RegisterComponent<Attacker>();
+        ecs->RegisterComponent<Animated>();
+        ecs->RegisterComponent<InTower>();
+        ecs->RegisterComponent<ForeignControl>();
+
+        collision = ecs->RegisterSystem<CollisionSystem>();
+        ecs->RegisterSystem<ListSystem<0>>();
+        ecs->RegisterSystem<ListSystem<1>>();
+        ecs->RegisterSystem<ListSystem<2>>();
+        ecs->RegisterSystem<ListSystem<3>>();
+        SetSignature<CollisionSystem, Collider>();
+        SetSignature<ListSystem<0>, Render>();
+        SetSignature<ListSystem<1>, Physics>();
+        SetSignature<ListSystem<2>, Living>();
+        SetSignature<ListSystem<3>, Animated>();
+        collision->Init(ecs);
+
+        // A monster of a wave
+        prototype = ecs->CreateInstance(nullptr, nullptr, nullptr, nullptr);
+        ecs->GetInstanceBounds(prototype) = tg::aabb3({-0.5f, 0, -0.5f}, {0.5f, 2, 0.5f});
+        ecs->CreateComponent<Prototype>(prototype);
+        ecs->CreateComponent<Render>(prototype);
+        ecs->CreateComponent<Physics>(prototype);
+        ecs->CreateComponent<Living>(prototype);
+        ecs->CreateComponent<Mortal>(prototype);
+        ecs->CreateComponent<Attacker>(prototype);
+        ecs->CreateComponent<Animated>(prototype);
+        ecs->CreateComponent<ForeignControl>(prototype);
+        ecs->CreateComponent<CircleShape>(prototype)->circle = tg::sphere3(tg::pos3::zero, 0.5f);
+        ecs->CreateComponent<Collider>(prototype)->dynamic = true;
+
+        prefab = ecs->BakePrefab(prototype, {});
+    }
+
+    template <typename SysT, typename CompT>
+    void SetSignature()
+    {
+        Signature signature;
+        signature.set(ecs->GetComponentType<CompT>());
+        ecs->SetSystemSignature<SysT>(signature);
+    }
+
+    void Destroy(std::vector<InstanceHandle>& handles)
+    {
+        for (auto const handle : handles)
+            ecs->DestroyInstance(handle);
+        handles.clear();
+    }
+};
+
+void Run(Scene& scene, size_t count)
+{
+    std::mt19937 rng{uint32_t(count)};
+    std::uniform_real_distribution<float> position(-90, 90);
+
+    std::vector<gamedev::transform> placements(count);
+    for (auto& xform : placements)
+        xform.translation = tg::vec3(position(rng), 0, position(rng));
+
+    auto& ecs = *scene.ecs;
+    std::vector<InstanceHandle> units;
+    auto const reset = [&] { scene.Destroy(units); };
+
+    // Factory::Create before the batch API: clone the prototype, its components & leave the Prototype behind
+    auto const clonePerUnit = bench::Measure(reset, [&]
+    {
+        for (auto const& placement : placements)
+        {
+            auto const handle = ecs.CloneInstance(scene.prototype);
+            ecs.CloneComponents(scene.prototype, handle);
+            ecs.RemoveComponent<Prototype>(handle);
+            ecs.GetInstanceTransform(handle).translation = placement.translation;
+            ecs.MarkTransformChanged(handle);
+            units.push_back(handle);
+        }
+    });
+
+    auto const cloneBatch = bench::Measure(reset, [&] { units = ecs.CloneInstanceBatch(scene.prototype, placements); });
+
+    // The same from a baked prefab (Factory::Create & Factory::CreateBatch today)
+    auto const prefabPerUnit = bench::Measure(reset, [&]
+    {
+        for (auto const& placement : placements)
+        {
+            auto const handle = ecs.Instantiate(scene.prefab);
+            ecs.GetInstanceTransform(handle).translation = placement.translation;
+            ecs.MarkTransformChanged(handle);
+            units.push_back(handle);
+        }
+    });
+
+    auto const prefabBatch = bench::Measure(reset, [&] { units = ecs.InstantiateBatch(scene.prefab, placements); });
+    reset();
+
+    char name[64];
+    std::snprintf(name, sizeof(name), "clone prototype x%zu", count);
+    bench::Report(name, clonePerUnit, cloneBatch);
+    std::snprintf(name, sizeof(name), "instantiate prefab x%zu", count);
+    bench::Report(name, prefabPerUnit, prefabBatch);
+}
+}
+
+int main()
+{
+    Scene scene(12000);
+
+#ifdef GAMEDEV_ARCHETYPE_STORAGE
+    bench::Header("Spawning a wave of monsters (archetype storage): per unit against one batch", "per unit", "batch");
+#else
+    bench::Header("Spawning a wave of monsters (sparse set storage): per unit against one batch", "per unit", "batch");
+#endif
+
+    for (size_t count : {1000, 10000})
+        Run(scene, count);
+
+    return 0;
+}
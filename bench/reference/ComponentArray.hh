@@ -0,0 +1,89 @@
+#pragma once
+#include "advanced/World.hh"
+#include <unordered_map>
+#include <vector>
+#include <assert.h>
+
+namespace gamedev
+{
+namespace reference
+{
+/***
+* ComponentArray before the sparse-set storage: two unordered_maps between handle & packed index.
+*
+* Reduced to insert, lookup & remove. The fixed std::array<CompT, MAX_INSTANCES> is a vector of the requested
+* capacity (MAX_INSTANCES was 2048) & the O(n^2) IntegrityCheck() after every insert & remove is left out,
+* with it the 20k & 200k runs wouldn't finish.
+*
+***/
+template <typename CompT>
+class ComponentArray
+{
+public:
+    explicit ComponentArray(size_t capacity) : mComponentArray(capacity) {}
+
+    void InsertData(InstanceHandle handle, CompT& component)
+    {
+        assert(mEntityToIndexMap.find(handle) == mEntityToIndexMap.end() && "Component added to same entity more than once.");
+
+        size_t newIndex = mSize;
+        mEntityToIndexMap.insert_or_assign(handle, newIndex);
+        mIndexToEntityMap.insert_or_assign(newIndex, handle);
+        mComponentArray[newIndex] = component;
+
+        ++mSize;
+    }
+
+    void RemoveData(InstanceHandle handle)
+    {
+        assert(mEntityToIndexMap.find(handle) != mEntityToIndexMap.end() && "Removing non-existent component.");
+
+        // Copy element at end into deleted element's place to maintain density
+        size_t indexOfRemovedEntity = mEntityToIndexMap[handle];
+        size_t indexOfLastElement = mSize - 1;
+        mComponentArray[indexOfRemovedEntity] = mComponentArray[indexOfLastElement];
+
+        // Update map to the moved position
+        InstanceHandle entityOfLastElement = mIndexToEntityMap[indexOfLastElement];
+        mEntityToIndexMap.insert_or_assign(entityOfLastElement, indexOfRemovedEntity);
+        mIndexToEntityMap.insert_or_assign(indexOfRemovedEntity, entityOfLastElement);
+
+        // Remove empty
+        mEntityToIndexMap.erase(handle);
+        mIndexToEntityMap.erase(indexOfLastElement);
+
+        if (mSize > 0)
+            --mSize;
+    }
+
+    void RemoveAll()
+    {
+        mEntityToIndexMap.clear();
+        mIndexToEntityMap.clear();
+        mSize = 0;
+    }
+
+    CompT* GetData(InstanceHandle handle)
+    {
+        assert(mEntityToIndexMap.find(handle) != mEntityToIndexMap.end());
+        return &mComponentArray[mEntityToIndexMap[handle]];
+    }
+
+    CompT* TryGetData(InstanceHandle handle)
+    {
+        if (mEntityToIndexMap.find(handle) == mEntityToIndexMap.end())
+            return nullptr;
+
+        return &mComponentArray[mEntityToIndexMap[handle]];
+    }
+
+    size_t Size() const { return mSize; }
+
+private:
+    std::vector<CompT> mComponentArray;
+    std::unordered_map<InstanceHandle, size_t, InstanceHandleHash> mEntityToIndexMap;
+    std::unordered_map<size_t, InstanceHandle> mIndexToEntityMap;
+    size_t mSize = 0;
+};
+}
+}
@@ -0,0 +1,168 @@
+#include "reference/Hash2D.hh"
+
+void gamedev::reference::Hash2D::Init(tg::size2 cellCount, tg::aabb2 bounds)
+{
+    mMaxCells = cellCount;
+    // Is being used later for denormalization, so correct values for that
+    mMaxCells.width -= 1;
+    mMaxCells.height -= 1;
+    mBounds = bounds;
+}
+
+int gamedev::reference::Hash2D::GetIndexID_(tg::ipos2 pos) { return pos.y * mMaxCells.width + pos.x; }
+
+tg::ipos2 gamedev::reference::Hash2D::PositionToGrid_(const tg::pos2& position)
+{
+    tg::vec2 spatial_coordinate;
+
+    // Normalized world space coordinates within the grid
+    spatial_coordinate.x = tg::saturate((position.x - mBounds.min.x) / (mBounds.max.x - mBounds.min.x));
+    spatial_coordinate.y = tg::saturate((position.y - mBounds.min.y) / (mBounds.max.y - mBounds.min.y));
+
+    // Output denormalized in cell space
+    return tg::ipos2(spatial_coordinate * mMaxCells);
+}
+
+tg::ipos2 gamedev::reference::Hash2D::PositionToGrid_(const tg::pos3& position)
+{
+    tg::vec2 spatial_coordinate;
+
+    spatial_coordinate.x = tg::saturate((position.x - mBounds.min.x) / (mBounds.max.x - mBounds.min.x));
+    spatial_coordinate.y = tg::saturate((position.z - mBounds.min.y) / (mBounds.max.y - mBounds.min.y));
+
+    // Output denormalized in cell space
+    return tg::ipos2(spatial_coordinate * mMaxCells);
+}
+
+void gamedev::reference::Hash2D::Insert_(Client& c)
+{
+    auto i1 = PositionToGrid_(c.dimensions.min + c.translation);
+    auto i2 = PositionToGrid_(c.dimensions.max + c.translation);
+
+    c.indicies = {i1, i2};
+
+    for (int x = i1.x; x <= i2.x; x++)
+    {
+        for (int y = i1.y; y <= i2.y; y++)
+        {
+            tg::ipos2 pos{x, y};
+            auto k = GetIndexID_(pos);
+
+            if (mBinMap.find(k) == mBinMap.end())
+            {
+                mBinMap.insert({k, std::vector<Client>()});
+            }
+
+            mBinMap[k].push_back(c);
+            mClientMap.insert_or_assign(c.handle, c);
+        }
+    }
+}
+
+void gamedev::reference::Hash2D::Remove_(Client& c)
+{
+    auto i1 = c.indicies.first;
+    auto i2 = c.indicies.second;
+
+    for (int x = i1.x; x <= i2.x; x++)
+    {
+        for (int y = i1.y; y <= i2.y; y++)
+        {
+            tg::ipos2 pos{x, y};
+            auto k = GetIndexID_(pos);
+
+            auto& container = mBinMap[k];
+            for (int i = 0; i < container.size(); i++)
+            {
+                if (container[i].handle == c.handle)
+                {
+                    std::swap(container[i], container.back());
+                    container.pop_back();
+                }
+            }
+        }
+    }
+}
+
+void gamedev::reference::Hash2D::AddInstance(const InstanceHandle handle, const tg::vec3& translation, const tg::aabb3& dimensions)
+{
+    if (mClientMap.find(handle) != mClientMap.end())
+        return;
+
+    tg::pos2 min = {dimensions.min.x, dimensions.min.z};
+    tg::pos2 max = {dimensions.max.x, dimensions.max.z};
+
+    // Create a new internal client which holds some easy access information
+    Client hc2{handle, {translation.x, translation.z}, {min, max}, {}, 0};
+
+    Insert_(hc2);
+}
+
+void gamedev::reference::Hash2D::UpdateInstance(const InstanceHandle handle, const tg::vec3& translation)
+{
+    if (mClientMap.find(handle) != mClientMap.end())
+    {
+        auto& c = mClientMap[handle];
+        c.translation.x = translation.x;
+        c.translation.y = translation.z;
+
+        Remove_(c);
+        Insert_(c);
+    }
+}
+
+void gamedev::reference::Hash2D::RemoveInstance(InstanceHandle handle)
+{
+    if (mClientMap.find(handle) == mClientMap.end())
+    {
+        return;
+    }
+
+    auto c = mClientMap[handle];
+    Remove_(c);
+}
+
+std::unordered_set<gamedev::InstanceHandle, gamedev::InstanceHandleHash> gamedev::reference::Hash2D::FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max)
+{
+    // find area to search for instances
+    auto i1 = PositionToGrid_(min + translation);
+    auto i2 = PositionToGrid_(max + translation);
+
+    // instance container
+    std::unordered_set<InstanceHandle, InstanceHandleHash> handles;
+
+    // ensure uniqueness
+    int queryID = mQueryIDs++;
+
+    // search whole area
+    for (int x = i1.x; x <= i2.x; x++)
+    {
+        for (int y = i1.y; y <= i2.y; y++)
+        {
+            tg::ipos2 pos{x, y};
+            auto k = GetIndexID_(pos);
+
+            // sanity check + instance retrieval
+            if (mBinMap.find(k) != mBinMap.end())
+            {
+                for (auto& v : mBinMap[k])
+                {
+                    // uniqueness check: if instance was already added during this query, its queryID will match
+                    if (v.queryID != queryID)
+                    {
+                        v.queryID = queryID;
+                        handles.insert(v.handle);
+                    }
+                }
+            }
+        }
+    }
+
+    return handles;
+}
+
+void gamedev::reference::Hash2D::Clear()
+{
+    mBinMap.clear();
+    mClientMap.clear();
+}
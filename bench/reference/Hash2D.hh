@@ -0,0 +1,55 @@
+#pragma once
+#include "advanced/World.hh"
+#include "typed-geometry/tg.hh"
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace gamedev
+{
+namespace reference
+{
+/***
+* Hash2D before the flat grid: bins of whole client copies in an unordered_map, removal scans the bins,
+* every FindNear() returns a fresh unordered_set.
+*
+* Reduced to what the benchmarks measure, otherwise unchanged (including the cell stride of cellCount - 1).
+*
+***/
+class Hash2D
+{
+public:
+    void Init(tg::size2 cellCount, tg::aabb2 bounds);
+
+    void AddInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions);
+    void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation);
+    void RemoveInstance(const InstanceHandle identifier);
+    std::unordered_set<gamedev::InstanceHandle, InstanceHandleHash> FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max);
+    void Clear();
+
+private:
+    struct Client
+    {
+        InstanceHandle handle = {std::uint32_t(-1)};
+        tg::vec2 translation;
+        tg::aabb2 dimensions;
+        std::pair<tg::ipos2, tg::ipos2> indicies; // form aabb inside the spatial grid
+        int queryID = -1;                         // to deduplicate on retrieval
+    };
+
+    tg::ipos2 PositionToGrid_(const tg::pos2& spatial_key);
+    tg::ipos2 PositionToGrid_(const tg::pos3& spatial_key);
+    void Insert_(Client& c);
+    void Remove_(Client& c);
+
+    int GetIndexID_(tg::ipos2 pos);
+
+private:
+    tg::size2 mMaxCells;
+    tg::aabb2 mBounds;
+    int mQueryIDs = 1;
+    std::unordered_map<int, std::vector<Client>> mBinMap;                      // Point -> Instances
+    std::unordered_map<InstanceHandle, Client, InstanceHandleHash> mClientMap; // Instance -> Client
+};
+}
+}
@@ -0,0 +1,332 @@
+#include "reference/ScalarNarrowphase.hh"
+
+bool gamedev::reference::ScalarNarrowphase::Collide(InstanceHandle handle_dynamic, InstanceHandle handle_any)
+{
+    auto& xform_d = mECS->GetInstanceTransform(handle_dynamic);
+    auto const& xform_a = mECS->GetInstanceTransform(handle_any);
+
+    auto boxShape_d = mECS->TryGetComponent<BoxShape>(handle_dynamic);
+    auto circleShape_d = mECS->TryGetComponent<CircleShape>(handle_dynamic);
+    auto boxShape_a = mECS->TryGetComponent<BoxShape>(handle_any);
+    auto circleShape_a = mECS->TryGetComponent<CircleShape>(handle_any);
+
+    if (boxShape_a && boxShape_d)
+        return Collide(handle_dynamic, xform_d, xform_a, boxShape_d, boxShape_a);
+
+    else if (boxShape_a && circleShape_d)
+        return Collide(handle_dynamic, xform_d, xform_a, circleShape_d, boxShape_a);
+
+    else if (circleShape_a && boxShape_d)
+        return Collide(handle_dynamic, xform_d, xform_a, boxShape_d, circleShape_a);
+
+    else if (circleShape_a && circleShape_d)
+        return Collide(handle_dynamic, xform_d, xform_a, circleShape_d, circleShape_a);
+
+    return false;
+}
+
+bool gamedev::reference::ScalarNarrowphase::Collide(InstanceHandle handle_dynamic, transform& xform_dynamic, transform const& xform_any, const BoxShape* box_dynamic, const BoxShape* box_any)
+{
+    // Transform collision box
+    const auto transform1 = affine_to_mat4(xform_dynamic.transform_mat());
+    auto tBox1 = box_dynamic->box;
+    tBox1.center = transform1 * box_dynamic->box.center;
+    tBox1.half_extents[0] = transform1 * box_dynamic->box.half_extents[0];
+    tBox1.half_extents[2] = transform1 * box_dynamic->box.half_extents[2];
+
+    const auto transform2 = affine_to_mat4(xform_any.transform_mat());
+    auto tBox2 = box_any->box;
+    tBox2.center = transform2 * box_any->box.center;
+    tBox2.half_extents[0] = transform2 * box_any->box.half_extents[0];
+    tBox2.half_extents[2] = transform2 * box_any->box.half_extents[2];
+
+    // Interpret as circles to do fast collision check
+    auto distance = tg::distance(tBox1.center, tBox2.center);
+    auto radius1 = tg::length(tBox1.half_extents[0] + tBox1.half_extents[2]);
+    auto radius2 = tg::length(tBox2.half_extents[0] + tBox2.half_extents[2]);
+    //if (distance > (radius1 + radius2) + (radius1 + radius2))
+    if (distance > (radius1 + radius2))
+        return 0; // No Intersection
+
+    tg::vec3 push = minimalPush(tBox1, tBox2);
+
+    // If the push-vector is zero, no collision happend.
+    if ((push.x == 0) && (push.z == 0))
+        return 0;
+
+    mLastPush = push;
+
+    return 1;
+}
+
+bool gamedev::reference::ScalarNarrowphase::Collide(InstanceHandle handle_dynamic, transform& xform_dynamic, transform const& xform_any, const BoxShape* box_dynamic, const CircleShape* circle_static)
+{
+    // Transform collision box
+    const auto transform1 = xform_dynamic.transform_mat2D();
+    tg::box3 tBox;
+    tBox.center = transform1 * box_dynamic->box.center;
+    tBox.half_extents[0] = transform1 * box_dynamic->box.half_extents[0];
+    tBox.half_extents[2] = transform1 * box_dynamic->box.half_extents[2];
+
+    const auto transform2 = xform_any.transform_mat2D();
+    const auto scale2 = tg::max(xform_any.scaling.width, xform_any.scaling.depth);
+    tg::sphere3 tCircle;
+    tCircle.center = transform2 * circle_static->circle.center;
+    tCircle.radius = scale2 * circle_static->circle.radius;
+    
+    // Interpret as circles to do fast collision check
+    auto distance = tg::distance_sqr(tBox.center, tCircle.center);
+    auto radius1 = tg::length(tBox.half_extents[0] + tBox.half_extents[2]);
+    if (distance > (radius1 + tCircle.radius) * (radius1 + tCircle.radius))
+        return 0; // No Intersection
+
+    tg::vec3 push = minimalPush(tBox, tCircle);
+
+    // If the push-vector is zero, no collision happend.
+    if ((push.x == 0) && (push.z == 0))
+        return 0;
+
+    mLastPush = push;
+
+    return 1;
+}
+
+bool gamedev::reference::ScalarNarrowphase::Collide(InstanceHandle handle_dynamic, transform& xform_dynamic, transform const& xform_any, const CircleShape* circle_dynamic, const BoxShape* box_static)
+{
+    // Transform collision box
+    const auto transform1 = xform_any.transform_mat2D();
+    tg::box3 tBox;
+    tBox.center = transform1 * box_static->box.center;
+    tBox.half_extents[0] = transform1 * box_static->box.half_extents[0];
+    tBox.half_extents[2] = transform1 * box_static->box.half_extents[2];
+
+    const auto transform2 = xform_dynamic.transform_mat2D();
+    const auto scale2 = tg::max(xform_dynamic.scaling.width, xform_dynamic.scaling.depth);
+    tg::sphere3 tCircle;
+    tCircle.center = transform2 * circle_dynamic->circle.center;
+    tCircle.radius = scale2 * circle_dynamic->circle.radius;
+
+    // Interpret as circles to do fast collision check
+    auto distance = tg::distance_sqr(tBox.center, tCircle.center);
+    auto radius1 = tg::length(tBox.half_extents[0] + tBox.half_extents[2]);
+    if (distance > (radius1 + tCircle.radius) * (radius1 + tCircle.radius))
+        return 0; // No Intersection
+
+    tg::vec3 push = minimalPush(tCircle, tBox);
+
+    // If the push-vector is zero, no collision happend.
+    if ((push.x == 0) && (push.z == 0))
+        return 0;
+
+    mLastPush = push;
+
+    return 1;
+}
+
+bool gamedev::reference::ScalarNarrowphase::Collide(InstanceHandle handle_dynamic, transform& xform_dynamic, transform const& xform_any, const CircleShape* circle_dynamic, const CircleShape* circle_static)
+{
+    // Transform collision box
+    const auto transform1 = xform_dynamic.transform_mat2D();
+    const auto scale1 = tg::max(xform_dynamic.scaling.width, xform_dynamic.scaling.depth);
+    tg::sphere3 tCircle1;
+    tCircle1.center = transform1 * circle_dynamic->circle.center;
+    tCircle1.radius = scale1 * circle_dynamic->circle.radius;
+
+    const auto transform2 = xform_any.transform_mat2D();
+    const auto scale2 = tg::max(xform_any.scaling.width, xform_any.scaling.depth);
+    tg::sphere3 tCircle2;
+    tCircle2.center = transform2 * circle_static->circle.center;
+    tCircle2.radius = scale2 * circle_static->circle.radius;
+
+    // Do fast circle collision check
+    auto distance = tg::distance_sqr(tCircle1.center, tCircle2.center);
+    if (distance > (tCircle1.radius + tCircle2.radius) * (tCircle1.radius + tCircle2.radius))
+        return 0; // No Intersection
+
+    tg::vec3 push = minimalPush(tCircle1, tCircle2);
+
+    // If the push-vector is zero, no collision happend.
+    if ((push.x == 0) && (push.z == 0))
+        return 0;
+
+    mLastPush = push;
+
+    return 1;
+}
+
+tg::vec3 gamedev::reference::ScalarNarrowphase::SAT_AxisTest(const tg::vec3& axis, const std::array<tg::pos3, 4>& points1, const std::array<tg::pos3, 4>& points2)
+{
+    float min1 = INFINITY;
+    float max1 = -INFINITY;
+
+    float min2 = INFINITY;
+    float max2 = -INFINITY;
+
+    // Project all points on the given axis & find maximum/minimum
+    for (const auto& p : points1)
+    {
+        float projection = tg::dot(p, axis);
+
+        min1 = tg::min(min1, projection);
+        max1 = tg::max(max1, projection);
+    }
+
+    for (const auto& p : points2)
+    {
+        float projection = tg::dot(p, axis);
+
+        min2 = tg::min(min2, projection);
+        max2 = tg::max(max2, projection);
+    }
+
+    // On overlap, create a push-vector along the given axis
+    if ((max1 >= min2) && (max2 >= min1))
+    {
+        // Push a bit more than needed
+        float d = tg::min(max2 - min1, max1 - min2) / tg::dot(axis, axis) + 1e-10;
+        return d * axis;
+    }
+
+    // Else, return a zero-vector (equal to: no overlap found).
+    return tg::vec3::zero;
+}
+
+tg::vec3 gamedev::reference::ScalarNarrowphase::minimalPush(const tg::box3& box_dynamic, const tg::box3& box_any)
+{
+    // half_extents are already the axes
+    auto axes = std::array<tg::vec3, 4>();
+    axes[0] = box_dynamic.half_extents[0]; // boxA
+    axes[1] = box_dynamic.half_extents[2]; //
+    axes[2] = box_any.half_extents[0];     // boxB
+    axes[3] = box_any.half_extents[2];     //
+
+    // points must be calculated from the center
+    auto center1 = box_dynamic.center;
+    auto center2 = box_any.center;
+    std::array<tg::pos3, 4> points1;
+    std::array<tg::pos3, 4> points2;
+
+    points1[0] = center1 + box_dynamic.half_extents[0] + box_dynamic.half_extents[2];
+    points1[1] = center1 + box_dynamic.half_extents[0] - box_dynamic.half_extents[2];
+    points1[2] = center1 - box_dynamic.half_extents[0] + box_dynamic.half_extents[2];
+    points1[3] = center1 - box_dynamic.half_extents[0] - box_dynamic.half_extents[2];
+
+    points2[0] = center2 + box_any.half_extents[0] + box_any.half_extents[2];
+    points2[1] = center2 + box_any.half_extents[0] - box_any.half_extents[2];
+    points2[2] = center2 - box_any.half_extents[0] + box_any.half_extents[2];
+    points2[3] = center2 - box_any.half_extents[0] - box_any.half_extents[2];
+
+    // SAT Test all axis for a potential collision. Break if a separting axis is found.
+    // push is the vector, which holds the displacement to avoid collision on this axis.
+    // push == (0,0) => separating axis / no collision
+    // push  > (0,0) => overlap
+    std::vector<tg::vec3> push_vectors;
+    for (const auto& axis : axes)
+    {
+        auto push = SAT_AxisTest(axis, points1, points2);
+        if (push.x != 0 || push.z != 0)
+            push_vectors.push_back(push);
+        else
+            return tg::vec3::zero;
+    }
+
+    // Get minimum necessary vector to resolve collision.
+    tg::vec3 minimum_push;
+    float minimum = INFINITY;
+    for (const auto& push : push_vectors)
+    {
+        if (tg::dot(push, push) < minimum)
+        {
+            minimum_push = push;
+            minimum = tg::dot(push, push);
+        }
+    }
+
+    // Assert, that box1 is pushed away from box2
+    tg::vec3 d = box_any.center - box_dynamic.center;
+    if (tg::dot(d, minimum_push) > 0)
+        minimum_push *= -1;
+
+    return minimum_push;
+}
+
+
+tg::vec3 gamedev::reference::ScalarNarrowphase::minimalPush(const tg::box3& box_dynamic, const tg::sphere3& circle_any)
+{
+    // half_extents are already the axes
+    auto axes = std::array<tg::vec3, 2>();
+    axes[0] = tg::normalize_safe(box_dynamic.half_extents[0]);
+    axes[1] = tg::normalize_safe(box_dynamic.half_extents[2]);
+
+    // points must be calculated from the center
+    auto center1 = box_dynamic.center;
+    auto center2 = circle_any.center;
+    std::array<tg::pos3, 4> points1;
+    std::array<tg::pos3, 4> points2;
+
+    points1[0] = center1 + box_dynamic.half_extents[0] + box_dynamic.half_extents[2];
+    points1[1] = center1 + box_dynamic.half_extents[0] - box_dynamic.half_extents[2];
+    points1[2] = center1 - box_dynamic.half_extents[0] + box_dynamic.half_extents[2];
+    points1[3] = center1 - box_dynamic.half_extents[0] - box_dynamic.half_extents[2];
+
+    // Circle is interpreted as a rectangle for collision, but it works
+    points2[0] = center2 + circle_any.radius * axes[0];
+    points2[1] = center2 + circle_any.radius * axes[1];
+    points2[2] = center2 - circle_any.radius * axes[0];
+    points2[3] = center2 - circle_any.radius * axes[1];
+
+    // SAT Test all axis for a potential collision. Break if a separting axis is found.
+    // push is the vector, which holds the displacement to avoid collision on this axis.
+    // push == (0,0) => separating axis / no collision
+    // push  > (0,0) => overlap
+    std::vector<tg::vec3> push_vectors;
+    for (const auto& axis : axes)
+    {
+        auto push = SAT_AxisTest(axis, points1, points2);
+        if (push.x > 0 || push.z > 0)
+            push_vectors.push_back(push);
+        else
+            return tg::vec3::zero;
+    }
+
+    // Get minimum necessary vector to resolve collision.
+    tg::vec3 minimum_push;
+    float minimum = INFINITY;
+    for (const auto& push : push_vectors)
+    {
+        if (tg::dot(push, push) < minimum)
+        {
+            minimum_push = push;
+            minimum = tg::dot(push, push);
+        }
+    }
+
+    // Assert, that box1 is pushed away from box2
+    tg::vec3 d = circle_any.center - box_dynamic.center;
+    if (tg::dot(d, minimum_push) > 0)
+        minimum_push *= -1;
+
+    return minimum_push;
+}
+
+
+tg::vec3 gamedev::reference::ScalarNarrowphase::minimalPush(const tg::sphere3& circle_dynamic, const tg::box3& box_static)
+{
+    return -1.0 * minimalPush(box_static, circle_dynamic);
+}
+
+tg::vec3 gamedev::reference::ScalarNarrowphase::minimalPush(const tg::sphere3& circle_dynamic, const tg::sphere3& circle_static)
+{
+    tg::vec3 dir = circle_dynamic.center - circle_static.center;
+    float len = tg::length(dir);
+
+    if (len >= circle_dynamic.radius + circle_static.radius)
+        return tg::vec3::zero;
+
+    dir /= len;
+
+    tg::vec3 push = dir * tg::abs(len - circle_dynamic.radius - circle_static.radius);
+
+    return push;
+}
+
@@ -0,0 +1,42 @@
+#pragma once
+#include "ecs/Engine.hh"
+#include "components/ShapeComp.hh"
+#include <array>
+
+namespace gamedev
+{
+namespace reference
+{
+/***
+* Narrowphase of the CollisionSystem before the batched kernels: one Collide() per pair, dispatched by
+* four component lookups, transforms both shapes & resolves it with minimalPush / SAT_AxisTest on 3D shapes.
+*
+* Only computes the push (GetLastPush()), nothing is moved.
+*
+***/
+class ScalarNarrowphase
+{
+public:
+    explicit ScalarNarrowphase(std::shared_ptr<EngineECS> ecs) : mECS(std::move(ecs)) {}
+
+    // True if the pair overlaps, GetLastPush() then moves handle_dynamic out of handle_any
+    bool Collide(InstanceHandle handle_dynamic, InstanceHandle handle_any);
+    tg::vec3 GetLastPush() const { return mLastPush; }
+
+private:
+    bool Collide(InstanceHandle handle_dyn, transform& xform_dyn, transform const& xform_any, const BoxShape* box1, const BoxShape* box2);
+    bool Collide(InstanceHandle handle_dyn, transform& xform_dyn, transform const& xform_any, const BoxShape* box, const CircleShape* circle);
+    bool Collide(InstanceHandle handle_dyn, transform& xform_dyn, transform const& xform_any, const CircleShape* circle, const BoxShape* box);
+    bool Collide(InstanceHandle handle_dyn, transform& xform_dyn, transform const& xform_any, const CircleShape* circle1, const CircleShape* circle2);
+    tg::vec3 minimalPush(const tg::box3& box1, const tg::box3& box2);
+    tg::vec3 minimalPush(const tg::sphere3& circle1, const tg::sphere3& circle2);
+    tg::vec3 minimalPush(const tg::box3& box, const tg::sphere3& circle);
+    tg::vec3 minimalPush(const tg::sphere3& circle_dynamic, const tg::box3& box_static);
+    tg::vec3 SAT_AxisTest(const tg::vec3& axis, const std::array<tg::pos3, 4>& points1, const std::array<tg::pos3, 4>& points2);
+
+private:
+    std::shared_ptr<EngineECS> mECS;
+    tg::vec3 mLastPush = tg::vec3::zero;
+};
+}
+}
@@ -11,4 +11,31 @@
 #include "components/PrototypeComp.hh"
 #include "components/AudioComp.hh"
 #include "components/AnimationComp.hh"
+#include <type_traits>
 
+namespace gamedev
+{
+// Components are PODs, the component storages & the prefab store relocate & clone them with memcpy.
+static_assert(std::is_trivially_copyable_v<Physics>, "Physics is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Render>, "Render is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<BoxShape>, "BoxShape is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<CircleShape>, "CircleShape is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Collider>, "Collider is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Prototype>, "Prototype is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<SoundEmitter>, "SoundEmitter is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Animated>, "Animated is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Input>, "Input is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<PointLightEmitter>, "PointLightEmitter is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<ParticleEmitter>, "ParticleEmitter is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Living>, "Living is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Dweller>, "Dweller is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Attacker>, "Attacker is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Mortal>, "Mortal is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Destructible>, "Destructible is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Producer>, "Producer is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Climber>, "Climber is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Arrow>, "Arrow is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<InTower>, "InTower is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<Tower>, "Tower is expected to be trivially copyable");
+static_assert(std::is_trivially_copyable_v<ForeignControl>, "ForeignControl is expected to be trivially copyable");
+}
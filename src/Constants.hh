@@ -4,8 +4,11 @@
 // Maximum amount of different Component Types
 #define MAX_COMPONENTS 32U
 
-// Maximum amount of living entities
-#define MAX_INSTANCES 2048
+// Amount of components per storage chunk (chunks are allocated on demand and never move)
+#define COMPONENT_CHUNK_SIZE 1024U
+
+// Size of a storage chunk of the archetype backend in bytes (GAMEDEV_ARCHETYPE_STORAGE)
+#define ARCHETYPE_CHUNK_BYTES 16384U
 
 // Indicator which components an entity has or which a system needs (simple bitwise comparison)
 using Signature = std::bitset<MAX_COMPONENTS>;
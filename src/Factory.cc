@@ -62,6 +62,7 @@ void gamedev::Factory::AddPreset(std::string identifier, std::filesystem::path i
     if (pathFound && nameFound)
     {
         OverwritePreset(mObjectPathToID[path], presetHandle);
+        return;
     }
 
     if (!pathFound && nameFound)
@@ -89,28 +90,133 @@ void gamedev::Factory::AddPreset(std::string identifier, std::filesystem::path i
 void gamedev::Factory::OverwritePreset(int presetID, InstanceHandle templateHandle)
 {
     glow::info() << "Overwriting Object.";
+
+    // The prefab (if any) is replaced when the new preset is baked
     auto presetHandle = mIDToPreset[presetID];
-    mECS->RemoveAllComponents(presetHandle);
-    mECS->CloneComponents(templateHandle, presetHandle);
+    if (mECS->IsLiveHandle(presetHandle))
+    {
+        mECS->DestroyInstance(presetHandle);
+    }
+
+    mIDToPreset[presetID] = templateHandle;
 }
 
-gamedev::InstanceHandle gamedev::Factory::GetPreset(std::string identifier)
+int gamedev::Factory::FindPresetID(std::string const& identifier)
 {
     std::string name = lowerString(identifier);
-    
+
     if (mObjectNameToID.find(name) != mObjectNameToID.end())
     {
-        return mIDToPreset[mObjectNameToID[name]];
+        return mObjectNameToID[name];
     }
 
     if (mObjectPathToID.find(name) != mObjectPathToID.end())
     {
-        return mIDToPreset[mObjectPathToID[name]];
+        return mObjectPathToID[name];
+    }
+
+    return -1;
+}
+
+gamedev::InstanceHandle gamedev::Factory::GetPreset(std::string identifier)
+{
+    auto presetID = FindPresetID(identifier);
+
+    if (presetID >= 0 && mIDToPreset.find(presetID) != mIDToPreset.end())
+    {
+        return mIDToPreset[presetID];
     }
 
     return {std::uint32_t(-1)};
 }
 
+gamedev::PrefabHandle gamedev::Factory::GetPrefab(std::string identifier)
+{
+    auto presetID = FindPresetID(identifier);
+
+    if (presetID < 0)
+    {
+        return {};
+    }
+
+    BakePreset(presetID);
+
+    return mIDToPrefab[presetID];
+}
+
+gamedev::transform gamedev::Factory::GetPresetTransform(std::string identifier)
+{
+    auto presetID = FindPresetID(identifier);
+    assert(presetID >= 0 && "Accessing unregistered preset.");
+
+    auto preset = mIDToPreset.find(presetID);
+    if (preset != mIDToPreset.end())
+    {
+        return mECS->GetInstanceTransform(preset->second);
+    }
+
+    return mECS->GetPrefabs().GetTransform(mIDToPrefab[presetID]);
+}
+
+tg::aabb3 gamedev::Factory::GetPresetBounds(std::string identifier)
+{
+    auto presetID = FindPresetID(identifier);
+    assert(presetID >= 0 && "Accessing unregistered preset.");
+
+    auto preset = mIDToPreset.find(presetID);
+    if (preset != mIDToPreset.end())
+    {
+        return mECS->GetInstanceBounds(preset->second);
+    }
+
+    return mECS->GetPrefabs().GetBounds(mIDToPrefab[presetID]);
+}
+
+gamedev::PrefabRender gamedev::Factory::PresetRender(std::string const& asset_name)
+{
+    auto& prefabs = mECS->GetPrefabs();
+
+    PrefabRender render;
+    render.mesh = prefabs.GetAssetId(asset_name);
+    render.texAlbedo = prefabs.GetAssetId(GameObjects::TexAlbedoPolyPaletteName);
+    return render;
+}
+
+void gamedev::Factory::BakePreset(int presetID)
+{
+    auto preset = mIDToPreset.find(presetID);
+    if (preset == mIDToPreset.end())
+    {
+        return;
+    }
+
+    // A re-registered preset replaces its old prefab
+    auto prefab = mIDToPrefab.find(presetID);
+    PrefabHandle replace = prefab != mIDToPrefab.end() ? prefab->second : PrefabHandle{};
+
+    // Presets added without Register() have no render assets
+    mIDToPrefab[presetID] = mECS->BakePrefab(preset->second, mIDToRender[presetID], replace);
+    mECS->DestroyInstance(preset->second);
+
+    mIDToPreset.erase(preset);
+}
+
+void gamedev::Factory::BakePresets()
+{
+    std::vector<int> presetIDs;
+    presetIDs.reserve(mIDToPreset.size());
+
+    for (const auto& preset : mIDToPreset)
+    {
+        presetIDs.push_back(preset.first);
+    }
+
+    for (auto presetID : presetIDs)
+    {
+        BakePreset(presetID);
+    }
+}
+
 gamedev::InstanceHandle gamedev::Factory::Register(std::string asset_identifier, float scaling)
 {
     std::string a_name = lowerString(asset_identifier);
@@ -122,7 +228,7 @@ gamedev::InstanceHandle gamedev::Factory::Register(std::string asset_identifier,
     }
 
     auto handle = mECS->CreateInstance(mObj->getVAO(a_name), mObj->mTexAlbedoPolyPalette, nullptr, nullptr);
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     auto prototype = mECS->CreateComponent<gamedev::Prototype>(handle);
 
@@ -137,6 +243,7 @@ gamedev::InstanceHandle gamedev::Factory::Register(std::string asset_identifier,
     PostProcessRegistration(handle);
 
     AddPreset(a_name, handle);
+    mIDToRender[FindPresetID(a_name)] = PresetRender(a_name);
 
     return handle;
 }
@@ -153,7 +260,7 @@ gamedev::InstanceHandle gamedev::Factory::Register(std::string asset_identifier,
     }
 
     auto handle = mECS->CreateInstance(mObj->getVAO(a_name), mObj->mTexAlbedoPolyPalette, nullptr, nullptr);
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     auto prototype = mECS->CreateComponent<gamedev::Prototype>(handle);
 
@@ -166,6 +273,7 @@ gamedev::InstanceHandle gamedev::Factory::Register(std::string asset_identifier,
     PostProcessRegistration(handle);
 
     AddPreset(f_name, handle);
+    mIDToRender[FindPresetID(f_name)] = PresetRender(a_name);
 
     return handle;
 }
@@ -183,7 +291,7 @@ gamedev::InstanceHandle gamedev::Factory::Register(std::string asset_identifier,
     }
 
     auto handle = mECS->CreateInstance(mObj->getVAO(a_name), mObj->mTexAlbedoPolyPalette, nullptr, nullptr);
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     auto prototype = mECS->CreateComponent<gamedev::Prototype>(handle);
 
@@ -197,34 +305,60 @@ gamedev::InstanceHandle gamedev::Factory::Register(std::string asset_identifier,
     PostProcessRegistration(handle);
 
     AddPreset(f_name, f_path, handle);
+    mIDToRender[FindPresetID(f_name)] = PresetRender(a_name);
 
     return handle;
 }
 
-gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle)
+void gamedev::Factory::AddToSpatialIndex(InstanceHandle handle)
+{
+    mECS->GetHashMap().AddInstance(handle, mECS->GetInstanceTransform(handle).translation, mECS->GetInstanceBounds(handle), SpatialCategoriesOf(handle));
+}
+
+gamedev::SpatialMask gamedev::Factory::SpatialCategoriesOf(InstanceHandle handle)
+{
+    SpatialMask categories = 0;
+
+    if (auto collider = mECS->TryGetComponent<Collider>(handle))
+        categories |= collider->dynamic ? SpatialDynamic : SpatialStatic;
+
+    if (auto living = mECS->TryGetComponent<Living>(handle))
+        return categories | SpatialUnit | (living->friendly ? SpatialFriendly : SpatialHostile);
+
+    if (mECS->TestSignature<Collider>(handle))
+        return categories | SpatialStructure;
+
+    return categories | SpatialItem;
+}
+
+gamedev::InstanceHandle gamedev::Factory::CloneInstance_(InstanceHandle source_handle)
 {
     auto clone_handle = mECS->CloneInstance(source_handle);
-    auto& clone = mECS->GetInstance(clone_handle);
     mECS->CloneComponents(source_handle, clone_handle);
-    mECS->GetHashMap().AddInstance(clone_handle, clone.xform.translation, clone.max_bounds);
+    return clone_handle;
+}
+
+gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle)
+{
+    auto clone_handle = CloneInstance_(source_handle);
+    AddToSpatialIndex(clone_handle);
     return clone_handle;
 }
 
 gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle, tg::pos3 position)
 {
-    auto clone_handle = Clone(source_handle);
-    auto& clone = mECS->GetInstance(clone_handle);
+    auto clone_handle = CloneInstance_(source_handle);
+    auto clone = mECS->GetInstance(clone_handle);
     clone.xform.translation = position - tg::pos3::zero;
-    mECS->GetHashMap().UpdateInstance(clone_handle, clone.xform.translation, clone.max_bounds);
 
     if (mT)
     {
         clone.xform.translation.y = mT->heightAt(position);
     }
 
-    mECS->GetHashMap().UpdateInstance(clone_handle, clone.xform.translation, clone.max_bounds);
-    auto e = Event(EventType::NewPosition, clone_handle, clone_handle);
-    mECS->SendFunctionalEvent(e);
+    // Listed once at its final position, later moves go through the transform change log
+    AddToSpatialIndex(clone_handle);
+    mECS->MarkTransformChanged(clone_handle);
 
     return clone_handle;
 }
@@ -232,8 +366,9 @@ gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle, tg
 gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle, tg::pos3 position, tg::quat rotation)
 {
     auto clone_handle = Clone(source_handle, position);
-    auto& clone = mECS->GetInstance(clone_handle);
+    auto clone = mECS->GetInstance(clone_handle);
     clone.xform.rotation = rotation;
+    mECS->MarkTransformChanged(clone_handle);
 
     return clone_handle;
 }
@@ -241,9 +376,10 @@ gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle, tg
 gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle, tg::pos3 position, tg::quat rotation, tg::size3 scaling)
 {
     auto clone_handle = Clone(source_handle, position);
-    auto& clone = mECS->GetInstance(clone_handle);
+    auto clone = mECS->GetInstance(clone_handle);
     clone.xform.rotation = rotation;
     clone.xform.scaling = scaling;
+    mECS->MarkTransformChanged(clone_handle);
 
     return clone_handle;
 }
@@ -251,13 +387,14 @@ gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle, tg
 gamedev::InstanceHandle gamedev::Factory::Clone(InstanceHandle source_handle, tg::pos3 position, tg::size3 scaling)
 {
     auto clone_handle = Clone(source_handle, position);
-    auto& clone = mECS->GetInstance(clone_handle);
+    auto clone = mECS->GetInstance(clone_handle);
     clone.xform.scaling = scaling;
+    mECS->MarkTransformChanged(clone_handle);
 
     return clone_handle;
 }
 
-gamedev::InstanceHandle gamedev::Factory::Create(std::string identifier)
+gamedev::InstanceHandle gamedev::Factory::Instantiate_(std::string identifier)
 {
     std::string name = lowerString(identifier);
 
@@ -267,41 +404,41 @@ gamedev::InstanceHandle gamedev::Factory::Create(std::string identifier)
         return { std::uint32_t(-1)};
     }
 
-    auto preset_handle = GetPreset(name);
-    auto fresh_handle = mECS->CloneInstance(preset_handle);
-    mECS->CloneComponents(preset_handle, fresh_handle);
+    auto fresh_handle = mECS->Instantiate(GetPrefab(name));
 
-    mECS->RemoveComponent<gamedev::Prototype>(fresh_handle);
+    mGeneratedObjects.push_back({fresh_handle, name});
+    mLastCreated = mGeneratedObjects.back();
 
-    auto& instance = mECS->GetInstance(fresh_handle);
-    mECS->GetHashMap().AddInstance(fresh_handle, instance.xform.translation, instance.max_bounds);
-    auto e = Event(EventType::NewPosition, fresh_handle, fresh_handle);
-    mECS->SendFunctionalEvent(e);
+    return fresh_handle;
+}
 
-    mECS->UpdateSystems(fresh_handle);
+gamedev::InstanceHandle gamedev::Factory::Create(std::string identifier)
+{
+    auto fresh_handle = Instantiate_(identifier);
 
-    mGeneratedObjects.push_back({fresh_handle, name});
-    mLastCreated = mGeneratedObjects.back();
+    if (fresh_handle.is_valid())
+        AddToSpatialIndex(fresh_handle);
 
     return fresh_handle;
 }
 
 gamedev::InstanceHandle gamedev::Factory::Create(std::string object_name, tg::pos3 position)
 {
-    auto fresh_handle = Create(object_name);
-    auto& transform = mECS->GetInstance(fresh_handle).xform;
-    transform.translation = tg::vec3(position);
+    auto fresh_handle = Instantiate_(object_name);
+    if (!fresh_handle.is_valid())
+        return fresh_handle;
 
-    auto& instance = mECS->GetInstance(fresh_handle);
+    auto& transform = mECS->GetInstanceTransform(fresh_handle);
+    transform.translation = tg::vec3(position);
 
     if (mT)
     {
         transform.translation.y = mT->heightAt(position);
     }
 
-    mECS->GetHashMap().UpdateInstance(fresh_handle, instance.xform.translation, instance.max_bounds);
-    auto e = Event(EventType::NewPosition, fresh_handle, fresh_handle);
-    mECS->SendFunctionalEvent(e);
+    // Listed once at its final position, later moves go through the transform change log
+    AddToSpatialIndex(fresh_handle);
+    mECS->MarkTransformChanged(fresh_handle);
 
     return fresh_handle;
 }
@@ -309,8 +446,9 @@ gamedev::InstanceHandle gamedev::Factory::Create(std::string object_name, tg::po
 gamedev::InstanceHandle gamedev::Factory::Create(std::string object_name, tg::pos3 position, tg::quat rotation)
 {
     auto fresh_handle = Create(object_name, position);
-    auto& transform = mECS->GetInstance(fresh_handle).xform;
+    auto& transform = mECS->GetInstanceTransform(fresh_handle);
     transform.rotation = rotation;
+    mECS->MarkTransformChanged(fresh_handle);
 
     return fresh_handle;
 }
@@ -318,9 +456,10 @@ gamedev::InstanceHandle gamedev::Factory::Create(std::string object_name, tg::po
 gamedev::InstanceHandle gamedev::Factory::Create(std::string object_name, tg::pos3 position, tg::quat rotation, tg::size3 scaling)
 {
     auto fresh_handle = Create(object_name, position);
-    auto& transform = mECS->GetInstance(fresh_handle).xform;
+    auto& transform = mECS->GetInstanceTransform(fresh_handle);
     transform.rotation = rotation;
     transform.scaling = scaling;
+    mECS->MarkTransformChanged(fresh_handle);
 
     return fresh_handle;
 }
@@ -328,12 +467,55 @@ gamedev::InstanceHandle gamedev::Factory::Create(std::string object_name, tg::po
 gamedev::InstanceHandle gamedev::Factory::Create(std::string object_name, tg::pos3 position, tg::size3 scaling)
 {
     auto fresh_handle = Create(object_name, position);
-    auto& transform = mECS->GetInstance(fresh_handle).xform;
+    auto& transform = mECS->GetInstanceTransform(fresh_handle);
     transform.scaling = scaling;
+    mECS->MarkTransformChanged(fresh_handle);
 
     return fresh_handle;
 }
 
+std::vector<gamedev::InstanceHandle> gamedev::Factory::CreateBatch(std::string identifier, cc::span<transform const> placements)
+{
+    std::string name = lowerString(identifier);
+
+    if (!exists(name))
+    {
+        glow::error() << "Creating unregistered unit.";
+        return {};
+    }
+
+    auto prefab = GetPrefab(name);
+    auto const& preset = mECS->GetPrefabs().GetTransform(prefab);
+
+    std::vector<transform> xforms(placements.size(), preset);
+    for (size_t i = 0; i < placements.size(); i++)
+    {
+        auto& xform = xforms[i];
+        xform.translation = placements[i].translation;
+        xform.rotate(placements[i].rotation);
+        xform.scale(placements[i].scaling);
+
+        if (mT)
+        {
+            xform.translation.y = mT->heightAt(tg::pos3(xform.translation));
+        }
+    }
+
+    auto fresh_handles = mECS->InstantiateBatch(prefab, xforms);
+
+    for (auto handle : fresh_handles)
+    {
+        AddToSpatialIndex(handle);
+
+        mGeneratedObjects.push_back({handle, name});
+    }
+
+    if (!fresh_handles.empty())
+        mLastCreated = mGeneratedObjects.back();
+
+    return fresh_handles;
+}
+
 void gamedev::Factory::RegisterAutomatically(std::vector<std::string> asset_identifiers, float scaling)
 {
     for (const auto& obj : asset_identifiers)
@@ -439,7 +621,7 @@ bool gamedev::Factory::SaveObjectsTo(std::filesystem::path filepath)
 
     for (auto& object : mGeneratedObjects)
     {
-        auto xform = mECS->GetInstance(object.first).xform;
+        auto xform = mECS->GetInstanceTransform(object.first);
 
         file.write((char*)object.second.c_str(), object.second.size()); // write string identifier
         file.write("\0", sizeof(char));                                 // write null end for easy reading of string
@@ -475,7 +657,7 @@ bool gamedev::Factory::SaveMarkedObjectsTo(std::filesystem::path filepath)
 
     for (auto& object : mMarkedObjects)
     {
-        auto xform = mECS->GetInstance(object.first).xform;
+        auto xform = mECS->GetInstanceTransform(object.first);
 
         file.write((char*)object.second.c_str(), object.second.size()); // write string identifier
         file.write("\0", sizeof(char));                                 // write null end for easy reading of string
@@ -524,6 +706,7 @@ std::vector<gamedev::InstanceHandle> gamedev::Factory::LoadObjectsFrom(std::file
 
         auto handle = Create(identifier, tg::pos3(translation), rotation, scaling);   // create instance upon this
         mECS->GetInstanceTransform(handle).translation = translation;
+        mECS->MarkTransformChanged(handle);
 
         handles.push_back(handle);
 
@@ -18,9 +18,16 @@
  *    auto handle = GetPreset("person");              // Can be accessed either by the path above or by its filename alone (without extension)
  *    // Do something with handle to modify preset
  * 
+ * Presets are authored as instances (flagged as Prototype). Once they are complete, BakePresets() moves them into
+ * prefabs (see ecs/PrefabStore.hh), which releases their instances & components from the world.
+ * Creating an entity from a preset which was not baked yet bakes it first.
+ * 
  * Creating an entity is as simple as:
  *    auto handle = Create("person");
  * 
+ * Many entities of the same preset are created at once by:
+ *    auto handles = CreateBatch("creature", placements);
+ * 
  * To customize the registration of new entities, subclasses of factory can overwrite the Register() methods.
  * 
  */
@@ -39,9 +46,20 @@ public:
     void AddPreset(std::string identifier, InstanceHandle presetHandle);
     void AddPreset(std::string identifier, std::filesystem::path identifying_path, InstanceHandle presetHandle);
 
-    // Returns the handle of the actual preset (i.e. to modify the preset)
+    // Returns the handle of the actual preset (i.e. to modify the preset), only valid until the preset is baked
     InstanceHandle GetPreset(std::string identifier);
 
+    // Returns the prefab of the preset (bakes the preset if needed)
+    PrefabHandle GetPrefab(std::string identifier);
+
+    // Instance data of a preset, whether it is baked or not
+    transform GetPresetTransform(std::string identifier);
+    tg::aabb3 GetPresetBounds(std::string identifier);
+
+    // Moves all presets into prefabs and destroys their instances.
+    // Presets registered afterwards are baked on their first use (or by the next call).
+    void BakePresets();
+
     // Create a new object with the asset manager using asset_identifier
     // and add this object as a preset with the "prototype" component (prevents system usage of this instance).
     // Will either use the asset_identifier name as an identifier for the factory system and, if applicable, also add as a path identifier.
@@ -58,6 +76,10 @@ public:
     InstanceHandle Create(std::string identifier, tg::pos3 position, tg::quat rotation, tg::size3 scaling);
     InstanceHandle Create(std::string identifier, tg::pos3 position, tg::size3 scaling);
 
+    // Creates one instance per placement in a single batch (cheaper than calling Create() repeatedly, see EngineECS::CloneInstanceBatch).
+    // Each placement sets the position (placed on the terrain if attached), its rotation & scaling are applied on top of the preset.
+    std::vector<InstanceHandle> CreateBatch(std::string identifier, cc::span<transform const> placements);
+
     // Creates a new instance and clones the components of the given handle (along with some transformation)
     InstanceHandle Clone(InstanceHandle templateHandle);
     InstanceHandle Clone(InstanceHandle templateHandle, tg::pos3 position);
@@ -91,11 +113,24 @@ public:
 private:
     // Overwrites the given ID with the given handle. Won't do any sanity check.
     void OverwritePreset(int presetID, InstanceHandle templateHandle);
+    void BakePreset(int presetID);
+    // Asset ids of the mesh & the palette texture of a registered preset
+    PrefabRender PresetRender(std::string const& asset_name);
+    // Returns the internal ID of the identifier (name or path) or -1
+    int FindPresetID(std::string const& identifier);
     bool SaveObjectsTo(std::filesystem::path filepath);
     bool SaveMarkedObjectsTo(std::filesystem::path filepath);
     std::vector<InstanceHandle> LoadObjectsFrom(std::filesystem::path filepath, bool marked = false);
 
     tg::aabb3 MaxBoundingBox(tg::aabb3& boundingBox);
+
+    // Creates the instance without listing it in the spatial index
+    InstanceHandle Instantiate_(std::string identifier);
+    InstanceHandle CloneInstance_(InstanceHandle source_handle);
+
+    // Lists a fresh instance in the spatial hash map of the ECS, categorized by its components
+    void AddToSpatialIndex(InstanceHandle handle);
+    SpatialMask SpatialCategoriesOf(InstanceHandle handle);
 protected:
     // Can be modified by subclasses to i.e. add some additional components while using the main class' registration method
     virtual void PostProcessRegistration(InstanceHandle presetHandle){};
@@ -113,8 +148,10 @@ protected:
     // Mappings to get from the object identifier (name or path) to the internal ID which uniquely identifies the presets handle
     std::unordered_map<std::string, int> mObjectNameToID;
     std::unordered_map<std::string, int> mObjectPathToID;
-    // A unique mapping the the instance handle of the preset
+    // A unique mapping the the instance handle of the preset (while authored), to its prefab (once baked) & its render assets
     std::unordered_map<int, InstanceHandle> mIDToPreset;
+    std::unordered_map<int, PrefabHandle> mIDToPrefab;
+    std::unordered_map<int, PrefabRender> mIDToRender;
 
     // Keeps track of all objects that were created (not cloned) by this factory (handle & object identifier)
     std::list<std::pair<InstanceHandle, std::string>> mGeneratedObjects;
@@ -21,6 +21,7 @@
 #include <glow-extras/geometry/UVSphere.hh>
 
 #include "utility/Random.hh"
+#include "utility/Raycast.hh"
 
 #include <GLFW/glfw3.h> // window/input framework
 
@@ -69,7 +70,7 @@ void Game::init()
     mCamera.target.forward = tg::normalize(tg::vec3(1.f, -0.7f, 0.f));*/
     mCamera.physical = mCamera.target;
 
-    mAdvancedFeatures.initialize();
+    mAdvancedFeatures.initialize(mMaxInstances);
 
     // Game Assets
     mGameAssets = std::make_shared<gamedev::GameObjects>();
@@ -104,6 +105,14 @@ void Game::init()
     mECS->RegisterComponent<gamedev::Tower>();
     mECS->RegisterComponent<gamedev::ForeignControl>();
 
+    // Register Events
+    mECS->RegisterEvent<gamedev::CollisionEvent>();
+    mECS->RegisterEvent<gamedev::ArrowHitEvent>();
+    mECS->RegisterEvent<gamedev::HitEvent>();
+    mECS->RegisterEvent<gamedev::DeathEvent>();
+    mECS->RegisterEvent<gamedev::SupplyEvent>();
+    mECS->RegisterEvent<gamedev::MoreWoodEvent>();
+
     // Register systems managed by ECS before use
     mCollisionSys = mECS->RegisterSystem<gamedev::CollisionSystem>();
     {
@@ -156,7 +165,6 @@ void Game::init()
         signature.set(mECS->GetComponentType<gamedev::SoundEmitter>());
         mECS->SetSystemSignature<gamedev::AudioSystem>(signature);
     }
-    mCleanSys = mECS->RegisterSystem<gamedev::CleanupSystem>();
 
     // Create autonomous systems not managed by ECS before use
     mEnvironmentSys = std::make_shared<gamedev::EnvironmentSystem>(); 
@@ -168,7 +176,6 @@ void Game::init()
     mLightSys->Init(mECS);
     mParticleSys->Init(mECS);
     mAnimationSys->Init(mECS);
-    mCleanSys->Init(mECS);
     mAudioSys->Init(mECS);
 
     // Factories
@@ -184,7 +191,13 @@ void Game::init()
     mStructFac->Init(mECS, mGameAssets);
     mNatureFac->Init(mECS, mGameAssets);
 
-    // Terrain
+    // The prefabs of the factories refer to their meshes & textures by asset name
+    auto assets = mGameAssets;
+    mECS->SetAssetResolvers([assets](std::string const& mesh) { return assets->getVAO(mesh); },
+                            [assets](std::string const& texture) { return assets->getTexture(texture); });
+
+    // Terrain (initializes the spatial index over the map)
+    mECS->SetSpatialIndexType(mSpatialIndexType);
     mTerrain = std::make_shared<gamedev::Terrain>();
     mTerrain->Init(mECS);
     mTerrain->setGroundMesh("../data/meshes/world_ground.obj");
@@ -200,7 +213,7 @@ void Game::init()
     mStructFac->AttachTerrain(mTerrain);
     mNatureFac->AttachTerrain(mTerrain);
     mGamelogicSys->AttachTerrain(mTerrain);
-    mCollisionSys->Init(mECS, mTerrain->GetSize());
+    mCollisionSys->Init(mECS);
 
     // Initialize GFX
     mRenderSys->UpdateWindowResolution(getWindowSize());
@@ -219,6 +232,12 @@ void Game::init()
     mUnitFac->InitResources();
     mItemFac->InitResources();
 
+    // Presets are complete, move them out of the world
+    mNatureFac->BakePresets();
+    mStructFac->BakePresets();
+    mUnitFac->BakePresets();
+    mItemFac->BakePresets();
+
     fillSpawnMenu(mNatureFac->GetNameIdentifiers(), mItemFac->GetNameIdentifiers(), mUnitFac->GetNameIdentifiers(), mStructFac->GetNameIdentifiers());
 
     // Initialize Game State
@@ -242,6 +261,62 @@ void Game::init()
     mItemFac->LoadObjects();
 
     mEnvironmentSys->SetMinutesPerDay(0.5);
+
+    initScheduler();
+}
+
+void Game::initScheduler()
+{
+    using gamedev::Resource;
+
+    mScheduler.Init(mECS);
+    mCollisionSys->SetThreadPool(mScheduler.GetThreadPool());
+
+    auto const playing = [this]() { return state == PLAY; };
+    auto const visible = [this]() { return state == PLAY || state == MENU; };
+
+    mScheduler.AddSystem("Particles", [this](float dt) { mParticleSys->Update(dt); })
+        .RunIf([this]() { return (state == PLAY || state == MENU) && mEnableParticleSpawn; })
+        .Writes<gamedev::ParticleEmitter>()
+        .Reads(Resource::Transforms)
+        .Writes(Resource::Particles)
+        .Writes(Resource::Events);
+
+    mScheduler.AddSystem("Lights", [this](float dt) { mLightSys->Update(dt); })
+        .RunIf(visible)
+        .Writes<gamedev::PointLightEmitter>()
+        .Reads(Resource::Transforms);
+
+    mScheduler.AddSystem("Environment", [this](float dt) { mEnvironmentSys->Update(dt); })
+        .RunIf(playing)
+        .Writes(Resource::Environment);
+
+    mScheduler.AddSystem("Physics", [this](float dt) { mPhysicsSys->Update(dt); })
+        .RunIf(playing)
+        .Writes<gamedev::Physics>()
+        .Reads<gamedev::InTower>()
+        .Writes(Resource::Transforms);
+
+    // The remaining systems change the structure of the world & touch most components
+    mScheduler.AddSystem("Collision", [this](float dt) { mCollisionSys->Update(dt); }).RunIf(playing).Exclusive();
+    mScheduler.AddSystem("Gamelogic", [this](float dt) { mGamelogicSys->Update(dt); }).RunIf(playing).Exclusive();
+    mScheduler.AddSystem("Animation", [this](float dt) { mAnimationSys->Update(dt); }).RunIf(playing).Exclusive();
+
+    mScheduler.AddSystem("Waves", [this](float) { spawnWaves(); }).RunIf(playing).Exclusive();
+}
+
+void Game::spawnWaves()
+{
+    if (!mEnvironmentSys->mNewDay || mHoldSpawns)
+        return;
+
+    auto day = mEnvironmentSys->getDayCount();
+
+    if (!(day % 1))
+        mGamelogicSys->SpawnEnemyWave(day + 3);
+
+    if (!(day % 1))
+        mGamelogicSys->SpawnReinforcements(day / 2 + 2);
 }
 
 void Game::onFrameStart()
@@ -264,40 +339,13 @@ void Game::update(float elapsedSeconds)
 
     mAudioSys->Update(elapsedSeconds);
 
-    if (state == PLAY || state == MENU)
-    {
-        mTime_ParticleSys = (mEnableParticleSpawn) ? mParticleSys->Update(elapsedSeconds) / 1000.f : 0.f;
-        mTime_LightSys = mLightSys->Update(elapsedSeconds) / 1000.f;
-    }
+    mScheduler.Update(elapsedSeconds);
+
+    *mAdvancedFeatures.mStatAwakeBodies = float(mPhysicsSys->GetNumAwake());
+    *mAdvancedFeatures.mStatSleepingBodies = float(mPhysicsSys->GetNumSleeping());
 
     if (state == PLAY)
     {
-        auto t_0 = std::chrono::steady_clock::now();
-        mTime_PhysicsSys = mPhysicsSys->Update(elapsedSeconds) / 1000.f;
-        mTime_CollisionSys = mCollisionSys->Update(elapsedSeconds) / 1000.f;
-        mTime_EnvironmentSys = mEnvironmentSys->Update(elapsedSeconds) / 1000.f;
-        mTime_GamelogicSys = mGamelogicSys->Update(elapsedSeconds) / 1000.f;
-        mTime_AnimationSys = mAnimationSys->Update(elapsedSeconds) / 1000.f;
-
-        if (mEnvironmentSys->mNewDay)
-        {
-            auto day = mEnvironmentSys->getDayCount();
-
-            if (!mHoldSpawns)
-            {
-                if (!(day % 1))
-                    mGamelogicSys->SpawnEnemyWave(day + 3);
-
-                if (!(day % 1))
-                    mGamelogicSys->SpawnReinforcements(day / 2 + 2);
-            }
-        }
-
-        mTime_CleanSys = mCleanSys->Update() / 1000.f;
-
-        auto t_n = std::chrono::steady_clock::now();
-        mTime_AllSys = std::chrono::duration_cast<std::chrono::microseconds>(t_n - t_0).count() / 1000.f;
-
         frameControl++;
     }
 }
@@ -320,7 +368,7 @@ void Game::render(float elapsedSeconds)
         {
             // Get possible selection
             auto const mousePos = input().getMousePosition();
-            auto target = mRenderSys->ReadPickingBuffer(int(mousePos.x), getWindowHeight() - int(mousePos.y));
+            auto target = pickInstance(int(mousePos.x), getWindowHeight() - int(mousePos.y));
 
             mAdvancedFeatures.mSelectedInstance = target;
 
@@ -381,9 +429,8 @@ void Game::render(float elapsedSeconds)
     if (!ImGui::GetIO().WantCaptureMouse && input().isMouseButtonReleased(GLFW_MOUSE_BUTTON_2))
     {
         auto const mousePos = input().getMousePosition();
-        auto target = mRenderSys->ReadPickingBuffer(int(mousePos.x), getWindowHeight() - int(mousePos.y));
-        auto w_position = mRenderSys->MouseToWorld(mousePos.x, getWindowHeight() - mousePos.y);
-        w_position.y = mTerrain->heightAt(w_position);
+        auto target = pickInstance(int(mousePos.x), getWindowHeight() - int(mousePos.y));
+        auto w_position = pickGround(int(mousePos.x), getWindowHeight() - int(mousePos.y));
 
         if (!mEditorMode)
         {
@@ -647,15 +694,24 @@ void Game::onGui()
 
                 if (ImGui::TreeNodeEx("Performance (ms)", ImGuiTreeNodeFlags_DefaultOpen))
                 {
-                    ImGui::Text("All Systems: %.2f", mTime_AllSys);
-                    ImGui::Text("Animations: %.2f", mTime_AnimationSys);
-                    ImGui::Text("Cleaning: %.2f", mTime_CleanSys);
-                    ImGui::Text("Collisions: %.2f", mTime_CollisionSys);
-                    ImGui::Text("Environment: %.2f", mTime_EnvironmentSys);
-                    ImGui::Text("Gamelogic: %.2f", mTime_GamelogicSys);
-                    ImGui::Text("Lights: %.2f", mTime_LightSys);
-                    ImGui::Text("Particles: %.2f", mTime_ParticleSys);
-                    ImGui::Text("Physics: %.2f", mTime_PhysicsSys);
+                    bool parallel = mScheduler.IsParallel();
+                    if (ImGui::Checkbox("Parallel Systems", &parallel))
+                        mScheduler.SetParallel(parallel);
+
+                    // Between frames, no system job is running
+                    bool quadTree = mSpatialIndexType == gamedev::SpatialIndexType::LooseQuadTree;
+                    if (ImGui::Checkbox("Quadtree Spatial Index", &quadTree))
+                    {
+                        mSpatialIndexType = quadTree ? gamedev::SpatialIndexType::LooseQuadTree : gamedev::SpatialIndexType::Grid;
+                        mECS->SetSpatialIndexType(mSpatialIndexType);
+                    }
+
+                    ImGui::Text("All Systems: %.2f (%d stages, %u threads)", mScheduler.GetTotalTime(), mScheduler.GetNumStages(), mScheduler.GetNumThreads());
+                    for (const auto& job : mScheduler.GetJobs())
+                        ImGui::Text("[%d] %s: %.2f", job.stage, job.name.c_str(), job.time);
+
+                    ImGui::Text("Physics bodies: %zu awake, %zu sleeping", mPhysicsSys->GetNumAwake(), mPhysicsSys->GetNumSleeping());
+                    ImGui::Text("Colliders: %zu awake, %zu sleeping", mCollisionSys->GetNumAwake(), mCollisionSys->GetNumSleeping());
 
                     ImGui::TreePop();
                 }
@@ -691,6 +747,7 @@ void Game::onGui()
 
                 // run the editor (some Imgui and a gizmo to move it around)
                 gamedev::manipulateTransform(mAdvancedFeatures.mEditorState, view, proj, transformToManipulate);
+                mECS->MarkTransformChanged(mAdvancedFeatures.mSelectedInstance);
                 if (mECS->TestSignature<gamedev::Physics>(mAdvancedFeatures.mSelectedInstance))
                 {
                     gamedev::manipulatePhysics(mAdvancedFeatures.mEditorState, mECS->GetComponent<gamedev::Physics>(mAdvancedFeatures.mSelectedInstance));
@@ -891,6 +948,42 @@ void Game::flyToSelectedinstance()
     }
 }
 
+gamedev::InstanceHandle Game::pickInstance(int x, int y)
+{
+    auto ray = mRenderSys->MouseToRay(x, y);
+
+    // Nothing behind the ground
+    gamedev::RaycastHit hit;
+    if (gamedev::RaycastTerrain(*mTerrain, ray, hit))
+        ray.pos1 = hit.position;
+
+    // Only units & structures, carried weapons, items & arrows would cover them.
+    // A mask requests all of its categories, so both are cast & the first hit wins.
+    gamedev::RaycastHit unitHit, structureHit;
+    auto const unit = gamedev::RaycastInstances(*mECS, ray, 0.f, gamedev::SpatialUnit, mPickCandidates, unitHit);
+    auto const structure = gamedev::RaycastInstances(*mECS, ray, 0.f, gamedev::SpatialStructure, mPickCandidates, structureHit);
+
+    if (unit && (!structure || unitHit.t <= structureHit.t))
+        return unitHit.handle;
+
+    return structure ? structureHit.handle : gamedev::InstanceHandle{std::uint32_t(-1)};
+}
+
+tg::pos3 Game::pickGround(int x, int y)
+{
+    auto const ray = mRenderSys->MouseToRay(x, y);
+
+    gamedev::RaycastHit hit;
+    if (gamedev::RaycastTerrain(*mTerrain, ray, hit))
+        return hit.position;
+
+    // Off the map: on the plane y = 0
+    auto const delta = ray.pos1 - ray.pos0;
+    auto position = delta.y < 0.f ? ray.pos0 - (ray.pos0.y / delta.y) * delta : ray.pos1;
+    position.y = mTerrain->heightAt(position);
+    return position;
+}
+
 void Game::fillSpawnMenu(std::vector<std::string> nature, std::vector<std::string> items, std::vector<std::string> units, std::vector<std::string> structures)
 {
     mNatureObjects = nature;
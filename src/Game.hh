@@ -21,8 +21,8 @@
 #include "systems/ParticleSystem.hh"
 #include "systems/GamelogicSystem.hh"
 #include "systems/AnimationSystem.hh"
-#include "systems/CleanupSystem.hh"
 #include "systems/AudioSystem.hh"
+#include "ecs/Scheduler.hh"
 
 // Factories
 #include "factories/UnitFactory.hh"
@@ -50,6 +50,9 @@ private:
     // Features
     gamedev::AdvancedFeatures mAdvancedFeatures;
 
+    // Capacity of the world (all live instances incl. prototypes, arrows, ...)
+    uint32_t mMaxInstances = 131072;
+
     gamedev::AudioSystem mAudioSystem;
 
     //UI
@@ -67,6 +70,9 @@ private:
     bool mCullFaces = true;
     bool mHoldSpawns = false;
 
+    // Structure behind the spatial index shared by all systems, can be switched in the Performance settings
+    gamedev::SpatialIndexType mSpatialIndexType = gamedev::SpatialIndexType::Grid;
+
     // Shadows
     bool mEnablePointShadows = true;
     bool mEnableDirShadows = true;
@@ -101,17 +107,6 @@ private:
     bool mEnableFreeFlyCam = false;
 
 private:
-    // Debug
-    float mTime_PhysicsSys = 0.0;
-    float mTime_CollisionSys = 0.0;
-    float mTime_EnvironmentSys = 0.0;
-    float mTime_LightSys = 0.0;
-    float mTime_ParticleSys = 0.0;
-    float mTime_GamelogicSys = 0.0;
-    float mTime_AnimationSys = 0.0;
-    float mTime_CleanSys = 0.0;
-    float mTime_AllSys = 0.0;
-
     // Shadows
     int mPointShadowResolution = 1024;
     int mDirShadowResolution = 1024;
@@ -176,6 +171,9 @@ private:
     // Terrain
     std::shared_ptr<gamedev::Terrain> mTerrain;
 
+    // Picking
+    std::vector<gamedev::SpatialRayHit> mPickCandidates;
+
     // ECS
     std::shared_ptr<gamedev::EngineECS> mECS;
     std::shared_ptr<gamedev::CollisionSystem> mCollisionSys;
@@ -186,9 +184,11 @@ private:
     std::shared_ptr<gamedev::ParticleSystem> mParticleSys;
     std::shared_ptr<gamedev::GamelogicSystem> mGamelogicSys;
     std::shared_ptr<gamedev::AnimationSystem> mAnimationSys;
-    std::shared_ptr<gamedev::CleanupSystem> mCleanSys;
     std::shared_ptr<gamedev::AudioSystem> mAudioSys;
 
+    // Runs the system updates (per-system timings are shown in the UI)
+    gamedev::Scheduler mScheduler;
+
     // Factories
     std::shared_ptr<gamedev::UnitFactory> mUnitFac;
     std::shared_ptr<gamedev::StructureFactory> mStructFac;
@@ -227,6 +227,8 @@ public:
     //
     // your own methods
     //
+    void initScheduler();
+    void spawnWaves();
     void updateCamera(float elapsedSeconds);
     void fillSpawnMenu(std::vector<std::string> nature, std::vector<std::string> items, std::vector<std::string> units, std::vector<std::string> structures);
 
@@ -250,6 +252,10 @@ public:
     // read the picking buffer at the specified pixel coordinate
     //gamedev::InstanceHandle readPickingBuffer(int x, int y);
 
+    // picking on the CPU along the camera ray through the pixel (spatial index & terrain)
+    gamedev::InstanceHandle pickInstance(int x, int y);
+    tg::pos3 pickGround(int x, int y);
+
     void flyToSelectedinstance();
 
     void toggleEditorMode() { mEditorMode ? mEditorMode = false : mEditorMode = true; }
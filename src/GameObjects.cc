@@ -33,6 +33,14 @@ void gamedev::GameObjects::initializeTextures()
 {
     mTexAlbedoPolyPalette = glow::Texture2D::createFromFile("../data/textures/BigPalette.png", glow::ColorSpace::sRGB);
     //mTexNormalWater = glow::Texture2D::createFromFile("../data/textures/water.normal.png", glow::ColorSpace::Linear);
+
+    mMapNameToTexture[TexAlbedoPolyPaletteName] = mTexAlbedoPolyPalette;
+}
+
+glow::SharedTexture2D gamedev::GameObjects::getTexture(std::string const& name)
+{
+    auto texture = mMapNameToTexture.find(name);
+    return texture != mMapNameToTexture.end() ? texture->second : nullptr;
 }
 
 void gamedev::GameObjects::scanMeshes()
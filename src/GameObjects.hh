@@ -40,6 +40,9 @@ public:
     glow::SharedTexture2D mTexAlbedoPolyPalette;
     glow::SharedTexture2D mTexNormalWater;
 
+    // asset names of the textures above (see getTexture)
+    static constexpr char const* TexAlbedoPolyPaletteName = "bigpalette";
+
 public:
     // (deprecated) Initialize predefined meshes
     void initialize();
@@ -54,6 +57,8 @@ public:
     bool registerObject(std::filesystem::path mesh_path);
     // Get VAO using either the asset-filename or the asset-filepath
     glow::SharedVertexArray getVAO(std::filesystem::path identifier);
+    // Get a texture by its asset name (i.e. TexAlbedoPolyPaletteName), nullptr if unknown
+    glow::SharedTexture2D getTexture(std::string const& name);
     // Get AABB using either the asset-filename or the asset-filepath
     tg::aabb3 getAABB(std::filesystem::path identifier);
     // Check if a certain object identifier (filename or filepath) is registered
@@ -79,5 +84,6 @@ private:
     std::unordered_map<std::string, std::string> mMapNameToID;
     std::unordered_map<std::string, glow::SharedVertexArray> mMapObjectPathToVAO;
     std::unordered_map<std::string, tg::aabb3> mMapObjectPathToAABB;
+    std::unordered_map<std::string, glow::SharedTexture2D> mMapNameToTexture;
 };
 }
@@ -36,7 +36,7 @@ gamedev::InstanceHandle gamedev::Terrain::CreateGround(tg::pos3 pos, tg::size3 s
 
     mGroundHandle = mECS->CreateInstance(mVaoGround, mTexGround, nullptr, nullptr);
 
-    auto& groundTransform = mECS->GetInstance(mGroundHandle).xform;
+    auto& groundTransform = mECS->GetInstanceTransform(mGroundHandle);
     groundTransform.translation = pos - tg::pos3::zero;
     groundTransform.scale(scale);
 
@@ -44,9 +44,9 @@ gamedev::InstanceHandle gamedev::Terrain::CreateGround(tg::pos3 pos, tg::size3 s
 
     tg::aabb3 mapSize = tg::aabb3(mMapExtents.min, mMapExtents.max);
     tg::size3 cells = tg::size_of(mapSize);
-    mECS->GetHashMap().Init({cells.width, cells.depth}, mapSize);
+    mECS->InitSpatialIndex({cells.width, cells.depth}, mapSize);
     
-    auto& instance = mECS->GetInstance(mGroundHandle);
+    auto instance = mECS->GetInstance(mGroundHandle);
     instance.max_bounds = {mMapExtents.min, mMapExtents.max};
 
     auto render = mECS->CreateComponent<Render>(mGroundHandle);
@@ -63,7 +63,7 @@ gamedev::InstanceHandle gamedev::Terrain::CreateWater(tg::pos3 pos, tg::size3 sc
         return { unsigned(-1) };
 
     mWaterHandle = mECS->CreateInstance(mVaoWater, mTexWater, nullptr, nullptr);
-    auto& waterTransform = mECS->GetInstance(mWaterHandle).xform;
+    auto& waterTransform = mECS->GetInstanceTransform(mWaterHandle);
     waterTransform.translation = pos - tg::pos3::zero;
     waterTransform.scale(scale);
     // todo: maybe fix this and have the water have its real extents
@@ -157,7 +157,7 @@ float gamedev::Terrain::heightAt(const tg::pos2& p)
 
     // Bilinear interpolation
     float h_y0 = tg::interpolate(mHeightMap[p0.y    ][p0.x], mHeightMap[p0.y][p0.x + 1], s);
-    float h_y1 = tg::interpolate(mHeightMap[p0.y + 1][p0.x], mHeightMap[p0.y][p0.x + 1], s);
+    float h_y1 = tg::interpolate(mHeightMap[p0.y + 1][p0.x], mHeightMap[p0.y + 1][p0.x + 1], s);
     
     float h = tg::interpolate(h_y0, h_y1, t);
     return h;
@@ -171,14 +171,14 @@ float gamedev::Terrain::heightAt(const tg::pos3& p)
 
 pm::minmax_t<tg::pos3> gamedev::Terrain::getMapGroundExtents()
 {
-    const auto transform = tg::mat4(mECS->GetInstance(mGroundHandle).xform.transform_mat());
+    const auto transform = tg::mat4(mECS->GetInstanceTransform(mGroundHandle).transform_mat());
     auto extents = mMeshGround.position.minmax();
     return {transform * extents.min, transform * extents.max};
 }
 
 pm::minmax_t<tg::pos3> gamedev::Terrain::getMapWaterExtents()
 {
-    const auto transform = tg::mat4(mECS->GetInstance(mWaterHandle).xform.transform_mat());
+    const auto transform = tg::mat4(mECS->GetInstanceTransform(mWaterHandle).transform_mat());
     auto extents = mMeshWater.position.minmax();
     return {transform * extents.min, transform * extents.max};
 }
@@ -26,6 +26,9 @@ public:
     InstanceHandle CreateGround(tg::pos3 pos, tg::size3 scale);
     InstanceHandle CreateWater(tg::pos3 pos, tg::size3 scale);
 
+    // Only builds the height map of the mesh (no instance, no GL calls), e.g. for headless tests
+    void setHeightmap(const Mesh3D& mesh, const transform& xform) { createHeightmap(mesh, xform); }
+
     float heightAt(const tg::pos2& p);
     float heightAt(const tg::pos3& p);
 
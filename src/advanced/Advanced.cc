@@ -57,23 +57,23 @@ void gamedev::AdvancedFeatures::createDemoInstances(glow::SharedVertexArray cons
         for (auto z = 0; z < 9; ++z)
         {
             auto instanceHandle = mWorld.createInstance((x % 2 == 0 && z % 3 == 0) ? vaoSphere : vaoCube, texAlbedo, texNormal, texARM);
-            gamedev::Instance& instance = mWorld.getInstance(instanceHandle);
+            gamedev::InstanceRef instance = mWorld.getInstance(instanceHandle);
 
             instance.xform.translation = {float(x) * 4.f, float(x + z) * 0.5f, float(z) * 4.f};
 
-            instance.anim = (x % 3 == 0 && z % 2 == 0) ? gamedev::Instance::AnimationType::Bounce : gamedev::Instance::AnimationType::Spin;
-            instance.animSpeed = 0.15f * float(x * z + 1.f);
-            instance.animBaseY = instance.xform.translation.y;
+            instance.meta.anim = (x % 3 == 0 && z % 2 == 0) ? gamedev::Instance::AnimationType::Bounce : gamedev::Instance::AnimationType::Spin;
+            instance.meta.animSpeed = 0.15f * float(x * z + 1.f);
+            instance.meta.animBaseY = instance.xform.translation.y;
 
             // alpha is stored in the 8 least significant bits
             float alpha = tg::min(1.f, float(x + z) / 7.f);
-            instance.albedoBias = (colorScheme[(x * z) % COUNTOF(colorScheme)] << 8) | (uint32_t(alpha * 255.f) & 0xFF);
+            instance.render.albedoBias = (colorScheme[(x * z) % COUNTOF(colorScheme)] << 8) | (uint32_t(alpha * 255.f) & 0xFF);
         }
     }
 
     mInstanceGenerated = mWorld.createInstance(vaoGenerated, texAlbedo, texNormal, texARM);
     mWorld.getInstanceTransform(mInstanceGenerated).translation = {-12, -2, 9};
-    mWorld.getInstance(mInstanceGenerated).anim = gamedev::Instance::AnimationType::SinusTravel;
+    mWorld.getInstanceMeta(mInstanceGenerated).anim = gamedev::Instance::AnimationType::SinusTravel;
 
     // start with the first entity selected
     mSelectedInstance = mWorld.getNthInstanceHandle(0);
@@ -81,29 +81,32 @@ void gamedev::AdvancedFeatures::createDemoInstances(glow::SharedVertexArray cons
 
 void gamedev::AdvancedFeatures::drawWorld(glow::UsedProgram& shader)
 {
+    auto const renders = mWorld.getLiveRenders();
+    auto const transforms = mWorld.getLiveTransforms();
+
     // loop over instances in the world and draw them
     for (auto i = 0u; i < mWorld.getNumLiveInstances(); ++i)
     {
-        gamedev::Instance const& instance = mWorld.getNthInstance(i);
+        gamedev::InstanceRender const& render = renders[i];
         gamedev::InstanceHandle const handle = mWorld.getNthInstanceHandle(i);
 
         // bind the textures
-        shader["uTexAlbedo"] = instance.texAlbedo;
-        shader["uTexNormal"] = instance.texNormal;
-        shader["uTexARM"] = instance.texARM;
+        shader["uTexAlbedo"] = render.texAlbedo;
+        shader["uTexNormal"] = render.texNormal;
+        shader["uTexARM"] = render.texARM;
 
         // compute and upload the model matrix
-        tg::mat4x3 const modelMatrix = instance.xform.transform_mat();
+        tg::mat4x3 const modelMatrix = transforms[i].transform_mat();
         shader["uModel"] = modelMatrix;
 
         // set the instance handle value so it can be written to the picking buffer
         shader["uPickingID"] = handle._value;
 
         // set the color bias
-        shader["uAlbedoBiasPacked"] = instance.albedoBias;
+        shader["uAlbedoBiasPacked"] = render.albedoBias;
 
         // bind and draw the mesh
-        instance.vao->bind().draw();
+        render.vao->bind().draw();
     }
 
     *mStatNumDraws += float(mWorld.getNumLiveInstances());
@@ -111,27 +114,30 @@ void gamedev::AdvancedFeatures::drawWorld(glow::UsedProgram& shader)
 
 void gamedev::AdvancedFeatures::drawPolyWorld(glow::UsedProgram& shader)
 {
+    auto const renders = mWorld.getLiveRenders();
+    auto const transforms = mWorld.getLiveTransforms();
+
     // loop over instances in the world and draw them
     for (auto i = 0u; i < mWorld.getNumLiveInstances(); ++i)
     {
-        gamedev::Instance const& instance = mWorld.getNthInstance(i);
+        gamedev::InstanceRender const& render = renders[i];
         gamedev::InstanceHandle const handle = mWorld.getNthInstanceHandle(i);
 
         // bind the textures
-        shader["uTexAlbedo"] = instance.texAlbedo;
+        shader["uTexAlbedo"] = render.texAlbedo;
 
         // compute and upload the model matrix
-        tg::mat4x3 const modelMatrix = instance.xform.transform_mat();
+        tg::mat4x3 const modelMatrix = transforms[i].transform_mat();
         shader["uModel"] = modelMatrix;
 
         // set the instance handle value so it can be written to the picking buffer
         shader["uPickingID"] = handle._value;
 
         // set the color bias
-        shader["uAlbedoBiasPacked"] = instance.albedoBias;
+        shader["uAlbedoBiasPacked"] = render.albedoBias;
 
         // bind and draw the mesh
-        instance.vao->bind().draw();
+        render.vao->bind().draw();
     }
 
     *mStatNumDraws += float(mWorld.getNumLiveInstances());
@@ -161,12 +167,10 @@ void gamedev::AdvancedFeatures::drawOutlineIfSelected(glow::SharedTextureRectang
         shader["uProj"] = proj;
         shader["uView"] = view;
 
-        auto const& instance = mWorld.getInstance(mSelectedInstance);
-
-        tg::mat4x3 const modelMatrix = instance.xform.transform_mat();
+        tg::mat4x3 const modelMatrix = mWorld.getInstanceTransform(mSelectedInstance).transform_mat();
         shader["uModel"] = modelMatrix;
 
-        instance.vao->bind().draw();
+        mWorld.getInstanceRender(mSelectedInstance).vao->bind().draw();
 
         *mStatNumDraws += 1.f;
     }
@@ -178,7 +182,7 @@ void gamedev::AdvancedFeatures::runImgui(bool& outFlyToSelection, bool& outCreat
     {
         if (mWorld.isLiveHandle(mSelectedInstance))
         {
-            gamedev::Instance& inst = mWorld.getInstance(mSelectedInstance);
+            gamedev::InstanceRef inst = mWorld.getInstance(mSelectedInstance);
             ImGui::Text("Selected Instance 0x%08X", mSelectedInstance._value);
 
             if (ImGui::Button("Focus on Selection (F)"))
@@ -197,40 +201,40 @@ void gamedev::AdvancedFeatures::runImgui(bool& outFlyToSelection, bool& outCreat
                 mSelectedInstance = {};
             }
 
-            tg::vec4 unpackedColor = unpackSaturatedFloat4(inst.albedoBias);
+            tg::vec4 unpackedColor = unpackSaturatedFloat4(inst.render.albedoBias);
             if (ImGui::ColorEdit4("Color Bias", tg::data_ptr(unpackedColor), ImGuiColorEditFlags_AlphaBar | ImGuiColorEditFlags_AlphaPreview))
             {
-                inst.albedoBias = packSaturatedFloat4(unpackedColor);
+                inst.render.albedoBias = packSaturatedFloat4(unpackedColor);
             }
 
             ImGui::TextUnformatted("Animation");
 
-            if (ImGui::RadioButton("None##Anim", inst.anim == gamedev::Instance::AnimationType::None))
-                inst.anim = gamedev::Instance::AnimationType::None;
+            if (ImGui::RadioButton("None##Anim", inst.meta.anim == gamedev::Instance::AnimationType::None))
+                inst.meta.anim = gamedev::Instance::AnimationType::None;
 
             ImGui::SameLine();
 
-            if (ImGui::RadioButton("Spin##Anim", inst.anim == gamedev::Instance::AnimationType::Spin))
-                inst.anim = gamedev::Instance::AnimationType::Spin;
+            if (ImGui::RadioButton("Spin##Anim", inst.meta.anim == gamedev::Instance::AnimationType::Spin))
+                inst.meta.anim = gamedev::Instance::AnimationType::Spin;
 
             ImGui::SameLine();
 
-            if (ImGui::RadioButton("Bounce##Anim", inst.anim == gamedev::Instance::AnimationType::Bounce))
+            if (ImGui::RadioButton("Bounce##Anim", inst.meta.anim == gamedev::Instance::AnimationType::Bounce))
             {
-                if (inst.anim != gamedev::Instance::AnimationType::Bounce)
+                if (inst.meta.anim != gamedev::Instance::AnimationType::Bounce)
                 {
-                    inst.anim = gamedev::Instance::AnimationType::Bounce;
-                    inst.animBaseY = inst.xform.translation.y;
+                    inst.meta.anim = gamedev::Instance::AnimationType::Bounce;
+                    inst.meta.animBaseY = inst.xform.translation.y;
                 }
             }
 
             ImGui::SameLine();
 
-            if (ImGui::RadioButton("Travel##Anim", inst.anim == gamedev::Instance::AnimationType::SinusTravel))
-                inst.anim = gamedev::Instance::AnimationType::SinusTravel;
+            if (ImGui::RadioButton("Travel##Anim", inst.meta.anim == gamedev::Instance::AnimationType::SinusTravel))
+                inst.meta.anim = gamedev::Instance::AnimationType::SinusTravel;
 
-            ImGui::SliderFloat("Animation Speed", &inst.animSpeed, 0.f, 50.f);
-            ImGui::SliderFloat("Animation Base Y", &inst.animBaseY, -50.f, 50.f);
+            ImGui::SliderFloat("Animation Speed", &inst.meta.animSpeed, 0.f, 50.f);
+            ImGui::SliderFloat("Animation Base Y", &inst.meta.animBaseY, -50.f, 50.f);
         }
         else
         {
@@ -299,27 +303,33 @@ void gamedev::AdvancedFeatures::updateAnimationsInWorld(float dt, float currentT
 {
     using AnimType = gamedev::Instance::AnimationType;
 
-    for (auto& instance : mWorld.getLiveInstancesSpan())
+    auto const metas = mWorld.getLiveMetas();
+    auto const transforms = mWorld.getLiveTransforms();
+
+    for (auto i = 0u; i < metas.size(); ++i)
     {
-        switch (instance.anim)
+        auto const& meta = metas[i];
+        auto& xform = transforms[i];
+
+        switch (meta.anim)
         {
         case AnimType::Spin:
         {
-            auto const rotation = tg::quat::from_axis_angle({0, 1, 0}, tg::degree(90.f * dt * instance.animSpeed));
-            instance.xform.rotate(rotation);
+            auto const rotation = tg::quat::from_axis_angle({0, 1, 0}, tg::degree(90.f * dt * meta.animSpeed));
+            xform.rotate(rotation);
         }
         break;
         case AnimType::Bounce:
         {
-            auto const val = tg::sin(100_deg * currentTime * instance.animSpeed) * .5f;
-            instance.xform.translation.y = instance.animBaseY + val;
+            auto const val = tg::sin(100_deg * currentTime * meta.animSpeed) * .5f;
+            xform.translation.y = meta.animBaseY + val;
         }
         break;
         case AnimType::SinusTravel:
         {
             auto const angle = 90_deg * currentTime;
-            instance.xform.translation.x += tg::sin(angle) * dt * instance.animSpeed;
-            instance.xform.translation.z += tg::cos(angle) * dt * instance.animSpeed;
+            xform.translation.x += tg::sin(angle) * dt * meta.animSpeed;
+            xform.translation.z += tg::cos(angle) * dt * meta.animSpeed;
         }
         break;
         default:
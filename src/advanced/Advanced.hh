@@ -16,6 +16,8 @@ struct AdvancedFeatures
     float* mStatFrametime = nullptr;
     float* mStatNumUpdates = nullptr;
     float* mStatNumDraws = nullptr;
+    float* mStatAwakeBodies = nullptr;
+    float* mStatSleepingBodies = nullptr;
 
     gamedev::World mWorld;
     std::shared_ptr<gamedev::EngineECS> mECS;
@@ -24,16 +26,18 @@ struct AdvancedFeatures
     gamedev::InstanceHandle mSelectedInstance;
     gamedev::EditorState mEditorState;
 
-    void initialize()
+    void initialize(uint32_t maxNumInstances)
     {
         // stat setup - track various metrics as your game runs
         mStats = gamedev::initializeStatistics(100, 256);
         mStatFrametime = gamedev::getStat(mStats, "frametime", gamedev::StatType::timing);     // time spent per frame in milliseconds
         mStatNumUpdates = gamedev::getStat(mStats, "num_updates", gamedev::StatType::counter); // amount of update() ticks per frame
         mStatNumDraws = gamedev::getStat(mStats, "num_drawcalls", gamedev::StatType::counter); // amount of drawcalls per frame
+        mStatAwakeBodies = gamedev::getStat(mStats, "num_awake_bodies", gamedev::StatType::counter);       // physics bodies outside of towers which are simulated
+        mStatSleepingBodies = gamedev::getStat(mStats, "num_sleeping_bodies", gamedev::StatType::counter); // physics bodies skipped until they are moved
 
         // initialize world
-        mWorld.initialize(2048);
+        mWorld.initialize(maxNumInstances);
     }
 
     void setECS(std::shared_ptr<gamedev::EngineECS> ecs);
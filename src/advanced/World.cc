@@ -8,26 +8,21 @@ gamedev::InstanceHandle gamedev::World::createInstance(glow::SharedVertexArray c
                                                        glow::SharedTexture2D const& arm)
 {
     auto const res = mCPoolInstances.acquire();
+    auto const index = mCPoolInstances.get_handle_index(res);
 
-    auto& newNode = mCPoolInstances.get(res);
-    newNode.vao = vao;
-    newNode.texAlbedo = albedo;
-    newNode.texNormal = normal;
-    newNode.texARM = arm;
-    newNode.albedoBias = 0u;
+    auto& meta = mCPoolInstances.get(res);
+    meta = {};
+    meta.mHandle = {res};
 
-    newNode.xform = {};
-    newNode.anim = Instance::AnimationType::None;
-    newNode.animSpeed = 1.f;
-    newNode.animBaseY = 0.f;
+    auto& render = mRenders[index];
+    render.vao = vao;
+    render.texAlbedo = albedo;
+    render.texNormal = normal;
+    render.texARM = arm;
+    render.albedoBias = 0u;
 
-    newNode.mHandle = {res};
-
-    newNode.max_bounds = {tg::pos3::zero, tg::pos3::zero};
-    newNode.facing = tg::dir3::pos_z;
-    newNode.new_position = true;
-
-    newNode.destroy = false;
+    mTransforms[index] = {};
+    mBounds[index] = {tg::pos3::zero, tg::pos3::zero};
 
     return {res};
 }
@@ -36,23 +31,60 @@ void gamedev::World::destroyInstance(InstanceHandle handle)
 {
     CC_ASSERT(handle.is_valid());
 
-    mCPoolInstances.release(handle._value);
+    auto const index = mCPoolInstances.get_handle_index(handle._value);
+
+    // The pool moves its last element into the freed spot, the other streams follow
+    if (mCPoolInstances.release(handle._value))
+    {
+        auto const last = mCPoolInstances.size();
+
+        mTransforms[index] = mTransforms[last];
+        mBounds[index] = mBounds[last];
+        mRenders[index] = std::move(mRenders[last]);
+        mRenders[last] = {};
+    }
+    else
+    {
+        mRenders[index] = {};
+    }
+}
+
+void gamedev::World::destroyAllInstances()
+{
+    for (auto& render : getLiveRenders())
+        render = {};
+
+    mCPoolInstances.release_all();
 }
 
-void gamedev::World::initialize(uint32_t maxNumInstances) { mCPoolInstances.initialize(maxNumInstances, cc::system_allocator); }
+void gamedev::World::initialize(uint32_t maxNumInstances)
+{
+    mCPoolInstances.initialize(maxNumInstances, cc::system_allocator);
+
+    mTransforms.resize(maxNumInstances);
+    mBounds.resize(maxNumInstances);
+    mRenders.resize(maxNumInstances);
+}
 
-void gamedev::World::destroy() { mCPoolInstances.destroy(); }
+void gamedev::World::destroy()
+{
+    mCPoolInstances.destroy();
+
+    mTransforms = {};
+    mBounds = {};
+    mRenders = {};
+}
 
 void gamedev::World::SetSignature(InstanceHandle handle, Signature signature)
 {
     assert(isLiveHandle(handle) && "Entity not valid.");
 
-    getInstance(handle).mSignature = signature;
+    getInstanceMeta(handle).mSignature = signature;
 }
 
 Signature gamedev::World::GetSignature(InstanceHandle handle)
 {
     assert(isLiveHandle(handle) && "Entity not valid.");
 
-    return getInstance(handle).mSignature;
+    return getInstanceMeta(handle).mSignature;
 }
\ No newline at end of file
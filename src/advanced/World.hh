@@ -9,6 +9,7 @@
 namespace gamedev
 {
 GLOW_SHARED(class, Instance);
+struct InstanceMeta;
 
 // refers to an instance
 struct InstanceHandle
@@ -17,6 +18,10 @@ struct InstanceHandle
 
     bool is_valid() const { return _value != uint32_t(-1); }
 
+    // Slot index inside the instance pool (the upper bits hold the generation).
+    // Two live handles never share an index, so it can be used to address flat arrays.
+    uint32_t index() const { return compact_pool<InstanceMeta>::handle_index(_value); }
+
     // Comparison
     bool operator==(const InstanceHandle& handle) const { return _value == handle._value; }
     bool operator<(const InstanceHandle& handle) const { return _value < handle._value; }
@@ -26,7 +31,17 @@ struct InstanceHandle
 // a single "instance" in the world
 // think about what state varies between your renderables
 // maybe you want differing shaders? - make them part of your renderable
-struct Instance
+//
+// The World stores the parts of an instance in separate dense streams (all indexed alike),
+// so a system only touches the bytes it needs:
+//    - transform:        World::getInstanceTransform()   (physics, animation, collision, ...)
+//    - bounds:           World::getInstanceBounds()      (spatial queries, collision)
+//    - InstanceRender:   World::getInstanceRender()      (rendering)
+//    - InstanceMeta:     World::getInstanceMeta()        (cold data: signature, handle, animation, ...)
+// World::getInstance() bundles references to all parts (InstanceRef), Instance is a full copy (e.g. for prefabs).
+
+// mesh & material of an instance
+struct InstanceRender
 {
     // main mesh
     glow::SharedVertexArray vao;
@@ -35,18 +50,16 @@ struct Instance
     glow::SharedTexture2D texAlbedo;
     glow::SharedTexture2D texNormal;
     glow::SharedTexture2D texARM; // Ambient Occlusion + Roughness + Metallic packed into R/G/B
-    uint32_t albedoBias;          // packed RGBA color added to albedo
-
-    // main transform
-    transform xform;
-    tg::aabb3 max_bounds;
-    tg::dir3 facing;
-    bool new_position;    // Indicates the spatial hash map to refresh this instance
+    uint32_t albedoBias = 0u;     // packed RGBA color added to albedo
 
     // Auxiliary Models (not the best approach, but keeps initial structure)
     // Note: When rendering, all auxiliary models will reference the base entities transform. No inter-auxiliary-reference possible atm.
     std::vector<AuxiliaryModel> auxModels;
+};
 
+// rarely accessed data of an instance
+struct InstanceMeta
+{
     // animation info
     // for a more elaborate game, you might want separate places to store logic like this
     // ideally your render world is as separate from gameplay/logic as possible - but this is a quick way to do it
@@ -58,14 +71,36 @@ struct Instance
         Bounce
     };
 
-    AnimationType anim;
-    float animSpeed;
-    float animBaseY;
+    tg::dir3 facing = tg::dir3::pos_z;
+
+    AnimationType anim = AnimationType::None;
+    float animSpeed = 1.f;
+    float animBaseY = 0.f;
 
     Signature mSignature;
     InstanceHandle mHandle;
+};
 
-    bool destroy;
+// full copy of an instance
+struct Instance
+{
+    using AnimationType = InstanceMeta::AnimationType;
+
+    transform xform;
+    tg::aabb3 max_bounds = {tg::pos3::zero, tg::pos3::zero};
+    InstanceRender render;
+    InstanceMeta meta;
+};
+
+// references to the parts of a live instance, only valid until the next instance is destroyed
+struct InstanceRef
+{
+    transform& xform;
+    tg::aabb3& max_bounds;
+    InstanceRender& render;
+    InstanceMeta& meta;
+
+    Instance Copy() const { return {xform, max_bounds, render, meta}; }
 };
 
 class World
@@ -76,29 +111,33 @@ public:
                                                 glow::SharedTexture2D const& normal,
                                                 glow::SharedTexture2D const& arm);
 
-    Instance& getInstance(InstanceHandle handle) { return mCPoolInstances.get(handle._value); }
+    InstanceRef getInstance(InstanceHandle handle) { return getNthInstance(uint32_t(mCPoolInstances.get_handle_index(handle._value))); }
 
-    transform& getInstanceTransform(InstanceHandle handle) { return mCPoolInstances.get(handle._value).xform; }
+    transform& getInstanceTransform(InstanceHandle handle) { return mTransforms[mCPoolInstances.get_handle_index(handle._value)]; }
+    tg::aabb3& getInstanceBounds(InstanceHandle handle) { return mBounds[mCPoolInstances.get_handle_index(handle._value)]; }
+    InstanceRender& getInstanceRender(InstanceHandle handle) { return mRenders[mCPoolInstances.get_handle_index(handle._value)]; }
+    InstanceMeta& getInstanceMeta(InstanceHandle handle) { return mCPoolInstances.get(handle._value); }
 
     void destroyInstance(InstanceHandle handle);
 
-    void destroyAllInstances() { mCPoolInstances.release_all(); }
+    void destroyAllInstances();
 
     // returns true if the given handle is valid and refers to a live instance
+    // (a single generation compare, so handles can be kept as weak references, e.g. attack targets)
     bool isLiveHandle(InstanceHandle handle) const { return mCPoolInstances.is_alive(handle._value); }
 
-    // access all live instances as a single contigous array
+    // access all live instances as contigous arrays (one per stream, the nth elements belong to the same instance)
     uint32_t getNumLiveInstances() const { return mCPoolInstances.get_span().size(); }
-    Instance const* getLiveInstances() const { return mCPoolInstances.get_span().data(); }
 
-    // array view for the above
-    cc::span<Instance const> getLiveInstancesSpan() const { return mCPoolInstances.get_span(); }
-    cc::span<Instance> getLiveInstancesSpan() { return mCPoolInstances.get_span(); }
+    cc::span<transform> getLiveTransforms() { return {mTransforms.data(), mCPoolInstances.size()}; }
+    cc::span<tg::aabb3> getLiveBounds() { return {mBounds.data(), mCPoolInstances.size()}; }
+    cc::span<InstanceRender> getLiveRenders() { return {mRenders.data(), mCPoolInstances.size()}; }
+    cc::span<InstanceMeta> getLiveMetas() { return mCPoolInstances.get_span(); }
 
     uint32_t getMaxNumInstances() const { return uint32_t(mCPoolInstances.max_size()); }
 
     InstanceHandle getNthInstanceHandle(uint32_t i) const { return {mCPoolInstances.get_nth_handle(i)}; }
-    Instance const& getNthInstance(uint32_t i) const { return getLiveInstancesSpan()[i]; }
+    InstanceRef getNthInstance(uint32_t i) { return {mTransforms[i], mBounds[i], mRenders[i], mCPoolInstances.data()[i]}; }
 
     // ECS integration
     // ---------------
@@ -112,7 +151,12 @@ public:
     void destroy();
 
 private:
-    compact_pool<Instance> mCPoolInstances;
+    // handles & InstanceMeta, the other streams follow the compact order of this pool
+    compact_pool<InstanceMeta> mCPoolInstances;
+
+    std::vector<transform> mTransforms;
+    std::vector<tg::aabb3> mBounds;
+    std::vector<InstanceRender> mRenders;
 };
 
 class InstanceHandleHash
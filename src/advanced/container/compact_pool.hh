@@ -4,20 +4,40 @@
 // ist ziemlich nuetzlich um eine simple render world zu basteln und waere
 // etwas umstandlich zu porten
 #include <clean-core/alloc_array.hh>
-#include <clean-core/atomic_linked_pool.hh>
+#include <clean-core/assert.hh>
+#include <clean-core/span.hh>
 #include <clean-core/storage.hh>
 #include <clean-core/utility.hh>
 
+#include <cstdint>
+
 namespace gamedev
 {
 // O(1) acquire, release, access
 // memory contiguous
 // access via handles is double indirected
+//
+// handles are 32 bit: [ generation (12 bit) | slot index (20 bit) ]
+// the generation of a slot is bumped on release, so stale handles are detected by a single compare
+// a slot whose generation would wrap around is retired instead of reused, so a stale handle can never alias a new value
+// released slots are reused first-in first-out, which spreads the generations over all slots (and delays retiring)
+// (the clean-core linked pool only has 16 index bits, which caps the world at 65535 instances)
 template <class T>
 struct compact_pool
 {
 public:
-    using handle_t = cc::atomic_linked_pool<size_t>::handle_t;
+    using handle_t = uint32_t;
+
+    static constexpr uint32_t num_index_bits = 20;
+    static constexpr uint32_t index_mask = (1u << num_index_bits) - 1;
+    static constexpr uint32_t generation_mask = (1u << (32 - num_index_bits)) - 1;
+    static constexpr uint32_t retired_generation = generation_mask;
+
+    // the all-ones handle is reserved as "invalid", so the last slot index is never handed out
+    static constexpr size_t max_capacity = index_mask;
+
+    static constexpr uint32_t handle_index(handle_t handle) { return handle & index_mask; }
+    static constexpr uint32_t handle_generation(handle_t handle) { return handle >> num_index_bits; }
 
     compact_pool() = default;
     explicit compact_pool(size_t size, cc::allocator* alloc = cc::system_allocator) { initialize(size, alloc); }
@@ -35,9 +55,13 @@ public:
             return;
 
         CC_ASSERT(_compact_values.size() == 0 && "double init");
-        _sparse_indices.initialize(size, alloc);
+        CC_ASSERT(size <= max_capacity && "pool too large for the handle layout");
+
         _compact_values = _compact_values.uninitialized(size, alloc);
         _compact_pool_handles = _compact_pool_handles.uninitialized(size, alloc);
+        _slot_compact_indices = _slot_compact_indices.uninitialized(size, alloc);
+        _slot_generations = _slot_generations.filled(size, 0u, alloc);
+        _reset_free_list();
     }
 
     void destroy() { _destroy(); }
@@ -47,12 +71,15 @@ public:
     {
         CC_ASSERT(!is_full() && "overcommited");
         // acquire
-        auto const pool_handle = _sparse_indices.acquire();
+        uint32_t const slot = _free_head;
+        _free_head = _slot_compact_indices[slot];
+
+        auto const pool_handle = _make_handle(slot);
         auto const compact_idx = _compact_head;
         ++_compact_head;
 
         // write cross-reference indices
-        _sparse_indices.get(pool_handle) = compact_idx;
+        _slot_compact_indices[slot] = uint32_t(compact_idx);
         _compact_pool_handles[compact_idx] = pool_handle;
 
         // ctor
@@ -66,10 +93,13 @@ public:
     bool release(handle_t handle)
     {
         CC_ASSERT(!is_empty() && "already empty");
+        CC_ASSERT(is_alive(handle) && "releasing stale handle");
 
-        // release pool
-        size_t const compact_idx = _sparse_indices.get(handle);
-        _sparse_indices.release(handle);
+        // release slot, bumping the generation invalidates all outstanding handles
+        uint32_t const slot = handle_index(handle);
+        size_t const compact_idx = _slot_compact_indices[slot];
+        if (_bump_generation(slot))
+            _push_free_slot(slot);
 
         // dtor
         if constexpr (!std::is_trivially_destructible_v<T>)
@@ -84,13 +114,14 @@ public:
         }
 
         // move head to this position
-        //_compact_values[compact_idx].value = cc::move(_compact_values[_compact_head].value);
         new (cc::placement_new, &_compact_values[compact_idx].value) T(cc::move(_compact_values[_compact_head].value));
+        if constexpr (!std::is_trivially_destructible_v<T>)
+            _compact_values[_compact_head].value.~T();
         _compact_pool_handles[compact_idx] = _compact_pool_handles[_compact_head];
 
         // update pool entry
-        uint32_t const modified_pool_handle = _compact_pool_handles[compact_idx];
-        _sparse_indices.get(modified_pool_handle) = compact_idx;
+        handle_t const modified_pool_handle = _compact_pool_handles[compact_idx];
+        _slot_compact_indices[handle_index(modified_pool_handle)] = uint32_t(compact_idx);
 
         return true;
     }
@@ -103,14 +134,19 @@ public:
                 val.~T();
             }
 
+        unsigned const num_released = unsigned(_compact_head);
+        for (size_t i = 0; i < _compact_head; ++i)
+            _bump_generation(handle_index(_compact_pool_handles[i]));
+
         _compact_head = 0;
-        return _sparse_indices.release_all();
+        _reset_free_list();
+        return num_released;
     }
 
     /// access a slot
     /// do not maintain direct references, they are invalidated after the next release
-    CC_FORCE_INLINE T& get(handle_t handle) { return _compact_values[_sparse_indices.get(handle)].value; }
-    CC_FORCE_INLINE T const& get(handle_t handle) const { return _compact_values[_sparse_indices.get(handle)].value; }
+    CC_FORCE_INLINE T& get(handle_t handle) { return _compact_values[get_handle_index(handle)].value; }
+    CC_FORCE_INLINE T const& get(handle_t handle) const { return _compact_values[get_handle_index(handle)].value; }
 
     CC_FORCE_INLINE T* data() { return reinterpret_cast<T*>(_compact_values.data()); }
     CC_FORCE_INLINE T const* data() const { return reinterpret_cast<T const*>(_compact_values.data()); }
@@ -120,21 +156,65 @@ public:
 
     size_t max_size() const { return _compact_values.size(); }
 
-    bool is_full() const { return size() == max_size(); }
+    // retired slots are never handed out again, so the pool can be full before size() reaches max_size()
+    bool is_full() const { return _free_head >= _slot_compact_indices.size(); }
     bool is_empty() const { return _compact_head == 0; }
 
-    bool is_alive(handle_t handle) const { return handle != unsigned(-1) && _sparse_indices.is_alive(handle); }
+    // free slots always carry a generation newer than any handle issued for them, so the generation compare suffices
+    bool is_alive(handle_t handle) const
+    {
+        uint32_t const slot = handle_index(handle);
+        return slot < _slot_generations.size() && _slot_generations[slot] == handle_generation(handle);
+    }
 
     /// iterate allocated slots
     /// for (auto const& val : pool.get_span()) { ... }
     CC_FORCE_INLINE cc::span<T> get_span() { return {data(), size()}; }
     CC_FORCE_INLINE cc::span<T const> get_span() const { return {data(), size()}; }
 
-    CC_FORCE_INLINE size_t get_handle_index(handle_t handle) const { return _sparse_indices.get(handle); }
+    CC_FORCE_INLINE size_t get_handle_index(handle_t handle) const
+    {
+        CC_ASSERT(is_alive(handle) && "accessing stale handle");
+        return _slot_compact_indices[handle_index(handle)];
+    }
     CC_FORCE_INLINE size_t get_index_head() const { return _compact_head; }
     CC_FORCE_INLINE handle_t get_nth_handle(unsigned index) const { return _compact_pool_handles[index]; }
 
 private:
+    handle_t _make_handle(uint32_t slot) const { return (_slot_generations[slot] << num_index_bits) | slot; }
+
+    // returns false if the slot is retired (its generation is used up)
+    bool _bump_generation(uint32_t slot)
+    {
+        _slot_generations[slot] = _slot_generations[slot] + 1;
+        return _slot_generations[slot] != retired_generation;
+    }
+
+    // free slots are chained through _slot_compact_indices, terminated by the slot count
+    void _push_free_slot(uint32_t slot)
+    {
+        uint32_t const end = uint32_t(_slot_compact_indices.size());
+        _slot_compact_indices[slot] = end;
+
+        if (_free_head == end)
+            _free_head = slot;
+        else
+            _slot_compact_indices[_free_tail] = slot;
+
+        _free_tail = slot;
+    }
+
+    void _reset_free_list()
+    {
+        _free_head = uint32_t(_slot_compact_indices.size());
+
+        for (uint32_t i = 0; i < _slot_compact_indices.size(); ++i)
+        {
+            if (_slot_generations[i] != retired_generation)
+                _push_free_slot(i);
+        }
+    }
+
     void _destroy()
     {
         if (max_size() == 0)
@@ -146,18 +226,27 @@ private:
                 val.~T();
             }
 
-        _sparse_indices.destroy();
         _compact_values = {};
         _compact_pool_handles = {};
+        _slot_compact_indices = {};
+        _slot_generations = {};
         _compact_head = 0;
+        _free_head = 0;
+        _free_tail = 0;
     }
 
 
 private:
-    cc::atomic_linked_pool<size_t, true> _sparse_indices;
     cc::alloc_array<cc::storage_for<T>> _compact_values;
     cc::alloc_array<handle_t> _compact_pool_handles;
+
+    // per slot: compact index while alive, next free slot while free
+    cc::alloc_array<uint32_t> _slot_compact_indices;
+    cc::alloc_array<uint32_t> _slot_generations;
+
     size_t _compact_head = 0;
+    uint32_t _free_head = 0;
+    uint32_t _free_tail = 0;
 };
 
 }
@@ -5,8 +5,6 @@ namespace gamedev
 {
 struct Animated : Component
 {
-    using Component::Component; // Use constructor of component
-
     bool rotXAnim = false;
     tg::angle rot_x = 0_deg;
     bool rotYAnim = false;
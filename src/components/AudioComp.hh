@@ -7,8 +7,6 @@ namespace gamedev
 {
 struct SoundEmitter : public Component
 {
-    using Component::Component;
-
     Sound* sound = NULL;
     OALSource* oalSource = NULL;
     SoundPriority priority = low;
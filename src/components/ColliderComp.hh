@@ -5,8 +5,6 @@ namespace gamedev
 {
 struct Collider : public Component
 {
-    using Component::Component;
-
     bool dynamic = false;
 };
 }
\ No newline at end of file
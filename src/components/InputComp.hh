@@ -5,8 +5,6 @@ namespace gamedev
 {
 struct Input : public Component
 {
-    using Component::Component;
-
     tg::pos3 targetMove = tg::pos3(0.f, 0.f, 0.f);
     tg::vec3 targetLook = tg::vec3(1.f, 0.f, 0.f);
     tg::vec3 currentLook = targetLook;
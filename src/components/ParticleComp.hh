@@ -1,5 +1,4 @@
 #pragma once
-#include <vector>
 #include "components/Component.hh"
 #include "types/Particle.hh"
 
@@ -7,8 +6,8 @@ namespace gamedev
 {
 struct ParticleEmitter : Component
 {
-    using Component::Component;
-
-    std::vector<ParticleProperties> pp;
+    static constexpr int MaxProperties = 4;
+    ParticleProperties pp[MaxProperties];
+    int numProperties = 0; // used entries of pp
 };
 }
\ No newline at end of file
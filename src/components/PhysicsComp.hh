@@ -13,8 +13,6 @@ struct arcEq
 
 struct Physics : Component
 {
-    using Component::Component; // Use constructor of component
-
     tg::vec3 velocity = tg::vec3::zero;
     tg::vec3 lastPosition = tg::vec3::zero;
 
@@ -27,5 +25,9 @@ struct Physics : Component
     float arc_yMax = 0;
     float arc_yBase = 0;
     float arc_ySlope = 0;
+
+    // Sleeping: no velocity & not moved by anyone since the last step, for PhysicsSystem::SleepSteps steps
+    uint16_t idleSteps = 0;
+    tg::vec3 restPosition = tg::vec3::zero; // at the end of the last step
 };
 }
\ No newline at end of file
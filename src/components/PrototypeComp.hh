@@ -4,8 +4,8 @@
 namespace gamedev
 {
 // Just a flag to prevent any system from using this instance
+// (factory presets while they are authored, until they are baked into prefabs, or disabled instances)
 struct Prototype : public Component
 {
-    using Component::Component;
 };
 }
\ No newline at end of file
@@ -6,9 +6,6 @@ namespace gamedev
 // Marks object to be rendered by the Rendering System
 struct Render : Component
 {
-    using Component::Component;
-    
-    transform* inheritTransform = nullptr;
     bool selectable = false;
     bool targetable = false;
 };
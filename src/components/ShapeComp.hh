@@ -8,15 +8,11 @@ namespace gamedev
 // Oriented Bounding Box or Bounding Circle
 struct BoxShape : public Component
 {
-    using Component::Component;
-
     tg::box3 box;
 };
 
 struct CircleShape : public Component
 {
-    using Component::Component;
-
     tg::sphere3 circle;
 };
 }
\ No newline at end of file
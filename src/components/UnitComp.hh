@@ -6,15 +6,14 @@ namespace gamedev
 {
 struct Living : public Component
 {
-    using Component::Component;
-
     int idle = 0;
 
     // Friendly stuff
-    bool friendly;
+    bool friendly = false;
 
     // Common stuff
-    std::string name;
+    static constexpr int MaxName = 16;
+    char name[MaxName] = ""; // stored inline, so prefabs can be saved to disk
 
     bool moveOrder = false;
     tg::pos3 movePosition= tg::pos3::zero;
@@ -27,16 +26,12 @@ struct Living : public Component
 
 struct Dweller : public Component
 {
-    using Component::Component;
-
     InstanceHandle home = {std::uint32_t(-1)};
     bool hasHome = false;
 };
 
 struct Attacker : public Component
 {
-    using Component::Component;
-
     int idle = 0;
 
     bool forceAttack = false;
@@ -52,23 +47,17 @@ struct Attacker : public Component
 
 struct Mortal : public Component
 {
-    using Component::Component;
-
     Hitpoints health = {1, 1};
     float armor = 0.0;  // damage deflection in percent (range: [0, 1])
 };
 
 struct Destructible : public Component
 {
-    using Component::Component;
-
     Hitpoints health = {1, 1};
 };
 
 struct Producer : public Component
 {
-    using Component::Component;
-
     int idle = 0;
 
     float income = 0.5;
@@ -79,8 +68,6 @@ struct Producer : public Component
 
 struct Climber : public Component
 {
-    using Component::Component;
-
     float speed = 1.0;
     bool elevated = false;
 
@@ -89,33 +76,30 @@ struct Climber : public Component
 
 struct Arrow : public Component
 {
-    using Component::Component;
-
     float damage = 1.0;
     float lifetime = 4.0;
     float velocity = 0.0;
     tg::angle32 angle = 0_deg;
     InstanceHandle shotBy = {std::uint32_t(-1)};
     InstanceHandle target = {std::uint32_t(-1)};
+    tg::pos3 lastPosition;     // of the last hit test, the arrow is swept from there
+    bool hasLastPosition = false;
 };
 
 struct InTower : public Component
 {
-    using Component::Component;
 };
 
 struct Tower : public Component
 {
-    using Component::Component;
-
     tg::pos3 position;
 };
 
 struct ForeignControl : public Component
 {
-    using Component::Component;
-
-    std::vector<tg::pos3> waypoints;
+    static constexpr int MaxWaypoints = 16;
+    tg::pos3 waypoints[MaxWaypoints];
+    int numWaypoints = 0; // used entries of waypoints
     tg::pos3 currentTarget = tg::pos3::zero;
     int currentIndex = 0;
 };
@@ -0,0 +1,732 @@
+#pragma once
+#include "ecs/ComponentTypeInfo.hh"
+#include "ecs/TypeId.hh"
+#include "ecs/View.hh"
+#include "advanced/World.hh"
+#include "components/Component.hh"
+#include "glow/common/log.hh"
+#include "Constants.hh"
+#include <clean-core/span.hh>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include <assert.h>
+
+namespace gamedev
+{
+/***
+* Archetype storage backend (alternative to the sparse-set ComponentManager).
+* Enabled by configuring with -DGAMEDEV_ARCHETYPE_STORAGE=ON, see Engine.hh.
+*
+* All instances with the exact same Signature share an Archetype.
+* An Archetype stores its rows in chunks of ARCHETYPE_CHUNK_BYTES, inside a chunk every component type
+* is a separate tightly packed column (SoA). A view walks the matching archetypes chunk by chunk,
+* so the components it touches are read linearly without any per-instance lookups.
+*
+* Adding or removing components moves the instance to another archetype.
+* To keep component pointers valid while an instance is assembled (factories create several components in a row),
+* structural changes are staged per instance and applied by Flush():
+*    - Staged components live in separate allocations and are returned by Get/TryGet right away.
+*    - Flush() runs when a view is created outside of any view iteration, or when called explicitly.
+*    - Views only see the flushed state, staged removals are already honored.
+* Destroying an instance is applied immediately.
+*
+* Pointers returned by Get/TryGet stay valid until the next Flush() or the next destruction of any instance
+* that shares the archetype (the sparse-set backend has the same restriction for removals).
+*
+***/
+
+class Archetype
+{
+public:
+    Archetype(Signature signature, const std::array<ComponentTypeInfo, MAX_COMPONENTS>& infos) : mSignature(signature), mInfos(infos)
+    {
+        mColumnOf.fill(-1);
+
+        size_t rowBytes = 0;
+        size_t maxAlign = alignof(InstanceHandle);
+        for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+        {
+            if (!signature.test(type))
+                continue;
+
+            mColumnOf[type] = int(mColumns.size());
+            mColumns.push_back({ComponentType(type), 0, infos[type].size});
+            rowBytes += infos[type].size;
+            maxAlign = std::max(maxAlign, infos[type].align);
+        }
+
+        // Worst case padding per column is (align - 1)
+        mRowsPerChunk = uint32_t(std::max<size_t>(1, ARCHETYPE_CHUNK_BYTES / std::max<size_t>(1, rowBytes + maxAlign)));
+
+        size_t offset = 0;
+        for (auto& column : mColumns)
+        {
+            auto const align = infos[column.type].align;
+            offset = (offset + align - 1) / align * align;
+            column.offset = offset;
+            offset += column.size * mRowsPerChunk;
+        }
+        mChunkBytes = std::max<size_t>(offset, 1);
+    }
+
+    ~Archetype() { Clear(); }
+
+    Archetype(Archetype const&) = delete;
+    Archetype& operator=(Archetype const&) = delete;
+
+    Signature GetSignature() const { return mSignature; }
+    bool Has(ComponentType type) const { return mColumnOf[type] >= 0; }
+
+    uint32_t Size() const { return uint32_t(mHandles.size()); }
+    uint32_t RowsPerChunk() const { return mRowsPerChunk; }
+    uint32_t NumChunks() const { return uint32_t(mChunks.size()); }
+
+    InstanceHandle HandleAt(uint32_t row) const { return mHandles[row]; }
+
+    void* Get(ComponentType type, uint32_t row)
+    {
+        auto const& column = mColumns[mColumnOf[type]];
+        return mChunks[row / mRowsPerChunk].get() + column.offset + (row % mRowsPerChunk) * column.size;
+    }
+
+    // First element of a column inside a chunk.
+    template <typename CompT>
+    CompT* Column(ComponentType type, uint32_t chunk)
+    {
+        return reinterpret_cast<CompT*>(mChunks[chunk].get() + mColumns[mColumnOf[type]].offset);
+    }
+
+    // Reserves a row for the instance, the caller constructs all components of the row.
+    uint32_t AppendRow(InstanceHandle handle)
+    {
+        uint32_t const row = Size();
+        if (row == mChunks.size() * mRowsPerChunk)
+            mChunks.emplace_back(static_cast<std::byte*>(::operator new(mChunkBytes, std::align_val_t(ChunkAlignment))));
+
+        mHandles.push_back(handle);
+        return row;
+    }
+
+    // Destroys all components of the row & moves the last row into its place.
+    // Returns the handle of the moved instance, or an invalid handle if no move happened.
+    InstanceHandle RemoveRow(uint32_t row)
+    {
+        for (auto const& column : mColumns)
+            mInfos[column.type].Destroy(Get(column.type, row));
+
+        uint32_t const last = Size() - 1;
+        InstanceHandle moved;
+
+        if (row != last)
+        {
+            for (auto const& column : mColumns)
+            {
+                void* lastPtr = Get(column.type, last);
+                mInfos[column.type].Move(Get(column.type, row), lastPtr);
+                mInfos[column.type].Destroy(lastPtr);
+            }
+
+            mHandles[row] = mHandles[last];
+            moved = mHandles[row];
+        }
+
+        mHandles.pop_back();
+        return moved;
+    }
+
+    void Clear()
+    {
+        for (uint32_t row = 0; row < Size(); ++row)
+            for (auto const& column : mColumns)
+                mInfos[column.type].Destroy(Get(column.type, row));
+
+        mHandles.clear();
+    }
+
+private:
+    static constexpr size_t ChunkAlignment = 64;
+
+    struct ChunkDeleter
+    {
+        void operator()(std::byte* ptr) const { ::operator delete(ptr, std::align_val_t(ChunkAlignment)); }
+    };
+
+    struct ColumnLayout
+    {
+        ComponentType type;
+        size_t offset;
+        size_t size;
+    };
+
+    Signature mSignature;
+    const std::array<ComponentTypeInfo, MAX_COMPONENTS>& mInfos;
+
+    std::array<int, MAX_COMPONENTS> mColumnOf;
+    std::vector<ColumnLayout> mColumns;
+
+    uint32_t mRowsPerChunk = 1;
+    size_t mChunkBytes = 1;
+
+    std::vector<std::unique_ptr<std::byte, ChunkDeleter>> mChunks;
+    std::vector<InstanceHandle> mHandles;
+};
+
+class ArchetypeComponentManager;
+
+template <typename Include, typename Excl>
+class ArchetypeView;
+
+template <typename... Ts, typename... Xs>
+class ArchetypeView<std::tuple<Ts...>, Exclude<Xs...>>
+{
+    static_assert(sizeof...(Ts) > 0, "A view needs at least one component type.");
+
+public:
+    ArchetypeView(ArchetypeComponentManager* manager, std::array<ComponentType, sizeof...(Ts)> types, Signature include, Signature exclude)
+      : mManager(manager), mTypes(types), mInclude(include), mExclude(exclude)
+    {
+    }
+
+    // Calls func(InstanceHandle, Ts&...) for every matching instance.
+    template <typename Func>
+    void each(Func&& func);
+
+private:
+    template <typename Func, size_t... Is>
+    void EachInArchetype(Archetype& archetype, Func& func, std::index_sequence<Is...>);
+
+private:
+    ArchetypeComponentManager* mManager;
+    std::array<ComponentType, sizeof...(Ts)> mTypes;
+    Signature mInclude;
+    Signature mExclude;
+};
+
+class ArchetypeComponentManager
+{
+public:
+    ~ArchetypeComponentManager() { AllEntitiesDestroyed(); }
+
+    // Register the component struct (once) to the manager.
+    template <typename CompT>
+    void RegisterComponent()
+    {
+        auto const type = TypeId<ComponentFamily>::Id<CompT>();
+
+        assert(type < MAX_COMPONENTS && "Too many component types.");
+        assert(!mTypeInfos[type].IsValid() && "Registering component type more than once.");
+
+        mTypeInfos[type] = ComponentTypeInfo::Create<CompT>();
+    }
+
+    // Return the components type id
+    template <typename CompT>
+    ComponentType GetComponentType()
+    {
+        auto const type = TypeId<ComponentFamily>::Id<CompT>();
+
+        assert(type < MAX_COMPONENTS && mTypeInfos[type].IsValid() && "Component not registered before use.");
+
+        return ComponentType(type);
+    }
+
+    // Add a fresh component to an instance
+    template <typename CompT>
+    CompT* CreateComponent(InstanceHandle handle)
+    {
+        CompT Component;
+        Component.handle_value = handle._value;
+
+        return static_cast<CompT*>(Stage(handle, GetComponentType<CompT>(), &Component));
+    }
+
+    // Add a fresh component to an instance
+    template <typename CompT>
+    CompT* TryCreateComponent(InstanceHandle handle)
+    {
+        if (auto existing = TryGetComponent<CompT>(handle))
+        {
+            glow::log() << "Tried to add component to same entity more than once.";
+            return existing;
+        }
+
+        return CreateComponent<CompT>(handle);
+    }
+
+    // Add an existing component to an instance
+    template <typename CompT>
+    void AddComponent(InstanceHandle handle, CompT component)
+    {
+        component.handle_value = handle._value;
+        Stage(handle, GetComponentType<CompT>(), &component);
+    }
+
+    // Remove a component from an instance
+    template <typename CompT>
+    void RemoveComponent(InstanceHandle handle)
+    {
+        assert(Find(handle, GetComponentType<CompT>()) && "Removing non-existent component.");
+        Unstage(handle, GetComponentType<CompT>());
+    }
+
+    template <typename CompT>
+    void TryRemoveComponent(InstanceHandle handle)
+    {
+        Unstage(handle, GetComponentType<CompT>());
+    }
+
+    void RemoveAllComponents(InstanceHandle handle)
+    {
+        for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+            if (mTypeInfos[type].IsValid())
+                Unstage(handle, ComponentType(type));
+    }
+
+    // Get reference to a component from an instance
+    template <typename CompT>
+    CompT* GetComponent(InstanceHandle handle)
+    {
+        auto component = TryGetComponent<CompT>(handle);
+        if (!component)
+        {
+            glow::error() << "Retrieving non-existent component: " << typeid(CompT).name();
+            assert(component);
+        }
+
+        return component;
+    }
+
+    template <typename CompT>
+    CompT* TryGetComponent(InstanceHandle handle)
+    {
+        return static_cast<CompT*>(Find(handle, GetComponentType<CompT>()));
+    }
+
+    // Iterate all instances owning Ts... but none of Xs...
+    // Applies staged structural changes first, unless another view is currently iterating.
+    template <typename... Ts, typename... Xs>
+    ArchetypeView<std::tuple<Ts...>, Exclude<Xs...>> View(Exclude<Xs...> = {})
+    {
+        Flush();
+
+        Signature include;
+        Signature exclude;
+        (include.set(GetComponentType<Ts>()), ...);
+        (exclude.set(GetComponentType<Xs>()), ...);
+
+        return ArchetypeView<std::tuple<Ts...>, Exclude<Xs...>>(this, {GetComponentType<Ts>()...}, include, exclude);
+    }
+
+    // Removes all components of the destroyed instance right away.
+    void EntityDestroyed(InstanceHandle handle)
+    {
+        auto location = FindLocation(handle);
+        if (!location)
+            return;
+
+        ReleaseStaged(*location);
+
+        if (location->archetype)
+            RemoveRow(*location->archetype, location->row);
+
+        *location = {};
+    }
+
+    // Notifies the storage, that all entities have been destroyed.
+    void AllEntitiesDestroyed()
+    {
+        for (auto& location : mLocations)
+            ReleaseStaged(location);
+
+        for (auto& archetype : mArchetypes)
+            archetype->Clear();
+
+        mLocations.clear();
+        mDirty.clear();
+    }
+
+    // Clones all components from the source instance.
+    void CloneEntityComponents(InstanceHandle handle_source, InstanceHandle handle_copy)
+    {
+        for (size_t t = 0; t < MAX_COMPONENTS; ++t)
+        {
+            auto const type = ComponentType(t);
+            void* source = mTypeInfos[type].IsValid() ? Find(handle_source, type) : nullptr;
+            if (!source)
+                continue;
+
+            Unstage(handle_copy, type);
+
+            void* clone = StageCopy(handle_copy, type, source);
+            mTypeInfos[type].asBase(clone)->handle_value = handle_copy._value;
+        }
+    }
+
+    // Pointers to the given component types of the instance (nullptr for types it does not own).
+    ComponentSources GetComponentSources(InstanceHandle handle, Signature types)
+    {
+        ComponentSources sources{};
+        for (size_t t = 0; t < MAX_COMPONENTS; ++t)
+            if (types.test(t) && mTypeInfos[t].IsValid())
+                sources[t] = Find(handle, ComponentType(t));
+
+        return sources;
+    }
+
+    // Copies the given component types from the sources to all instances (fresh instances without components).
+    // The instances are appended to their archetype directly, without staging.
+    void InstantiateComponentsBatch(cc::span<InstanceHandle const> handles, Signature types, ComponentSources const& sources)
+    {
+        for (size_t t = 0; t < MAX_COMPONENTS; ++t)
+            if (!sources[t])
+                types.reset(t);
+
+        if (types.none())
+            return;
+
+        // Rows of an archetype must not be appended while a view walks it
+        if (mIterating > 0)
+        {
+            for (auto handle : handles)
+                for (size_t t = 0; t < MAX_COMPONENTS; ++t)
+                    if (types.test(t))
+                        mTypeInfos[t].asBase(StageCopy(handle, ComponentType(t), sources[t]))->handle_value = handle._value;
+            return;
+        }
+
+        Archetype* target = GetOrCreateArchetype(types);
+
+        for (auto handle : handles)
+        {
+            auto& location = GetOrCreateLocation(handle);
+            assert(!location.archetype && location.staged.empty() && "Instantiated instances must not own components yet.");
+
+            uint32_t const row = target->AppendRow(handle);
+            for (size_t t = 0; t < MAX_COMPONENTS; ++t)
+            {
+                if (!types.test(t))
+                    continue;
+
+                void* copy = target->Get(ComponentType(t), row);
+                mTypeInfos[t].Copy(copy, sources[t]);
+                mTypeInfos[t].asBase(copy)->handle_value = handle._value;
+            }
+
+            location.archetype = target;
+            location.row = row;
+        }
+    }
+
+    // Moves all instances with staged changes into their new archetypes.
+    void Flush()
+    {
+        if (mIterating > 0)
+            return;
+
+        for (auto slot : mDirty)
+        {
+            auto& location = mLocations[slot];
+            if (!location.dirty)
+                continue;
+
+            Migrate(location);
+        }
+
+        mDirty.clear();
+    }
+
+    size_t GetNumArchetypes() const { return mArchetypes.size(); }
+
+private:
+    template <typename Include, typename Excl>
+    friend class ArchetypeView;
+
+    // Tag for the component type ids
+    struct ComponentFamily;
+
+    struct StagedComponent
+    {
+        ComponentType type;
+        void* data;
+    };
+
+    struct Location
+    {
+        InstanceHandle handle;
+        Archetype* archetype = nullptr;
+        uint32_t row = 0;
+
+        bool dirty = false;
+        Signature added;   // staged components, not yet part of the archetype
+        Signature removed; // archetype components staged for removal
+        std::vector<StagedComponent> staged;
+    };
+
+    Location* FindLocation(InstanceHandle handle)
+    {
+        uint32_t const slot = handle.index();
+        if (slot >= mLocations.size() || !(mLocations[slot].handle == handle))
+            return nullptr;
+
+        return &mLocations[slot];
+    }
+
+    Location& GetOrCreateLocation(InstanceHandle handle)
+    {
+        uint32_t const slot = handle.index();
+        if (slot >= mLocations.size())
+            mLocations.resize(slot + 1);
+
+        auto& location = mLocations[slot];
+        if (!(location.handle == handle))
+        {
+            // slot was used by a destroyed instance
+            ReleaseStaged(location);
+            if (location.archetype)
+                RemoveRow(*location.archetype, location.row);
+
+            location = {};
+            location.handle = handle;
+        }
+
+        return location;
+    }
+
+    void MarkDirty(Location& location)
+    {
+        if (location.dirty)
+            return;
+
+        location.dirty = true;
+        mDirty.push_back(location.handle.index());
+    }
+
+    void* Find(InstanceHandle handle, ComponentType type)
+    {
+        auto location = FindLocation(handle);
+        if (!location)
+            return nullptr;
+
+        if (location->added.test(type))
+        {
+            for (auto const& staged : location->staged)
+                if (staged.type == type)
+                    return staged.data;
+        }
+
+        if (location->removed.test(type) || !location->archetype || !location->archetype->Has(type))
+            return nullptr;
+
+        return location->archetype->Get(type, location->row);
+    }
+
+    // Moves the component into a separate allocation until the next flush.
+    void* Stage(InstanceHandle handle, ComponentType type, void* component)
+    {
+        void* data = AllocateStaged(handle, type);
+        mTypeInfos[type].Move(data, component);
+        return data;
+    }
+
+    // Stores a copy of the component until the next flush.
+    void* StageCopy(InstanceHandle handle, ComponentType type, const void* component)
+    {
+        void* data = AllocateStaged(handle, type);
+        mTypeInfos[type].Copy(data, component);
+        return data;
+    }
+
+    // Uninitialized memory for a staged component, the caller constructs the component.
+    void* AllocateStaged(InstanceHandle handle, ComponentType type)
+    {
+        auto& location = GetOrCreateLocation(handle);
+
+        assert(!location.added.test(type) && "Component added to same entity more than once.");
+        assert((location.removed.test(type) || !location.archetype || !location.archetype->Has(type)) && "Component added to same entity more than once.");
+
+        auto const& info = mTypeInfos[type];
+        void* data = ::operator new(info.size, std::align_val_t(info.align));
+
+        location.staged.push_back({type, data});
+        location.added.set(type);
+        MarkDirty(location);
+
+        return data;
+    }
+
+    void Unstage(InstanceHandle handle, ComponentType type)
+    {
+        auto location = FindLocation(handle);
+        if (!location)
+            return;
+
+        if (location->added.test(type))
+        {
+            for (size_t i = 0; i < location->staged.size(); ++i)
+            {
+                if (location->staged[i].type != type)
+                    continue;
+
+                FreeStaged(location->staged[i]);
+                location->staged[i] = location->staged.back();
+                location->staged.pop_back();
+                break;
+            }
+
+            location->added.reset(type);
+        }
+
+        if (location->archetype && location->archetype->Has(type) && !location->removed.test(type))
+        {
+            location->removed.set(type);
+            MarkDirty(*location);
+        }
+    }
+
+    void FreeStaged(StagedComponent const& staged)
+    {
+        auto const& info = mTypeInfos[staged.type];
+        info.Destroy(staged.data);
+        ::operator delete(staged.data, std::align_val_t(info.align));
+    }
+
+    void ReleaseStaged(Location& location)
+    {
+        for (auto const& staged : location.staged)
+            FreeStaged(staged);
+
+        location.staged.clear();
+        location.added.reset();
+        location.removed.reset();
+        location.dirty = false;
+    }
+
+    void RemoveRow(Archetype& archetype, uint32_t row)
+    {
+        auto const moved = archetype.RemoveRow(row);
+        if (moved.is_valid())
+            mLocations[moved.index()].row = row;
+    }
+
+    Archetype* GetOrCreateArchetype(Signature signature)
+    {
+        auto it = mArchetypeLookup.find(signature);
+        if (it != mArchetypeLookup.end())
+            return it->second;
+
+        mArchetypes.push_back(std::make_unique<Archetype>(signature, mTypeInfos));
+        mArchetypeLookup.insert({signature, mArchetypes.back().get()});
+        return mArchetypes.back().get();
+    }
+
+    void Migrate(Location& location)
+    {
+        Archetype* source = location.archetype;
+        uint32_t const sourceRow = location.row;
+        Signature const sourceSignature = source ? source->GetSignature() : Signature();
+        Signature const targetSignature = (sourceSignature & ~location.removed) | location.added;
+
+        Archetype* target = targetSignature.none() ? nullptr : GetOrCreateArchetype(targetSignature);
+
+        if (target)
+        {
+            uint32_t const row = target->AppendRow(location.handle);
+
+            for (size_t t = 0; t < MAX_COMPONENTS; ++t)
+            {
+                if (!targetSignature.test(t))
+                    continue;
+
+                auto const type = ComponentType(t);
+                void* src = location.added.test(type) ? Find(location.handle, type) : source->Get(type, sourceRow);
+                mTypeInfos[type].Move(target->Get(type, row), src);
+            }
+
+            location.archetype = target;
+            location.row = row;
+        }
+        else
+        {
+            location.archetype = nullptr;
+            location.row = 0;
+        }
+
+        // Destroys the moved-from components (and the removed ones)
+        if (source)
+            RemoveRow(*source, sourceRow);
+
+        ReleaseStaged(location);
+    }
+
+private:
+    std::array<ComponentTypeInfo, MAX_COMPONENTS> mTypeInfos{};
+
+    std::vector<std::unique_ptr<Archetype>> mArchetypes;
+    std::unordered_map<Signature, Archetype*> mArchetypeLookup;
+
+    // Indexed by the slot of the InstanceHandle
+    std::vector<Location> mLocations;
+    // Slots with staged changes
+    std::vector<uint32_t> mDirty;
+
+    // Amount of running view iterations, no flush while > 0
+    int mIterating = 0;
+};
+
+template <typename... Ts, typename... Xs>
+template <typename Func>
+void ArchetypeView<std::tuple<Ts...>, Exclude<Xs...>>::each(Func&& func)
+{
+    struct IterationGuard
+    {
+        int& counter;
+        IterationGuard(int& c) : counter(c) { ++counter; }
+        ~IterationGuard() { --counter; }
+    } guard(mManager->mIterating);
+
+    // Archetypes are only created by a flush, so the list does not change while iterating
+    for (auto& archetype : mManager->mArchetypes)
+    {
+        Signature const signature = archetype->GetSignature();
+        if ((signature & mInclude) != mInclude || (signature & mExclude).any())
+            continue;
+
+        EachInArchetype(*archetype, func, std::index_sequence_for<Ts...>{});
+    }
+}
+
+template <typename... Ts, typename... Xs>
+template <typename Func, size_t... Is>
+void ArchetypeView<std::tuple<Ts...>, Exclude<Xs...>>::EachInArchetype(Archetype& archetype, Func& func, std::index_sequence<Is...>)
+{
+    uint32_t const rowsPerChunk = archetype.RowsPerChunk();
+
+    for (uint32_t chunk = archetype.NumChunks(); chunk-- > 0;)
+    {
+        std::tuple<Ts*...> columns{archetype.Column<Ts>(mTypes[Is], chunk)...};
+
+        uint32_t const first = chunk * rowsPerChunk;
+        for (uint32_t row = std::min(archetype.Size(), first + rowsPerChunk); row-- > first;)
+        {
+            // Instances may have been destroyed in the meantime
+            if (row >= archetype.Size())
+                continue;
+
+            InstanceHandle const handle = archetype.HandleAt(row);
+            if ((mManager->mLocations[handle.index()].removed & mInclude).any())
+                continue;
+
+            uint32_t const i = row - first;
+            func(handle, std::get<Is>(columns)[i]...);
+        }
+    }
+}
+}
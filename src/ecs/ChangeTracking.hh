@@ -0,0 +1,144 @@
+#pragma once
+#include "advanced/World.hh"
+#include "advanced/transform.hh"
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Change tracking, so systems only process instances which changed since they last looked.
+*
+* Query filters:
+*    - Added<CompT>:       The component was added to the instance (or the instance stopped being a Prototype).
+*    - Changed<CompT>:     The component was marked via EngineECS::MarkChanged<CompT>().
+*    - Changed<transform>: The instance transform was marked via EngineECS::MarkTransformChanged().
+*
+* Usage:
+*    mMoved = mECS->Query(Changed<transform>{});   // once, e.g. in Init
+*    mMoved.each([&](InstanceHandle handle) { ... }); // every update: all instances moved since the last call
+*
+* Every change is stamped with the global change tick of the EngineECS and appended to a per-filter log (once per tick & instance).
+* A query remembers the tick of its last read and visits the log entries since then, each instance at most once per read.
+* The log is trimmed up to the oldest read position of all queries, so a query should be read regularly.
+*
+* Writes are not detected automatically, whoever changes a transform or component in place has to mark it.
+* Removals are still reported through System::RemoveEntity.
+*
+***/
+
+template <typename T>
+struct Added
+{
+};
+
+template <typename T>
+struct Changed
+{
+};
+
+// Log of the instances changed per tick for one filter.
+class ChangeChannel
+{
+public:
+    // Marking is not synchronized, the writers of a component/transform must not run in parallel (see ecs/Scheduler.hh).
+    void Mark(InstanceHandle handle, uint32_t tick)
+    {
+        uint32_t const slot = handle.index();
+        if (slot >= mLatest.size())
+            mLatest.resize(slot + 1);
+
+        auto& latest = mLatest[slot];
+        if (latest.tick == tick && latest.handle == handle)
+            return;
+
+        latest = {handle, tick};
+        mLog.push_back(latest);
+    }
+
+    uint32_t AddReader()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mReaderTicks.push_back(0);
+        return uint32_t(mReaderTicks.size() - 1);
+    }
+
+    // Calls func(InstanceHandle) for every instance marked in [last read tick, now).
+    template <typename Func>
+    void Read(uint32_t reader, uint32_t now, Func&& func)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        uint32_t const since = mReaderTicks[reader];
+        mReaderTicks[reader] = now;
+
+        auto it = std::lower_bound(mLog.begin(), mLog.end(), since, [](Entry const& e, uint32_t tick) { return e.tick < tick; });
+        for (; it != mLog.end() && it->tick < now; ++it)
+        {
+            // Only the latest entry of an instance counts, older ones are duplicates (or belong to a destroyed instance)
+            auto const& latest = mLatest[it->handle.index()];
+            if (latest.tick == it->tick && latest.handle == it->handle)
+                func(it->handle);
+        }
+
+        Trim();
+    }
+
+    void Clear()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mLog.clear();
+        mLatest.clear();
+    }
+
+private:
+    // Drops the entries every reader has already seen.
+    void Trim()
+    {
+        uint32_t const oldest = *std::min_element(mReaderTicks.begin(), mReaderTicks.end());
+        auto it = std::lower_bound(mLog.begin(), mLog.end(), oldest, [](Entry const& e, uint32_t tick) { return e.tick < tick; });
+        mLog.erase(mLog.begin(), it);
+    }
+
+private:
+    struct Entry
+    {
+        InstanceHandle handle;
+        uint32_t tick = 0;
+    };
+
+    std::vector<Entry> mLog;         // sorted by tick
+    std::vector<Entry> mLatest;      // latest entry per slot index
+    std::vector<uint32_t> mReaderTicks;
+    std::mutex mMutex;
+};
+
+// A registered reader of a change channel, created by EngineECS::Query().
+class ChangeQuery
+{
+public:
+    ChangeQuery() = default;
+    ChangeQuery(ChangeChannel* channel, std::atomic<uint32_t>* tick) : mChannel(channel), mTick(tick) { mReader = channel->AddReader(); }
+
+    // Calls func(InstanceHandle) for every instance changed since the last call (may include destroyed instances).
+    template <typename Func>
+    void each(Func&& func)
+    {
+        if (!mChannel)
+            return;
+
+        // Advance the tick, changes made from now on are part of the next read
+        uint32_t const now = mTick->fetch_add(1) + 1;
+        mChannel->Read(mReader, now, func);
+    }
+
+    bool IsValid() const { return mChannel != nullptr; }
+
+private:
+    ChangeChannel* mChannel = nullptr;
+    std::atomic<uint32_t>* mTick = nullptr;
+    uint32_t mReader = 0;
+};
+}
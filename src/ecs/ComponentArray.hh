@@ -2,8 +2,11 @@
 #include "advanced/World.hh"
 #include "components/Component.hh"
 #include "glow/common/log.hh"
-#include <unordered_map>
-#include <array>
+#include <clean-core/span.hh>
+#include <vector>
+#include <memory>
+#include <cstring>
+#include <type_traits>
 #include <assert.h>
 
 namespace gamedev
@@ -14,6 +17,19 @@ namespace gamedev
 * A Component Array holds all Components of a certain type.
 * It is always packed and accessed by the InstanceHandle.
 * 
+* Storage is a sparse set:
+*   - mSparse is indexed by the slot index of a handle and stores the position in the dense arrays.
+*   - mDense stores the full handle of every packed component (index + generation).
+* Lookups are two array reads, stale handles are rejected by comparing the dense handle.
+* 
+* Components are stored in fixed-size chunks which are allocated on demand.
+* Growing never relocates existing chunks, so component pointers stay valid until the component
+* itself is removed (removal still moves the last component into the freed spot).
+* Trailing chunks are released once they are empty, one spare chunk is kept so that
+* adding & removing around a chunk boundary doesn't allocate every time.
+* 
+* Trivially copyable components are inserted, relocated & cloned with memcpy.
+* 
 ***/
 
 // Interface of different ComponentArrays.
@@ -21,10 +37,10 @@ class IComponentArray
 {
 public:
     virtual ~IComponentArray() = default;
-    virtual gamedev::Component* GetBaseComponent(InstanceHandle handle) = 0;
-    virtual gamedev::Component* TryGetBaseComponent(InstanceHandle handle) = 0;
     virtual void TryRemoveData(InstanceHandle handle) = 0;
     virtual void CloneEntityComponent(InstanceHandle& handle_source, InstanceHandle& handle_copy) = 0;
+    virtual const void* TryGetDataRaw(InstanceHandle handle) = 0;
+    virtual void InsertDataBatch(const void* source, cc::span<InstanceHandle const> handles) = 0;
     virtual void EntityDestroyed(InstanceHandle handle) = 0;
     virtual void AllEntitiesDestroyed() = 0;
 };
@@ -34,166 +50,179 @@ template <typename CompT>
 class ComponentArray : public IComponentArray
 {
 public:
-    // Creates a mapping from InstanceHandle to Array,
+    // Returns true if the Instance owns a component of this type.
+    bool Contains(InstanceHandle handle) const
+    {
+        uint32_t const slot = handle.index();
+        if (slot >= mSparse.size())
+            return false;
+
+        uint32_t const denseIndex = mSparse[slot];
+        return denseIndex < mSize && mDense[denseIndex] == handle;
+    }
+
+    // Maps the InstanceHandle to the end of the dense array,
     // and adds the component to the array.
     void InsertData(InstanceHandle handle, CompT& component)
     {
-        assert(mEntityToIndexMap.find(handle) == mEntityToIndexMap.end() && "Component added to same entity more than once.");
-        
-        size_t newIndex = mSize;
-        //mEntityToIndexMap[handle] = newIndex;
-        //mIndexToEntityMap[newIndex] = handle;
-        mEntityToIndexMap.insert_or_assign(handle, newIndex);
-        mIndexToEntityMap.insert_or_assign(newIndex, handle);
-        mComponentArray[newIndex] = component;
+        assert(!Contains(handle) && "Component added to same entity more than once.");
 
-        ++mSize;
+        uint32_t const slot = handle.index();
+        if (slot >= mSparse.size())
+            mSparse.resize(slot + 1, InvalidIndex);
 
-        IntegrityCheck();
+        uint32_t const newIndex = mSize;
+        if (newIndex == Capacity())
+            mChunks.emplace_back(new CompT[COMPONENT_CHUNK_SIZE]);
+
+        mSparse[slot] = newIndex;
+        mDense.push_back(handle);
+        Copy(At(newIndex), component);
+
+        ++mSize;
     }
 
     void TryInsertData(InstanceHandle handle, CompT& component)
     {
-        if(mEntityToIndexMap.find(handle) != mEntityToIndexMap.end())
+        if (Contains(handle))
         {
             glow::log() << "Tried to add component to same entity more than once.";
             return;
         }
 
-        size_t newIndex = mSize;
-        //mEntityToIndexMap[handle] = newIndex;
-        //mIndexToEntityMap[newIndex] = handle;
-        mEntityToIndexMap.insert_or_assign(handle, newIndex);
-        mIndexToEntityMap.insert_or_assign(newIndex, handle);
-        mComponentArray[newIndex] = component;
-        ++mSize;
-
-        IntegrityCheck();
+        InsertData(handle, component);
     }
 
-    // Removes the component from the Instance by updating the mapping into the array.
+    // Removes the component from the Instance by moving the last element into its place.
     void RemoveData(InstanceHandle handle)
     {
-        assert(mEntityToIndexMap.find(handle) != mEntityToIndexMap.end() && "Removing non-existent component.");
+        assert(Contains(handle) && "Removing non-existent component.");
 
-		    // Copy element at end into deleted element's place to maintain density
-        size_t indexOfRemovedEntity = mEntityToIndexMap[handle];
-        size_t indexOfLastElement = mSize - 1;
-        mComponentArray[indexOfRemovedEntity] = mComponentArray[indexOfLastElement];
+        // Copy element at end into deleted element's place to maintain density
+        uint32_t const indexOfRemovedEntity = mSparse[handle.index()];
+        uint32_t const indexOfLastElement = mSize - 1;
 
-        // Update map to the moved position
-        InstanceHandle entityOfLastElement = mIndexToEntityMap[indexOfLastElement];
-        //mEntityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
-        //mIndexToEntityMap[indexOfLastElement] = entityOfLastElement;
-        mEntityToIndexMap.insert_or_assign(entityOfLastElement, indexOfRemovedEntity);
-        mIndexToEntityMap.insert_or_assign(indexOfRemovedEntity, entityOfLastElement);
+        if (indexOfRemovedEntity != indexOfLastElement)
+        {
+            InstanceHandle const entityOfLastElement = mDense[indexOfLastElement];
+            Copy(At(indexOfRemovedEntity), At(indexOfLastElement));
+            mDense[indexOfRemovedEntity] = entityOfLastElement;
+            mSparse[entityOfLastElement.index()] = indexOfRemovedEntity;
+        }
 
         // Remove empty
-        mEntityToIndexMap.erase(handle);
-        mIndexToEntityMap.erase(indexOfLastElement);
+        mSparse[handle.index()] = InvalidIndex;
+        mDense.pop_back();
+        --mSize;
 
-        if (mSize > 0)
-            --mSize;
-
-        IntegrityCheck();
+        ReleaseEmptyChunks();
     }
 
-    // Removes the component from the Instance by updating the mapping into the array.
+    // Removes the component from the Instance if it exists.
     void TryRemoveData(InstanceHandle handle)
     {
-        if(mEntityToIndexMap.find(handle) == mEntityToIndexMap.end())
-        {
+        if (!Contains(handle))
             return;
-        }
-
-        // Copy element at end into deleted element's place to maintain density
-        size_t indexOfRemovedEntity = mEntityToIndexMap[handle];
-        size_t indexOfLastElement = mSize - 1;
-        mComponentArray[indexOfRemovedEntity] = mComponentArray[indexOfLastElement];
-
-        // Update map to the moved position
-        InstanceHandle entityOfLastElement = mIndexToEntityMap[indexOfLastElement];
-        //mEntityToIndexMap[entityOfLastElement] = indexOfRemovedEntity;
-        //mIndexToEntityMap[indexOfLastElement] = entityOfLastElement;
-        mEntityToIndexMap.insert_or_assign(entityOfLastElement, indexOfRemovedEntity);
-        mIndexToEntityMap.insert_or_assign(indexOfRemovedEntity, entityOfLastElement);
-
-        // Remove empty
-        mEntityToIndexMap.erase(handle);
-        mIndexToEntityMap.erase(indexOfLastElement);
 
-        if (mSize > 0)
-            --mSize;
-
-        IntegrityCheck();
+        RemoveData(handle);
     }
 
     // Remove the component from all instances
     void RemoveAll()
     {
-        mEntityToIndexMap.clear();
-        mIndexToEntityMap.clear();
+        mSparse.clear();
+        mDense.clear();
+        mChunks.clear();
         mSize = 0;
     }
 
     // Returns a reference to the Instances component
     CompT* GetData(InstanceHandle handle)
     {
-        if (mEntityToIndexMap.find(handle) == mEntityToIndexMap.end())
+        if (!Contains(handle))
         {
             glow::error() << "Retrieving non-existent component: " << typeid(CompT).name();
-            assert(mEntityToIndexMap.find(handle) != mEntityToIndexMap.end());
+            assert(Contains(handle));
         }
 
-        return &mComponentArray[mEntityToIndexMap[handle]];
+        return &At(mSparse[handle.index()]);
     }
 
-    // Tries to return a reference to the Instance component, else it will return an empty component.
+    // Tries to return a reference to the Instance component, else it will return nullptr.
     CompT* TryGetData(InstanceHandle handle)
     {
-        if (mEntityToIndexMap.find(handle) == mEntityToIndexMap.end())
+        if (!Contains(handle))
             return nullptr;
 
-        return &mComponentArray[mEntityToIndexMap[handle]];
-    }
-
-    Component* GetBaseComponent(InstanceHandle handle)
-    {
-        return reinterpret_cast<Component*>(GetData(handle));
-    }
-
-    Component* TryGetBaseComponent(InstanceHandle handle)
-    {
-        return reinterpret_cast<Component*>(TryGetData(handle));
+        return &At(mSparse[handle.index()]);
     }
 
-    // Clones the component of source if it exists & sets the instance reference to nullptr (correct this before using!)
+    // Clones the component of source if it exists.
     void CloneEntityComponent(InstanceHandle& handle_source, InstanceHandle& handle_copy)
     {
-        if (mEntityToIndexMap.find(handle_source) == mEntityToIndexMap.end())
+        CompT* source = TryGetData(handle_source);
+        if (!source)
             return;
 
-        if (mEntityToIndexMap.find(handle_copy) != mEntityToIndexMap.end())
+        CompT* copy = TryGetData(handle_copy);
+        if (copy)
         {
-            mComponentArray[mEntityToIndexMap[handle_copy]] = mComponentArray[mEntityToIndexMap[handle_source]];
-            mComponentArray[mEntityToIndexMap[handle_copy]].instance = nullptr;
-            mComponentArray[mEntityToIndexMap[handle_copy]].handle_value = handle_copy._value;
+            Copy(*copy, *source);
         }
         else
         {
-            InsertData(handle_copy, mComponentArray[mEntityToIndexMap[handle_source]]);
-            mComponentArray[mEntityToIndexMap[handle_copy]].instance = nullptr;
-            mComponentArray[mEntityToIndexMap[handle_copy]].handle_value = handle_copy._value;
+            InsertData(handle_copy, *source);
+            copy = GetData(handle_copy);
+        }
+
+        copy->handle_value = handle_copy._value;
+    }
+
+    // Type-erased TryGetData(), used to gather the sources of InsertDataBatch().
+    const void* TryGetDataRaw(InstanceHandle handle) { return TryGetData(handle); }
+
+    // Copies the source component (a CompT) to all given instances, which must not own this component yet.
+    void InsertDataBatch(const void* source, cc::span<InstanceHandle const> handles)
+    {
+        if (!source || handles.empty())
+            return;
+
+        auto const& component = *static_cast<const CompT*>(source);
+
+        Reserve(mSize + handles.size());
+
+        for (auto handle : handles)
+        {
+            assert(!Contains(handle) && "Component added to same entity more than once.");
+
+            uint32_t const slot = handle.index();
+            if (slot >= mSparse.size())
+                mSparse.resize(slot + 1, InvalidIndex);
+
+            mSparse[slot] = mSize;
+            mDense.push_back(handle);
+
+            CompT& copy = At(mSize);
+            Copy(copy, component);
+            copy.handle_value = handle._value;
+
+            ++mSize;
         }
+    }
+
+    // Allocates chunks for at least count components.
+    void Reserve(size_t count)
+    {
+        while (Capacity() < count)
+            mChunks.emplace_back(new CompT[COMPONENT_CHUNK_SIZE]);
 
-        GetBaseComponent(handle_copy)->instance = nullptr;
+        mDense.reserve(count);
     }
 
     // Will check if the entity had this component and destroy it.
     void EntityDestroyed(InstanceHandle handle)
     {
-        if (mEntityToIndexMap.find(handle) != mEntityToIndexMap.end())
-            RemoveData(handle);
+        TryRemoveData(handle);
     }
 
     // Will check if the entity had this component and destroy it.
@@ -202,41 +231,45 @@ public:
         RemoveAll();
     }
 
-    // Checks integrity.
-    void IntegrityCheck()
+    // Number of packed components.
+    size_t Size() const { return mSize; }
+
+    // Handles of all instances owning this component, in storage order.
+    const std::vector<InstanceHandle>& Handles() const { return mDense; }
+
+    // Number of components which fit into the allocated chunks.
+    size_t Capacity() const { return mChunks.size() * COMPONENT_CHUNK_SIZE; }
+
+private:
+    static constexpr uint32_t InvalidIndex = uint32_t(-1);
+
+    CompT& At(uint32_t denseIndex) { return mChunks[denseIndex / COMPONENT_CHUNK_SIZE][denseIndex % COMPONENT_CHUNK_SIZE]; }
+
+    // Frees trailing chunks without components, but keeps one empty chunk as spare.
+    void ReleaseEmptyChunks()
     {
-        for (const auto& i1 : mIndexToEntityMap)
-        {
-            for (const auto& i2 : mIndexToEntityMap)
-            {
-                if ((i1.first == i2.first) && (i1.second._value == i2.second._value))
-                    continue;
-
-                if (i1.first == i2.first)
-                    int i = 0;
-
-                if (i1.second._value == i2.second._value)
-                    int i = 0;
-        
-                //assert((i1.second._value != i2.second._value)) && "Double id");
-            }
-        }
+        while (Capacity() - mSize > COMPONENT_CHUNK_SIZE)
+            mChunks.pop_back();
     }
 
-private:
-    // Densely packed array of components.
-    // Maximum corresponds to the maximum of living instances.
-    std::array<CompT, MAX_INSTANCES> mComponentArray;
+    static void Copy(CompT& dst, const CompT& src)
+    {
+        if constexpr (std::is_trivially_copyable_v<CompT>)
+            std::memcpy(static_cast<void*>(&dst), &src, sizeof(CompT));
+        else
+            dst = src;
+    }
 
-    // Maps InstanceHandle to array index.
-    std::unordered_map<InstanceHandle, size_t, InstanceHandleHash> mEntityToIndexMap;
-    
-    // Maps array index to InstanceHandle.
-    std::unordered_map<size_t, InstanceHandle> mIndexToEntityMap;
+    // Densely packed components, split into chunks of COMPONENT_CHUNK_SIZE.
+    std::vector<std::unique_ptr<CompT[]>> mChunks;
 
-    // Valid entries in the array.
-    size_t mSize;
+    // Handle of the component at the same dense position.
+    std::vector<InstanceHandle> mDense;
 
-    CompT mDummy;
+    // Maps the slot index of an InstanceHandle to the array index.
+    std::vector<uint32_t> mSparse;
+
+    // Valid entries in the array.
+    uint32_t mSize = 0;
 };
-}
\ No newline at end of file
+}
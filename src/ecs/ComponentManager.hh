@@ -1,7 +1,11 @@
 #pragma once
 #include "ecs/ComponentArray.hh"
+#include "ecs/ComponentTypeInfo.hh"
+#include "ecs/View.hh"
+#include "ecs/TypeId.hh"
 #include "advanced/World.hh"
-#include <unordered_map>
+#include <array>
+#include <memory>
 #include <assert.h>
 
 namespace gamedev
@@ -14,7 +18,7 @@ namespace gamedev
 * It will automatically create a unique Signature for a Component Type.
 * 
 * Fun Fact:
-*    - The integer representation of the typeid(..).name() pointer is used as a unique key to map Component to ComponentType.
+*    - The ComponentType is a sequential id per component struct (see ecs/TypeId.hh), it directly indexes the array of Component Arrays.
 *    - The Signature is a bitset which allows for easy bitwise comparison to check if an entity has certain Component Types.
 * 
 ***/
@@ -25,34 +29,31 @@ public:
     template <typename CompT>
     void RegisterComponent()
     {
-      const char* typeName = typeid(CompT).name();
+      auto const type = TypeId<ComponentFamily>::Id<CompT>();
 
-      assert(mComponentTypes.find(typeName) == mComponentTypes.end() && "Registering component type more than once.");
+      assert(type < MAX_COMPONENTS && "Too many component types.");
+      assert(!mComponentArrays[type] && "Registering component type more than once.");
 
-      // Add ComponentType to map
-      mComponentTypes.insert({typeName, mNextComponentType});
-      // Create ComponentType pool and add it to map
-      mComponentArrays.insert({typeName, std::make_shared<ComponentArray<CompT>>()});
-      // Update free ComponentType bit
-      ++mNextComponentType;
+      // Create ComponentType pool
+      mComponentArrays[type] = std::make_shared<ComponentArray<CompT>>();
     }
 
     // Return the components type id
     template <typename CompT>
     ComponentType GetComponentType()
     {
-        const char* typeName = typeid(CompT).name();
+        auto const type = TypeId<ComponentFamily>::Id<CompT>();
 
-        assert(mComponentTypes.find(typeName) != mComponentTypes.end() && "Component not registered before use.");
+        assert(type < MAX_COMPONENTS && mComponentArrays[type] && "Component not registered before use.");
 
-        return mComponentTypes[typeName];
+        return ComponentType(type);
     }
 
     // Add a fresh component to an instance
     template <typename CompT>
-    CompT* CreateComponent(InstanceHandle handle, Instance& instance)
+    CompT* CreateComponent(InstanceHandle handle)
     {
-        CompT Component(&instance);
+        CompT Component;
         Component.handle_value = handle._value;
 
         auto CompArray = GetComponentArray<CompT>();
@@ -62,9 +63,9 @@ public:
 
     // Add a fresh component to an instance
     template <typename CompT>
-    CompT* TryCreateComponent(InstanceHandle handle, Instance& instance)
+    CompT* TryCreateComponent(InstanceHandle handle)
     {
-        CompT Component(&instance);
+        CompT Component;
         Component.handle_value = handle._value;
 
         auto CompArray = GetComponentArray<CompT>();
@@ -94,7 +95,8 @@ public:
     {
         for (auto& arr : mComponentArrays)
         {
-            arr.second->TryRemoveData(handle);
+            if (arr)
+                arr->TryRemoveData(handle);
         }
     }
 
@@ -105,59 +107,79 @@ public:
     template <typename CompT>
     CompT* TryGetComponent(InstanceHandle handle) { return GetComponentArray<CompT>()->TryGetData(handle); }
 
+    // Iterate all instances owning Ts... but none of Xs...
+    template <typename... Ts, typename... Xs>
+    ComponentView<std::tuple<Ts...>, Exclude<Xs...>> View(Exclude<Xs...> = {})
+    {
+        return ComponentView<std::tuple<Ts...>, Exclude<Xs...>>(GetComponentArray<Ts>()..., GetComponentArray<Xs>()...);
+    }
+
     // Notifies all component arrays that an entity has been destroyed.
     // If necessary, all component arrays will delete the entity from their mapping.
     void EntityDestroyed(InstanceHandle handle)
     {
-        for (const auto& pair : mComponentArrays)
+        for (const auto& component : mComponentArrays)
         {
-            const auto& component = pair.second;
-
-            component->EntityDestroyed(handle);
+            if (component)
+                component->EntityDestroyed(handle);
         }
     }
 
     // Notifies all component arrays, that all entities have been destroyed.
     void AllEntitiesDestroyed()
     {
-        for (const auto& pair : mComponentArrays)
+        for (const auto& component : mComponentArrays)
         {
-            const auto& component = pair.second;
-
-            component->AllEntitiesDestroyed();
+            if (component)
+                component->AllEntitiesDestroyed();
         }
     }
 
-    // Clones all components from the source instance & corrects the Instance reference of those components.
-    void CloneEntityComponents(Instance& instance_source, Instance& instance_copy)
+    // Clones all components from the source instance.
+    void CloneEntityComponents(InstanceHandle handle_source, InstanceHandle handle_copy)
     {
         for (const auto& cArray : mComponentArrays)
         {
-            cArray.second->CloneEntityComponent(instance_source.mHandle, instance_copy.mHandle);
-            auto clone = cArray.second->TryGetBaseComponent(instance_copy.mHandle);
+            if (cArray)
+                cArray->CloneEntityComponent(handle_source, handle_copy);
+        }
+    }
+
+    // Pointers to the given component types of the instance (nullptr for types it does not own).
+    ComponentSources GetComponentSources(InstanceHandle handle, Signature types)
+    {
+        ComponentSources sources{};
+        for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+        {
+            if (types.test(type) && mComponentArrays[type])
+                sources[type] = mComponentArrays[type]->TryGetDataRaw(handle);
+        }
 
-            if (clone)
-                clone->instance = &instance_copy;
+        return sources;
+    }
+
+    // Copies the given component types from the sources to all instances (fresh instances without components).
+    void InstantiateComponentsBatch(cc::span<InstanceHandle const> handles, Signature types, ComponentSources const& sources)
+    {
+        for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+        {
+            if (types.test(type) && mComponentArrays[type])
+                mComponentArrays[type]->InsertDataBatch(sources[type], handles);
         }
     }
 
 private:
-    // Map typeid(..).name() to component type
-    std::unordered_map<const char*, ComponentType> mComponentTypes{};
-    // Map typeid(..).name() to component array
-    std::unordered_map<const char*, std::shared_ptr<IComponentArray>> mComponentArrays{};
-    // ComponentType to be assigned for the next registered component
-    ComponentType mNextComponentType{};
+    // Tag for the component type ids
+    struct ComponentFamily;
+
+    // Component arrays indexed by ComponentType
+    std::array<std::shared_ptr<IComponentArray>, MAX_COMPONENTS> mComponentArrays{};
 
     // Convenience: Cast component array to correct component type
     template <typename CompT>
-    std::shared_ptr<ComponentArray<CompT>> GetComponentArray()
+    ComponentArray<CompT>* GetComponentArray()
     {
-        const char* typeName = typeid(CompT).name();
-
-        assert(mComponentTypes.find(typeName) != mComponentTypes.end() && "Component not registered before use.");
-
-        return std::static_pointer_cast<ComponentArray<CompT>>(mComponentArrays[typeName]);
+        return static_cast<ComponentArray<CompT>*>(mComponentArrays[GetComponentType<CompT>()].get());
     }
 };
 }
\ No newline at end of file
@@ -0,0 +1,67 @@
+#pragma once
+#include "components/Component.hh"
+#include "Constants.hh"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace gamedev
+{
+// Type-erased operations on a component type.
+// Trivially copyable components are moved & copied with memcpy and need no destruction.
+struct ComponentTypeInfo
+{
+    size_t size = 0;
+    size_t align = 0;
+    bool trivial = false;
+    void (*moveConstruct)(void* dst, void* src) = nullptr;
+    void (*copyConstruct)(void* dst, const void* src) = nullptr;
+    void (*destroy)(void* ptr) = nullptr;
+    Component* (*asBase)(void* ptr) = nullptr;
+
+    bool IsValid() const { return size != 0; }
+
+    void Move(void* dst, void* src) const
+    {
+        if (trivial)
+            std::memcpy(dst, src, size);
+        else
+            moveConstruct(dst, src);
+    }
+
+    void Copy(void* dst, const void* src) const
+    {
+        if (trivial)
+            std::memcpy(dst, src, size);
+        else
+            copyConstruct(dst, src);
+    }
+
+    void Destroy(void* ptr) const
+    {
+        if (!trivial)
+            destroy(ptr);
+    }
+
+    template <typename CompT>
+    static ComponentTypeInfo Create()
+    {
+        ComponentTypeInfo info;
+        info.size = sizeof(CompT);
+        info.align = alignof(CompT);
+        info.trivial = std::is_trivially_copyable_v<CompT>;
+        info.moveConstruct = [](void* dst, void* src) { new (dst) CompT(std::move(*static_cast<CompT*>(src))); };
+        info.copyConstruct = [](void* dst, const void* src) { new (dst) CompT(*static_cast<const CompT*>(src)); };
+        info.destroy = [](void* ptr) { static_cast<CompT*>(ptr)->~CompT(); };
+        info.asBase = [](void* ptr) -> Component* { return static_cast<CompT*>(ptr); };
+        return info;
+    }
+};
+
+// One pointer per ComponentType to a component to copy from, nullptr for types that are not copied.
+// Used to clone instances & to instantiate prefabs (see ecs/PrefabStore.hh) with the same code path.
+using ComponentSources = std::array<const void*, MAX_COMPONENTS>;
+}
@@ -2,12 +2,18 @@
 #include <glow/fwd.hh>
 
 #include "ecs/ComponentManager.hh"
+#include "ecs/ArchetypeStorage.hh"
 #include "ecs/SystemManager.hh"
 #include "ecs/EventManager.hh"
+#include "ecs/EntityCommandBuffer.hh"
+#include "ecs/EntitySet.hh"
+#include "ecs/ChangeTracking.hh"
+#include "ecs/PrefabStore.hh"
 #include "advanced/World.hh"
 #include "Components.hh"
-#include "utility/HashMap.hh"
+#include "utility/SpatialIndex.hh"
 #include <array>
+#include <functional>
 #include "glow/common/log.hh"
 
 /***
@@ -22,6 +28,14 @@ namespace gamedev
 {
 GLOW_SHARED(class, EngineECS);
 
+// Component storage backend, selected at build time (CMake option GAMEDEV_ARCHETYPE_STORAGE).
+// Both expose the same interface, see ecs/ComponentManager.hh & ecs/ArchetypeStorage.hh.
+#ifdef GAMEDEV_ARCHETYPE_STORAGE
+using ComponentStorage = ArchetypeComponentManager;
+#else
+using ComponentStorage = ComponentManager;
+#endif
+
 class EngineECS
 {
 public:
@@ -29,7 +43,7 @@ public:
     void Init(World& world)
     {
         mSystemManager = std::make_unique<SystemManager>();
-        mComponentManager = std::make_unique<ComponentManager>();
+        mComponentManager = std::make_unique<ComponentStorage>();
         mEventManager = std::make_unique<EventManager>();
         mInstanceManager = std::shared_ptr<World>(&world);
     }
@@ -41,33 +55,97 @@ public:
                                                 glow::SharedTexture2D const& normal,
                                                 glow::SharedTexture2D const& arm)
     {
-        return mInstanceManager->createInstance(vao, albedo, normal, arm);
+        auto handle = mInstanceManager->createInstance(vao, albedo, normal, arm);
+        MarkTransformChanged(handle);
+        return handle;
     }
 
     [[nodiscard]] InstanceHandle CloneInstance(InstanceHandle source_handle)
     {
-        auto& source_instance = GetInstance(source_handle);
-        auto copy_handle = mInstanceManager->createInstance(source_instance.vao, source_instance.texAlbedo, source_instance.texNormal, source_instance.texARM);
-        auto& copy_instance = GetInstance(copy_handle);
-        
-        copy_instance.albedoBias = source_instance.albedoBias;
-        copy_instance.xform = source_instance.xform;
-        copy_instance.max_bounds = source_instance.max_bounds;
-        
-        return copy_handle;
+        return CreateInstanceFrom(GetInstanceRender(source_handle), GetInstanceTransform(source_handle), GetInstanceBounds(source_handle));
     }
 
-    Instance& GetInstance(InstanceHandle handle) { return mInstanceManager->getInstance(handle); }
+    // Creates one copy of the source instance per transform, including all components except Prototype.
+    // Components are copied per component type in bulk, the systems are notified once for the whole batch.
+    [[nodiscard]] std::vector<InstanceHandle> CloneInstanceBatch(InstanceHandle source_handle, cc::span<transform const> xforms)
+    {
+        auto signature = mInstanceManager->GetSignature(source_handle);
+        signature.reset(GetComponentType<Prototype>());
+
+        auto handles = CreateInstancesFrom(GetInstanceRender(source_handle), GetInstanceBounds(source_handle), xforms);
+        InstantiateComponents(handles, signature, mComponentManager->GetComponentSources(source_handle, signature));
 
-    transform& GetInstanceTransform(InstanceHandle handle) { return mInstanceManager->getInstance(handle).xform; }
+        mSystemManager->EntitiesCreated(handles, signature);
 
-    uint32_t getNumLiveInstances() const { return mInstanceManager->getNumLiveInstances(); }
+        return handles;
+    }
 
-    void MarkDestruction(InstanceHandle handle)
+    // Prefabs
+    // -------
+    // See ecs/PrefabStore.hh
+    // Snapshots the instance & its components (except Prototype) into a prefab, the instance itself stays untouched.
+    // The render data is given by asset ids (see SetAssetResolvers). If replace is a valid prefab, it is overwritten.
+    PrefabHandle BakePrefab(InstanceHandle handle, PrefabRender const& render, PrefabHandle replace = {})
     {
-        mInstanceManager->getInstance(handle).destroy = true;
+        auto signature = mInstanceManager->GetSignature(handle);
+        signature.reset(GetComponentType<Prototype>());
+
+        PrefabInstance instance;
+        instance.xform = GetInstanceTransform(handle);
+        instance.max_bounds = GetInstanceBounds(handle);
+        instance.render = render;
+
+        return mPrefabs.Create(instance, signature, mComponentManager->GetComponentSources(handle, signature), replace);
     }
 
+    // Creates an instance with a copy of the prefab data & components.
+    [[nodiscard]] InstanceHandle Instantiate(PrefabHandle prefab)
+    {
+        auto const& source = mPrefabs.GetInstance(prefab);
+        auto handle = CreateInstanceFrom(ResolveRender(source.render), source.xform, source.max_bounds);
+        InstantiateComponents(cc::span<InstanceHandle const>(&handle, 1), mPrefabs.GetSignature(prefab), mPrefabs.GetComponents(prefab));
+
+        UpdateSystems(handle);
+
+        return handle;
+    }
+
+    // Creates one instance of the prefab per transform, like CloneInstanceBatch().
+    [[nodiscard]] std::vector<InstanceHandle> InstantiateBatch(PrefabHandle prefab, cc::span<transform const> xforms)
+    {
+        auto const signature = mPrefabs.GetSignature(prefab);
+        auto const& source = mPrefabs.GetInstance(prefab);
+
+        auto handles = CreateInstancesFrom(ResolveRender(source.render), source.max_bounds, xforms);
+        InstantiateComponents(handles, signature, mPrefabs.GetComponents(prefab));
+
+        mSystemManager->EntitiesCreated(handles, signature);
+
+        return handles;
+    }
+
+    // Turn the asset names of prefabs into meshes & textures when they are instantiated (usually lookups in the asset manager).
+    // Without resolvers (or for NoAsset) the render data stays empty.
+    using MeshResolver = std::function<glow::SharedVertexArray(std::string const&)>;
+    using TextureResolver = std::function<glow::SharedTexture2D(std::string const&)>;
+    void SetAssetResolvers(MeshResolver meshes, TextureResolver textures)
+    {
+        mMeshResolver = std::move(meshes);
+        mTextureResolver = std::move(textures);
+    }
+
+    PrefabStore& GetPrefabs() { return mPrefabs; }
+
+    // All parts of the instance, prefer the accessors of the single parts below (see advanced/World.hh)
+    InstanceRef GetInstance(InstanceHandle handle) { return mInstanceManager->getInstance(handle); }
+
+    transform& GetInstanceTransform(InstanceHandle handle) { return mInstanceManager->getInstanceTransform(handle); }
+    tg::aabb3& GetInstanceBounds(InstanceHandle handle) { return mInstanceManager->getInstanceBounds(handle); }
+    InstanceRender& GetInstanceRender(InstanceHandle handle) { return mInstanceManager->getInstanceRender(handle); }
+    InstanceMeta& GetInstanceMeta(InstanceHandle handle) { return mInstanceManager->getInstanceMeta(handle); }
+
+    uint32_t getNumLiveInstances() const { return mInstanceManager->getNumLiveInstances(); }
+
     void DestroyInstance(InstanceHandle handle)
     {
         mInstanceManager->destroyInstance(handle);
@@ -78,14 +156,23 @@ public:
     {
         mComponentManager->EntityDestroyed(handle);
         mSystemManager->EntityDestroyed(handle);
-        mSpatialHashMap.RemoveInstance(handle);
+        mSpatialHashMap->RemoveInstance(handle);
     }
     
     void AllInstancesDestroyed()
     {
         mComponentManager->AllEntitiesDestroyed();
         mSystemManager->AllEntitiesDestroyed();
-        mSpatialHashMap.Clear();
+        mSpatialHashMap->Clear();
+        mEventManager->Clear();
+
+        mTransformChanges.Clear();
+        for (auto& channel : mAddedChanges)
+            if (channel)
+                channel->Clear();
+        for (auto& channel : mChangedChanges)
+            if (channel)
+                channel->Clear();
     }
 
     bool IsLiveHandle(InstanceHandle handle) const { return mInstanceManager->isLiveHandle(handle); }
@@ -96,18 +183,20 @@ public:
     void RegisterComponent()
     {
         mComponentManager->RegisterComponent<CompT>();
+        mPrefabs.RegisterComponent<CompT>(GetComponentType<CompT>());
     }
 
     template <typename CompT>
     CompT* CreateComponent(InstanceHandle handle)
     {
-        auto Component = mComponentManager->CreateComponent<CompT>(handle, mInstanceManager->getInstance(handle));
+        auto Component = mComponentManager->CreateComponent<CompT>(handle);
 
         auto signature = mInstanceManager->GetSignature(handle);
         signature.set(mComponentManager->GetComponentType<CompT>(), true);
         mInstanceManager->SetSignature(handle, signature);
 
         // mSystemManager->EntitySignatureChanged(handle, signature);
+        ComponentsAdded<CompT>(handle);
         UpdateSystems(handle);
 
         return Component;
@@ -116,13 +205,14 @@ public:
     template <typename CompT>
     CompT* TryCreateComponent(InstanceHandle handle)
     {
-        auto Component = mComponentManager->TryCreateComponent<CompT>(handle, mInstanceManager->getInstance(handle));
+        auto Component = mComponentManager->TryCreateComponent<CompT>(handle);
 
         auto signature = mInstanceManager->GetSignature(handle);
         signature.set(mComponentManager->GetComponentType<CompT>(), true);
         mInstanceManager->SetSignature(handle, signature);
 
         // mSystemManager->EntitySignatureChanged(handle, signature);
+        ComponentsAdded<CompT>(handle);
         UpdateSystems(handle);
 
         return Component;
@@ -138,17 +228,18 @@ public:
         mInstanceManager->SetSignature(handle, signature);
 
         // mSystemManager->EntitySignatureChanged(handle, signature);
+        ComponentsAdded<CompT>(handle);
         UpdateSystems(handle);
     }
 
     void CloneComponents(InstanceHandle source_handle, InstanceHandle copy_handle)
     {
-        auto& source_instance = GetInstance(source_handle);
-        auto& copy_instance = GetInstance(copy_handle);
+        auto const signature = mInstanceManager->GetSignature(source_handle);
 
-        mComponentManager->CloneEntityComponents(source_instance, copy_instance);
+        mComponentManager->CloneEntityComponents(source_handle, copy_handle);
 
-        mInstanceManager->SetSignature(copy_handle, source_instance.mSignature);
+        mInstanceManager->SetSignature(copy_handle, signature);
+        ComponentsAdded(copy_handle, signature);
 
         UpdateSystems(copy_handle);
     }
@@ -162,6 +253,7 @@ public:
         signature.set(mComponentManager->GetComponentType<CompT>(), false);
         mInstanceManager->SetSignature(handle, signature);
         
+        ComponentRemoved<CompT>(handle);
         UpdateSystems(handle);
     }
 
@@ -176,6 +268,7 @@ public:
 
         // mSystemManager->EntitySignatureChanged(handle, signature);
 
+        ComponentRemoved<CompT>(handle);
         UpdateSystems(handle);
     }
 
@@ -204,6 +297,14 @@ public:
         return mComponentManager->TryGetComponent<CompT>(handle);
     }
 
+    // Iterate all instances owning Ts... but none of Xs...
+    // Prototypes are always excluded, they are presets being authored (or disabled instances) and not part of the game.
+    template <typename... Ts, typename... Xs>
+    auto View(Exclude<Xs...> = {})
+    {
+        return mComponentManager->View<Ts...>(Exclude<Xs..., Prototype>{});
+    }
+
     template <typename CompT>
     ComponentType GetComponentType()
     {
@@ -213,7 +314,7 @@ public:
     template <typename CompT>
     bool TestSignature(InstanceHandle handle)
     {
-        return mInstanceManager->getInstance(handle).mSignature.test(mComponentManager->GetComponentType<CompT>());
+        return mInstanceManager->getInstanceMeta(handle).mSignature.test(mComponentManager->GetComponentType<CompT>());
     }
 
     // System Management
@@ -227,7 +328,7 @@ public:
             return;
         }
 
-        mSystemManager->EntitySignatureChanged(handle, GetInstance(handle).mSignature);
+        mSystemManager->EntitySignatureChanged(handle, mInstanceManager->getInstanceMeta(handle).mSignature);
     }
 
     template <typename SysT>
@@ -244,39 +345,297 @@ public:
 
     World* GetInstanceManager() { return mInstanceManager.get(); }
     SystemManager* GetSystemManager() { return mSystemManager.get(); }
-    ComponentManager* GetComponentManager() { return mComponentManager.get(); }
+    ComponentStorage* GetComponentManager() { return mComponentManager.get(); }
+
+    // Change Tracking
+    // ---------------
+    // See ecs/ChangeTracking.hh
+    template <typename CompT>
+    void MarkChanged(InstanceHandle handle)
+    {
+        auto& channel = mChangedChanges[GetComponentType<CompT>()];
+        if (channel)
+            channel->Mark(handle, mChangeTick.load());
+    }
+
+    void MarkTransformChanged(InstanceHandle handle) { mTransformChanges.Mark(handle, mChangeTick.load()); }
+
+    template <typename CompT>
+    ChangeQuery Query(Added<CompT>)
+    {
+        return ChangeQuery(&GetOrCreateChannel(mAddedChanges, GetComponentType<CompT>()), &mChangeTick);
+    }
+
+    template <typename CompT>
+    ChangeQuery Query(Changed<CompT>)
+    {
+        return ChangeQuery(&GetOrCreateChannel(mChangedChanges, GetComponentType<CompT>()), &mChangeTick);
+    }
+
+    ChangeQuery Query(Changed<transform>) { return ChangeQuery(&mTransformChanges, &mChangeTick); }
+
+    // Deferred Structural Changes
+    // ---------------------------
+    // Structural changes during system updates are recorded here, see ecs/EntityCommandBuffer.hh
+    EntityCommandBuffer& GetCommandBuffer() { return mCommandBuffer; }
+
+    // Applies all recorded commands, then updates the systems once per changed instance.
+    // Commands recorded while flushing (e.g. by event listeners) are applied by the next flush.
+    void FlushCommands()
+    {
+        if (mCommandBuffer.Empty())
+            return;
+
+        mCommandBuffer.TakeCommands(mFlushedCommands);
+
+        for (auto& command : mFlushedCommands)
+        {
+            // Destroyed by an earlier command
+            if (!IsLiveHandle(command.handle))
+                continue;
+
+            if (command.type == EntityCommandBuffer::Command::Type::DestroyInstance)
+            {
+                mChangedInstances.erase(command.handle);
+                DestroyInstance(command.handle);
+            }
+            else
+            {
+                command.apply(*this, command.handle);
+                mChangedInstances.insert(command.handle);
+            }
+        }
+
+        for (auto handle : mChangedInstances)
+            UpdateSystems(handle);
+
+        mFlushedCommands.clear();
+        mChangedInstances.clear();
+    }
 
     // Event Management
     // ----------------
-    void AddFunctionalListener(EventType type, std::function<void(Event&)> const&listener)
+    // See ecs/EventManager.hh
+    template <typename EventT>
+    void RegisterEvent()
     {
-        mEventManager->AddFunctionalListener(type, listener);
+        mEventManager->RegisterEvent<EventT>();
     }
 
-    void SendFunctionalEvent(Event& event)
+    template <typename EventT>
+    void SendEvent(EventT const& event)
     {
-        mEventManager->SendFunctionalEvent(event);
+        mEventManager->SendEvent(event);
     }
 
-    void SendEvent(Event& event)
+    template <typename EventT>
+    EventReader<EventT> CreateEventReader()
     {
-        mEventManager->SendEvent(event);
+        return mEventManager->CreateEventReader<EventT>();
     }
 
-    std::vector<Event>& GetPendingEvents() { return mEventManager->GetPendingEvents(); }
+    // Retires the events of the previous frame, called once per frame.
+    void UpdateEvents() { mEventManager->Update(); }
 
     // Spatial Hash Map
-    Hash2D& GetHashMap() { return mSpatialHashMap; }
+    SpatialIndex& GetHashMap() { return *mSpatialHashMap; }
+
+    // Sets the area & resolution of the spatial index (kept for SetSpatialIndexType), drops its content
+    void InitSpatialIndex(tg::size2 cellCount, tg::aabb2 bounds)
+    {
+        mSpatialCellCount = cellCount;
+        mSpatialBounds = bounds;
+        mSpatialHashMap->Init(cellCount, bounds);
+    }
+    void InitSpatialIndex(tg::size2 cellCount, tg::aabb3 bounds) { InitSpatialIndex(cellCount, tg::aabb2({bounds.min.x, bounds.min.z}, {bounds.max.x, bounds.max.z})); }
+
+    // Exchanges the structure behind GetHashMap(), the listed instances move over with their categories.
+    // Don't call while a system job runs, they query the index.
+    void SetSpatialIndexType(SpatialIndexType type)
+    {
+        if (type == mSpatialIndexType)
+            return;
+
+        auto index = CreateSpatialIndex(type);
+        index->Init(mSpatialCellCount, mSpatialBounds);
+
+        for (uint32_t i = 0; i < mInstanceManager->getNumLiveInstances(); ++i)
+        {
+            auto const handle = mInstanceManager->getNthInstanceHandle(i);
+            if (mSpatialHashMap->Contains(handle))
+                index->AddInstance(handle, GetInstanceTransform(handle).translation, GetInstanceBounds(handle), mSpatialHashMap->GetCategories(handle));
+        }
+
+        mSpatialHashMap = std::move(index);
+        mSpatialIndexType = type;
+    }
+
+    SpatialIndexType GetSpatialIndexType() const { return mSpatialIndexType; }
 
 
+private:
+    // Structural changes without updating the systems, used by FlushCommands()
+    friend class EntityCommandBuffer;
+
+    template <typename CompT>
+    void ApplyCreateComponent(InstanceHandle handle)
+    {
+        if (TestSignature<CompT>(handle))
+            return;
+
+        mComponentManager->CreateComponent<CompT>(handle);
+        SetSignatureBit<CompT>(handle, true);
+        ComponentsAdded<CompT>(handle);
+    }
+
+    template <typename CompT>
+    void ApplyAddComponent(InstanceHandle handle, CompT const& component)
+    {
+        if (TestSignature<CompT>(handle))
+        {
+            auto* existing = GetComponent<CompT>(handle);
+            *existing = component;
+            existing->handle_value = handle._value;
+            return;
+        }
+
+        mComponentManager->AddComponent<CompT>(handle, component);
+        SetSignatureBit<CompT>(handle, true);
+        ComponentsAdded<CompT>(handle);
+    }
+
+    template <typename CompT>
+    void ApplyRemoveComponent(InstanceHandle handle)
+    {
+        if (!TestSignature<CompT>(handle))
+            return;
+
+        mComponentManager->RemoveComponent<CompT>(handle);
+        SetSignatureBit<CompT>(handle, false);
+        ComponentRemoved<CompT>(handle);
+    }
+
+    // Creates an instance with the render data, transform & bounds of a source (but no components).
+    InstanceHandle CreateInstanceFrom(InstanceRender const& render, transform const& xform, tg::aabb3 const& bounds)
+    {
+        auto copy_handle = mInstanceManager->createInstance(render.vao, render.texAlbedo, render.texNormal, render.texARM);
+
+        GetInstanceRender(copy_handle).albedoBias = render.albedoBias;
+        GetInstanceTransform(copy_handle) = xform;
+        GetInstanceBounds(copy_handle) = bounds;
+        MarkTransformChanged(copy_handle);
+
+        return copy_handle;
+    }
+
+    // Render data of an instance from the asset ids of a prefab
+    InstanceRender ResolveRender(PrefabRender const& render) const
+    {
+        auto const texture = [&](AssetId id) { return id != NoAsset && mTextureResolver ? mTextureResolver(mPrefabs.GetAssetName(id)) : nullptr; };
+
+        InstanceRender resolved;
+        resolved.vao = render.mesh != NoAsset && mMeshResolver ? mMeshResolver(mPrefabs.GetAssetName(render.mesh)) : nullptr;
+        resolved.texAlbedo = texture(render.texAlbedo);
+        resolved.texNormal = texture(render.texNormal);
+        resolved.texARM = texture(render.texARM);
+        resolved.albedoBias = render.albedoBias;
+        return resolved;
+    }
+
+    std::vector<InstanceHandle> CreateInstancesFrom(InstanceRender const& render, tg::aabb3 const& bounds, cc::span<transform const> xforms)
+    {
+        std::vector<InstanceHandle> handles;
+        handles.reserve(xforms.size());
+
+        for (auto const& xform : xforms)
+            handles.push_back(CreateInstanceFrom(render, xform, bounds));
+
+        return handles;
+    }
+
+    // Copies the components to fresh instances, without notifying the systems.
+    void InstantiateComponents(cc::span<InstanceHandle const> handles, Signature signature, ComponentSources const& sources)
+    {
+        mComponentManager->InstantiateComponentsBatch(handles, signature, sources);
+
+        for (auto handle : handles)
+        {
+            mInstanceManager->SetSignature(handle, signature);
+            ComponentsAdded(handle, signature);
+        }
+    }
+
+    // Marks the given components as added, only channels with a query are tracked.
+    void ComponentsAdded(InstanceHandle handle, Signature components)
+    {
+        // Prototypes are not part of the game, their components count as added once the Prototype component is removed
+        if (components.test(GetComponentType<Prototype>()) || TestSignature<Prototype>(handle))
+            return;
+
+        for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+        {
+            if (components.test(type) && mAddedChanges[type])
+                mAddedChanges[type]->Mark(handle, mChangeTick.load());
+        }
+    }
+
+    template <typename CompT>
+    void ComponentsAdded(InstanceHandle handle)
+    {
+        Signature components;
+        components.set(GetComponentType<CompT>());
+        ComponentsAdded(handle, components);
+    }
+
+    template <typename CompT>
+    void ComponentRemoved(InstanceHandle handle)
+    {
+        if (GetComponentType<CompT>() == GetComponentType<Prototype>())
+            ComponentsAdded(handle, mInstanceManager->GetSignature(handle));
+    }
+
+    ChangeChannel& GetOrCreateChannel(std::array<std::unique_ptr<ChangeChannel>, MAX_COMPONENTS>& channels, ComponentType type)
+    {
+        if (!channels[type])
+            channels[type] = std::make_unique<ChangeChannel>();
+
+        return *channels[type];
+    }
+
+    template <typename CompT>
+    void SetSignatureBit(InstanceHandle handle, bool value)
+    {
+        auto signature = mInstanceManager->GetSignature(handle);
+        signature.set(mComponentManager->GetComponentType<CompT>(), value);
+        mInstanceManager->SetSignature(handle, signature);
+    }
+
 private:
     std::shared_ptr<World> mInstanceManager;
     std::unique_ptr<SystemManager> mSystemManager;
-    std::unique_ptr<ComponentManager> mComponentManager;
+    std::unique_ptr<ComponentStorage> mComponentManager;
     std::unique_ptr<EventManager> mEventManager;
 
+    // Outside of the World, prefabs don't occupy instance slots or component rows
+    PrefabStore mPrefabs;
+    MeshResolver mMeshResolver;
+    TextureResolver mTextureResolver;
+
+    EntityCommandBuffer mCommandBuffer;
+    std::vector<EntityCommandBuffer::Command> mFlushedCommands;
+    EntitySet mChangedInstances;
+
+    // Change tracking
+    std::atomic<uint32_t> mChangeTick{1};
+    ChangeChannel mTransformChanges;
+    std::array<std::unique_ptr<ChangeChannel>, MAX_COMPONENTS> mAddedChanges;
+    std::array<std::unique_ptr<ChangeChannel>, MAX_COMPONENTS> mChangedChanges;
+
 private:
     // Spatial Hash Map
-    Hash2D mSpatialHashMap;
+    SpatialIndexType mSpatialIndexType = SpatialIndexType::Grid;
+    std::unique_ptr<SpatialIndex> mSpatialHashMap = CreateSpatialIndex(mSpatialIndexType);
+    tg::size2 mSpatialCellCount = {1, 1};
+    tg::aabb2 mSpatialBounds = tg::aabb2::unit_centered;
 };
 }
\ No newline at end of file
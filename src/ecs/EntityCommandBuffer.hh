@@ -0,0 +1,94 @@
+#pragma once
+#include "advanced/World.hh"
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace gamedev
+{
+class EngineECS;
+
+/***
+* Records structural changes (destroying instances, adding & removing components) during system updates.
+*
+* Changing the structure immediately updates the entity lists of every system, which is slow when done per change
+* and unsafe while other systems iterate (or run in parallel, see ecs/Scheduler.hh).
+* Recorded commands are applied by EngineECS::FlushCommands() at the sync points between scheduler stages:
+*    - Commands are applied in the order they were recorded.
+*    - Commands for instances destroyed in the meantime are dropped.
+*    - The systems are updated once per changed instance, after all commands have been applied.
+*
+* Until the flush, the instance & its components stay untouched, so listeners of e.g. a death event can still access them.
+*
+*    mECS->GetCommandBuffer().DestroyInstance(arrowHandle);
+*    mECS->GetCommandBuffer().RemoveComponent<ForeignControl>(handle);
+*
+* Creating instances stays immediate (the handle is needed to set up the instance).
+* Recording is thread safe.
+*
+***/
+class EntityCommandBuffer
+{
+public:
+    struct Command
+    {
+        enum class Type
+        {
+            DestroyInstance = 0,
+            ChangeComponents
+        };
+
+        Type type;
+        InstanceHandle handle;
+        std::function<void(EngineECS&, InstanceHandle)> apply;
+    };
+
+public:
+    void DestroyInstance(InstanceHandle handle) { Record({Command::Type::DestroyInstance, handle, nullptr}); }
+
+    // Adds a fresh component (does nothing if the instance already owns one).
+    template <typename CompT>
+    void CreateComponent(InstanceHandle handle)
+    {
+        Record({Command::Type::ChangeComponents, handle, [](auto& ecs, InstanceHandle h) { ecs.template ApplyCreateComponent<CompT>(h); }});
+    }
+
+    // Adds the given component (replaces the component if the instance already owns one).
+    template <typename CompT>
+    void AddComponent(InstanceHandle handle, CompT const& component)
+    {
+        Record({Command::Type::ChangeComponents, handle, [component](auto& ecs, InstanceHandle h) { ecs.template ApplyAddComponent<CompT>(h, component); }});
+    }
+
+    // Removes the component (does nothing if the instance does not own one).
+    template <typename CompT>
+    void RemoveComponent(InstanceHandle handle)
+    {
+        Record({Command::Type::ChangeComponents, handle, [](auto& ecs, InstanceHandle h) { ecs.template ApplyRemoveComponent<CompT>(h); }});
+    }
+
+    bool Empty()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCommands.empty();
+    }
+
+    // Moves all recorded commands into the given (empty) vector.
+    void TakeCommands(std::vector<Command>& commands)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        commands.swap(mCommands);
+    }
+
+private:
+    void Record(Command&& command)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCommands.push_back(std::move(command));
+    }
+
+private:
+    std::vector<Command> mCommands;
+    std::mutex mMutex;
+};
+}
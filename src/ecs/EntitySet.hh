@@ -0,0 +1,132 @@
+#pragma once
+#include "advanced/World.hh"
+#include <algorithm>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Dense set of InstanceHandles (sparse set), used as the entity list of systems.
+*
+* insert, erase and contains are O(1) array accesses, iteration walks a packed vector.
+* Removal swaps the last handle into the freed position, so the order is arbitrary by default.
+*
+* If a system needs a deterministic iteration order, SetOrdered(true) keeps the handles sorted by value
+* (like the std::set this replaces). Sorting is done lazily on the next iteration after the set changed.
+*
+* A slot holds at most one handle: inserting a handle replaces a stale handle with the same slot index.
+*
+***/
+class EntitySet
+{
+public:
+    using const_iterator = std::vector<InstanceHandle>::const_iterator;
+
+    explicit EntitySet(bool ordered = false) : mOrdered(ordered) {}
+
+    // Returns false if the handle already was part of the set.
+    bool insert(InstanceHandle handle)
+    {
+        uint32_t const slot = handle.index();
+        if (slot >= mSparse.size())
+            mSparse.resize(slot + 1, InvalidIndex);
+
+        uint32_t const denseIndex = mSparse[slot];
+        if (denseIndex != InvalidIndex)
+        {
+            if (mDense[denseIndex] == handle)
+                return false;
+
+            // stale handle of a destroyed instance occupies the slot
+            mDense[denseIndex] = handle;
+            mSorted = false;
+            return true;
+        }
+
+        mSparse[slot] = uint32_t(mDense.size());
+        mDense.push_back(handle);
+        mSorted = mSorted && (mDense.size() < 2 || mDense[mDense.size() - 2] < handle);
+        return true;
+    }
+
+    // Returns the amount of removed handles (0 or 1).
+    size_t erase(InstanceHandle handle)
+    {
+        if (!contains(handle))
+            return 0;
+
+        uint32_t const slot = handle.index();
+        uint32_t const denseIndex = mSparse[slot];
+        uint32_t const lastIndex = uint32_t(mDense.size() - 1);
+
+        if (denseIndex != lastIndex)
+        {
+            mDense[denseIndex] = mDense[lastIndex];
+            mSparse[mDense[denseIndex].index()] = denseIndex;
+            mSorted = false;
+        }
+
+        mDense.pop_back();
+        mSparse[slot] = InvalidIndex;
+        return 1;
+    }
+
+    bool contains(InstanceHandle handle) const
+    {
+        uint32_t const slot = handle.index();
+        return slot < mSparse.size() && mSparse[slot] != InvalidIndex && mDense[mSparse[slot]] == handle;
+    }
+
+    size_t count(InstanceHandle handle) const { return contains(handle) ? 1 : 0; }
+
+    void clear()
+    {
+        mSparse.clear();
+        mDense.clear();
+        mSorted = true;
+    }
+
+    size_t size() const { return mDense.size(); }
+    bool empty() const { return mDense.empty(); }
+
+    // Access by position, the position of a handle changes when other handles are erased.
+    InstanceHandle operator[](size_t i) const
+    {
+        SortIfNeeded();
+        return mDense[i];
+    }
+
+    const_iterator begin() const
+    {
+        SortIfNeeded();
+        return mDense.cbegin();
+    }
+    const_iterator end() const { return mDense.cend(); }
+
+    void SetOrdered(bool ordered) { mOrdered = ordered; }
+    bool IsOrdered() const { return mOrdered; }
+
+private:
+    void SortIfNeeded() const
+    {
+        if (!mOrdered || mSorted)
+            return;
+
+        std::sort(mDense.begin(), mDense.end());
+        for (uint32_t i = 0; i < mDense.size(); ++i)
+            mSparse[mDense[i].index()] = i;
+
+        mSorted = true;
+    }
+
+private:
+    static constexpr uint32_t InvalidIndex = uint32_t(-1);
+
+    // Sorting on iteration does not change the content of the set, hence mutable.
+    mutable std::vector<uint32_t> mSparse;
+    mutable std::vector<InstanceHandle> mDense;
+    mutable bool mSorted = true;
+
+    bool mOrdered = false;
+};
+}
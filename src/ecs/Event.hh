@@ -1,42 +1,66 @@
 #pragma once
-#include <unordered_map>
-#include <array>
-#include <assert.h>
+#include "advanced/World.hh"
+#include "advanced/transform.hh"
 
 namespace gamedev
 {
-struct Component;
-
 /***
-* https://austinmorlan.com/posts/entity_component_system/
-* 
+* Event payloads, sent through typed channels (see ecs/EventChannel.hh & ecs/EventManager.hh).
+*
+* Events are read later in the frame (or in the next one), when the involved instances might already be destroyed.
+* Therefore events carry everything their readers need, e.g. the transform of a killed instance.
+*
 ***/
-enum class EventType
-{
-  // Send if two instances collide
-  StaticCollision,
-  NewPosition,
-  ArrowHit,
-  MonsterHit,
-  PioneerHit,
-  BuildingHit,
-  MonsterDeath,
-  PioneerDeath,
-  BuildingDestroyed,
-  Supply1,
-  Supply2,
-  MoreWood
+
+// Who or what got hit / killed
+enum class TargetType
+{
+    Monster,
+    Pioneer,
+    Building
 };
 
-struct Event
+// A dynamic collider was pushed out of a static collider
+struct CollisionEvent
 {
-    Event() = delete;
-    explicit Event(EventType type, InstanceHandle sender, InstanceHandle subject) : mType(type), mSender(sender), mSubject(subject) {}
+    InstanceHandle staticHandle;
+    InstanceHandle dynamicHandle;
+};
 
-    EventType mType;
-    InstanceHandle mSender;
-    InstanceHandle mSubject;
+// An arrow reached its target
+struct ArrowHitEvent
+{
+    InstanceHandle arrow;
+    InstanceHandle target;
+    InstanceHandle shooter;
+    float damage = 0.f;
 };
 
+struct HitEvent
+{
+    TargetType type;
+    InstanceHandle attacker;
+    InstanceHandle target;
+    transform xform; // of the target when it was hit
+    float damage = 0.f;
+};
 
-}
\ No newline at end of file
+struct DeathEvent
+{
+    TargetType type;
+    InstanceHandle killer;
+    InstanceHandle killed;
+    transform xform; // of the killed instance
+};
+
+struct SupplyEvent
+{
+    int level = 0;
+};
+
+struct MoreWoodEvent
+{
+    InstanceHandle bonfire;
+    float wood = 0.f;
+};
+}
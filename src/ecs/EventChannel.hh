@@ -0,0 +1,152 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Double-buffered, typed event queue.
+*
+* Sending appends the event to the buffer of the current frame:
+*    - A slot is reserved by an atomic counter, so systems running in parallel can send without locking.
+*    - If the preallocated buffer is full, the event goes into a mutex protected overflow vector.
+*      The buffer grows at the next Update(), so this only happens while the event rate increases.
+*
+* Readers (EventReader) keep their own position and visit every event they have not seen yet, in send order.
+* Events stay readable for two updates (the current and the previous frame), so a reader which runs before the sender
+* in a frame gets the events in the next frame, and a reader which runs after the sender gets them in the same frame.
+*
+* A channel must not be read while other jobs send to it (see Resource::Events in ecs/Scheduler.hh).
+*
+***/
+class IEventChannel
+{
+public:
+    virtual ~IEventChannel() = default;
+
+    // Drops the events of the previous frame, the current frame becomes the previous one.
+    virtual void Update() = 0;
+    virtual void Clear() = 0;
+};
+
+template <typename EventT>
+class EventChannel : public IEventChannel
+{
+public:
+    void Send(EventT const& event)
+    {
+        auto& buffer = mBuffers[mCurrent];
+
+        uint32_t const slot = buffer.size.fetch_add(1, std::memory_order_relaxed);
+        if (slot < buffer.events.size())
+        {
+            buffer.events[slot] = event;
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mOverflowMutex);
+        buffer.overflow.push_back(event);
+    }
+
+    // Calls func(EventT const&) for every event with a sequence number >= next, then advances next.
+    template <typename Func>
+    void Read(uint64_t& next, Func&& func) const
+    {
+        for (auto b : {1 - mCurrent, mCurrent})
+        {
+            auto const& buffer = mBuffers[b];
+            uint64_t const count = buffer.Count();
+
+            uint64_t first = next > buffer.start ? next - buffer.start : 0;
+            for (uint64_t i = first; i < count; ++i)
+                func(buffer.At(uint32_t(i)));
+        }
+
+        next = mBuffers[mCurrent].start + mBuffers[mCurrent].Count();
+    }
+
+    // Amount of events sent in the current frame.
+    size_t Size() const { return mBuffers[mCurrent].Count(); }
+
+    void Update() override
+    {
+        auto& previous = mBuffers[1 - mCurrent];
+        auto& current = mBuffers[mCurrent];
+
+        // Grow for the next frames if the events did not fit
+        uint64_t const sent = current.Count();
+        if (sent > mCapacity)
+            mCapacity = size_t(sent * 2);
+
+        previous.Reset(mCapacity);
+        previous.start = current.start + sent;
+
+        mCurrent = 1 - mCurrent;
+    }
+
+    void Clear() override
+    {
+        // Sequence numbers keep increasing, so readers do not skip later events
+        uint64_t const next = mBuffers[mCurrent].start + mBuffers[mCurrent].Count();
+
+        for (auto& buffer : mBuffers)
+        {
+            buffer.Reset(mCapacity);
+            buffer.start = next;
+        }
+    }
+
+private:
+    struct Buffer
+    {
+        std::vector<EventT> events = std::vector<EventT>(InitialCapacity);
+        std::vector<EventT> overflow;
+        std::atomic<uint32_t> size{0};
+        uint64_t start = 0; // sequence number of the first event
+
+        uint64_t Count() const { return std::min<uint64_t>(size.load(std::memory_order_acquire), events.size()) + overflow.size(); }
+
+        EventT const& At(uint32_t i) const { return i < events.size() ? events[i] : overflow[i - events.size()]; }
+
+        void Reset(size_t capacity)
+        {
+            if (capacity > events.size())
+                events.resize(capacity);
+
+            overflow.clear();
+            size = 0;
+        }
+    };
+
+    static constexpr size_t InitialCapacity = 64;
+
+    Buffer mBuffers[2];
+    int mCurrent = 0;
+    size_t mCapacity = InitialCapacity;
+    std::mutex mOverflowMutex;
+};
+
+// Read position of one consumer in an EventChannel, created by EngineECS::CreateEventReader().
+template <typename EventT>
+class EventReader
+{
+public:
+    EventReader() = default;
+    explicit EventReader(EventChannel<EventT>* channel) : mChannel(channel) {}
+
+    // Calls func(EventT const&) for every event sent since the last call.
+    template <typename Func>
+    void each(Func&& func)
+    {
+        if (mChannel)
+            mChannel->Read(mNext, func);
+    }
+
+private:
+    EventChannel<EventT>* mChannel = nullptr;
+    uint64_t mNext = 0;
+};
+}
@@ -1,12 +1,10 @@
 #pragma once
 #include "ecs/Event.hh"
-#include "advanced/World.hh"
-#include <unordered_map>
+#include "ecs/EventChannel.hh"
+#include "ecs/TypeId.hh"
 #include <assert.h>
-#include <functional>
-#include <list>
-
-#define FUNCTIONAL_LISTENER(EventType, Listener) EventType, std::bind(&Listener, this, std::placeholders::_1)
+#include <memory>
+#include <vector>
 
 namespace gamedev
 {
@@ -14,54 +12,86 @@ namespace gamedev
 * Thanks to
 * https://austinmorlan.com/posts/entity_component_system/
 * & RTG Assignment 2
-* 
-* The EventManager is used to generate & optionally also directly resolve simple Events.
-* You can do 2 things:
-*     1. Send functional events via SendFunctionalEvent(..).
-*        These events are resolved the moment, they are issued.
-*        But a call to AddFunctionalListener(..) needs  to be done before, which registers a certain method to this event.
-*     
-*     2. Send plain events via SendEvent(..).
-*        These events are NOT handled by the EventManager.
-*        You have to manually get mPendingEvents via GetPendingEvents(), loop through all events and resolve them yourself (i.e. in Game.cc).
-* 
-* How to do functional Events:
-*     1. Inside class SomeClass define a function.
-*        void SomeClass::InputListener(Event& event) { // Some Code, maybe even altering variables of SomeClass depending on event }
-* 
-*     2. Add this function as a listener at some point of execution.
-*        mEventManager->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::Banana, SomeClass::InputListener));
-*        Done.
-* 
+*
+* The EventManager owns one EventChannel per event type (any struct, see ecs/Event.hh).
+*
+* How to do Events:
+*     1. Register the event type once, before any system is initialized.
+*        mECS->RegisterEvent<HitEvent>();
+*
+*     2. Send events from anywhere (also from systems running in parallel).
+*        mECS->SendEvent(HitEvent{TargetType::Monster, attacker, target, xform, damage});
+*
+*     3. Create a reader (e.g. in the Init of a system) and consume the events in batch at a defined point of its update.
+*        mHitEvents = mECS->CreateEventReader<HitEvent>();
+*        mHitEvents.each([&](HitEvent const& e) { ... });
+*
+* Update() is called once per frame (by the Scheduler) and retires the events of the previous frame.
+*
 ***/
 class EventManager
 {
 public:
-    // If something should directly react to an event, simply do:
-    void AddFunctionalListener(EventType type, std::function<void(Event&)> const& listener)
+    template <typename EventT>
+    void RegisterEvent()
+    {
+        auto const type = TypeId<EventFamily>::Id<EventT>();
+
+        if (type >= mChannels.size())
+            mChannels.resize(type + 1);
+
+        assert(!mChannels[type] && "Registering event type more than once.");
+
+        mChannels[type] = std::make_unique<EventChannel<EventT>>();
+    }
+
+    template <typename EventT>
+    void SendEvent(EventT const& event)
+    {
+        GetChannel<EventT>()->Send(event);
+    }
+
+    template <typename EventT>
+    EventReader<EventT> CreateEventReader()
     {
-        mFunctionalListeners[type].push_back(listener);
+        return EventReader<EventT>(GetChannel<EventT>());
     }
 
-    // Call this method for events, which should be handled directly by some registered method
-    void SendFunctionalEvent(Event& event)
+    // Retires the events of the previous frame in all channels.
+    void Update()
     {
-        for (auto const& listener : mFunctionalListeners[event.mType])
+        for (auto& channel : mChannels)
         {
-            listener(event);
+            if (channel)
+                channel->Update();
         }
     }
 
-    // Call this method for events, which you want handle yourself somewhere
-    void SendEvent(Event& event) { mPendingEvents.push_back(event); }
+    void Clear()
+    {
+        for (auto& channel : mChannels)
+        {
+            if (channel)
+                channel->Clear();
+        }
+    }
+
+private:
+    template <typename EventT>
+    EventChannel<EventT>* GetChannel()
+    {
+        auto const type = TypeId<EventFamily>::Id<EventT>();
 
-    // Call this method to get all unresolved events and then handle them yourself
-    std::vector<Event>& GetPendingEvents() { return mPendingEvents; }
+        assert(type < mChannels.size() && mChannels[type] && "Event type used before registered.");
+
+        return static_cast<EventChannel<EventT>*>(mChannels[type].get());
+    }
 
 private:
-    // Holds all unresolved events that are NOT directly handled by some method
-    std::vector<Event> mPendingEvents;
-    // Holds all mappings from an EventType to a list of methods which all get executed on a particular EventType
-    std::unordered_map<EventType, std::list<std::function<void(Event&)>>> mFunctionalListeners;
+    // Tag for the event type ids
+    struct EventFamily;
+
+    // Channels indexed by event type id
+    std::vector<std::unique_ptr<IEventChannel>> mChannels;
 };
-}
\ No newline at end of file
+}
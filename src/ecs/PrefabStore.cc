@@ -0,0 +1,198 @@
+#include "ecs/PrefabStore.hh"
+#include <fstream>
+
+namespace
+{
+// "GDPF", followed by the version of the layout below
+constexpr uint32_t FileMagic = 0x46504447;
+constexpr uint32_t FileVersion = 1;
+
+// File layout (native endianness):
+//    magic, version
+//    asset count, per asset:        name length, name
+//    prefab count, per prefab:      PrefabInstance, component count, per component: type, size, bytes
+template <typename T>
+void Write(std::ostream& file, T const& value)
+{
+    file.write(reinterpret_cast<char const*>(&value), sizeof(T));
+}
+
+template <typename T>
+bool Read(std::istream& file, T& value)
+{
+    return bool(file.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+}
+
+gamedev::PrefabHandle gamedev::PrefabStore::Create(PrefabInstance const& instance, Signature components, ComponentSources const& sources, PrefabHandle replace)
+{
+    Prefab prefab;
+    prefab.instance = instance;
+    prefab.signature = components;
+
+    // Layout of the blob, every component at its natural alignment
+    size_t bytes = 0;
+    for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+    {
+        if (!components.test(type))
+            continue;
+
+        assert(mTypeInfos[type].IsValid() && sources[type] && "Prefab component not registered or missing.");
+
+        auto const& info = mTypeInfos[type];
+        assert(info.align <= BlobAlignment && "Over-aligned component type.");
+
+        bytes = (bytes + info.align - 1) / info.align * info.align;
+        prefab.offsets[type] = bytes;
+        bytes += info.size;
+    }
+
+    prefab.blob.reset(static_cast<std::byte*>(::operator new(std::max<size_t>(bytes, 1), std::align_val_t(BlobAlignment))));
+
+    for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+    {
+        if (!components.test(type))
+            continue;
+
+        void* copy = prefab.blob.get() + prefab.offsets[type];
+        mTypeInfos[type].Copy(copy, sources[type]);
+        mTypeInfos[type].asBase(copy)->handle_value = uint32_t(-1);
+        prefab.components[type] = copy;
+    }
+
+    if (replace.is_valid())
+    {
+        assert(replace._value < mPrefabs.size() && "Replacing non-existent prefab.");
+        Destroy(mPrefabs[replace._value]);
+        mPrefabs[replace._value] = std::move(prefab);
+        return replace;
+    }
+
+    mPrefabs.push_back(std::move(prefab));
+    return {uint32_t(mPrefabs.size() - 1)};
+}
+
+gamedev::AssetId gamedev::PrefabStore::GetAssetId(std::string const& name)
+{
+    auto const [it, inserted] = mAssetIds.try_emplace(name, AssetId(mAssetNames.size()));
+    if (inserted)
+        mAssetNames.push_back(name);
+
+    return it->second;
+}
+
+bool gamedev::PrefabStore::Save(std::filesystem::path const& filepath) const
+{
+    std::ofstream file(filepath, std::ios::binary);
+    if (!file)
+        return false;
+
+    Write(file, FileMagic);
+    Write(file, FileVersion);
+
+    Write(file, uint32_t(mAssetNames.size()));
+    for (auto const& name : mAssetNames)
+    {
+        Write(file, uint32_t(name.size()));
+        file.write(name.data(), std::streamsize(name.size()));
+    }
+
+    Write(file, uint32_t(mPrefabs.size()));
+    for (auto const& prefab : mPrefabs)
+    {
+        Write(file, prefab.instance);
+        Write(file, uint32_t(prefab.signature.count()));
+
+        for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+        {
+            if (!prefab.signature.test(type))
+                continue;
+
+            auto const& info = mTypeInfos[type];
+            assert(info.trivial && "Only trivially copyable components can be saved.");
+
+            Write(file, uint32_t(type));
+            Write(file, uint32_t(info.size));
+            file.write(static_cast<char const*>(prefab.components[type]), std::streamsize(info.size));
+        }
+    }
+
+    return bool(file);
+}
+
+bool gamedev::PrefabStore::Load(std::filesystem::path const& filepath)
+{
+    Clear();
+
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file || !ReadFrom(file))
+    {
+        Clear();
+        return false;
+    }
+
+    return true;
+}
+
+bool gamedev::PrefabStore::ReadFrom(std::istream& file)
+{
+    uint32_t magic = 0, version = 0;
+    if (!Read(file, magic) || !Read(file, version) || magic != FileMagic || version != FileVersion)
+        return false;
+
+    uint32_t numAssets = 0;
+    if (!Read(file, numAssets))
+        return false;
+
+    for (uint32_t i = 0; i < numAssets; ++i)
+    {
+        uint32_t length = 0;
+        if (!Read(file, length))
+            return false;
+
+        std::string name(length, '\0');
+        if (!file.read(name.data(), std::streamsize(length)))
+            return false;
+
+        GetAssetId(name);
+    }
+
+    uint32_t numPrefabs = 0;
+    if (!Read(file, numPrefabs))
+        return false;
+
+    // Components are read into one buffer per type, Create() copies them into the blob
+    std::array<std::vector<std::byte>, MAX_COMPONENTS> buffers;
+
+    for (uint32_t i = 0; i < numPrefabs; ++i)
+    {
+        PrefabInstance instance;
+        uint32_t numComponents = 0;
+        if (!Read(file, instance) || !Read(file, numComponents))
+            return false;
+
+        Signature signature;
+        ComponentSources sources{};
+        for (uint32_t c = 0; c < numComponents; ++c)
+        {
+            uint32_t type = 0, size = 0;
+            if (!Read(file, type) || !Read(file, size) || type >= MAX_COMPONENTS)
+                return false;
+
+            auto const& info = mTypeInfos[type];
+            if (!info.IsValid() || !info.trivial || info.size != size)
+                return false;
+
+            buffers[type].resize(size);
+            if (!file.read(reinterpret_cast<char*>(buffers[type].data()), std::streamsize(size)))
+                return false;
+
+            signature.set(type);
+            sources[type] = buffers[type].data();
+        }
+
+        Create(instance, signature, sources);
+    }
+
+    return true;
+}
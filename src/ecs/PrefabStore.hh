@@ -0,0 +1,185 @@
+#pragma once
+#include "ecs/ComponentTypeInfo.hh"
+#include "advanced/transform.hh"
+#include "Constants.hh"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <filesystem>
+#include <iosfwd>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <assert.h>
+
+namespace gamedev
+{
+/***
+* Storage for prefabs (the presets of the factories), outside of the World and the component storage.
+*
+* A prefab is plain data: transform, bounds, the render assets by id & one compact blob holding a copy of each of its components.
+* Prefabs don't take a World slot or a row in any component array, no system or view ever sees them.
+*
+* The store does not know the World or any GPU object:
+*    - Component types are only known by their type-erased operations (see ecs/ComponentTypeInfo.hh).
+*    - Meshes & textures are referred to by asset ids (interned asset names, see GetAssetId()), the ECS resolves them
+*      into the render data of an instance when the prefab is instantiated (see EngineECS::SetAssetResolvers).
+*
+* So prefabs can be created from any component source or loaded from disk, the ECS is only needed to instantiate them:
+*    auto prefab = mECS->BakePrefab(handle, render);                // snapshot of an authored instance
+*    auto fresh_handle = mECS->Instantiate(prefab);                 // straight copy of the blob into the storage
+*    auto handles = mECS->InstantiateBatch(prefab, transforms);
+*
+*    store.Save(path);                                              // all prefabs with their components & asset names
+*    other_store.Load(path);                                        // same prefab handles, only needs the component types registered
+*
+* Prefabs are immutable, replacing one (Create() with an existing handle) does not affect instances created earlier.
+*
+***/
+
+// refers to a prefab
+struct PrefabHandle
+{
+    uint32_t _value = uint32_t(-1);
+
+    bool is_valid() const { return _value != uint32_t(-1); }
+
+    bool operator==(const PrefabHandle& handle) const { return _value == handle._value; }
+};
+
+// refers to a render asset (mesh or texture) by name, see PrefabStore::GetAssetId
+using AssetId = uint32_t;
+static constexpr AssetId NoAsset = uint32_t(-1);
+
+// mesh & material of a prefab, the counterpart of InstanceRender (see advanced/World.hh)
+struct PrefabRender
+{
+    AssetId mesh = NoAsset;
+    AssetId texAlbedo = NoAsset;
+    AssetId texNormal = NoAsset;
+    AssetId texARM = NoAsset;
+    uint32_t albedoBias = 0u;
+};
+
+// instance data of a prefab
+struct PrefabInstance
+{
+    transform xform;
+    tg::aabb3 max_bounds;
+    PrefabRender render;
+};
+
+static_assert(std::is_trivially_copyable_v<PrefabInstance>);
+
+class PrefabStore
+{
+public:
+    ~PrefabStore() { Clear(); }
+
+    // Registers the type-erased operations of a component type (done by EngineECS::RegisterComponent).
+    template <typename CompT>
+    void RegisterComponent(ComponentType type)
+    {
+        assert(type < MAX_COMPONENTS && "Too many component types.");
+        mTypeInfos[type] = ComponentTypeInfo::Create<CompT>();
+    }
+
+    // Creates a prefab from the instance data & a copy of each component in components (all types of the signature).
+    // If replace is a valid prefab, its content is exchanged instead.
+    PrefabHandle Create(PrefabInstance const& instance, Signature components, ComponentSources const& sources, PrefabHandle replace = {});
+
+    bool Contains(PrefabHandle handle) const { return handle._value < mPrefabs.size(); }
+
+    // Instance data of the prefab
+    PrefabInstance const& GetInstance(PrefabHandle handle) const { return Get(handle).instance; }
+    transform const& GetTransform(PrefabHandle handle) const { return Get(handle).instance.xform; }
+    tg::aabb3 const& GetBounds(PrefabHandle handle) const { return Get(handle).instance.max_bounds; }
+    Signature GetSignature(PrefabHandle handle) const { return Get(handle).signature; }
+
+    // Pointers into the blob of the prefab, see ComponentStorage::InstantiateComponentsBatch
+    ComponentSources const& GetComponents(PrefabHandle handle) const { return Get(handle).components; }
+
+    template <typename CompT>
+    CompT const* TryGetComponent(PrefabHandle handle, ComponentType type) const
+    {
+        return static_cast<CompT const*>(Get(handle).components[type]);
+    }
+
+    // Interns the name of a render asset (i.e. a mesh path), equal names share an id
+    AssetId GetAssetId(std::string const& name);
+    std::string const& GetAssetName(AssetId id) const
+    {
+        assert(id < mAssetNames.size() && "Retrieving non-existent asset.");
+        return mAssetNames[id];
+    }
+
+    // Writes all prefabs (instance data, asset names & component blobs) to a binary file.
+    // Components are stored as raw bytes, so only trivially copyable components can be saved.
+    bool Save(std::filesystem::path const& filepath) const;
+
+    // Replaces all prefabs by the ones of the file, the handles stay the same as when saved.
+    // Fails (and leaves the store empty) if a component type is not registered or changed its size since.
+    bool Load(std::filesystem::path const& filepath);
+
+    size_t Size() const { return mPrefabs.size(); }
+
+    void Clear()
+    {
+        for (auto& prefab : mPrefabs)
+            Destroy(prefab);
+
+        mPrefabs.clear();
+        mAssetNames.clear();
+        mAssetIds.clear();
+    }
+
+private:
+    static constexpr size_t BlobAlignment = 64;
+
+    struct BlobDeleter
+    {
+        void operator()(std::byte* ptr) const { ::operator delete(ptr, std::align_val_t(BlobAlignment)); }
+    };
+
+    using Blob = std::unique_ptr<std::byte, BlobDeleter>;
+
+    struct Prefab
+    {
+        PrefabInstance instance;
+        Signature signature;
+        ComponentSources components{}; // into blob, nullptr for types the prefab does not own
+        std::array<size_t, MAX_COMPONENTS> offsets{};
+        Blob blob;
+    };
+
+    // Reads the content of a file written by Save() (see ecs/PrefabStore.cc)
+    bool ReadFrom(std::istream& file);
+
+    Prefab const& Get(PrefabHandle handle) const
+    {
+        assert(Contains(handle) && "Retrieving non-existent prefab.");
+        return mPrefabs[handle._value];
+    }
+
+    void Destroy(Prefab& prefab)
+    {
+        for (size_t type = 0; type < MAX_COMPONENTS; ++type)
+        {
+            if (prefab.components[type])
+                mTypeInfos[type].Destroy(prefab.blob.get() + prefab.offsets[type]);
+        }
+
+        prefab.components = {};
+        prefab.blob.reset();
+    }
+
+private:
+    std::array<ComponentTypeInfo, MAX_COMPONENTS> mTypeInfos{};
+    std::vector<Prefab> mPrefabs;
+
+    std::vector<std::string> mAssetNames;
+    std::unordered_map<std::string, AssetId> mAssetIds;
+};
+}
@@ -0,0 +1,106 @@
+#include "ecs/Scheduler.hh"
+#include <algorithm>
+#include <chrono>
+
+bool gamedev::Scheduler::Job::ConflictsWith(Job const& other) const
+{
+    bool const components = (componentWrites & (other.componentReads | other.componentWrites)).any() || (other.componentWrites & componentReads).any();
+    bool const resources = (resourceWrites & (other.resourceReads | other.resourceWrites)).any() || (other.resourceWrites & resourceReads).any();
+
+    return components || resources;
+}
+
+void gamedev::Scheduler::Init(std::shared_ptr<EngineECS>& ecs, unsigned numThreads)
+{
+    mECS = ecs;
+    mThreadPool = std::make_unique<ThreadPool>(numThreads);
+}
+
+gamedev::Scheduler::Job& gamedev::Scheduler::AddSystem(std::string const& name, std::function<void(float)> const& update)
+{
+    Job job;
+    job.name = name;
+    job.update = update;
+    job.ecs = mECS.get();
+
+    mJobs.push_back(job);
+    mDirty = true;
+
+    return mJobs.back();
+}
+
+void gamedev::Scheduler::BuildStages()
+{
+    mNumStages = 0;
+
+    for (size_t j = 0; j < mJobs.size(); ++j)
+    {
+        int stage = 0;
+        for (size_t i = 0; i < j; ++i)
+        {
+            if (mJobs[j].ConflictsWith(mJobs[i]))
+                stage = std::max(stage, mJobs[i].stage + 1);
+        }
+
+        mJobs[j].stage = stage;
+        mNumStages = std::max(mNumStages, stage + 1);
+    }
+
+    mStages.assign(mNumStages, {});
+    for (size_t j = 0; j < mJobs.size(); ++j)
+        mStages[mJobs[j].stage].push_back(j);
+
+    mDirty = false;
+}
+
+void gamedev::Scheduler::RunJob(Job& job, float dt)
+{
+    auto t0 = std::chrono::steady_clock::now();
+
+    job.update(dt);
+
+    auto tn = std::chrono::steady_clock::now();
+    job.time = std::chrono::duration_cast<std::chrono::microseconds>(tn - t0).count() / 1000.f;
+    job.ran = true;
+}
+
+void gamedev::Scheduler::Update(float dt)
+{
+    auto t0 = std::chrono::steady_clock::now();
+
+    if (mDirty)
+        BuildStages();
+
+    mECS->UpdateEvents();
+
+    for (auto& job : mJobs)
+    {
+        job.ran = false;
+        job.time = 0.f;
+    }
+
+    for (auto const& stage : mStages)
+    {
+        mTasks.clear();
+
+        for (auto j : stage)
+        {
+            auto& job = mJobs[j];
+            if (job.condition && !job.condition())
+                continue;
+
+            if (mParallel)
+                mTasks.push_back([this, &job, dt] { RunJob(job, dt); });
+            else
+                RunJob(job, dt);
+        }
+
+        mThreadPool->Run(mTasks);
+
+        // Sync point: apply the structural changes recorded by this stage
+        mECS->FlushCommands();
+    }
+
+    auto tn = std::chrono::steady_clock::now();
+    mTotalTime = std::chrono::duration_cast<std::chrono::microseconds>(tn - t0).count() / 1000.f;
+}
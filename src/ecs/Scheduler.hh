@@ -0,0 +1,155 @@
+#pragma once
+#include "ecs/Engine.hh"
+#include "utility/ThreadPool.hh"
+#include "Constants.hh"
+#include <bitset>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Runs the per-frame system updates, independent systems in parallel.
+*
+* Every system is added as a job with the data it reads & writes:
+*    - Component types (by their ComponentType).
+*    - Shared state which is not a component (see Resource), e.g. the instance transforms or the spatial index.
+*
+*    mScheduler->AddSystem("Physics", [this](float dt) { mPhysicsSys->Update(dt); })
+*        .Writes<Physics>()
+*        .Reads<InTower>()
+*        .Writes(Resource::Transforms);
+*
+* Jobs are grouped into stages. A job is placed one stage after the latest earlier job it conflicts with
+* (one of them writes what the other one reads or writes). Jobs of the same stage run in parallel, stages run in order.
+* Conflicting jobs therefore always run in the order they were added, which keeps the results identical to a sequential update,
+* as long as the declarations are complete.
+*
+* Structural changes recorded in the EntityCommandBuffer are applied after every stage.
+* Event channels are swapped once per update, before the first stage (see ecs/EventChannel.hh).
+*
+***/
+
+// Shared state besides components
+enum class Resource : uint32_t
+{
+    Transforms = 0, // Instance transforms & bounds in the World
+    Structure,      // Creating/destroying instances, adding/removing components
+    Events,         // Event channels: Reads = sending (lock-free), Writes = consuming via an EventReader
+    SpatialIndex,   // Shared spatial index (EngineECS::GetHashMap)
+    Particles,      // Particle pool of the ParticleSystem
+    Environment,    // Time of day
+    Audio,          // AudioSystem (sounds triggered by gameplay)
+
+    Count
+};
+
+using ResourceSet = std::bitset<size_t(Resource::Count)>;
+
+class Scheduler
+{
+public:
+    struct Job
+    {
+        std::string name;
+        std::function<void(float)> update;
+        std::function<bool()> condition;
+
+        Signature componentReads;
+        Signature componentWrites;
+        ResourceSet resourceReads;
+        ResourceSet resourceWrites;
+
+        int stage = 0;
+        float time = 0.f; // of the last update in ms
+        bool ran = false; // during the last update
+
+        template <typename CompT>
+        Job& Reads()
+        {
+            componentReads.set(ecs->GetComponentType<CompT>());
+            return *this;
+        }
+
+        template <typename CompT>
+        Job& Writes()
+        {
+            componentWrites.set(ecs->GetComponentType<CompT>());
+            return *this;
+        }
+
+        Job& Reads(Resource r)
+        {
+            resourceReads.set(size_t(r));
+            return *this;
+        }
+
+        Job& Writes(Resource r)
+        {
+            resourceWrites.set(size_t(r));
+            return *this;
+        }
+
+        // Conflicts with every other job (e.g. systems whose events reach arbitrary listeners)
+        Job& Exclusive()
+        {
+            componentWrites.set();
+            resourceWrites.set();
+            return *this;
+        }
+
+        // The job is skipped in frames where the condition returns false
+        Job& RunIf(std::function<bool()> const& c)
+        {
+            condition = c;
+            return *this;
+        }
+
+        bool ConflictsWith(Job const& other) const;
+
+        EngineECS* ecs = nullptr;
+    };
+
+public:
+    void Init(std::shared_ptr<EngineECS>& ecs, unsigned numThreads = 0);
+
+    // The returned reference is only valid until the next AddSystem call.
+    Job& AddSystem(std::string const& name, std::function<void(float)> const& update);
+
+    // Runs all jobs (whose condition holds) stage by stage.
+    void Update(float dt);
+
+    void SetParallel(bool parallel) { mParallel = parallel; }
+    bool IsParallel() const { return mParallel; }
+
+    std::vector<Job> const& GetJobs() const { return mJobs; }
+    int GetNumStages() const { return mNumStages; }
+    unsigned GetNumThreads() const { return mThreadPool ? mThreadPool->GetNumThreads() : 1; }
+
+    // Exclusive jobs run alone on the calling thread (see ThreadPool::Run), they may hand their own work to the pool.
+    ThreadPool* GetThreadPool() const { return mThreadPool.get(); }
+
+    // Wall time of the last update in ms
+    float GetTotalTime() const { return mTotalTime; }
+
+private:
+    void BuildStages();
+    void RunJob(Job& job, float dt);
+
+private:
+    std::shared_ptr<EngineECS> mECS;
+    std::unique_ptr<ThreadPool> mThreadPool;
+
+    std::vector<Job> mJobs;
+    std::vector<std::vector<size_t>> mStages;
+    int mNumStages = 0;
+    bool mDirty = true;
+
+    bool mParallel = true;
+    float mTotalTime = 0.f;
+
+    std::vector<std::function<void()>> mTasks;
+};
+}
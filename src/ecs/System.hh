@@ -1,7 +1,8 @@
 #pragma once
 #include "advanced/World.hh"
 #include "Constants.hh"
-#include <set>
+#include "ecs/EntitySet.hh"
+#include <clean-core/span.hh>
 #include <chrono>
 
 /*** 
@@ -25,7 +26,7 @@
  *
  * System Main Class
  * Any system implementation must inherit from this class to be managed by the SystemManager of the Entity Component System.
- * By design, a system holds handles of all objects which qualify for this system in the set mEntities.
+ * By design, a system holds handles of all objects which qualify for this system in the set mEntities (see ecs/EntitySet.hh).
  * If an entity qualifies for a system, the AddEntity method is called by the system manager.
  * If an entity does not qualify, the RemoveEntity method is called.
  * Both events are always triggered, independent of whether the entity was registered for the system or not.
@@ -61,9 +62,16 @@ public:
     virtual void RemoveEntity(InstanceHandle& handle) { mEntities.erase(handle); };
     virtual void RemoveAllEntities() { mEntities.clear(); }
 
+    // Called once for a batch of new entities sharing one signature (see EngineECS::CloneInstanceBatch).
+    virtual void AddEntities(cc::span<InstanceHandle const> handles, Signature entitySignature)
+    {
+        for (auto handle : handles)
+            AddEntity(handle, entitySignature);
+    }
+
     virtual ~System() {}
 
-    // Reminder: A set is always ordered (here by handle._value) & only holds unique elements.
-    std::set<InstanceHandle> mEntities;
+    // Reminder: The set only holds unique elements, but is unordered unless mEntities.SetOrdered(true) is called.
+    EntitySet mEntities;
 };
 }
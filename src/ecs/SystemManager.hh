@@ -2,7 +2,8 @@
 #include "advanced/World.hh"
 #include "ecs/System.hh"
 #include "ecs/ComponentManager.hh"
-#include <unordered_map>
+#include "ecs/TypeId.hh"
+#include <vector>
 
 namespace gamedev
 {
@@ -13,7 +14,7 @@ namespace gamedev
  * It also is in charge of maintaining a record of registered Systems and their Signatures.
  *
  * Fun Facts:
- *    - Like the ComponentManager again the typeid(..).name() pointer is used as a unique key to map to the systems.
+ *    - Like in the ComponentManager, every System Type gets a sequential id (see ecs/TypeId.hh) which indexes the system & signature arrays.
  *
  ***/
 
@@ -24,12 +25,18 @@ public:
     template <typename SysT>
     std::shared_ptr<SysT> RegisterSystem()
     {
-        const char* typeName = typeid(SysT).name();
+        auto const type = TypeId<SystemFamily>::Id<SysT>();
 
-        assert(mSystems.find(typeName) == mSystems.end() && "Registering system more than once.");
+        if (type >= mSystems.size())
+        {
+            mSystems.resize(type + 1);
+            mSignatures.resize(type + 1);
+        }
+
+        assert(!mSystems[type] && "Registering system more than once.");
 
         auto system = std::make_shared<SysT>();
-        mSystems.insert({typeName, system});
+        mSystems[type] = system;
         return system;
     }
 
@@ -37,44 +44,44 @@ public:
     template <typename SysT>
     void SetSignature(Signature signature)
     {
-        const char* typeName = typeid(SysT).name();
+        auto const type = TypeId<SystemFamily>::Id<SysT>();
 
-        assert(mSystems.find(typeName) != mSystems.end() && "System used before registered.");
+        assert(type < mSystems.size() && mSystems[type] && "System used before registered.");
 
-        mSignatures.insert({typeName, signature});
+        mSignatures[type] = signature;
     }
 
     // Removes the destroyed Entity from all Systems if necessary.
     void EntityDestroyed(InstanceHandle handle)
     {
-        for (const auto& pair : mSystems)
+        for (const auto& system : mSystems)
         {
-            const auto& system = pair.second;
-
-            system->RemoveEntity(handle);
+            if (system)
+                system->RemoveEntity(handle);
         }
     }
 
     // Notifies all systems, that all entities have been destroyed.
     void AllEntitiesDestroyed()
     {
-        for (const auto& pair : mSystems)
+        for (const auto& system : mSystems)
         {
-            const auto& system = pair.second;
-
-            system->RemoveAllEntities();
+            if (system)
+                system->RemoveAllEntities();
         }
     }
 
     // Checks the (new) Entity Signature against all System Signatures to add or remove them from Systems.
     void EntitySignatureChanged(InstanceHandle handle, Signature entitySignature)
     {
-        for (const auto& pair : mSystems)
+        for (size_t type = 0; type < mSystems.size(); ++type)
         {
-            const auto& type = pair.first;
-            const auto& system = pair.second;
+            const auto& system = mSystems[type];
             const auto& systemSignature = mSignatures[type];
 
+            if (!system)
+                continue;
+
             if ((entitySignature & systemSignature) == systemSignature)
             {
                 system->AddEntity(handle, entitySignature);
@@ -86,9 +93,26 @@ public:
         }
     }
 
+    // Adds a batch of new Entities sharing one Signature to all qualifying Systems, each System Signature is tested once.
+    // The entities are new, so Systems they do not qualify for are not notified.
+    void EntitiesCreated(cc::span<InstanceHandle const> handles, Signature entitySignature)
+    {
+        for (size_t type = 0; type < mSystems.size(); ++type)
+        {
+            const auto& system = mSystems[type];
+            const auto& systemSignature = mSignatures[type];
+
+            if (system && (entitySignature & systemSignature) == systemSignature)
+                system->AddEntities(handles, entitySignature);
+        }
+    }
+
 private:
-    // Map typeid(..).name() to a Signature
-    std::unordered_map<const char*, Signature> mSignatures{};
-    std::unordered_map<const char*, std::shared_ptr<System>> mSystems{};
+    // Tag for the system type ids
+    struct SystemFamily;
+
+    // Signatures & systems indexed by system type id
+    std::vector<Signature> mSignatures{};
+    std::vector<std::shared_ptr<System>> mSystems{};
 };
 }
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+
+namespace gamedev
+{
+/***
+* Sequential ids per type, one counter per Family.
+*
+* Every Id<T>() instantiation owns a function-local static which is initialized exactly once from the family counter.
+* After that, looking up the id of a type is a plain static read (no typeid(..).name() hashing or map lookup).
+* Ids are dense (0, 1, 2, ...), in order of the first request per type, so they can index flat arrays.
+*
+*    struct ComponentFamily;
+*    size_t id = TypeId<ComponentFamily>::Id<Transform>();
+*
+***/
+template <typename Family>
+class TypeId
+{
+public:
+    template <typename T>
+    static std::size_t Id()
+    {
+        static const std::size_t id = sNext++;
+        return id;
+    }
+
+    // Amount of ids handed out so far.
+    static std::size_t Count() { return sNext; }
+
+private:
+    static inline std::atomic<std::size_t> sNext{0};
+};
+}
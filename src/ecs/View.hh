@@ -0,0 +1,92 @@
+#pragma once
+#include "ecs/ComponentArray.hh"
+#include "advanced/World.hh"
+#include <tuple>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* A View iterates all instances which own every component of Ts... and none of Xs...
+*
+* Usage:
+*    mECS->View<Living, Attacker, Physics>(Exclude<InTower>{}).each(
+*        [&](InstanceHandle handle, Living& living, Attacker& attacker, Physics& physics) { ... });
+*
+* Iteration is driven by the smallest of the included component arrays, all other components are
+* fetched by O(1) sparse-set lookups. No per-system entity list is needed.
+*
+* The driving array is walked back to front:
+*    - Components added during iteration are appended and therefore not visited this time.
+*    - Removing the current instance's components moves an already visited element into its slot.
+*
+***/
+
+// Marker for the components an instance must not have.
+template <typename... Xs>
+struct Exclude
+{
+};
+
+template <typename Include, typename Excl>
+class ComponentView;
+
+template <typename... Ts, typename... Xs>
+class ComponentView<std::tuple<Ts...>, Exclude<Xs...>>
+{
+    static_assert(sizeof...(Ts) > 0, "A view needs at least one component type.");
+
+public:
+    ComponentView(ComponentArray<Ts>*... included, ComponentArray<Xs>*... excluded) : mIncluded(included...), mExcluded(excluded...) {}
+
+    // Calls func(InstanceHandle, Ts&...) for every matching instance.
+    template <typename Func>
+    void each(Func&& func)
+    {
+        const std::vector<InstanceHandle>& handles = SmallestHandles();
+
+        for (size_t i = handles.size(); i-- > 0;)
+        {
+            // Components may have been removed in the meantime
+            if (i >= handles.size())
+                continue;
+
+            InstanceHandle const handle = handles[i];
+
+            if (!Matches(handle))
+                continue;
+
+            func(handle, *std::get<ComponentArray<Ts>*>(mIncluded)->TryGetData(handle)...);
+        }
+    }
+
+    // True if the instance owns all included and none of the excluded components.
+    bool Matches(InstanceHandle handle) const
+    {
+        bool const hasAll = (std::get<ComponentArray<Ts>*>(mIncluded)->Contains(handle) && ...);
+        bool const hasExcluded = (false || ... || std::get<ComponentArray<Xs>*>(mExcluded)->Contains(handle));
+
+        return hasAll && !hasExcluded;
+    }
+
+    // Upper bound of visited instances (size of the driving array).
+    size_t SizeHint() const { return SmallestHandles().size(); }
+
+private:
+    const std::vector<InstanceHandle>& SmallestHandles() const
+    {
+        const std::vector<InstanceHandle>* smallest = nullptr;
+
+        ((smallest = (!smallest || std::get<ComponentArray<Ts>*>(mIncluded)->Handles().size() < smallest->size())
+                         ? &std::get<ComponentArray<Ts>*>(mIncluded)->Handles()
+                         : smallest),
+         ...);
+
+        return *smallest;
+    }
+
+private:
+    std::tuple<ComponentArray<Ts>*...> mIncluded;
+    std::tuple<ComponentArray<Xs>*...> mExcluded;
+};
+}
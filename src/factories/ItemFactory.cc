@@ -16,7 +16,7 @@ void gamedev::ItemFactory::InitResources()
 void gamedev::ItemFactory::Init_Arrow()
 {
     auto handle = mIDToPreset[mObjectNameToID["arrow"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -38,7 +38,6 @@ void gamedev::ItemFactory::Init_Arrow()
 void gamedev::ItemFactory::Init_Bow()
 {
     auto handle = mIDToPreset[mObjectNameToID["bow"]];
-    auto& instance = mECS->GetInstance(handle);
 
     auto animated = mECS->CreateComponent<gamedev::Animated>(handle);
 }
@@ -146,7 +146,7 @@ void gamedev::StructureFactory::Init_StartingBonfire()
     Register("bonfire", "starting_bonfire", false, 0.5);
 
     auto handle = mIDToPreset[mObjectNameToID["starting_bonfire"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -179,7 +179,7 @@ void gamedev::StructureFactory::Init_StartingBonfire()
     light->shadowing = true;
 
     // Particles: Fire
-    particles->pp.resize(2);
+    particles->numProperties = 2;
     particles->pp[0].baseColor = tg::color3(255, 108, 33) / 255;
     particles->pp[0].baseLife = 0.8;
     particles->pp[0].basePosition = tg::pos3(0.0, -0.2, 0.0);
@@ -207,7 +207,7 @@ void gamedev::StructureFactory::Init_StartingBonfire()
 void gamedev::StructureFactory::Init_aLantern()
 {
     auto handle = mIDToPreset[mObjectNameToID["astreetlantern"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -242,7 +242,7 @@ void gamedev::StructureFactory::Init_aLantern()
 void gamedev::StructureFactory::Init_RegularBonfire()
 {
     auto handle = mIDToPreset[mObjectNameToID["bonfire"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -274,7 +274,7 @@ void gamedev::StructureFactory::Init_RegularBonfire()
     light->pl.radius = 3.0;
 
     // Particles: Fire
-    particles->pp.resize(2);
+    particles->numProperties = 2;
     particles->pp[0].baseColor = tg::color3(255, 108, 33) / 255;
     particles->pp[0].baseLife = 0.5;
     particles->pp[0].basePosition = tg::pos3(0.0, -0.2, 0.0);
@@ -301,7 +301,7 @@ void gamedev::StructureFactory::Init_RegularBonfire()
 void gamedev::StructureFactory::Init_Tower()
 {
     auto handle = mIDToPreset[mObjectNameToID["tower0"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -329,7 +329,7 @@ void gamedev::StructureFactory::Init_Tower()
 void gamedev::StructureFactory::Init_Forge() 
 {
     auto handle = mIDToPreset[mObjectNameToID["forge"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -355,7 +355,7 @@ void gamedev::StructureFactory::Init_Forge()
     collider->dynamic = false;
 
     // Particles: Fire
-    particles->pp.resize(2);
+    particles->numProperties = 2;
     particles->pp[0].baseColor = tg::color3(255, 51, 0) / 255;
     particles->pp[0].baseLife = 0.5;
     particles->pp[0].basePosition = tg::pos3(-2.2, 0.52, -1.72);
@@ -387,7 +387,7 @@ void gamedev::StructureFactory::Init_aFences()
     for (const auto& n : names)
     {
         auto handle = mIDToPreset[mObjectNameToID[n]];
-        auto& instance = mECS->GetInstance(handle);
+        auto instance = mECS->GetInstance(handle);
 
         mECS->RemoveAllComponents(handle);
 
@@ -416,7 +416,7 @@ void gamedev::StructureFactory::Init_aFences()
 void gamedev::StructureFactory::Init_aStonewall()
 {
   auto handle = mIDToPreset[mObjectNameToID["astonewall"]];
-  auto& instance = mECS->GetInstance(handle);
+  auto instance = mECS->GetInstance(handle);
   
   mECS->RemoveAllComponents(handle);
   
@@ -447,7 +447,7 @@ void gamedev::StructureFactory::Init_aStoneGate()
     std::string id = "astonegate";
 
     auto handle = mIDToPreset[mObjectNameToID[id]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -474,7 +474,7 @@ void gamedev::StructureFactory::Init_aStonePillar()
     std::string id = "astonepillar";
 
     auto handle = mIDToPreset[mObjectNameToID[id]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -504,7 +504,7 @@ void gamedev::StructureFactory::Init_aSpikeBarriers()
     std::string id = "aspikebarriers";
 
     auto handle = mIDToPreset[mObjectNameToID[id]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -534,7 +534,7 @@ void gamedev::StructureFactory::Init_aWagon()
     std::string id = "awagon";
 
     auto handle = mIDToPreset[mObjectNameToID[id]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -560,7 +560,7 @@ void gamedev::StructureFactory::Init_aBanner()
     std::string id = "abanner";
 
     auto handle = mIDToPreset[mObjectNameToID[id]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -589,7 +589,7 @@ void gamedev::StructureFactory::Init_Streets()
     for (const auto& n : names)
     {
         auto handle = mIDToPreset[mObjectNameToID[n]];
-        auto& instance = mECS->GetInstance(handle);
+        auto instance = mECS->GetInstance(handle);
 
         mECS->RemoveAllComponents(handle);
 
@@ -609,7 +609,7 @@ void gamedev::StructureFactory::Init_WatchTowers()
     for (const auto& n : names)
     {
         auto handle = mIDToPreset[mObjectNameToID[n]];
-        auto& instance = mECS->GetInstance(handle);
+        auto instance = mECS->GetInstance(handle);
 
         mECS->RemoveAllComponents(handle);
 
@@ -636,7 +636,7 @@ void gamedev::StructureFactory::Init_WatchTowers()
 void gamedev::StructureFactory::Init_Stonefence()
 {
     auto handle = mIDToPreset[mObjectNameToID["astonefence0"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -1,6 +1,7 @@
 #include "factories/UnitFactory.hh"
 #include "utility/misc.hh"
 #include <glow/common/log.hh>
+#include <cstring>
 
 // All units can be rendered
 void gamedev::UnitFactory::PostProcessRegistration(InstanceHandle presetHandle)
@@ -55,7 +56,7 @@ gamedev::InstanceHandle gamedev::UnitFactory::Register(std::string asset_identif
     std::string u_name = lowerString(unit_identifier);
 
     auto handle = Factory::Register(a_name, u_name, scaling);
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     auto renderable = mECS->CreateComponent<Render>(handle);
 
@@ -94,7 +95,7 @@ gamedev::InstanceHandle gamedev::UnitFactory::Register(std::string asset_identif
     std::string u_name = lowerString(unit_identifier);
 
     auto handle = Factory::Register(a_name, u_name, unit_path, scaling);
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     auto renderable = mECS->CreateComponent<Render>(handle);
 
@@ -138,7 +139,7 @@ void gamedev::UnitFactory::RegisterAutomatically(std::vector<std::string> asset_
 void gamedev::UnitFactory::Init_Monster()
 {
     auto handle = mIDToPreset[mObjectNameToID["creature"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -166,7 +167,7 @@ void gamedev::UnitFactory::Init_Monster()
     collider->dynamic = true;
 
     // Evil
-    lifeform->name = "Algaz";
+    std::strncpy(lifeform->name, "Algaz", Living::MaxName - 1);
     lifeform->idle= 0.0;
     lifeform->friendly = false;
 
@@ -187,7 +188,7 @@ void gamedev::UnitFactory::Init_Monster()
 void gamedev::UnitFactory::Init_Person()
 {
     auto handle = mIDToPreset[mObjectNameToID["person"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -214,7 +215,7 @@ void gamedev::UnitFactory::Init_Person()
     collider->dynamic = true;
 
     // Friendly
-    lifeform->name = "Hans";
+    std::strncpy(lifeform->name, "Hans", Living::MaxName - 1);
     lifeform->idle = 0.0;
     lifeform->friendly = true;
 
@@ -229,7 +230,7 @@ void gamedev::UnitFactory::Init_Person()
 void gamedev::UnitFactory::Init_Artisan()
 {
     auto handle = mIDToPreset[mObjectNameToID["person_artisan"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -258,7 +259,7 @@ void gamedev::UnitFactory::Init_Artisan()
     collider->dynamic = true;
 
     // Friendly
-    lifeform->name = "Jrgen";
+    std::strncpy(lifeform->name, "Jrgen", Living::MaxName - 1);
     lifeform->idle = 0.0;
     lifeform->friendly = true;
 
@@ -276,7 +277,7 @@ void gamedev::UnitFactory::Init_Artisan()
 void gamedev::UnitFactory::Init_Soldier() 
 {
     auto handle = mIDToPreset[mObjectNameToID["person_soldier"]];
-    auto& instance = mECS->GetInstance(handle);
+    auto instance = mECS->GetInstance(handle);
 
     mECS->RemoveAllComponents(handle);
 
@@ -306,7 +307,7 @@ void gamedev::UnitFactory::Init_Soldier()
     collider->dynamic = true;
 
     // Friendly
-    lifeform->name = "Siegbert";
+    std::strncpy(lifeform->name, "Siegbert", Living::MaxName - 1);
     lifeform->idle = 0.0;
     lifeform->friendly = true;
 
@@ -318,27 +318,27 @@ void gamedev::RenderSystem::RenderInstances(glow::UsedProgram& shader)
         //if (mECS->TestSignature<Arrow>(handle))
         //    continue;
 
-        gamedev::Instance const& instance = mECS->GetInstance(handle);
+        gamedev::InstanceRender const& render = mECS->GetInstanceRender(handle);
 
         // bind the textures
-        shader["uTexAlbedo"] = instance.texAlbedo;
+        shader["uTexAlbedo"] = render.texAlbedo;
 
         // compute and upload the model matrix
-        tg::mat4x3 const modelMatrix = instance.xform.transform_mat();
+        tg::mat4x3 const modelMatrix = mECS->GetInstanceTransform(handle).transform_mat();
         shader["uModel"] = modelMatrix;
 
         // set the instance handle value so it can be written to the picking buffer
         shader["uPickingID"] = handle._value;
 
         // set the color bias
-        shader["uAlbedoBiasPacked"] = instance.albedoBias;
+        shader["uAlbedoBiasPacked"] = render.albedoBias;
 
         // bind and draw the mesh
-        instance.vao->bind().draw();
+        render.vao->bind().draw();
 
         // do the same for auxiliary meshes if existent
-        if (!instance.auxModels.empty())
-          RenderAuxiliary(shader, instance, modelMatrix);
+        if (!render.auxModels.empty())
+          RenderAuxiliary(shader, render, modelMatrix);
     }
 
     mDrawCalls += mEntities.size();
@@ -356,22 +356,20 @@ void gamedev::RenderSystem::RenderDepth(glow::UsedProgram& shader)
         // if (mECS->TestSignature<Arrow>(handle))
         //     continue;
 
-        gamedev::Instance const& instance = mECS->GetInstance(handle);
-
         // compute and upload the model matrix
-        tg::mat4x3 const modelMatrix = instance.xform.transform_mat();
+        tg::mat4x3 const modelMatrix = mECS->GetInstanceTransform(handle).transform_mat();
         shader["uModel"] = modelMatrix;
 
         // bind and draw the mesh
-        instance.vao->bind().draw();
+        mECS->GetInstanceRender(handle).vao->bind().draw();
     }
 
     mDrawCalls += mEntities.size();
 }
 
-void gamedev::RenderSystem::RenderAuxiliary(glow::UsedProgram& shader, const Instance& instance, const tg::mat4x3& parentTransform)
+void gamedev::RenderSystem::RenderAuxiliary(glow::UsedProgram& shader, const InstanceRender& render, const tg::mat4x3& parentTransform)
 {
-    for (const auto& model : instance.auxModels)
+    for (const auto& model : render.auxModels)
     {
         glow::info() << "Here should be nothing!";
 
@@ -389,7 +387,7 @@ void gamedev::RenderSystem::RenderAuxiliary(glow::UsedProgram& shader, const Ins
         model.vao->bind().draw();
     }
 
-    mDrawCalls += instance.auxModels.size();
+    mDrawCalls += render.auxModels.size();
 }
 
 void gamedev::RenderSystem::RenderBackground()
@@ -545,6 +543,26 @@ tg::pos3 gamedev::RenderSystem::MouseToWorld(int x, int y)
     return tg::pos3(p);
 }
 
+tg::segment3 gamedev::RenderSystem::MouseToRay(int x, int y) const
+{
+    // Camera of the last rendered frame, like the picking & depth buffers
+    auto const invViewProj = tg::inverse(mProj * mView);
+
+    tg::vec4 p;
+    p.x = (x + 0.5f) / float(mResolution.width) * 2 - 1;
+    p.y = (y + 0.5f) / float(mResolution.height) * 2 - 1;
+    p.w = 1.0;
+
+    auto const unproject = [&](float z)
+    {
+        p.z = z;
+        auto const q = invViewProj * p;
+        return tg::pos3(q / q.w);
+    };
+
+    return {unproject(-1.f), unproject(1.f)};
+}
+
 void gamedev::RenderSystem::RenderDepthCubemap()
 {
     float shadowNear = 0.01f;
@@ -676,13 +694,11 @@ void gamedev::RenderSystem::RenderOutline(InstanceHandle handle, const tg::vec4&
     shader["uProj"] = mProj;
     shader["uView"] = mView;
 
-    auto const& instance = mECS->GetInstance(handle);
-
-    tg::mat4x3 const modelMatrix = instance.xform.transform_mat();
+    tg::mat4x3 const modelMatrix = mECS->GetInstanceTransform(handle).transform_mat();
     shader["uModel"] = modelMatrix;
     shader["uColor"] = color;
 
-    instance.vao->bind().draw();
+    mECS->GetInstanceRender(handle).vao->bind().draw();
 
     mDrawCalls++;
 }
@@ -35,6 +35,8 @@ public:
     void ResizeRenderTargets(int w, int h);
     InstanceHandle ReadPickingBuffer(int x, int y);
     tg::pos3 MouseToWorld(int x, int y);
+    // Segment from the near to the far plane through the pixel, no readback (see utility/Raycast.hh)
+    tg::segment3 MouseToRay(int x, int y) const;
     glow::UsedProgram GetParticleShader();
     glow::SharedFramebuffer& GetParticleFramebuffer();
 
@@ -88,7 +90,7 @@ public:
 private:
     // Renders all submeshes of a model.
     // Not the best approach, but introduced to keep the initial structure
-    void RenderAuxiliary(glow::UsedProgram& shader, const Instance& instance, const tg::mat4x3& parentTransform);
+    void RenderAuxiliary(glow::UsedProgram& shader, const InstanceRender& render, const tg::mat4x3& parentTransform);
 
 private:
     void CreateGFXResources();
@@ -1,34 +1,23 @@
 #include "systems/AnimationSystem.hh"
 #include "advanced/transform.hh"
+#include "utility/Raycast.hh"
 #include "glow/common/log.hh"
 
 void gamedev::AnimationSystem::AddEntity(InstanceHandle& handle, Signature entitySignature)
 {
-    if (entitySignature.test(mECS->GetComponentType<Arrow>()))
-    {
-        mArrows.insert(handle);
-        mEntities.erase(handle);
-    }
-    else
-    {
-        mEntities.insert(handle);
-        mArrows.erase(handle);
-    }
+    mEntities.insert(handle);
 }
 
 void gamedev::AnimationSystem::RemoveEntity(InstanceHandle& handle, Signature entitySignature) {
-    mArrows.erase(handle);
     mEntities.erase(handle);
 }
 
 void gamedev::AnimationSystem::RemoveEntity(InstanceHandle& handle) {
-    mArrows.erase(handle);
     mEntities.erase(handle);
 }
 
 void gamedev::AnimationSystem::RemoveAllEntities()
 {
-    mArrows.clear();
     mEntities.clear();
 }
 
@@ -40,69 +29,80 @@ int gamedev::AnimationSystem::Update(float dt)
 {
     auto t0 = std::chrono::steady_clock::now();
 
-    for (const auto& handle : mArrows)
+    mECS->View<Arrow, Animated>().each([&](InstanceHandle handle, Arrow& arrow, Animated&)
     {
-        auto arrow = mECS->TryGetComponent<Arrow>(handle);
+        auto& xform = mECS->GetInstanceTransform(handle);
 
-        if (arrow)
+        // Lifetime
+        if (arrow.lifetime < 0)
         {
-            auto& instance = mECS->GetInstance(handle);
+            mECS->GetCommandBuffer().DestroyInstance(handle);
+            return;
+        }
+        arrow.lifetime -= dt;
 
-            // Lifetime
-            if (arrow->lifetime < 0)
-            {
-                mECS->MarkDestruction(handle);
-                continue;
-            }
-            arrow->lifetime -= dt;
+        // Orientation
+        auto physics = mECS->TryGetComponent<Physics>(handle);
+        if (physics)
+        {
+            AlignTrajectory(xform, physics);
+            mECS->MarkTransformChanged(handle);
+        }
 
-            // Orientation
-            auto physics = mECS->TryGetComponent<Physics>(handle);
-            if (physics)
-            {
-                AlignTrajectory(instance, physics);
-            }
+        // Collision, swept since the last frame so fast arrows can't pass through at large time steps.
+        // The first unit of the targets side in the path is hit.
+        auto const position = tg::pos3(xform.translation);
+        if (mECS->IsLiveHandle(arrow.target))
+        {
+            auto const side = mECS->GetHashMap().GetCategories(arrow.target) & (SpatialFriendly | SpatialHostile);
+            auto const from = arrow.hasLastPosition ? arrow.lastPosition : position;
 
-            // Collision
-            if (mECS->IsLiveHandle(arrow->target))
+            RaycastHit hit;
+            if (RaycastInstances(*mECS, {from, position}, ArrowRadius, SpatialUnit | side, mCandidates, hit))
             {
-                auto& target = mECS->GetInstance(arrow->target);
-                if (tg::distance_sqr(instance.xform.translation, target.xform.translation) < 0.1)
-                {
-                    Event e(EventType::ArrowHit, handle, arrow->target);
-                    mECS->SendFunctionalEvent(e);
-                }
+                mECS->SendEvent(ArrowHitEvent{handle, hit.handle, arrow.shotBy, arrow.damage});
+                arrow.target = {std::uint32_t(-1)}; // hits once, until it is destroyed
             }
         }
-    }
+        arrow.lastPosition = position;
+        arrow.hasLastPosition = true;
+    });
 
-    for (const auto& handle : mEntities)
+    mECS->View<Animated>(Exclude<Arrow>{}).each([&](InstanceHandle handle, Animated& animation)
     {
-        auto animation = mECS->GetComponent<Animated>(handle);
-        auto& instance = mECS->GetInstance(handle);
+        auto& xform = mECS->GetInstanceTransform(handle);
 
-        Rotate(instance, animation, dt);
-        Scale(instance, animation, dt);
-    }
+        auto const rotated = Rotate(xform, &animation, dt);
+        auto const scaled = Scale(xform, &animation, dt);
+
+        // Carried items and turning units have to move in the spatial index as well
+        if (rotated || scaled)
+            mECS->MarkTransformChanged(handle);
+    });
 
     auto tn = std::chrono::steady_clock::now();
     return std::chrono::duration_cast<std::chrono::microseconds>(tn - t0).count();
 }
 
-void gamedev::AnimationSystem::AlignTrajectory(Instance& instance, Physics* physics)
+void gamedev::AnimationSystem::AlignTrajectory(transform& xform, Physics* physics)
 {
-    auto angle = tg::acos(tg::dot(instance.xform.rotation_quat_x() * instance.xform.global_forward(), tg::normalize(tg::vec3(0.0f, physics->arc_ySlope, 1.f))));
-    instance.xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_x, angle));
+    auto angle = tg::acos(tg::dot(xform.rotation_quat_x() * xform.global_forward(), tg::normalize(tg::vec3(0.0f, physics->arc_ySlope, 1.f))));
+    xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_x, angle));
 }
 
-void gamedev::AnimationSystem::Rotate(Instance& instance, Animated* subject, float dt)
+bool gamedev::AnimationSystem::Rotate(transform& xform, Animated* subject, float dt)
 {
     auto rotate = 0_deg;
+    auto changed = false;
 
     if (subject->rotQuatAnim)
     {
+        auto const before = xform.rotation;
         auto alpha = tg::saturate(subject->rot_speed * dt);
-        instance.xform.inaccurate_lerp_to_rotation(subject->rot_quat, alpha);
+        xform.inaccurate_lerp_to_rotation(subject->rot_quat, alpha);
+
+        auto const& after = xform.rotation;
+        changed = tg::abs(after.x - before.x) + tg::abs(after.y - before.y) + tg::abs(after.z - before.z) + tg::abs(after.w - before.w) > RotationEpsilon;
     }
 
     if (subject->rotXAnim)
@@ -124,7 +124,8 @@ void gamedev::AnimationSystem::Rotate(Instance& instance, Animated* subject, flo
                 subject->rotXAnim = false;
         }
 
-        instance.xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_x, rotate));
+        xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_x, rotate));
+        changed = true;
     }
 
     if (subject->rotYAnim)
@@ -146,7 +147,8 @@ void gamedev::AnimationSystem::Rotate(Instance& instance, Animated* subject, flo
                 subject->rotYAnim = false;
         }
 
-        instance.xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_y, rotate));
+        xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_y, rotate));
+        changed = true;
     }
     
     if (subject->rotZAnim)
@@ -168,17 +170,19 @@ void gamedev::AnimationSystem::Rotate(Instance& instance, Animated* subject, flo
                 subject->rotZAnim = false;
         }
 
-        instance.xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_z, rotate));
+        xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_z, rotate));
+        changed = true;
     }
+
+    return changed;
 }
 
-void gamedev::AnimationSystem::Scale(Instance& instance, Animated* subject, float dt)
+bool gamedev::AnimationSystem::Scale(transform& xform, Animated* subject, float dt)
 {
     if (!subject->scaleAnim)
-        return;
+        return false;
 
-    auto& xform = instance.xform;
-    auto currentScale = instance.xform.scaling.depth;
+    auto currentScale = xform.scaling.depth;
     auto scaleLeft = subject->scale - currentScale;
 
     auto scale = 0.f;
@@ -189,7 +193,7 @@ void gamedev::AnimationSystem::Scale(Instance& instance, Animated* subject, floa
         if (scaleLeft >= 0.f)
         {
             subject->scaleAnim = false;
-            return;
+            return false;
         }
 
         scale = tg::max(scaleLeft, -1.f * dt);
@@ -200,13 +204,14 @@ void gamedev::AnimationSystem::Scale(Instance& instance, Animated* subject, floa
         if (scaleLeft <= 0.f)
         {
             subject->scaleAnim = false;
-            return;
+            return false;
         }
 
         scale = tg::min(scaleLeft, 1.f * dt);
     }
 
     xform.scaling += scale;
+    return true;
 }
 
 void gamedev::AnimationSystem::Wiggle(Living* subject, float dt)
@@ -4,6 +4,8 @@
 #include "advanced/World.hh"
 #include "ecs/System.hh"
 #include "ecs/Engine.hh"
+#include "utility/HashData.hh"
+#include <vector>
 
 namespace gamedev
 {
@@ -19,16 +21,18 @@ public:
 
     int Update(float dt);
 
-    void Rotate(Instance& instance, Animated* subject, float dt);
-    void Scale(Instance& instance, Animated* subject, float dt);
+    // Both return whether the transform changed, so the spatial index only follows actual motion
+    bool Rotate(transform& xform, Animated* subject, float dt);
+    bool Scale(transform& xform, Animated* subject, float dt);
     void Wiggle(Living* subject, float dt);
-    void AlignTrajectory(Instance& instance, Physics* physics);
+    void AlignTrajectory(transform& xform, Physics* physics);
 
 private:
-    std::shared_ptr<EngineECS> mECS;
+    static constexpr float ArrowRadius = 0.05f;
+    static constexpr float RotationEpsilon = 1e-5f; // a converged quaternion lerp still jitters in the last bits
 
-    std::set<InstanceHandle> mArrows;
-    std::set<InstanceHandle> mLiving;
+    std::shared_ptr<EngineECS> mECS;
+    std::vector<SpatialRayHit> mCandidates;
 };
 }
 
@@ -136,7 +136,7 @@ void gamedev::AudioSystem::UpdateSoundState(InstanceHandle handle, float dt)
         }
         else
         {
-            auto& instance = mECS->GetInstance(handle);
+            auto instance = mECS->GetInstance(handle);
             position = instance.xform.translation;
         }
 
@@ -352,7 +352,7 @@ void gamedev::AudioSystem::PlayLocalSound(InstanceHandle handle, std::string nam
 void gamedev::AudioSystem::PlayLocalSound(tg::pos3 position, std::string name, SoundType type, float volume, bool looping, float minRadius, float maxRadius, SoundPriority priority)
 {
     auto emitter = mECS->CreateInstance(NULL, NULL, NULL, NULL);
-    auto& instance = mECS->GetInstance(emitter);
+    auto instance = mECS->GetInstance(emitter);
     instance.xform.translation = tg::vec3(position);
 
     auto sound = mECS->CreateComponent<gamedev::SoundEmitter>(emitter);
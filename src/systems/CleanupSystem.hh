@@ -1,29 +0,0 @@
-#pragma once
-
-#include <glow/fwd.hh>
-#include "advanced/World.hh"
-#include "ecs/System.hh"
-#include "ecs/Engine.hh"
-#include "Terrain.hh"
-
-#include <array>
-
-namespace gamedev
-{
-class CleanupSystem : public System
-{
-public:
-    void Init(std::shared_ptr<EngineECS>& ecs);
-
-    void AddEntity(InstanceHandle& handle, Signature entitySignature);
-    void RemoveEntity(InstanceHandle& handle, Signature entitySignature);
-    void RemoveEntity(InstanceHandle& handle);
-    void RemoveAllEntities();
-
-    int Update();
-
-private:
-    std::shared_ptr<EngineECS> mECS;
-};
-}
-
@@ -3,35 +3,41 @@
 
 void gamedev::CollisionSystem::AddEntity(InstanceHandle& handle, Signature entitySignature)
 {
-    if (mECS->GetComponent<Collider>(handle)->dynamic)
+    bool const dynamic = mECS->GetComponent<Collider>(handle)->dynamic;
+
+    if (dynamic)
     {
         mDynamicEntities.insert(handle);
-
         mStaticEntities.erase(handle);
-
-        auto instance = mECS->GetInstance(handle);
-        mDynamicColliderHashMap.AddInstance(handle, instance.xform.translation, instance.max_bounds);
-        mStaticColliderHashMap.RemoveInstance(handle);
     }
     else
     {
         mStaticEntities.insert(handle);
-
         mDynamicEntities.erase(handle);
+    }
 
-        auto instance = mECS->GetInstance(handle);
-        mStaticColliderHashMap.AddInstance(handle, instance.xform.translation, instance.max_bounds);
-        mDynamicColliderHashMap.RemoveInstance(handle);
+    // The broadphase & the static grid are filled by UpdateSpatialIndex (Added<Collider>), colliders which already live
+    // in one of them switch sides
+    if (dynamic && mStaticColliders.Contains(handle))
+    {
+        mStaticColliders.Remove(handle);
+        mBroadphase.Add(handle, BoundsOf_(handle), true);
     }
+    else if (!dynamic && mBroadphase.Contains(handle))
+    {
+        mBroadphase.Remove(handle);
+        mStaticColliders.Add(handle, BoundsOf_(handle), ShapeOf_(handle));
+    }
+
+    SetColliderCategory_(handle, dynamic ? SpatialDynamic : SpatialStatic);
+
+    if (dynamic)
+        Wake_(handle);
 }
 
 void gamedev::CollisionSystem::RemoveEntity(InstanceHandle& handle, Signature entitySignature)
 {
-    mDynamicEntities.erase(handle);
-    mStaticEntities.erase(handle);
-
-    mStaticColliderHashMap.RemoveInstance(handle);
-    mDynamicColliderHashMap.RemoveInstance(handle);
+    RemoveEntity(handle);
 }
 
 void gamedev::CollisionSystem::RemoveEntity(InstanceHandle& handle)
@@ -39,8 +45,9 @@ void gamedev::CollisionSystem::RemoveEntity(InstanceHandle& handle)
     mDynamicEntities.erase(handle);
     mStaticEntities.erase(handle);
 
-    mStaticColliderHashMap.RemoveInstance(handle);
-    mDynamicColliderHashMap.RemoveInstance(handle);
+    mBroadphase.Remove(handle);
+    mStaticColliders.Remove(handle);
+    SetColliderCategory_(handle, 0);
 }
 
 void gamedev::CollisionSystem::RemoveAllEntities()
@@ -48,214 +55,327 @@ void gamedev::CollisionSystem::RemoveAllEntities()
     mDynamicEntities.clear();
     mStaticEntities.clear();
 
-    mStaticColliderHashMap.Clear();
-    mDynamicColliderHashMap.Clear();
+    mBroadphase.Clear();
+    mStaticColliders.Clear();
 }
 
 void gamedev::CollisionSystem::Init(std::shared_ptr<EngineECS>& ecs)
 {
     mECS = ecs;
 
-    mDynamicColliderHashMap.Init(tg::size2::unit, tg::aabb3::unit_from_zero);
-    mStaticColliderHashMap.Init(tg::size2::unit, tg::aabb3::unit_from_zero);
+    mAddedColliders = mECS->Query(Added<Collider>{});
+    mMovedInstances = mECS->Query(Changed<transform>{});
+}
+
+
+int gamedev::CollisionSystem::Update(float dt)
+{
+    auto t0 = std::chrono::steady_clock::now();
+
+    UpdateSpatialIndex();
+    ResolveCollisions();
 
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::NewPosition, CollisionSystem::PositionListener));
+    auto tn = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::microseconds>(tn - t0).count();
 }
 
-void gamedev::CollisionSystem::Init(std::shared_ptr<EngineECS>& ecs, tg::aabb3 map_bounds)
+void gamedev::CollisionSystem::SetColliderCategory_(InstanceHandle handle, SpatialMask category)
 {
-    mECS = ecs;
+    auto& index = mECS->GetHashMap();
+    if (!index.Contains(handle))
+        return;
 
-    auto size = tg::size_of(map_bounds);
+    auto const categories = (index.GetCategories(handle) & ~(SpatialStatic | SpatialDynamic)) | category;
+    if (categories != index.GetCategories(handle))
+        index.SetCategories(handle, categories);
+}
 
-    mDynamicColliderHashMap.Init({size.width, size.depth}, map_bounds);
-    mStaticColliderHashMap.Init({size.width, size.depth}, map_bounds);
+void gamedev::CollisionSystem::Wake_(InstanceHandle handle)
+{
+    auto const index = handle.index();
+    if (index >= mLastActive.size())
+        mLastActive.resize(index + 1, 0);
 
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::NewPosition, CollisionSystem::PositionListener));
+    mLastActive[index] = mFrame;
 }
 
+bool gamedev::CollisionSystem::IsAsleep_(InstanceHandle handle) const
+{
+    auto const index = handle.index();
+    return index < mLastActive.size() && mFrame - mLastActive[index] > SleepFrames;
+}
 
-int gamedev::CollisionSystem::Update(float dt)
+tg::aabb2 gamedev::CollisionSystem::BoundsOf_(InstanceHandle handle) const
 {
-    auto t0 = std::chrono::steady_clock::now();
+    auto const& translation = mECS->GetInstanceTransform(handle).translation;
+    auto const& bounds = mECS->GetInstanceBounds(handle);
 
-    mDT = dt;
+    return {{bounds.min.x + translation.x, bounds.min.z + translation.z}, {bounds.max.x + translation.x, bounds.max.z + translation.z}};
+}
 
-    ResolveStaticCollisions();
-    ResolveDynamicCollisions();
+void gamedev::CollisionSystem::UpdateSpatialIndex()
+{
+    // New colliders (created or no longer a prototype)
+    mAddedColliders.each([&](InstanceHandle handle)
+    {
+        if (mDynamicEntities.contains(handle))
+        {
+            mBroadphase.Add(handle, BoundsOf_(handle), true);
+            Wake_(handle);
+        }
+        else if (mStaticEntities.contains(handle))
+            mStaticColliders.Add(handle, BoundsOf_(handle), ShapeOf_(handle));
+    });
 
-    auto tn = std::chrono::steady_clock::now();
-    return std::chrono::duration_cast<std::chrono::microseconds>(tn - t0).count();
+    // Moved instances
+    mMovedInstances.each([&](InstanceHandle handle)
+    {
+        if (!mECS->IsLiveHandle(handle))
+            return;
+
+        // The only per-frame update of the shared index, the bounds follow rotation & scaling
+        const auto& translation = mECS->GetInstanceTransform(handle).translation;
+        mECS->GetHashMap().UpdateInstance(handle, translation, mECS->GetInstanceBounds(handle));
+
+        if (mBroadphase.Contains(handle))
+        {
+            mBroadphase.Move(handle, BoundsOf_(handle));
+            Wake_(handle);
+        }
+        else if (mStaticColliders.Contains(handle))
+            mStaticColliders.Move(handle, BoundsOf_(handle), ShapeOf_(handle));
+    });
+
+    mBroadphase.Update();
+
+    // Only in frames where structures were built, moved or destroyed
+    if (mStaticColliders.IsDirty())
+    {
+        mStaticColliders.Build();
+        WakeNear_(mStaticColliders.GetChangedAreas());
+    }
 }
 
-void gamedev::CollisionSystem::ResolveStaticCollisions()
+void gamedev::CollisionSystem::WakeNear_(const std::vector<tg::aabb2>& areas)
 {
-    tg::pos3 min{0, 0, 0};
-    tg::pos3 max{0, 0, 0};
-
-    std::queue<std::pair<InstanceHandle, InstanceHandle>> staticDynamic_2nd;
+    for (auto const& area : areas)
+    {
+        // Touching counts, a unit resting against a removed wall has to move on
+        mECS->GetHashMap().FindNear(tg::vec3::zero, {area.min.x, 0, area.min.y}, {area.max.x, 0, area.max.y}, SpatialDynamic, mNearby);
+        for (auto const handle : mNearby)
+        {
+            if (!mDynamicEntities.contains(handle))
+                continue;
 
-    mSecondRun = false;
+            auto const bounds = BoundsOf_(handle);
+            if (bounds.min.x <= area.max.x && area.min.x <= bounds.max.x && bounds.min.y <= area.max.y && area.min.y <= bounds.max.y)
+                Wake_(handle);
+        }
+    }
+}
 
+void gamedev::CollisionSystem::ResolveCollisions()
+{
+    // Lifecheck:
     for (const auto& handle_static : mStaticEntities)
     {
-        // Lifecheck:
         auto hp = mECS->TryGetComponent<Destructible>(handle_static);
         if (hp)
         {
             if (hp->health.current <= 0.0f)
             {
-                mECS->MarkDestruction(handle_static);
-                Event e(EventType::BuildingDestroyed, handle_static, handle_static);
+                mECS->GetCommandBuffer().DestroyInstance(handle_static);
             }
         }
+    }
 
-        // Collision Check:
-        auto boxShape_s = mECS->TryGetComponent<BoxShape>(handle_static);
-        auto circleShape_s = mECS->TryGetComponent<CircleShape>(handle_static);
-        auto& instance_s = mECS->GetInstance(handle_static);
-
-        auto bounds = instance_s.max_bounds;
-        bounds.max *= instance_s.xform.scaling;
-        bounds.min *= instance_s.xform.scaling;
-
-        //for (const auto& handle_dynamic : mDynamicEntities)
-        for (const auto& handle_dynamic : mDynamicColliderHashMap.FindNear(instance_s.xform.translation, instance_s.max_bounds))
-        {
-            if (mECS->TestSignature<InTower>(handle_dynamic))
-                continue;
-
-            auto collider = mECS->TryGetComponent<Collider>(handle_dynamic);
-
-            if ((!collider) || (!collider->dynamic))
-                continue;
+    // Collision Check:
+    ++mFrame;
+    mSolver.Clear();
+    mBodyHandles.clear();
+    mCandidates.clear();
 
-            auto& instance_d = mECS->GetInstance(handle_dynamic);
+    // Units inside towers stay where they are, sleeping units don't look for new contacts
+    mMovers.clear();
+    mNumUnits = 0;
+    mNumSleeping = 0;
 
-            auto boxShape_d = mECS->TryGetComponent<BoxShape>(handle_dynamic);
-            auto circleShape_d = mECS->TryGetComponent<CircleShape>(handle_dynamic);
+    for (const auto& handle_dynamic : mDynamicEntities)
+    {
+        if (mECS->TestSignature<InTower>(handle_dynamic))
+            continue;
 
-            bool collision = false;
+        ++mNumUnits;
+        if (IsAsleep_(handle_dynamic))
+            ++mNumSleeping;
+        else
+            mMovers.push_back(handle_dynamic);
+    }
 
-            if (boxShape_s && boxShape_d)
-                collision = Collide(instance_d, instance_s, boxShape_d, boxShape_s);
+    // Sleepers are woken by an awake partner first, so they also look for static contacts this frame
+    mDynamicPairs.clear();
 
-            else if (boxShape_s && circleShape_d)
-                collision = Collide(instance_d, instance_s, circleShape_d, boxShape_s);
+    for (const auto& pair : mBroadphase.GetPairs())
+    {
+        bool const movableA = pair.dynamicA && !mECS->TestSignature<InTower>(pair.a);
+        bool const movableB = pair.dynamicB && !mECS->TestSignature<InTower>(pair.b);
 
-            else if (circleShape_s && boxShape_d)
-                collision = Collide(instance_d, instance_s, boxShape_d, circleShape_s);
+        if (!movableA && !movableB)
+            continue;
 
-            else if (circleShape_s && circleShape_d)
-                collision = Collide(instance_d, instance_s, circleShape_d, circleShape_s);
+        // Nothing changed between sleeping units, an awake unit close enough to overlap the bounds wakes them
+        bool const asleepA = movableA && IsAsleep_(pair.a);
+        bool const asleepB = movableB && IsAsleep_(pair.b);
 
-            if (collision)
-            {
-                staticDynamic_2nd.push({handle_static, handle_dynamic});
+        if ((!movableA || asleepA) && (!movableB || asleepB))
+            continue;
 
-                Event collision_event(EventType::StaticCollision, handle_static, handle_dynamic);
-                mECS->SendFunctionalEvent(collision_event);
-            }
+        if (asleepA || asleepB)
+        {
+            auto const woken = asleepA ? pair.a : pair.b;
+            Wake_(woken);
+            mMovers.push_back(woken);
+            --mNumSleeping;
         }
+
+        auto& dynamicPair = mDynamicPairs.emplace_back(pair);
+        dynamicPair.dynamicA = movableA;
+        dynamicPair.dynamicB = movableB;
     }
 
-    mSecondRun = true;
+    FindStaticPairs_();
 
-    for (int i = 0; i < staticDynamic_2nd.size(); i++)
-    {
-        auto handle_static = staticDynamic_2nd.front().first;
-        auto handle_dynamic = staticDynamic_2nd.front().second;
-        staticDynamic_2nd.pop();
+    for (auto const& hits : mStaticHits)
+        for (auto const& [mover, collider] : hits)
+            mCandidates.push_back({BodyOf_(mMovers[mover], true), BodyOf_(collider->handle, false, &collider->shape)});
+
+    for (const auto& pair : mDynamicPairs)
+        mCandidates.push_back({BodyOf_(pair.a, pair.dynamicA), BodyOf_(pair.b, pair.dynamicB)});
 
-        // Collision Check:
-        auto boxShape_s = mECS->TryGetComponent<BoxShape>(handle_static);
-        auto circleShape_s = mECS->TryGetComponent<CircleShape>(handle_static);
-        auto& instance_s = mECS->GetInstance(handle_static);
+    mNarrowphase.Clear();
+    for (uint32_t i = 0; i < mCandidates.size(); ++i)
+        mNarrowphase.Add(i, mSolver.GetShape(mCandidates[i].first), mSolver.GetShape(mCandidates[i].second));
 
-        auto bounds = instance_s.max_bounds;
-        bounds.max *= instance_s.xform.scaling;
-        bounds.min *= instance_s.xform.scaling;
+    mNarrowphase.Run();
 
-        auto collider = mECS->TryGetComponent<Collider>(handle_dynamic);
+    mStaticContacts.clear();
 
-        if ((!collider) || (!collider->dynamic))
+    for (uint32_t i = 0; i < mCandidates.size(); ++i)
+    {
+        // If the push-vector is zero, no collision happend.
+        if (mNarrowphase.GetPush(i) == tg::vec2::zero)
             continue;
 
-        auto& instance_d = mECS->GetInstance(handle_dynamic);
+        auto const [first, second] = mCandidates[i];
+        mSolver.AddContact(first, second);
 
-        auto boxShape_d = mECS->TryGetComponent<BoxShape>(handle_dynamic);
-        auto circleShape_d = mECS->TryGetComponent<CircleShape>(handle_dynamic);
+        auto const handleA = mBodyHandles[first];
+        auto const handleB = mBodyHandles[second];
 
-        bool collision = false;
+        if (!mDynamicEntities.contains(handleA))
+            mStaticContacts.push_back({handleB, handleA});
+        else if (!mDynamicEntities.contains(handleB))
+            mStaticContacts.push_back({handleA, handleB});
+    }
 
-        if (boxShape_s && boxShape_d)
-            collision = Collide(instance_d, instance_s, boxShape_d, boxShape_s);
+    // Resolution:
+    mSolver.Solve(mThreadPool);
 
-        else if (boxShape_s && circleShape_d)
-            collision = Collide(instance_d, instance_s, circleShape_d, boxShape_s);
+    for (uint32_t body = 0; body < mBodyHandles.size(); ++body)
+    {
+        auto const correction = mSolver.GetCorrection(body);
+        if (correction == tg::vec2::zero)
+            continue;
 
-        else if (circleShape_s && boxShape_d)
-            collision = Collide(instance_d, instance_s, boxShape_d, circleShape_s);
+        mECS->GetInstanceTransform(mBodyHandles[body]).move_absolute({correction.x, 0.f, correction.y});
+        mECS->MarkTransformChanged(mBodyHandles[body]);
+    }
 
-        else if (circleShape_s && circleShape_d)
-            collision = Collide(instance_d, instance_s, circleShape_d, circleShape_s);
+    for (const auto& [handle_dynamic, handle_static] : mStaticContacts)
+    {
+        // Resolved position becomes the fallback position of the physics step
+        auto physics = mECS->TryGetComponent<Physics>(handle_dynamic);
+        if (physics)
+            physics->lastPosition = mECS->GetInstanceTransform(handle_dynamic).translation;
 
-        /*
-        if (collision)
-        {
-            Event collision_event(EventType::StaticCollision, handle_static, handle_dynamic);
-            mECS->SendFunctionalEvent(collision_event);
-        }
-        */
+        mECS->SendEvent(CollisionEvent{handle_static, handle_dynamic});
     }
 }
 
-void gamedev::CollisionSystem::ResolveDynamicCollisions()
+void gamedev::CollisionSystem::FindStaticPairs_()
 {
-    tg::pos3 min{0, 0, 0};
-    tg::pos3 max{0, 0, 0};
+    // The baked grid is read-only, the movers are split into ranges which are queried in parallel & merged in order
+    size_t const numTasks = mThreadPool ? std::min<size_t>(4 * mThreadPool->GetNumThreads(), mMovers.size() / 256 + 1) : 1;
+    size_t const rangeSize = (mMovers.size() + numTasks - 1) / numTasks;
 
-    mSecondRun = false;
+    mStaticHits.resize(numTasks);
+    mTasks.clear();
 
-    for (const auto& handle_1 : mDynamicEntities)
+    for (size_t t = 0; t < numTasks; ++t)
     {
-        if (mECS->TestSignature<InTower>(handle_1))
-            continue;
-
-        auto boxShape_1 = mECS->TryGetComponent<BoxShape>(handle_1);
-        auto circleShape_1 = mECS->TryGetComponent<CircleShape>(handle_1);
-        auto& instance_1 = mECS->GetInstance(handle_1);
-
-        //for (const auto& handle_2 : mDynamicEntities)
-        for (const auto& handle_2 : mDynamicColliderHashMap.FindNear(instance_1.xform.translation, instance_1.max_bounds))
+        mTasks.push_back([this, t, rangeSize]
         {
-            if (handle_1 == handle_2)
-                continue;
+            auto& hits = mStaticHits[t];
+            hits.clear();
 
-            auto collider = mECS->TryGetComponent<Collider>(handle_2);
-            if ((!collider) || (!collider->dynamic))
-                continue;
+            auto const end = std::min(mMovers.size(), (t + 1) * rangeSize);
+            for (auto mover = uint32_t(t * rangeSize); mover < end; ++mover)
+                mStaticColliders.ForEachOverlap(BoundsOf_(mMovers[mover]), [&](StaticColliderGrid::Collider const& c) { hits.push_back({mover, &c}); });
+        });
+    }
 
-            auto& instance_2 = mECS->GetInstance(handle_2);
+    if (mThreadPool)
+        mThreadPool->Run(mTasks);
+    else
+        mTasks[0]();
+}
 
-            auto boxShape_2 = mECS->TryGetComponent<BoxShape>(handle_2);
-            auto circleShape_2 = mECS->TryGetComponent<CircleShape>(handle_2);
+uint32_t gamedev::CollisionSystem::BodyOf_(InstanceHandle handle, bool movable, const WorldShape* shape)
+{
+    auto const index = handle.index();
+    if (index >= mBodyOf.size())
+    {
+        mBodyOf.resize(index + 1);
+        mBodyFrames.resize(index + 1, 0);
+    }
 
-            bool collision = false;
+    if (mBodyFrames[index] != mFrame)
+    {
+        mBodyOf[index] = mSolver.AddBody(shape ? *shape : ShapeOf_(handle), movable);
+        mBodyFrames[index] = mFrame;
+        mBodyHandles.push_back(handle);
+    }
 
-            if (boxShape_1 && boxShape_2)
-                collision = Collide(instance_1, instance_2, boxShape_1, boxShape_2);
+    return mBodyOf[index];
+}
 
-            else if (boxShape_1 && circleShape_2)
-                collision = Collide(instance_1, instance_2, circleShape_1, boxShape_2);
+gamedev::WorldShape gamedev::CollisionSystem::ShapeOf_(InstanceHandle handle) const
+{
+    auto const& xform = mECS->GetInstanceTransform(handle);
+    WorldShape shape;
 
-            else if (circleShape_1 && boxShape_2)
-                collision = Collide(instance_1, instance_2, boxShape_1, circleShape_2);
+    if (auto box = mECS->TryGetComponent<BoxShape>(handle))
+    {
+        auto const M = xform.transform_mat2D();
+        auto const center = M * box->box.center;
+        auto const axis0 = M * box->box.half_extents[0];
+        auto const axis1 = M * box->box.half_extents[2];
+
+        shape.type = ShapeType::Box;
+        shape.center = {center.x, center.z};
+        shape.axis0 = {axis0.x, axis0.z};
+        shape.axis1 = {axis1.x, axis1.z};
+    }
+    else if (auto circle = mECS->TryGetComponent<CircleShape>(handle))
+    {
+        auto const center = xform.transform_mat2D() * circle->circle.center;
 
-            else if (circleShape_1 && circleShape_2)
-                collision = Collide(instance_1, instance_2, circleShape_1, circleShape_2);
-        }
+        shape.type = ShapeType::Circle;
+        shape.center = {center.x, center.z};
+        shape.radius = tg::max(xform.scaling.width, xform.scaling.depth) * circle->circle.radius;
     }
+
+    return shape;
 }
 
 /*
@@ -445,379 +565,3 @@ bool gamedev::CollisionSystem::intersects(const CircleShape& circleA, const Circ
     return intersects(cA, cB);
 }
 */
-
-bool gamedev::CollisionSystem::Collide(Instance& instance_dynamic, Instance& instance_any, const BoxShape* box_dynamic, const BoxShape* box_any)
-{
-    // Transform collision box
-    const auto transform1 = affine_to_mat4(instance_dynamic.xform.transform_mat());
-    auto tBox1 = box_dynamic->box;
-    tBox1.center = transform1 * box_dynamic->box.center;
-    tBox1.half_extents[0] = transform1 * box_dynamic->box.half_extents[0];
-    tBox1.half_extents[2] = transform1 * box_dynamic->box.half_extents[2];
-
-    const auto transform2 = affine_to_mat4(instance_any.xform.transform_mat());
-    auto tBox2 = box_any->box;
-    tBox2.center = transform2 * box_any->box.center;
-    tBox2.half_extents[0] = transform2 * box_any->box.half_extents[0];
-    tBox2.half_extents[2] = transform2 * box_any->box.half_extents[2];
-
-    // Interpret as circles to do fast collision check
-    auto distance = tg::distance(tBox1.center, tBox2.center);
-    auto radius1 = tg::length(tBox1.half_extents[0] + tBox1.half_extents[2]);
-    auto radius2 = tg::length(tBox2.half_extents[0] + tBox2.half_extents[2]);
-    //if (distance > (radius1 + radius2) + (radius1 + radius2))
-    if (distance > (radius1 + radius2))
-        return 0; // No Intersection
-
-    tg::vec3 push = minimalPush(tBox1, tBox2);
-
-    // If the push-vector is zero, no collision happend.
-    if ((push.x == 0) && (push.z == 0))
-        return 0;
-
-    resolve(instance_dynamic, instance_any, push);
-
-    return 1;
-}
-
-bool gamedev::CollisionSystem::Collide(Instance& instance_dynamic, Instance& instance_any, const BoxShape* box_dynamic, const CircleShape* circle_static)
-{
-    // Transform collision box
-    const auto transform1 = instance_dynamic.xform.transform_mat2D();
-    tg::box3 tBox;
-    tBox.center = transform1 * box_dynamic->box.center;
-    tBox.half_extents[0] = transform1 * box_dynamic->box.half_extents[0];
-    tBox.half_extents[2] = transform1 * box_dynamic->box.half_extents[2];
-
-    const auto transform2 = instance_any.xform.transform_mat2D();
-    const auto scale2 = tg::max(instance_any.xform.scaling.width, instance_any.xform.scaling.depth);
-    tg::sphere3 tCircle;
-    tCircle.center = transform2 * circle_static->circle.center;
-    tCircle.radius = scale2 * circle_static->circle.radius;
-    
-    // Interpret as circles to do fast collision check
-    auto distance = tg::distance_sqr(tBox.center, tCircle.center);
-    auto radius1 = tg::length(tBox.half_extents[0] + tBox.half_extents[2]);
-    if (distance > (radius1 + tCircle.radius) * (radius1 + tCircle.radius))
-        return 0; // No Intersection
-
-    tg::vec3 push = minimalPush(tBox, tCircle);
-
-    // If the push-vector is zero, no collision happend.
-    if ((push.x == 0) && (push.z == 0))
-        return 0;
-
-    resolve(instance_dynamic, instance_any, push);
-
-    return 1;
-}
-
-bool gamedev::CollisionSystem::Collide(Instance& instance_dynamic, Instance& instance_any, const CircleShape* circle_dynamic, const BoxShape* box_static)
-{
-    // Transform collision box
-    const auto transform1 = instance_any.xform.transform_mat2D();
-    tg::box3 tBox;
-    tBox.center = transform1 * box_static->box.center;
-    tBox.half_extents[0] = transform1 * box_static->box.half_extents[0];
-    tBox.half_extents[2] = transform1 * box_static->box.half_extents[2];
-
-    const auto transform2 = instance_dynamic.xform.transform_mat2D();
-    const auto scale2 = tg::max(instance_dynamic.xform.scaling.width, instance_dynamic.xform.scaling.depth);
-    tg::sphere3 tCircle;
-    tCircle.center = transform2 * circle_dynamic->circle.center;
-    tCircle.radius = scale2 * circle_dynamic->circle.radius;
-
-    // Interpret as circles to do fast collision check
-    auto distance = tg::distance_sqr(tBox.center, tCircle.center);
-    auto radius1 = tg::length(tBox.half_extents[0] + tBox.half_extents[2]);
-    if (distance > (radius1 + tCircle.radius) * (radius1 + tCircle.radius))
-        return 0; // No Intersection
-
-    tg::vec3 push = minimalPush(tCircle, tBox);
-
-    // If the push-vector is zero, no collision happend.
-    if ((push.x == 0) && (push.z == 0))
-        return 0;
-
-    resolve(instance_dynamic, instance_any, push);
-
-    return 1;
-}
-
-bool gamedev::CollisionSystem::Collide(Instance& instance_dynamic, Instance& instance_any, const CircleShape* circle_dynamic, const CircleShape* circle_static)
-{
-    // Transform collision box
-    const auto transform1 = instance_dynamic.xform.transform_mat2D();
-    const auto scale1 = tg::max(instance_dynamic.xform.scaling.width, instance_dynamic.xform.scaling.depth);
-    tg::sphere3 tCircle1;
-    tCircle1.center = transform1 * circle_dynamic->circle.center;
-    tCircle1.radius = scale1 * circle_dynamic->circle.radius;
-
-    const auto transform2 = instance_any.xform.transform_mat2D();
-    const auto scale2 = tg::max(instance_any.xform.scaling.width, instance_any.xform.scaling.depth);
-    tg::sphere3 tCircle2;
-    tCircle2.center = transform2 * circle_static->circle.center;
-    tCircle2.radius = scale2 * circle_static->circle.radius;
-
-    // Do fast circle collision check
-    auto distance = tg::distance_sqr(tCircle1.center, tCircle2.center);
-    if (distance > (tCircle1.radius + tCircle2.radius) * (tCircle1.radius + tCircle2.radius))
-        return 0; // No Intersection
-
-    tg::vec3 push = minimalPush(tCircle1, tCircle2);
-
-    // If the push-vector is zero, no collision happend.
-    if ((push.x == 0) && (push.z == 0))
-        return 0;
-
-    resolve(instance_dynamic, instance_any, push);
-
-    return 1;
-}
-
-tg::vec3 gamedev::CollisionSystem::SAT_AxisTest(const tg::vec3& axis, const std::array<tg::pos3, 4>& points1, const std::array<tg::pos3, 4>& points2)
-{
-    float min1 = INFINITY;
-    float max1 = -INFINITY;
-
-    float min2 = INFINITY;
-    float max2 = -INFINITY;
-
-    // Project all points on the given axis & find maximum/minimum
-    for (const auto& p : points1)
-    {
-        float projection = tg::dot(p, axis);
-
-        min1 = tg::min(min1, projection);
-        max1 = tg::max(max1, projection);
-    }
-
-    for (const auto& p : points2)
-    {
-        float projection = tg::dot(p, axis);
-
-        min2 = tg::min(min2, projection);
-        max2 = tg::max(max2, projection);
-    }
-
-    // On overlap, create a push-vector along the given axis
-    if ((max1 >= min2) && (max2 >= min1))
-    {
-        // Push a bit more than needed
-        float d = tg::min(max2 - min1, max1 - min2) / tg::dot(axis, axis) + 1e-10;
-        return d * axis;
-    }
-
-    // Else, return a zero-vector (equal to: no overlap found).
-    return tg::vec3::zero;
-}
-
-tg::vec3 gamedev::CollisionSystem::minimalPush(const tg::box3& box_dynamic, const tg::box3& box_any)
-{
-    // half_extents are already the axes
-    auto axes = std::array<tg::vec3, 4>();
-    axes[0] = box_dynamic.half_extents[0]; // boxA
-    axes[1] = box_dynamic.half_extents[2]; //
-    axes[2] = box_any.half_extents[0];     // boxB
-    axes[3] = box_any.half_extents[2];     //
-
-    // points must be calculated from the center
-    auto center1 = box_dynamic.center;
-    auto center2 = box_any.center;
-    std::array<tg::pos3, 4> points1;
-    std::array<tg::pos3, 4> points2;
-
-    points1[0] = center1 + box_dynamic.half_extents[0] + box_dynamic.half_extents[2];
-    points1[1] = center1 + box_dynamic.half_extents[0] - box_dynamic.half_extents[2];
-    points1[2] = center1 - box_dynamic.half_extents[0] + box_dynamic.half_extents[2];
-    points1[3] = center1 - box_dynamic.half_extents[0] - box_dynamic.half_extents[2];
-
-    points2[0] = center2 + box_any.half_extents[0] + box_any.half_extents[2];
-    points2[1] = center2 + box_any.half_extents[0] - box_any.half_extents[2];
-    points2[2] = center2 - box_any.half_extents[0] + box_any.half_extents[2];
-    points2[3] = center2 - box_any.half_extents[0] - box_any.half_extents[2];
-
-    // SAT Test all axis for a potential collision. Break if a separting axis is found.
-    // push is the vector, which holds the displacement to avoid collision on this axis.
-    // push == (0,0) => separating axis / no collision
-    // push  > (0,0) => overlap
-    std::vector<tg::vec3> push_vectors;
-    for (const auto& axis : axes)
-    {
-        auto push = SAT_AxisTest(axis, points1, points2);
-        if (push.x != 0 || push.z != 0)
-            push_vectors.push_back(push);
-        else
-            return tg::vec3::zero;
-    }
-
-    // Get minimum necessary vector to resolve collision.
-    tg::vec3 minimum_push;
-    float minimum = INFINITY;
-    for (const auto& push : push_vectors)
-    {
-        if (tg::dot(push, push) < minimum)
-        {
-            minimum_push = push;
-            minimum = tg::dot(push, push);
-        }
-    }
-
-    // Assert, that box1 is pushed away from box2
-    tg::vec3 d = box_any.center - box_dynamic.center;
-    if (tg::dot(d, minimum_push) > 0)
-        minimum_push *= -1;
-
-    return minimum_push;
-}
-
-
-tg::vec3 gamedev::CollisionSystem::minimalPush(const tg::box3& box_dynamic, const tg::sphere3& circle_any)
-{
-    // half_extents are already the axes
-    auto axes = std::array<tg::vec3, 2>();
-    axes[0] = tg::normalize_safe(box_dynamic.half_extents[0]);
-    axes[1] = tg::normalize_safe(box_dynamic.half_extents[2]);
-
-    // points must be calculated from the center
-    auto center1 = box_dynamic.center;
-    auto center2 = circle_any.center;
-    std::array<tg::pos3, 4> points1;
-    std::array<tg::pos3, 4> points2;
-
-    points1[0] = center1 + box_dynamic.half_extents[0] + box_dynamic.half_extents[2];
-    points1[1] = center1 + box_dynamic.half_extents[0] - box_dynamic.half_extents[2];
-    points1[2] = center1 - box_dynamic.half_extents[0] + box_dynamic.half_extents[2];
-    points1[3] = center1 - box_dynamic.half_extents[0] - box_dynamic.half_extents[2];
-
-    // Circle is interpreted as a rectangle for collision, but it works
-    points2[0] = center2 + circle_any.radius * axes[0];
-    points2[1] = center2 + circle_any.radius * axes[1];
-    points2[2] = center2 - circle_any.radius * axes[0];
-    points2[3] = center2 - circle_any.radius * axes[1];
-
-    // SAT Test all axis for a potential collision. Break if a separting axis is found.
-    // push is the vector, which holds the displacement to avoid collision on this axis.
-    // push == (0,0) => separating axis / no collision
-    // push  > (0,0) => overlap
-    std::vector<tg::vec3> push_vectors;
-    for (const auto& axis : axes)
-    {
-        auto push = SAT_AxisTest(axis, points1, points2);
-        if (push.x > 0 || push.z > 0)
-            push_vectors.push_back(push);
-        else
-            return tg::vec3::zero;
-    }
-
-    // Get minimum necessary vector to resolve collision.
-    tg::vec3 minimum_push;
-    float minimum = INFINITY;
-    for (const auto& push : push_vectors)
-    {
-        if (tg::dot(push, push) < minimum)
-        {
-            minimum_push = push;
-            minimum = tg::dot(push, push);
-        }
-    }
-
-    // Assert, that box1 is pushed away from box2
-    tg::vec3 d = circle_any.center - box_dynamic.center;
-    if (tg::dot(d, minimum_push) > 0)
-        minimum_push *= -1;
-
-    return minimum_push;
-}
-
-
-tg::vec3 gamedev::CollisionSystem::minimalPush(const tg::sphere3& circle_dynamic, const tg::box3& box_static)
-{
-    return -1.0 * minimalPush(box_static, circle_dynamic);
-}
-
-tg::vec3 gamedev::CollisionSystem::minimalPush(const tg::sphere3& circle_dynamic, const tg::sphere3& circle_static)
-{
-    tg::vec3 dir = circle_dynamic.center - circle_static.center;
-    float len = tg::length(dir);
-
-    if (len >= circle_dynamic.radius + circle_static.radius)
-        return tg::vec3::zero;
-
-    dir /= len;
-
-    tg::vec3 push = dir * tg::abs(len - circle_dynamic.radius - circle_static.radius);
-
-    return push;
-}
-
-void gamedev::CollisionSystem::resolve(Instance& instance_dynamic, Instance& instance_any, tg::vec3 push)
-{
-    auto physics1 = mECS->TryGetComponent<Physics>(instance_dynamic.mHandle);
-
-    if (physics1)
-    {
-        if (!mSecondRun && tg::any(tg::comp<3, bool>(physics1->velocity)))
-        {
-            instance_dynamic.xform.move_absolute(physics1->lastPosition - instance_dynamic.xform.translation);
-
-            const float bounce_damping = 0.0;
-            const float friction_damping = 0.4;
-
-            tg::vec3 N = tg::normalize(push);
-            tg::vec3 vec_collision = tg::normalize_safe(physics1->velocity);
-
-            // todo: fix bounce
-            // if (physics2)
-            //    vec_collision -= physics2->velocity;
-
-            tg::vec3 bounce = tg::dot(vec_collision, N) * N; // perpendicular: bounce
-            tg::vec3 friction = vec_collision - bounce;
-
-            //physics1->velocity = friction_damping * friction;
-            instance_dynamic.xform.move_absolute((friction_damping * friction) * mDT);
-
-            return;
-        }
-    }
-    
-    instance_dynamic.xform.move_absolute(push); 
-
-    // Old stuff
-    //{
-    //    const float bounce_damping = 0.5;
-    //    const float friction_damping = 1.0;
-    //
-    //    // 1. Push dynamic object outside
-    //    instance_dynamic.xform.move_absolute(push);
-    //
-    //    if (physics1)
-    //    {
-    //        tg::vec3 N = tg::normalize(push);
-    //
-    //        tg::vec3 vec_collision = physics1->velocity;
-    //
-    //        // todo: fix bounce
-    //        // if (physics2)
-    //        //    vec_collision -= physics2->velocity;
-    //
-    //        tg::vec3 bounce = tg::dot(vec_collision, N) * N; // perpendicular: bounce
-    //        tg::vec3 friction = vec_collision - bounce;
-    //
-    //        physics1->velocity = bounce_damping * bounce + friction_damping * friction;
-    //    }
-    //}
-}
-
-void gamedev::CollisionSystem::PositionListener(Event& e)
-{
-    auto collider = mECS->TryGetComponent<Collider>(e.mSubject);
-
-    if (collider)
-    {
-        if (collider->dynamic)
-            mDynamicColliderHashMap.UpdateInstance(e.mSender, mECS->GetInstanceTransform(e.mSender).translation);
-        else
-            mStaticColliderHashMap.UpdateInstance(e.mSender, mECS->GetInstanceTransform(e.mSender).translation);
-    }
-}
\ No newline at end of file
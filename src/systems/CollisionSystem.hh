@@ -5,9 +5,26 @@
 #include "components/ShapeComp.hh"
 #include "ecs/System.hh"
 #include "ecs/Engine.hh"
+#include "utility/ContactSolver.hh"
+#include "utility/Narrowphase.hh"
+#include "utility/StaticColliderGrid.hh"
+#include "utility/SweepAndPrune.hh"
+#include "utility/ThreadPool.hh"
 
 /***
 * Tests for 2D collisions between CollisionShapes or tg::box2, tg::circle2 and tg::aabb2.
+*
+* Broadphase: static colliders are baked into a StaticColliderGrid (rebuilt only in frames where they change),
+* every unit outside of a tower queries it for its static pairs (in parallel, the grid is read-only).
+* A sweep-and-prune over the bounds of the dynamic colliders lists each overlapping pair of them once per frame
+* (ordered by handles). The narrowphase only runs on these pairs.
+* Narrowphase: all candidates are tested at once by the batched kernels of utility/Narrowphase.hh (XZ-plane).
+* Resolution: the overlapping pairs become the contacts of a ContactSolver (utility/ContactSolver.hh), which pushes
+* the colliders apart on the thread pool. Nothing is moved before all contacts are solved, the results don't depend
+* on the number of threads. Static colliders & units inside towers are not moved, two units are pushed apart half each.
+* Sleeping: a unit which hasn't moved for SleepFrames frames drops out of the active set, it no longer queries the static
+* grid & pairs of two sleeping units are skipped. It wakes as soon as its transform changes (move order, push, ...),
+* an awake unit comes close enough to overlap its bounds or a static collider it touches is built, moved or destroyed.
 * 
 * If a CollisionShape is tested it applies the transformations of the Instance first.
 * Then it calls an appropriate method of a tg object.
@@ -22,7 +39,6 @@ class CollisionSystem : public System
 {
 public:
     void Init(std::shared_ptr<EngineECS>& ecs);
-    void Init(std::shared_ptr<EngineECS>& ecs, tg::aabb3 map_bounds);
 
     void AddEntity(InstanceHandle& handle, Signature entitySignature);
     void RemoveEntity(InstanceHandle& handle, Signature entitySignature);
@@ -31,8 +47,16 @@ public:
 
     int Update(float dt);
 
-    void ResolveStaticCollisions();
-    void ResolveDynamicCollisions();
+    // Solves the contacts on the pool, on the calling thread without one.
+    void SetThreadPool(ThreadPool* pool) { mThreadPool = pool; }
+
+    // Units outside of towers of the last update
+    size_t GetNumAwake() const { return mNumUnits - mNumSleeping; }
+    size_t GetNumSleeping() const { return mNumSleeping; }
+
+    // Applies the collider additions & transform changes since the last update to the broadphase.
+    void UpdateSpatialIndex();
+    void ResolveCollisions();
 
     bool intersects(const BoxShape* boxA, const BoxShape* boxB);
     bool intersects(const BoxShape* box, const CircleShape* circle);
@@ -51,47 +75,58 @@ public:
     // tg::pos2 intersection(const CircleShape& circleA, const CircleShape& circleB);
 
 private:
-    float mDT = 0.0;
+    static constexpr uint32_t SleepFrames = 30; // without moving, before a unit sleeps
 
-    // Tests if a collision happens & resolves it.
-    bool Collide(Instance& instance_dyn, Instance& instance_any, const BoxShape* box1, const BoxShape* box2);
-    bool Collide(Instance& instance_dyn, Instance& instance_any, const BoxShape* box, const CircleShape* circle);
-    bool Collide(Instance& instance_dyn, Instance& instance_any, const CircleShape* circle, const BoxShape* box);
-    bool Collide(Instance& instance_dyn, Instance& instance_any, const CircleShape* circle1, const CircleShape* circle2);
+    // Fills mStaticHits with the static colliders overlapping the bounds of the movers
+    void FindStaticPairs_();
 
-    void resolve(Instance& instance1, Instance& instance2, tg::vec3 push);
+    // Body of the instance in mSolver, added on first use in a frame (with its baked shape, if given)
+    uint32_t BodyOf_(InstanceHandle handle, bool movable, const WorldShape* shape = nullptr);
+    WorldShape ShapeOf_(InstanceHandle handle) const;
 
-    // If a collision happens, a minimum push-vector is returned which pushes box1 away from box2.
-    // Else, a 0-vector is returned.
-    tg::vec3 minimalPush(const tg::box3& box1, const tg::box3& box2);
-    tg::vec3 minimalPush(const tg::sphere3& circle1, const tg::sphere3& circle2);
-    tg::vec3 minimalPush(const tg::box3& box, const tg::sphere3& circle);
-    tg::vec3 minimalPush(const tg::sphere3& circle_dynamic, const tg::box3& box_static);
+    // Static/dynamic layer of the instance in the shared spatial index (0 removes it)
+    void SetColliderCategory_(InstanceHandle handle, SpatialMask category);
 
-    // Helper method which is part of Collide(box, box).
-    tg::vec3 SAT_AxisTest(const tg::vec3& axis, const std::array<tg::pos3, 4>& points1, const std::array<tg::pos3, 4>& points2);
+    // World space bounds (XZ) of the instance, as used by the broadphase
+    tg::aabb2 BoundsOf_(InstanceHandle handle) const;
 
-    // http://www.metanetsoftware.com/technique/tutorialA.html#section5
-    // Collision Response Approach
-    // 1. Project our of collision
-    // 2. Split velocity vector into two components: parallel & perpendicular to the collision surface
-    // 3. Calculate bounce using perpendicular component
-    // 4. Calculate friction using parallel component
-
-private:
-    void PositionListener(Event& e);
+    void Wake_(InstanceHandle handle);
+    void WakeNear_(const std::vector<tg::aabb2>& areas); // dynamic colliders touching the areas
+    bool IsAsleep_(InstanceHandle handle) const;
 
 private:
     std::shared_ptr<EngineECS> mECS;
 
-    std::set<InstanceHandle> mStaticEntities;
-    std::set<InstanceHandle> mDynamicEntities;
+    // Ordered, the resolution order of overlapping colliders must not depend on insertion history
+    EntitySet mStaticEntities{true};
+    EntitySet mDynamicEntities{true};
+
+    SweepAndPrune mBroadphase; // dynamic colliders
+    StaticColliderGrid mStaticColliders;
+    Narrowphase mNarrowphase;
+    ContactSolver mSolver;
+    ThreadPool* mThreadPool = nullptr;
+
+    std::vector<InstanceHandle> mNearby;             // scratch of WakeNear_
+    std::vector<InstanceHandle> mMovers;             // awake dynamic colliders outside of towers
+    std::vector<SweepAndPrune::Pair> mDynamicPairs;  // broadphase pairs with an awake mover, dynamicA/B = movable
+    std::vector<std::vector<std::pair<uint32_t, StaticColliderGrid::Collider const*>>> mStaticHits; // (mover, static) by task
+    std::vector<std::function<void()>> mTasks;
+
+    std::vector<std::pair<uint32_t, uint32_t>> mCandidates;                 // bodies of the broadphase pairs
+    std::vector<std::pair<InstanceHandle, InstanceHandle>> mStaticContacts; // (dynamic, static)
 
-    bool mSecondRun = false;
+    std::vector<InstanceHandle> mBodyHandles; // by body
+    std::vector<uint32_t> mBodyOf;            // by InstanceHandle::index()
+    std::vector<uint32_t> mBodyFrames;        // frame mBodyOf was set in
+    uint32_t mFrame = 0;
 
+    std::vector<uint32_t> mLastActive; // by InstanceHandle::index(), frame a dynamic collider last moved or was woken
+    size_t mNumUnits = 0;
+    size_t mNumSleeping = 0;
 
-    Hash2D mStaticColliderHashMap;
-    Hash2D mDynamicColliderHashMap;
+    ChangeQuery mAddedColliders;
+    ChangeQuery mMovedInstances;
 };
 }
 
@@ -44,6 +44,7 @@ void gamedev::GamelogicSystem::RemoveEntity(InstanceHandle& handle, Signature en
     mSoldiers.erase(handle);
     mMonsters.erase(handle);
     mPeople.erase(handle);
+    mInjuredPioneers.erase(handle);
     mEntities.erase(handle);
 }
 
@@ -53,6 +54,7 @@ void gamedev::GamelogicSystem::RemoveEntity(InstanceHandle& handle)
     mSoldiers.erase(handle);
     mMonsters.erase(handle);
     mPeople.erase(handle);
+    mInjuredPioneers.erase(handle);
     mEntities.erase(handle);
 }
 
@@ -62,6 +64,7 @@ void gamedev::GamelogicSystem::RemoveAllEntities()
     mSoldiers.clear();
     mMonsters.clear();
     mPeople.clear();
+    mInjuredPioneers.clear();
     mEntities.clear();
 }
 
@@ -81,8 +84,8 @@ void gamedev::GamelogicSystem::Init(std::shared_ptr<EngineECS>& ecs,
     mGO = go;
     mGlobalScale = globalScale;
 
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::StaticCollision, GamelogicSystem::CollisionListener));
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::ArrowHit, GamelogicSystem::ArrowListener));
+    mCollisionEvents = mECS->CreateEventReader<CollisionEvent>();
+    mArrowHitEvents = mECS->CreateEventReader<ArrowHitEvent>();
 
     mAS->PlayLocalSound(tg::pos3(0, 0, 60), "water.wav", ambient, 0.4f, true, 10, 100);
     mAS->PlayLocalSound(tg::pos3(-80, 30, 90), "wind.wav", ambient, 0.5f, true, 20, 100);
@@ -102,22 +105,17 @@ int gamedev::GamelogicSystem::Update(float dt)
 
     mTime += dt;
 
+    mCollisionEvents.each([&](const CollisionEvent& e) { CollisionListener(e); });
+    mArrowHitEvents.each([&](const ArrowHitEvent& e) { ArrowListener(e); });
+
     ConsumeWood(dt);
     UpdateOutlines(dt);
 
-    for (const auto& h : mInjuredPioneers)
-    {
-        if (!mECS->IsLiveHandle(h))
-        {
-            mInjuredPioneers.erase(h);
-        }
-    }
-
-    for (const auto& handle : mEntities)
+    mECS->View<Living>().each([&](InstanceHandle handle, Living& living)
     {
-        const auto& instance = mECS->GetInstance(handle);
+        const auto instance = mECS->GetInstance(handle);
 
-        auto lifeform = mECS->GetComponent<Living>(handle);
+        auto lifeform = &living;
         auto attacker = mECS->TryGetComponent<Attacker>(handle);
 
         //if (attacker)
@@ -169,7 +167,7 @@ int gamedev::GamelogicSystem::Update(float dt)
 
         if (mUpdateControl / 30)
             UpdateHomefire();
-    }
+    });
 
     
     mUpdateControl++;
@@ -178,7 +176,7 @@ int gamedev::GamelogicSystem::Update(float dt)
     return std::chrono::duration_cast<std::chrono::microseconds>(tn - t0).count();
 }
 
-void gamedev::GamelogicSystem::LookForEnemy(const Instance& instance, Living* lifeform, Attacker* attacker)
+void gamedev::GamelogicSystem::LookForEnemy(InstanceRef instance, Living* lifeform, Attacker* attacker)
 {
     if (attacker->attackOrder.is_valid() || attacker->lastLookoutForEnemies < 30)
     {
@@ -186,58 +184,35 @@ void gamedev::GamelogicSystem::LookForEnemy(const Instance& instance, Living* li
     }
     attacker->lastLookoutForEnemies = 0;
 
-    // Look for instances in weapon range
+    auto const attackerPosition = tg::pos3(instance.xform.translation);
+
+    // Look for the nearest enemy in weapon range
     if (lifeform->friendly)
     {
-        for (const auto& n : mMonsters)
-        {
-            auto lifeformT = mECS->GetComponent<Living>(n);
-
-            auto attackerPosition = instance.xform.translation;
-            auto targetPosition = mECS->GetInstanceTransform(n).translation;
+        mECS->GetHashMap().FindNearest(attackerPosition, attacker->weapon.range, SpatialUnit | SpatialHostile, 1, mNearest);
 
-            if (tg::distance(targetPosition, attackerPosition) <= attacker->weapon.range)
-            {
-                SetAttackOrder(lifeform, attacker, n);
-                return;
-            }
-        }
+        if (!mNearest.empty())
+            SetAttackOrder(lifeform, attacker, mNearest.front().handle);
     }
     // unfriendly
     else
     {
-        auto range = tg::pos3(attacker->weapon.range + 1, 0.0, attacker->weapon.range + 1);
-        for (const auto& n : mECS->GetHashMap().FindNear(instance.xform.translation, -range, range))
-        {
-            // monsters autonomously attack pioneers
-            if (!mECS->TestSignature<Living>(n))
-                continue;
-
-            if (n == instance.mHandle)
-                continue;
-
-            auto lifeformT = mECS->TryGetComponent<Living>(n);
+        // monsters autonomously attack pioneers, a bit beyond their weapon range
+        mECS->GetHashMap().FindNearest(attackerPosition, attacker->weapon.range + 1, SpatialUnit | SpatialFriendly, 1, mNearest);
 
-            if (lifeformT && !lifeformT->friendly)
-                continue;
-
-            if (lifeformT)
-            {
-                auto attackerPosition = instance.xform.translation;
-                auto targetPosition = mECS->GetInstanceTransform(n).translation;
-                auto distance = tg::distance(attackerPosition, targetPosition);
-
-                SetAttackOrder(lifeform, attacker, n);
-                auto moveTo = targetPosition + tg::normalize(attackerPosition - targetPosition) * (distance - attacker->weapon.range * 0.9);
+        if (!mNearest.empty())
+        {
+            auto const target = mNearest.front().handle;
+            auto targetPosition = mECS->GetInstanceTransform(target).translation;
+            auto distance = tg::sqrt(mNearest.front().distance_sqr);
 
-                if (distance > attacker->weapon.range)
-                    SetMoveOrder(lifeform, moveTo);
+            SetAttackOrder(lifeform, attacker, target);
+            auto moveTo = targetPosition + tg::normalize(tg::vec3(attackerPosition) - targetPosition) * (distance - attacker->weapon.range * 0.9);
 
-                return;
-            }
+            if (distance > attacker->weapon.range)
+                SetMoveOrder(lifeform, moveTo);
         }
     }
-    
 }
 
 void gamedev::GamelogicSystem::SetMoveOrder(Living* subject, tg::vec3 moveTo)
@@ -247,12 +222,12 @@ void gamedev::GamelogicSystem::SetMoveOrder(Living* subject, tg::vec3 moveTo)
     subject->forceMove = true;
 }
 
-void gamedev::GamelogicSystem::UpdateMoveOrder(const Instance& instance, Living* subject, float dt)
+void gamedev::GamelogicSystem::UpdateMoveOrder(InstanceRef instance, Living* subject, float dt)
 {
     if (!subject->moveOrder)
       return;
 
-    if (mECS->TestSignature<InTower>(instance.mHandle))
+    if (mECS->TestSignature<InTower>(instance.meta.mHandle))
     {
         return;
     }
@@ -261,7 +236,7 @@ void gamedev::GamelogicSystem::UpdateMoveOrder(const Instance& instance, Living*
     subject->idle = 0;
 
     // Face direction
-    auto subject_dir = instance.xform.rotation_mat2D() * instance.facing;
+    auto subject_dir = instance.xform.rotation_mat2D() * instance.meta.facing;
     subject_dir.y = 0.0;
 
     // Target direction
@@ -273,7 +248,7 @@ void gamedev::GamelogicSystem::UpdateMoveOrder(const Instance& instance, Living*
     {
         if (subject->forceMove || (tg::abs(1.f - tg::dot(subject_dir, look_dir)) > 1.f))
         {
-            auto animation = mECS->TryGetComponent<Animated>(instance.mHandle);
+            auto animation = mECS->TryGetComponent<Animated>(instance.meta.mHandle);
 
             if (animation)
             {
@@ -288,7 +263,7 @@ void gamedev::GamelogicSystem::UpdateMoveOrder(const Instance& instance, Living*
     if (subject->forceMove || (distance > 0.1))
     {
         look_dir = tg::normalize_safe(look_dir);
-        auto physics = mECS->TryGetComponent<Physics>(instance.mHandle);
+        auto physics = mECS->TryGetComponent<Physics>(instance.meta.mHandle);
 
         if (physics)
             physics->velocity = (subject->moveSpeed * dt < distance) ? look_dir * subject->moveSpeed : look_dir * distance / dt;
@@ -298,7 +273,7 @@ void gamedev::GamelogicSystem::UpdateMoveOrder(const Instance& instance, Living*
     {
         subject->moveOrder = false;
 
-        auto physics = mECS->TryGetComponent<Physics>(instance.mHandle);
+        auto physics = mECS->TryGetComponent<Physics>(instance.meta.mHandle);
 
         if (physics)
             physics->velocity = tg::vec3::zero;
@@ -314,27 +289,27 @@ void gamedev::GamelogicSystem::SetFocus(Living* subject, InstanceHandle focusHan
     subject->focusHandle = focusHandle;
 }
 
-void gamedev::GamelogicSystem::UpdateFocus(const Instance& instance, Living* subject)
+void gamedev::GamelogicSystem::UpdateFocus(InstanceRef instance, Living* subject)
 {
     if (!subject->focusHandle.is_valid())
         return;
 
     if (!mECS->IsLiveHandle(subject->focusHandle))
     {
-        subject->focusHandle._value = uint32_t(1);
+        subject->focusHandle._value = uint32_t(-1);
         return;
     }
 
     // Face direction
-    auto subject_dir = instance.xform.rotation_mat2D() * instance.facing;
+    auto subject_dir = instance.xform.rotation_mat2D() * instance.meta.facing;
     subject_dir.y = 0.0;
 
     // Focus direction
-    const auto& focus = mECS->GetInstance(subject->focusHandle);
+    const auto focus = mECS->GetInstance(subject->focusHandle);
     auto look_to = focus.xform.translation - instance.xform.translation;
     look_to.y = 0.0;
 
-    auto animation = mECS->TryGetComponent<Animated>(instance.mHandle);
+    auto animation = mECS->TryGetComponent<Animated>(instance.meta.mHandle);
 
     if (animation)
     {
@@ -349,7 +324,7 @@ void gamedev::GamelogicSystem::SetAttackOrder(Living* subject, Attacker* attacke
     attacker->attackOrder = target;
 }
 
-void gamedev::GamelogicSystem::UpdateAttackOrder(const Instance& instance, Living* subject, Attacker* attacker, float dt)
+void gamedev::GamelogicSystem::UpdateAttackOrder(InstanceRef instance, Living* subject, Attacker* attacker, float dt)
 {
     const int updatesPerSecond = 60;
 
@@ -360,7 +335,7 @@ void gamedev::GamelogicSystem::UpdateAttackOrder(const Instance& instance, Livin
         attacker->attackOrder._value = std::uint32_t(-1);
     }
 
-    auto animation = mECS->TryGetComponent<Animated>(instance.mHandle);
+    auto animation = mECS->TryGetComponent<Animated>(instance.meta.mHandle);
 
     // No target, but weapon: sheath weapon
     if (!attacker->attackOrder.is_valid())
@@ -437,8 +412,7 @@ void gamedev::GamelogicSystem::AttackClaw(Attacker* attacker, float dt)
 
         mortal->health.current -= attacker->weapon.damage;
 
-        Event e(EventType::PioneerHit, {attacker->handle_value}, attacker->attackOrder);
-        mECS->SendFunctionalEvent(e);
+        mECS->SendEvent(HitEvent{TargetType::Pioneer, {attacker->handle_value}, attacker->attackOrder, mECS->GetInstanceTransform(attacker->attackOrder), attacker->weapon.damage});
 
         if (mortal->health.current <= 0.0f)
         {
@@ -447,7 +421,7 @@ void gamedev::GamelogicSystem::AttackClaw(Attacker* attacker, float dt)
             auto killedAttacker = mECS->TryGetComponent<Attacker>(attacker->attackOrder);
             if (killedAttacker && killedAttacker->weaponHandle.is_valid())
             {
-                mECS->MarkDestruction(killedAttacker->weaponHandle);
+                mECS->GetCommandBuffer().DestroyInstance(killedAttacker->weaponHandle);
             }
             auto position = mECS->GetInstanceTransform(attacker->attackOrder).translation;
             mAS->PlayLocalSound(tg::pos3(position), "claw4.wav", effect, 1.f);
@@ -464,8 +438,7 @@ void gamedev::GamelogicSystem::AttackClaw(Attacker* attacker, float dt)
     {
         destructible->health.current -= attacker->weapon.damage;
 
-        Event e(EventType::BuildingHit, {attacker->handle_value}, attacker->attackOrder);
-        mECS->SendFunctionalEvent(e);
+        mECS->SendEvent(HitEvent{TargetType::Building, {attacker->handle_value}, attacker->attackOrder, mECS->GetInstanceTransform(attacker->attackOrder), attacker->weapon.damage});
 
         if (destructible->health.current <= 0.0f)
         {
@@ -486,17 +459,16 @@ void gamedev::GamelogicSystem::ShootArrow(Attacker* attacker, float dt)
     if (arrowArc.xMax <= 0.0f)
         return;
 
-    const auto& instance = mECS->GetInstance({attacker->handle_value});
-    const auto& bow = mECS->GetInstance(attacker->weaponHandle);
-    const auto& target = mECS->GetInstance(attacker->attackOrder);
+    const auto bow = mECS->GetInstance(attacker->weaponHandle);
 
     auto arrowHandle = mIF->Create("arrow", tg::pos3(bow.xform.translation) + bow.xform.forward_vec() * 0.2);
-    auto& arrow = mECS->GetInstance(arrowHandle);
+    auto arrow = mECS->GetInstance(arrowHandle);
     arrow.xform.translation.y = bow.xform.translation.y + 0.3f;
     auto dir = arrowArc.velocity;
     dir.y = 0.0;
     dir = tg::normalize(dir);
     arrow.xform.rotation = tg::quat::from_axis_angle(tg::dir3::pos_y, tg::angle_towards(arrow.xform.forward_vec(), dir, tg::vec3::unit_y));
+    mECS->MarkTransformChanged(arrowHandle);
 
     auto arrowComp = mECS->GetComponent<Arrow>(arrowHandle);
     arrowComp->target = attacker->attackOrder;
@@ -526,7 +498,7 @@ void gamedev::GamelogicSystem::ShootArrow(Attacker* attacker, float dt)
     pp.varySize = 0.01f;
     pp.varyVelocity = tg::vec3(0.05f, 0.05f, 0.05f);
     pp.particlesPerSecond = 80.f;
-    particleComp->pp.push_back(pp);
+    particleComp->pp[particleComp->numProperties++] = pp;
 
     vector<string> arrowSounds = {"arrow1.wav", "arrow2.wav", "arrow3.wav", "arrow4.wav"};
     mAS->PlayLocalSound(attacker->weaponHandle, arrowSounds[int(RandomFloat(0, arrowSounds.size() - 0.01))], effect, 1.f);
@@ -539,8 +511,9 @@ void gamedev::GamelogicSystem::EquipWeapon(Attacker* attacker)
         if (!attacker->weaponHandle.is_valid())
         {
             attacker->weaponHandle = mIF->Create("bow");
-            auto& weapon = mECS->GetInstance(attacker->weaponHandle);
+            auto weapon = mECS->GetInstance(attacker->weaponHandle);
             weapon.xform.scaling = tg::size3(0.0f);
+            mECS->MarkTransformChanged(attacker->weaponHandle);
         }
 
         // Animate..
@@ -554,6 +527,7 @@ void gamedev::GamelogicSystem::EquipWeapon(Attacker* attacker)
         else
         {
             mECS->GetInstanceTransform(attacker->weaponHandle).scaling = tg::size3(0.6f);
+            mECS->MarkTransformChanged(attacker->weaponHandle);
         }
     }
 }
@@ -578,10 +552,11 @@ void gamedev::GamelogicSystem::SheathWeapon(Attacker* attacker)
     else
     {
         mECS->GetInstanceTransform(attacker->weaponHandle).scaling = tg::size3(0.0f);
+        mECS->MarkTransformChanged(attacker->weaponHandle);
     }
 }
 
-void gamedev::GamelogicSystem::MoveWeapon(const Instance& instance, Attacker* attacker)
+void gamedev::GamelogicSystem::MoveWeapon(InstanceRef instance, Attacker* attacker)
 {
     // No weapon
     if (!attacker->weaponHandle.is_valid())
@@ -589,7 +564,7 @@ void gamedev::GamelogicSystem::MoveWeapon(const Instance& instance, Attacker* at
         return;
     }
 
-    auto& weapon = mECS->GetInstance(attacker->weaponHandle);
+    auto weapon = mECS->GetInstance(attacker->weaponHandle);
     auto animation = mECS->TryGetComponent<Animated>(attacker->weaponHandle);
 
     if (attacker->weapon.type == WeaponType::Bow)
@@ -602,6 +577,7 @@ void gamedev::GamelogicSystem::MoveWeapon(const Instance& instance, Attacker* at
 
         weapon.xform.translation = instance.xform.translation + instance.xform.forward_vec() * 0.1 + instance.xform.right_vec() * 0.2;
         weapon.xform.translation.y = instance.xform.translation.y + 0.05f;
+        mECS->MarkTransformChanged(attacker->weaponHandle);
     }
 }
 
@@ -613,8 +589,8 @@ void gamedev::GamelogicSystem::AimWeapon(Attacker* attacker)
         return;
     }
 
-    auto& instance = mECS->GetInstance({attacker->handle_value});
-    auto& weapon = mECS->GetInstance(attacker->weaponHandle);
+    auto instance = mECS->GetInstance({attacker->handle_value});
+    auto weapon = mECS->GetInstance(attacker->weaponHandle);
     auto animation = mECS->TryGetComponent<Animated>(attacker->weaponHandle);
 
     if (attacker->weapon.type == WeaponType::Bow)
@@ -631,6 +607,8 @@ void gamedev::GamelogicSystem::AimWeapon(Attacker* attacker)
         {
             weapon.xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_x, -45_deg));
         }
+
+        mECS->MarkTransformChanged(attacker->weaponHandle);
     }
 }
 
@@ -639,8 +617,8 @@ void gamedev::GamelogicSystem::AimWeapon(Attacker* attacker)
 gamedev::arcEq gamedev::GamelogicSystem::GetArrowArc(Attacker* attacker, float dt)
 {
     // Get instances
-    const auto& bow = mECS->GetInstance(attacker->weaponHandle);
-    const auto& target = mECS->GetInstance(attacker->attackOrder);
+    const auto bow = mECS->GetInstance(attacker->weaponHandle);
+    const auto target = mECS->GetInstance(attacker->attackOrder);
 
     // Projectile speed + target velocity
     auto vm_a = attacker->weapon.missileSpeed;
@@ -700,9 +678,7 @@ bool gamedev::GamelogicSystem::LookForProduction(InstanceHandle handle)
     auto producer = mECS->GetComponent<Producer>(handle);
     producer->produceOrder = mProductionBuildings[int(RandomFloat(0, mProductionBuildings.size() - 0.01))];
 
-    auto pBulding = mECS->GetInstance(producer->produceOrder);
-
-    // SetMoveOrder(handle, tg::pos3(pBulding.xform.translation));
+    // SetMoveOrder(handle, tg::pos3(mECS->GetInstanceTransform(producer->produceOrder).translation));
 
     return true;
 }
@@ -781,6 +757,7 @@ void gamedev::GamelogicSystem::SpawnHouse(bool highlighted)
 
     auto tent = mSF->Create("tent0", mFreeInnerSlots[index], tg::quat::from_axis_angle(tg::dir3::pos_y, randomRotation));
     mECS->GetInstanceTransform(tent).scale(randomScale);
+    mECS->MarkTransformChanged(tent);
 
     std::swap(mFreeInnerSlots[index], mFreeInnerSlots.back());
     mFreeInnerSlots.pop_back();
@@ -834,11 +811,16 @@ void gamedev::GamelogicSystem::SpawnEnemyWave(int number)
     //    lifeform->movePosition = mHome.center;
     //}
 
-    for (int i = 0; i < number; i++)
+    std::vector<transform> placements(number);
+    for (auto& placement : placements)
     {
         auto location = mEnemySpawns[int(RandomFloat(0.0, mEnemySpawns.size() - 0.1))];
         location += tg::vec3(RandomFloat(-2, 2), 0.0, RandomFloat(-2, 2));
-        auto handle = mUF->Create("creature", location);
+        placement.translation = tg::vec3(location);
+    }
+
+    for (auto handle : mUF->CreateBatch("creature", placements))
+    {
         mCreatures.push_back(handle);
 
         auto lifeform = mECS->GetComponent<Living>(handle);
@@ -863,14 +845,19 @@ void gamedev::GamelogicSystem::SpawnReinforcements(int number)
     tg::rng rng;
     rng.seed(0);
 
-    for (int i = 0; i < number; i++)
+    std::vector<transform> placements(number);
+    for (auto& placement : placements)
     {
         auto direction = tg::uniform<tg::dir2>(rng);
         tg::pos3 position = mReinforcementsStart + tg::vec3(direction.x, 0, direction.y);
-        auto handle = mUF->Create("person", position);
+        placement.translation = tg::vec3(position);
+    }
 
+    for (auto handle : mUF->CreateBatch("person", placements))
+    {
         auto fc = mECS->CreateComponent<ForeignControl>(handle);
-        fc->waypoints = mReinforcementWay;
+        fc->numWaypoints = int(std::min(mReinforcementWay.size(), size_t(ForeignControl::MaxWaypoints)));
+        std::copy_n(mReinforcementWay.begin(), fc->numWaypoints, fc->waypoints);
         fc->currentIndex = 5;
 
         //auto lifeform = mECS->GetComponent<Living>(handle);
@@ -941,8 +928,7 @@ void gamedev::GamelogicSystem::Kill(InstanceHandle killedHandle, bool killedPion
 
     if (killedPioneer)
     {
-        Event e(EventType::PioneerDeath, killerHandle, killedHandle);
-        mECS->SendFunctionalEvent(e);
+        mECS->SendEvent(DeathEvent{TargetType::Pioneer, killerHandle, killedHandle, mECS->GetInstanceTransform(killedHandle)});
 
         auto random = RandomFloat(0.0, 10.0);
 
@@ -953,20 +939,18 @@ void gamedev::GamelogicSystem::Kill(InstanceHandle killedHandle, bool killedPion
     }
     else
     {
-        Event e(EventType::MonsterDeath, killerHandle, killedHandle);
-        mECS->SendFunctionalEvent(e);
+        mECS->SendEvent(DeathEvent{TargetType::Monster, killerHandle, killedHandle, mECS->GetInstanceTransform(killedHandle)});
 
         mAS->PlayLocalSound(tg::pos3(mECS->GetInstanceTransform(killedHandle).translation), "monsterDeath.wav", effect, 0.2, false, 3.0, 50.0);
 
     }
 
-    mECS->MarkDestruction(killedHandle);
+    mECS->GetCommandBuffer().DestroyInstance(killedHandle);
 }
 
 void gamedev::GamelogicSystem::Destroy(InstanceHandle destroyedHandle, InstanceHandle destroyerHandle)
 {
-    Event e(EventType::BuildingDestroyed, destroyerHandle, destroyedHandle);
-    mECS->SendFunctionalEvent(e);
+    mECS->SendEvent(DeathEvent{TargetType::Building, destroyerHandle, destroyedHandle, mECS->GetInstanceTransform(destroyedHandle)});
 
     
     auto position = mECS->GetInstanceTransform(destroyedHandle).translation;
@@ -989,10 +973,10 @@ void gamedev::GamelogicSystem::Destroy(InstanceHandle destroyedHandle, InstanceH
 
     // Walls can be repaired
     if (wall)
-        mECS->TryCreateComponent<Prototype>(destroyedHandle);
+        mECS->GetCommandBuffer().CreateComponent<Prototype>(destroyedHandle);
     // buildings must be rebuilt
     else
-        mECS->MarkDestruction(destroyedHandle);
+        mECS->GetCommandBuffer().DestroyInstance(destroyedHandle);
 }
 
 /*
@@ -1016,22 +1000,24 @@ void gamedev::GamelogicSystem::UpdateAttack(InstanceHandle handle, float dt)
         // equip bow
         if (attacker->weaponHandle.is_valid())
         {
-            auto& bowInstance = mECS->GetInstance(attacker->weaponHandle);
+            auto bowInstance = mECS->GetInstance(attacker->weaponHandle);
             bowInstance.xform.translation = tg::vec3(instance.xform.translation) + instance.xform.forward_vec() * 0.2;
             bowInstance.xform.translation.y = instance.xform.translation.y + 0.05f;
 
-            auto t_facing = bowInstance.xform.rotation_mat2D() * tg::vec3(bowInstance.facing);
+            auto t_facing = bowInstance.xform.rotation_mat2D() * tg::vec3(bowInstance.meta.facing);
             auto look_dir = instance.xform.forward_vec();
             t_facing.y, look_dir.y = 0.0;
             auto angle = tg::angle_towards(t_facing, look_dir, tg::vec3::unit_y);
             bowInstance.xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_y, angle));
+            mECS->MarkTransformChanged(attacker->weaponHandle);
         }
         else
         {
             attacker->weaponHandle = mIF->Create("bow", tg::pos3(instance.xform.translation) + instance.xform.forward_vec() * 0.2);
-            auto& bowInstance = mECS->GetInstance(attacker->weaponHandle);
+            auto bowInstance = mECS->GetInstance(attacker->weaponHandle);
             bowInstance.xform.translation.y = instance.xform.translation.y + 0.05f;
             bowInstance.xform.scale(0.6f);
+            mECS->MarkTransformChanged(attacker->weaponHandle);
         }
     }
     else
@@ -1071,14 +1057,15 @@ void gamedev::GamelogicSystem::UpdateAttack(InstanceHandle handle, float dt)
                 auto arrowComp = mECS->GetComponent<Arrow>(arrow);
                 arrowComp->target = attacker->attackOrder;
 
-                auto& arrowInstance = mECS->GetInstance(arrow);
+                auto arrowInstance = mECS->GetInstance(arrow);
                 arrowInstance.xform.translation.y = instance.xform.translation.y + 0.3f;
 
-                auto t_facing = arrowInstance.xform.rotation_mat2D() * tg::vec3(arrowInstance.facing);
+                auto t_facing = arrowInstance.xform.rotation_mat2D() * tg::vec3(arrowInstance.meta.facing);
                 auto look_dir = tg::normalize_safe(target.xform.translation - arrowInstance.xform.translation);
                 t_facing.y, look_dir.y = 0.0;
                 auto angle = tg::angle_towards(t_facing, look_dir, tg::vec3::unit_y);
                 arrowInstance.xform.rotate(tg::quat::from_axis_angle(tg::dir3::pos_y, angle));
+                mECS->MarkTransformChanged(arrow);
 
                 auto physicsComp = mECS->GetComponent<Physics>(arrow);
                 physicsComp->gravity = false;
@@ -1100,14 +1087,17 @@ void gamedev::GamelogicSystem::UpdateAttack(InstanceHandle handle, float dt)
 }
 */
 
-void gamedev::GamelogicSystem::CollisionListener(Event& e)
+void gamedev::GamelogicSystem::CollisionListener(const CollisionEvent& e)
 {
-    auto lifeform = mECS->TryGetComponent<Living>(e.mSubject);
+    if (!mECS->IsLiveHandle(e.dynamicHandle) || !mECS->IsLiveHandle(e.staticHandle))
+        return;
+
+    auto lifeform = mECS->TryGetComponent<Living>(e.dynamicHandle);
 
     if (lifeform)
     {
-        auto position = tg::pos3(mECS->GetInstanceTransform(e.mSubject).translation);
-        auto physics = mECS->TryGetComponent<Physics>(e.mSubject);
+        auto position = tg::pos3(mECS->GetInstanceTransform(e.dynamicHandle).translation);
+        auto physics = mECS->TryGetComponent<Physics>(e.dynamicHandle);
 
         auto movePosition = lifeform->movePosition;
         position.y = 0.f;
@@ -1122,38 +1112,43 @@ void gamedev::GamelogicSystem::CollisionListener(Event& e)
         // Monster
         if (!lifeform->friendly)
         {
-            auto attacker = mECS->TryGetComponent<Attacker>(e.mSubject);
-            auto structure = mECS->TryGetComponent<Destructible>(e.mSender);
+            auto attacker = mECS->TryGetComponent<Attacker>(e.dynamicHandle);
+            auto structure = mECS->TryGetComponent<Destructible>(e.staticHandle);
 
             if (structure && attacker)
             {
                 lifeform->moveOrder = false;
-                SetAttackOrder(lifeform, attacker, e.mSender);
+                SetAttackOrder(lifeform, attacker, e.staticHandle);
             }
         }
     }
 }
 
-void gamedev::GamelogicSystem::ArrowListener(Event& e)
+void gamedev::GamelogicSystem::ArrowListener(const ArrowHitEvent& e)
 {
-    auto arrow = mECS->TryGetComponent<Arrow>(e.mSender);
-    auto lifeform = mECS->TryGetComponent<Living>(e.mSubject);
-    auto mortal = mECS->TryGetComponent<Mortal>(e.mSubject);
-    mortal->health.current -= arrow->damage;
+    // Destroy arrow
+    mECS->GetCommandBuffer().DestroyInstance(e.arrow);
+
+    // Target might have died since the arrow hit
+    if (!mECS->IsLiveHandle(e.target))
+        return;
+
+    auto lifeform = mECS->TryGetComponent<Living>(e.target);
+    auto mortal = mECS->TryGetComponent<Mortal>(e.target);
+    if (!lifeform || !mortal || mortal->health.current <= 0.0f)
+        return;
+
+    mortal->health.current -= e.damage;
 
     if (!lifeform->friendly)
     {
-        Event e(EventType::MonsterHit, e.mSender, e.mSubject);
-        mECS->SendFunctionalEvent(e);
+        mECS->SendEvent(HitEvent{TargetType::Monster, e.shooter, e.target, mECS->GetInstanceTransform(e.target), e.damage});
     }
 
-    if (arrow && lifeform && mortal && (mortal->health.current <= 0.0f))
+    if (mortal->health.current <= 0.0f)
     {
-        Kill(e.mSubject, false, arrow->shotBy);
+        Kill(e.target, false, e.shooter);
     }
-
-    // Destroy arrow
-    mECS->MarkDestruction(e.mSender);
 }
 
 // Algorithm:
@@ -1171,9 +1166,9 @@ void gamedev::GamelogicSystem::SpawnStoneWalls()
     mAS->PlayGlobalSound("construction2.wav", effect, 0.5f);
 
     // Get the scalings of the used presets
-    auto wScale = mECS->GetInstanceTransform(mSF->GetPreset("astonewall")).scaling;
-    auto pScale = mECS->GetInstanceTransform(mSF->GetPreset("astonepillar")).scaling; 
-    auto gScale = mECS->GetInstanceTransform(mSF->GetPreset("astonegate")).scaling; 
+    auto wScale = mSF->GetPresetTransform("astonewall").scaling;
+    auto pScale = mSF->GetPresetTransform("astonepillar").scaling; 
+    auto gScale = mSF->GetPresetTransform("astonegate").scaling; 
 
     // Get the original (unmodified) AABBs and scale them according to the presets
     auto wSize = wScale * tg::size_of(mGO->getAABB("astonewall"));
@@ -1232,6 +1227,7 @@ void gamedev::GamelogicSystem::SpawnStoneWalls()
     tg::vec3 translation =  mHome.radius * tg::vec3::unit_z * -1;
     auto gHandle = mSF->Create("astonegate", mHome.center + translation - gOffs);
     mECS->GetInstanceTransform(gHandle).scale(gScaleFix);
+    mECS->MarkTransformChanged(gHandle);
 
     mWalls.push_back(gHandle);
 
@@ -1284,8 +1280,8 @@ void gamedev::GamelogicSystem::SpawnWoodWalls()
     mAS->PlayGlobalSound("construction1.wav", effect, 0.5f);
 
     // Get the scalings of the used presets
-    auto wScale = mECS->GetInstanceTransform(mSF->GetPreset("aFence0")).scaling;
-    auto gScale = mECS->GetInstanceTransform(mSF->GetPreset("astonegate")).scaling;   // Placeholder
+    auto wScale = mSF->GetPresetTransform("aFence0").scaling;
+    auto gScale = mSF->GetPresetTransform("astonegate").scaling;   // Placeholder
 
     // Get the original (unmodified) AABBs and scale them according to the presets
     auto wSize = wScale * tg::size_of(mGO->getAABB("aFence0"));
@@ -1370,9 +1366,9 @@ void gamedev::GamelogicSystem::SpawnSpikes()
     float homeRadius = mHome.radius;
 
     // Get the scalings of the used presets
-    auto swScale = mECS->GetInstanceTransform(mSF->GetPreset("astonewall")).scaling;
-    auto wScale = mECS->GetInstanceTransform(mSF->GetPreset("aspikebarriers")).scaling;
-    auto gScale = mECS->GetInstanceTransform(mSF->GetPreset("astonegate")).scaling; // Placeholder
+    auto swScale = mSF->GetPresetTransform("astonewall").scaling;
+    auto wScale = mSF->GetPresetTransform("aspikebarriers").scaling;
+    auto gScale = mSF->GetPresetTransform("astonegate").scaling; // Placeholder
 
     // Get the original (unmodified) AABBs and scale them according to the presets
     auto swSize = swScale * tg::size_of(mGO->getAABB("astonewall"));
@@ -1445,8 +1441,7 @@ void gamedev::GamelogicSystem::SpawnSpikes()
         mOutlinedHandles.push_back(mWalls.back());
         mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
 
-        auto e = Event(EventType::NewPosition, spikes, spikes);
-        mECS->SendFunctionalEvent(e);
+        mECS->MarkTransformChanged(spikes);
 
         translation = wRot * translation;
         w++;
@@ -1454,14 +1449,13 @@ void gamedev::GamelogicSystem::SpawnSpikes()
     // Last wall segment, without a consecutive pillar
     auto spikes = mSF->Create("aspikebarriers", mHome.center + translation,
                               tg::quat::from_axis_angle(tg::dir3::pos_y, (gTheta / 2.f + wTheta / 2.f) + w * wTheta + 180_deg));
-    mWalls.push_back(spikes);
     mECS->GetInstanceTransform(spikes).move_absolute(tg::vec3::unit_y * (-0.2 * wSize.height));
+    mWalls.push_back(spikes);
 
     mOutlinedHandles.push_back(mWalls.back());
     mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
 
-    auto e = Event(EventType::NewPosition, spikes, spikes);
-    mECS->SendFunctionalEvent(e);
+    mECS->MarkTransformChanged(spikes);
 
 
     w++;
@@ -1477,7 +1471,7 @@ void gamedev::GamelogicSystem::StartProduction(InstanceHandle handle)
     if ((!lifeform) || (lifeform->moveOrder))
         return;
 
-    if (particles && !particles->pp.empty())
+    if (particles && particles->numProperties > 0)
         return;
 
     ParticleProperties pp;
@@ -1499,13 +1493,16 @@ void gamedev::GamelogicSystem::StartProduction(InstanceHandle handle)
     if (!particles)
         particles = mECS->CreateComponent<ParticleEmitter>(handle);
     
-    particles->pp.push_back(pp);
+    particles->pp[particles->numProperties++] = pp;
 }
 
 void gamedev::GamelogicSystem::StopProduction(InstanceHandle handle)
 {
-    mECS->TryRemoveComponent<Producer>(handle);
-    mECS->GetComponent<Producer>(handle)->producing = false;
+    auto producer = mECS->TryGetComponent<Producer>(handle);
+    if (producer)
+        producer->producing = false;
+
+    mECS->GetCommandBuffer().RemoveComponent<Producer>(handle);
 }
 
 gamedev::InstanceHandle gamedev::GamelogicSystem::SpawnObjectRandomly(tg::pos3 position, std::string object_id)
@@ -1515,12 +1512,13 @@ gamedev::InstanceHandle gamedev::GamelogicSystem::SpawnObjectRandomly(tg::pos3 p
 
     auto handle = mSF->Create(object_id, position, tg::quat::from_axis_angle(tg::dir3::pos_y, randomAngle));
     mECS->GetInstanceTransform(handle).scale(randomSize);
+    mECS->MarkTransformChanged(handle);
     return handle;
 }
 
 gamedev::InstanceHandle gamedev::GamelogicSystem::TryConstructObject(std::string object_id)
 {
-    auto instance = mECS->GetInstance(mSF->GetPreset(object_id));
+    auto const bounds = mSF->GetPresetBounds(object_id);
 
     // You have 20 tries to find a free spot, good luck
     for (int i = 0; i < 20; i++)
@@ -1528,12 +1526,12 @@ gamedev::InstanceHandle gamedev::GamelogicSystem::TryConstructObject(std::string
         tg::pos3 randomPosition
             = mHome.center + RandomFloat(1.0, mHome.radius - 1.0) * tg::vec3::unit_x + RandomFloat(1.0, mHome.radius - 1.0) * tg::vec3::unit_z;
 
-        auto potential_colliders = mECS->GetHashMap().FindNear(tg::vec3(randomPosition), instance.max_bounds);
+        mECS->GetHashMap().FindNear(tg::vec3(randomPosition), bounds, mNearby);
         
         bool freeSpot = true;
-        for (const auto& pc : potential_colliders)
+        for (const auto& pc : mNearby)
         {
-            if (tg::intersects(instance.max_bounds, mECS->GetInstance(pc).max_bounds))
+            if (tg::intersects(bounds, mECS->GetInstanceBounds(pc)))
             {
                 freeSpot = false;
             }
@@ -1548,7 +1546,7 @@ gamedev::InstanceHandle gamedev::GamelogicSystem::TryConstructObject(std::string
 
 gamedev::InstanceHandle gamedev::GamelogicSystem::TryConstructRandomObject(std::vector<std::string> object_ids)
 {
-    auto instance = mECS->GetInstance(mSF->GetPreset(object_ids[0]));
+    auto const bounds = mSF->GetPresetBounds(object_ids[0]);
 
     // You have 20 tries to find a free spot, good luck
     for (int i = 0; i < 20; i++)
@@ -1556,12 +1554,12 @@ gamedev::InstanceHandle gamedev::GamelogicSystem::TryConstructRandomObject(std::
         tg::pos3 randomPosition = mHome.center + RandomFloat(-mHome.radius + 1, mHome.radius - 1.0) * tg::vec3::unit_x
                                   + RandomFloat(-mHome.radius + 1, mHome.radius - 1.0) * tg::vec3::unit_z;
 
-        auto potential_colliders = mECS->GetHashMap().FindNear(tg::vec3(randomPosition), instance.max_bounds);
+        mECS->GetHashMap().FindNear(tg::vec3(randomPosition), bounds, mNearby);
         
         bool freeSpot = true;
-        for (const auto& pc : potential_colliders)
+        for (const auto& pc : mNearby)
         {
-            if (tg::intersects(instance.max_bounds, mECS->GetInstance(pc).max_bounds))
+            if (tg::intersects(bounds, mECS->GetInstanceBounds(pc)))
             {
                 freeSpot = false;
             }
@@ -1602,8 +1600,8 @@ void gamedev::GamelogicSystem::SpawnWoodStartingFences()
         DeleteFortifications();
 
     // Get the scalings of the used presets
-    auto wScale = mECS->GetInstanceTransform(mSF->GetPreset("aFence1")).scaling;
-    auto gScale = mECS->GetInstanceTransform(mSF->GetPreset("astonegate")).scaling; // Placeholder
+    auto wScale = mSF->GetPresetTransform("aFence1").scaling;
+    auto gScale = mSF->GetPresetTransform("astonegate").scaling; // Placeholder
 
     // Get the original (unmodified) AABBs and scale them according to the presets
     auto wSize = wScale * tg::size_of(mGO->getAABB("aFence1"));
@@ -1764,16 +1762,16 @@ void gamedev::GamelogicSystem::AssignArtisan()
 
     for (auto h : mPeople)
     {
-        auto& instance = mECS->GetInstance(h);
+        auto instance = mECS->GetInstance(h);
 
         if (mECS->TestSignature<ForeignControl>(h) && tg::distance_sqr(instance.xform.translation, tg::vec3(mHome.center)) > mHome.radius * mHome.radius + 5.0)
         {
             continue;
         }
         
-        const auto& filthyPeasant = mECS->GetInstance(h);
+        const auto filthyPeasant = mECS->GetInstance(h);
         auto artisan = mUF->Create("person_artisan", tg::pos3(filthyPeasant.xform.translation), filthyPeasant.xform.rotation, filthyPeasant.xform.scaling);
-        mECS->MarkDestruction(filthyPeasant.mHandle);
+        mECS->GetCommandBuffer().DestroyInstance(filthyPeasant.meta.mHandle);
 
         mOutlinedHandles.push_back(artisan);
         mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
@@ -1792,9 +1790,9 @@ void gamedev::GamelogicSystem::AssignArtisan()
 
     //auto first = mPeople.begin();
     //
-    //const auto& filthyPeasant = mECS->GetInstance(*first);
+    //const auto filthyPeasant = mECS->GetInstance(*first);
     //auto artisan = mUF->Create("person_artisan", tg::pos3(filthyPeasant.xform.translation), filthyPeasant.xform.rotation, filthyPeasant.xform.scaling);
-    //mECS->MarkDestruction(filthyPeasant.mHandle);
+    //mECS->GetCommandBuffer().DestroyInstance(filthyPeasant.meta.mHandle);
     //
     //mOutlinedHandles.push_back(artisan);
     //mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
@@ -1819,16 +1817,16 @@ void gamedev::GamelogicSystem::AssignSoldier()
 
     for (auto h : mPeople)
     {
-        auto& instance = mECS->GetInstance(h);
+        auto instance = mECS->GetInstance(h);
 
         if (mECS->TestSignature<ForeignControl>(h) && tg::distance_sqr(instance.xform.translation, tg::vec3(mHome.center)) > mHome.radius * mHome.radius + 5.0)
         {
             continue;
         }
 
-        const auto& filthyPeasant = mECS->GetInstance(h);
+        const auto filthyPeasant = mECS->GetInstance(h);
         auto soldier = mUF->Create("person_soldier", tg::pos3(filthyPeasant.xform.translation), filthyPeasant.xform.rotation, filthyPeasant.xform.scaling);
-        mECS->MarkDestruction(filthyPeasant.mHandle);
+        mECS->GetCommandBuffer().DestroyInstance(filthyPeasant.meta.mHandle);
 
         mOutlinedHandles.push_back(soldier);
         mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
@@ -1847,9 +1845,9 @@ void gamedev::GamelogicSystem::AssignSoldier()
 
     //auto first = mPeople.begin();
     //
-    //const auto& filthyPeasant = mECS->GetInstance(*first);
+    //const auto filthyPeasant = mECS->GetInstance(*first);
     //auto soldier = mUF->Create("person_soldier", tg::pos3(filthyPeasant.xform.translation), filthyPeasant.xform.rotation, filthyPeasant.xform.scaling);
-    //mECS->MarkDestruction(filthyPeasant.mHandle);
+    //mECS->GetCommandBuffer().DestroyInstance(filthyPeasant.meta.mHandle);
     //
     //mOutlinedHandles.push_back(soldier);
     //mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
@@ -2082,8 +2080,7 @@ void gamedev::GamelogicSystem::AddWood()
         mFireWood += 5.0;
         UpdateHomefire();
 
-        Event e(EventType::MoreWood, mBonfire, mBonfire);
-        mECS->SendFunctionalEvent(e);
+        mECS->SendEvent(MoreWoodEvent{mBonfire, 5.f});
 
         mAS->PlayGlobalSound("wood.wav", effect, 0.5);
     }
@@ -2275,14 +2272,14 @@ void gamedev::GamelogicSystem::UpdateOutlines(float dt)
 // 1. Get to fire
 // 2. Destroy blocking structures
 // 3. Kill any pioneer in reach
-void gamedev::GamelogicSystem::UpdateMonster(const Instance& instance, Living* subject, float dt)
+void gamedev::GamelogicSystem::UpdateMonster(InstanceRef instance, Living* subject, float dt)
 {
     if (subject->friendly)
     {
         return;
     }
 
-    auto attacker = mECS->GetComponent<Attacker>(instance.mHandle);
+    auto attacker = mECS->GetComponent<Attacker>(instance.meta.mHandle);
 
     // Steal firewood if not attacking
     auto fireDist_sqr = tg::max(tg::distance_sqr(tg::pos3::zero + instance.xform.translation, mHome.center) - 0.5, 0.0);
@@ -2305,7 +2302,7 @@ void gamedev::GamelogicSystem::UpdateMonster(const Instance& instance, Living* s
     }
 }
 
-void gamedev::GamelogicSystem::StealFirewood(const Instance& instance, float dt)
+void gamedev::GamelogicSystem::StealFirewood(InstanceRef instance, float dt)
 {
     mFireWood -= dt/2.f;
 }
@@ -2347,8 +2344,7 @@ void gamedev::GamelogicSystem::UpgradeSupply()
             mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
         }
 
-        Event e(EventType::Supply1, {std::uint32_t(-1)}, {std::uint32_t(-1)});
-        mECS->SendFunctionalEvent(e);
+        mECS->SendEvent(SupplyEvent{1});
 
         mAS->PlayGlobalSound("supplyUpgrade.wav", effect, 1.f);
     }
@@ -2363,8 +2359,7 @@ void gamedev::GamelogicSystem::UpgradeSupply()
             mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
         }
 
-        Event e(EventType::Supply2, {std::uint32_t(-1)}, {std::uint32_t(-1)});
-        mECS->SendFunctionalEvent(e);
+        mECS->SendEvent(SupplyEvent{2});
 
         mAS->PlayGlobalSound("supplyUpgrade.wav", effect, 1.f);
     }
@@ -2377,16 +2372,18 @@ void gamedev::GamelogicSystem::UpgradeSupply()
             const auto& xform = mECS->GetInstanceTransform(h);
             auto towerHandle = mSF->Create("awatchtower1", tg::pos3(xform.translation), xform.rotation, xform.scaling);
             mECS->GetInstanceTransform(towerHandle).translation = xform.translation;
+            mECS->MarkTransformChanged(towerHandle);
             auto tower = mECS->GetComponent<Tower>(towerHandle);
 
             auto soldierHandle = mUF->Create("person_soldier");
             mECS->CreateComponent<InTower>(soldierHandle);
             mECS->GetInstanceTransform(soldierHandle).translation = tg::vec3(xform.translation + tg::vec3(tower->position) * xform.scaling);
+            mECS->MarkTransformChanged(soldierHandle);
 
             mOutlinedHandles.push_back(towerHandle);
             mOutlinedColors.push_back(tg::vec4(0.0, 153.0 / 255.0, 1.0, 1.0));
 
-            mECS->MarkDestruction(h);
+            mECS->GetCommandBuffer().DestroyInstance(h);
         }
 
         mAS->PlayGlobalSound("victory.wav", effect, 0.5f);
@@ -2429,9 +2426,9 @@ void gamedev::GamelogicSystem::TestReinforcementWay()
     }
 }
 
-void gamedev::GamelogicSystem::UpdateTowerSoldier(const Instance& instance, Living* lifeform, Attacker* attacker)
+void gamedev::GamelogicSystem::UpdateTowerSoldier(InstanceRef instance, Living* lifeform, Attacker* attacker)
 {
-    if (!mECS->TestSignature<InTower>(instance.mHandle))
+    if (!mECS->TestSignature<InTower>(instance.meta.mHandle))
     {
         return;
     }
@@ -2440,9 +2437,9 @@ void gamedev::GamelogicSystem::UpdateTowerSoldier(const Instance& instance, Livi
     lifeform->forceMove = false;
 }
 
-void gamedev::GamelogicSystem::UpdateForeignControl(const Instance& instance, Living* subject)
+void gamedev::GamelogicSystem::UpdateForeignControl(InstanceRef instance, Living* subject)
 {
-    auto fc = mECS->TryGetComponent<ForeignControl>(instance.mHandle);
+    auto fc = mECS->TryGetComponent<ForeignControl>(instance.meta.mHandle);
     if (!fc)
     {
         return;
@@ -2451,9 +2448,9 @@ void gamedev::GamelogicSystem::UpdateForeignControl(const Instance& instance, Li
     // Initial
     if (fc->currentTarget == tg::pos3::zero)
     {
-        if (fc->waypoints.size() < 2)
+        if (fc->numWaypoints < 2)
         {
-            mECS->RemoveComponent<ForeignControl>(instance.mHandle);
+            mECS->GetCommandBuffer().RemoveComponent<ForeignControl>(instance.meta.mHandle);
             return;
         }
 
@@ -2471,9 +2468,9 @@ void gamedev::GamelogicSystem::UpdateForeignControl(const Instance& instance, Li
     {
         fc->currentIndex++;
 
-        if (fc->currentIndex >= fc->waypoints.size())
+        if (fc->currentIndex >= fc->numWaypoints)
         {
-            mECS->RemoveComponent<ForeignControl>(instance.mHandle);
+            mECS->GetCommandBuffer().RemoveComponent<ForeignControl>(instance.meta.mHandle);
             return;
         }
 
@@ -2503,16 +2500,11 @@ void gamedev::GamelogicSystem::Heal()
 
     for (const auto& h : mInjuredPioneers)
     {
-        if (!mECS->IsLiveHandle(h))
-        {
-            mInjuredPioneers.erase(h);
-            continue;
-        }
-
         auto mortal = mECS->TryGetComponent<Mortal>(h);
-        mortal->health.current = mortal->health.max;
-        mInjuredPioneers.erase(h);
+        if (mortal)
+            mortal->health.current = mortal->health.max;
     }
+    mInjuredPioneers.clear();
 
     mAS->PlayGlobalSound("heal.wav", ui);
 }
@@ -144,20 +144,20 @@ private:
 
     void SetMoveOrder(Living* subject, tg::vec3 moveTo);
     void SetFocus(Living* subject, InstanceHandle focusHandle);
-    void UpdateMoveOrder(const Instance& instance, Living* subject, float dt);
-    void UpdateFocus(const Instance& instance, Living* subject);
-    void UpdateMonster(const Instance& instance, Living* subject, float dt);
-    void StealFirewood(const Instance& instance, float dt);
-    void UpdateForeignControl(const Instance& instance, Living* subject);
+    void UpdateMoveOrder(InstanceRef instance, Living* subject, float dt);
+    void UpdateFocus(InstanceRef instance, Living* subject);
+    void UpdateMonster(InstanceRef instance, Living* subject, float dt);
+    void StealFirewood(InstanceRef instance, float dt);
+    void UpdateForeignControl(InstanceRef instance, Living* subject);
 
     // Attacking
-    void LookForEnemy(const Instance& instance, Living* lifeform, Attacker* attacker);
-    void UpdateTowerSoldier(const Instance& instance, Living* lifeform, Attacker* attacker);
+    void LookForEnemy(InstanceRef instance, Living* lifeform, Attacker* attacker);
+    void UpdateTowerSoldier(InstanceRef instance, Living* lifeform, Attacker* attacker);
     void SetAttackOrder(Living* subject, Attacker* attacker, InstanceHandle target);
-    void UpdateAttackOrder(const Instance& instance, Living* subject, Attacker* attacker, float dt);
+    void UpdateAttackOrder(InstanceRef instance, Living* subject, Attacker* attacker, float dt);
     void EquipWeapon(Attacker* attacker);
     void SheathWeapon(Attacker* attacker);
-    void MoveWeapon(const Instance& instance, Attacker* attacker);
+    void MoveWeapon(InstanceRef instance, Attacker* attacker);
     void AimWeapon(Attacker* attacker);
     arcEq GetArrowArc(Attacker* attacker, float dt);
     void ShootArrow(Attacker* attacker, float dt);
@@ -199,8 +199,8 @@ private:
     void UpdateOutlines(float dt);
 
 private:
-    void CollisionListener(Event& e);
-    void ArrowListener(Event& e);
+    void CollisionListener(const CollisionEvent& e);
+    void ArrowListener(const ArrowHitEvent& e);
 
 public:
     float mGlobalScale = 1.0;                   // Affects baked positions
@@ -230,7 +230,12 @@ private:
     std::vector<tg::pos3> mReinforcementWay;
     std::vector<tg::pos3> mEnemySpawns;
 
-    std::set<InstanceHandle> mInjuredPioneers;
+    // Removed in RemoveEntity, so no liveness scan is needed
+    EntitySet mInjuredPioneers;
+
+    // Results of spatial queries, reused between queries
+    std::vector<InstanceHandle> mNearby;
+    std::vector<SpatialHit> mNearest;
 
     float mTime = 0.0;
 
@@ -278,10 +283,13 @@ private:
     std::shared_ptr<GameObjects> mGO;
     std::shared_ptr<Terrain> mTerrain;
 
-    std::set<InstanceHandle> mPeople;
-    std::set<InstanceHandle> mArtisans;
-    std::set<InstanceHandle> mSoldiers;
-    std::set<InstanceHandle> mMonsters;
+    EventReader<CollisionEvent> mCollisionEvents;
+    EventReader<ArrowHitEvent> mArrowHitEvents;
+
+    EntitySet mPeople;
+    EntitySet mArtisans;
+    EntitySet mSoldiers;
+    EntitySet mMonsters;
 };
 }
 
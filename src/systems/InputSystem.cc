@@ -72,8 +72,8 @@ void gamedev::InputSystem::InstructFocus(InstanceHandle active_handle, InstanceH
     }
 
     auto input = mECS->GetComponent<gamedev::Input>(active_handle);
-    auto activePosition = tg::pos3(mECS->GetInstance(active_handle).xform.translation);
-    auto passivePosition = tg::pos3(mECS->GetInstance(passive_handle).xform.translation);
+    auto activePosition = tg::pos3(mECS->GetInstanceTransform(active_handle).translation);
+    auto passivePosition = tg::pos3(mECS->GetInstanceTransform(passive_handle).translation);
     auto lookDir = passivePosition - activePosition;
 
     input->focusMove = focusMove;
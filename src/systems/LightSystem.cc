@@ -4,6 +4,10 @@
 void gamedev::LightSystem::Init(std::shared_ptr<EngineECS>& ecs)
 {
     mECS = ecs;
+
+    mAddedEmitters = mECS->Query(Added<PointLightEmitter>{});
+    mChangedEmitters = mECS->Query(Changed<PointLightEmitter>{});
+    mMovedInstances = mECS->Query(Changed<transform>{});
 }
 
 int gamedev::LightSystem::AddFreeLight(PointLight& pl)
@@ -46,10 +50,29 @@ int gamedev::LightSystem::GetLightCount() { return mLights.size(); }
 
 const gamedev::PointLight& gamedev::LightSystem::GetShadowingPointlight() { return mShadowPL; }
 
+void gamedev::LightSystem::UpdateWorldPosition(InstanceHandle handle)
+{
+    auto light = mECS->TryGetComponent<gamedev::PointLightEmitter>(handle);
+    if (!light)
+        return;
+
+    if (handle.index() >= mWorldPositions.size())
+        mWorldPositions.resize(handle.index() + 1);
+
+    // Lights bound to an instance move with that instance
+    auto const& xform = mECS->GetInstanceTransform(handle);
+    mWorldPositions[handle.index()] = tg::mat4(xform.transform_mat()) * light->pl.position;
+}
+
 void gamedev::LightSystem::BuildLights(float dt)
 {
     mLights.clear();
 
+    // Only lights which were added, changed or moved need a new world position
+    mAddedEmitters.each([&](InstanceHandle handle) { UpdateWorldPosition(handle); });
+    mChangedEmitters.each([&](InstanceHandle handle) { UpdateWorldPosition(handle); });
+    mMovedInstances.each([&](InstanceHandle handle) { UpdateWorldPosition(handle); });
+
     // Add all independent lights
     for (const auto& light : mFreeLights)
     {
@@ -59,7 +82,9 @@ void gamedev::LightSystem::BuildLights(float dt)
     // Add all instance-bound lights
     for (const auto& handle : mEntities)
     {
-        auto instance = mECS->GetInstance(handle);
+        if (handle.index() >= mWorldPositions.size())
+            UpdateWorldPosition(handle);
+
         auto light = mECS->GetComponent<gamedev::PointLightEmitter>(handle);
 
         if (!light->shadowing)
@@ -68,21 +93,10 @@ void gamedev::LightSystem::BuildLights(float dt)
 
             if (light->flicker)
             {
-                while (light->flicker_smoothingQueue.size() >= light->flicker_smoothing)
-                {
-                    light->flicker_sum -= light->flicker_smoothingQueue.front();
-                    light->flicker_smoothingQueue.pop();
-                }
-
-                light->flicker_smoothingQueue.push(RandomFloat(light->flicker_min, light->flicker_max));
-                light->flicker_sum += light->flicker_smoothingQueue.back();
-
-                mLights.back().intensity *= light->flicker_sum / light->flicker_smoothingQueue.size();
+                mLights.back().intensity *= NextFlicker(*light);
             }
 
-
-            // Lights bound to an instance move with that instance
-            mLights.back().position = tg::mat4(instance.xform.transform_mat()) * mLights.back().position;
+            mLights.back().position = mWorldPositions[handle.index()];
         }
         else
         {
@@ -90,21 +104,32 @@ void gamedev::LightSystem::BuildLights(float dt)
 
             if (light->flicker)
             {
-                while (light->flicker_smoothingQueue.size() >= light->flicker_smoothing)
-                {
-                    light->flicker_sum -= light->flicker_smoothingQueue.front();
-                    light->flicker_smoothingQueue.pop();
-                }
-
-                light->flicker_smoothingQueue.push(RandomFloat(light->flicker_min, light->flicker_max));
-                light->flicker_sum += light->flicker_smoothingQueue.back();
-
-                mShadowPL.intensity *= light->flicker_sum / light->flicker_smoothingQueue.size();
+                mShadowPL.intensity *= NextFlicker(*light);
             }
 
-            mShadowPL.position = tg::mat4(instance.xform.transform_mat()) * mShadowPL.position;
+            mShadowPL.position = mWorldPositions[handle.index()];
         }
     }
 }
 
+float gamedev::LightSystem::NextFlicker(PointLightEmitter& light)
+{
+    auto constexpr capacity = PointLightEmitter::MaxFlickerSmoothing;
+    auto const smoothing = tg::clamp(light.flicker_smoothing, 1, capacity);
 
+    // Drop the oldest samples until there is room for a new one
+    while (light.flicker_count >= smoothing)
+    {
+        light.flicker_sum -= light.flicker_samples[light.flicker_first];
+        light.flicker_first = (light.flicker_first + 1) % capacity;
+        --light.flicker_count;
+    }
+
+    auto const sample = RandomFloat(light.flicker_min, light.flicker_max);
+    light.flicker_samples[(light.flicker_first + light.flicker_count) % capacity] = sample;
+    light.flicker_sum += sample;
+    ++light.flicker_count;
+
+    // Smoothed over the last samples
+    return light.flicker_sum / light.flicker_count;
+}
@@ -22,6 +22,8 @@ public:
 
 private:
     void BuildLights(float dt);
+    void UpdateWorldPosition(InstanceHandle handle);
+    float NextFlicker(PointLightEmitter& light);
 
 private:
     std::shared_ptr<EngineECS> mECS;
@@ -29,6 +31,12 @@ private:
     std::vector<PointLight> mLights;
     PointLight mShadowPL;
 
+    // World space position of the instance-bound lights, indexed by the slot index of the handle
+    std::vector<tg::pos3> mWorldPositions;
+    ChangeQuery mAddedEmitters;
+    ChangeQuery mChangedEmitters;
+    ChangeQuery mMovedInstances;
+
 private:
     int mFreeLightIndex = 0;
     std::unordered_map<int, int> mExternToInternID;
@@ -34,12 +34,8 @@ void gamedev::ParticleSystem::Init(SharedEngineECS& ecs)
     Init_PioneerDeathParticles();
     Init_BuildingDestroyedParticles();
 
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::MonsterDeath, ParticleSystem::ParticleListener));
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::PioneerDeath, ParticleSystem::ParticleListener));
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::BuildingDestroyed, ParticleSystem::ParticleListener));
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::BuildingHit, ParticleSystem::ParticleListener));
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::PioneerHit, ParticleSystem::ParticleListener));
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::MonsterHit, ParticleSystem::ParticleListener));
+    mHitEvents = mECS->CreateEventReader<HitEvent>();
+    mDeathEvents = mECS->CreateEventReader<DeathEvent>();
 }
 
 void gamedev::ParticleSystem::SetupParticleCount(int particleCount)
@@ -72,15 +68,18 @@ int gamedev::ParticleSystem::Update(float elapsed_time)
 
     mParticleAttributes.clear();
 
+    // Create new particles for hits & deaths
+    EmitEventParticles();
+
     // Create new particles for all emitters
     for (const auto& handle : mEntities)
     {
-        auto& xform = mECS->GetInstance(handle).xform;
+        auto& xform = mECS->GetInstanceTransform(handle);
         auto* particleEmitter = mECS->GetComponent<ParticleEmitter>(handle);
 
-        for (auto& pp : particleEmitter->pp)
+        for (auto i = 0; i < particleEmitter->numProperties; i++)
         {
-            auto& particleProperties = particleEmitter->pp;
+            auto& pp = particleEmitter->pp[i];
             pp.emitNew += elapsed_time * pp.particlesPerSecond;
 
             for (auto i = 0; i < tg::floor(pp.emitNew); i++)
@@ -167,9 +166,10 @@ void gamedev::ParticleSystem::EmitParticle(const ParticleProperties& particlePro
 
     if (mAlive >= MAX_PARTICLES * 0.8)
     {
+        // Only grow the pool, the vertex buffer is resized on upload (no GL calls, this may run on a worker thread)
         glow::error() << "Too many particles, need to increase storage!";
         MAX_PARTICLES += MAX_PARTICLES * 0.2;
-        SetupParticleCount(MAX_PARTICLES);
+        mParticlePool.resize(MAX_PARTICLES);
     }
 }
 
@@ -181,52 +181,35 @@ void gamedev::ParticleSystem::KillParticle(int id)
     mFreeIndex--;
 }
 
-void gamedev::ParticleSystem::ParticleListener(Event& e)
+void gamedev::ParticleSystem::EmitEventParticles()
 {
-    auto& instance = mECS->GetInstance(e.mSubject);
-
-    if (e.mType == EventType::MonsterDeath)
-    {
-        for (int i = 0; i < 20; i++)
-        {
-            EmitParticle(mMonsterDeath, instance.xform);
-        }
-    }
-    else if (e.mType == EventType::PioneerDeath)
-    {
-        for (int i = 0; i < 40; i++)
-        {
-            EmitParticle(mPioneerDeath, instance.xform);
-        }
-    }
-    else if (e.mType == EventType::BuildingDestroyed)
-    {
-        for (int i = 0; i < 20; i++)
-        {
-            EmitParticle(mBuildingDestroyed, instance.xform);
-        }
-    }
-    else if (e.mType == EventType::MonsterHit)
+    auto emit = [&](const ParticleProperties& particleProperties, transform xform, int count)
     {
-        for (int i = 0; i < 3; i++)
+        for (int i = 0; i < count; i++)
         {
-            EmitParticle(mMonsterDeath, instance.xform);
+            EmitParticle(particleProperties, xform);
         }
-    }
-    else if (e.mType == EventType::PioneerHit)
+    };
+
+    mDeathEvents.each([&](const DeathEvent& e)
     {
-        for (int i = 0; i < 10; i++)
-        {
-            EmitParticle(mPioneerDeath, instance.xform);
-        }
-    }
-    else if (e.mType == EventType::BuildingHit)
+        if (e.type == TargetType::Monster)
+            emit(mMonsterDeath, e.xform, 20);
+        else if (e.type == TargetType::Pioneer)
+            emit(mPioneerDeath, e.xform, 40);
+        else if (e.type == TargetType::Building)
+            emit(mBuildingDestroyed, e.xform, 20);
+    });
+
+    mHitEvents.each([&](const HitEvent& e)
     {
-        for (int i = 0; i < 2; i++)
-        {
-            EmitParticle(mBuildingDestroyed, instance.xform);
-        }
-    }
+        if (e.type == TargetType::Monster)
+            emit(mMonsterDeath, e.xform, 3);
+        else if (e.type == TargetType::Pioneer)
+            emit(mPioneerDeath, e.xform, 10);
+        else if (e.type == TargetType::Building)
+            emit(mBuildingDestroyed, e.xform, 2);
+    });
 }
 
 void gamedev::ParticleSystem::Init_MonsterDeathParticles()
@@ -357,12 +340,12 @@ void gamedev::GPUParticleSystem::Update(float elapsed_time)
     // Create new particles for all emitters
     for (const auto& handle : mEntities)
     {
-        auto& xform = mECS->GetInstance(handle).xform;
+        auto& xform = mECS->GetInstanceTransform(handle);
         auto* particleEmitter = mECS->GetComponent<ParticleEmitter>(handle);
 
-        for (auto& pp : particleEmitter->pp)
+        for (auto i = 0; i < particleEmitter->numProperties; i++)
         {
-            auto& particleProperties = particleEmitter->pp;
+            auto& pp = particleEmitter->pp[i];
             pp.emitNew += elapsed_time * pp.particlesPerSecond;
 
             upperBound += pp.particlesPerSecond * (pp.baseLife + pp.varyLife + 1)
@@ -451,9 +434,10 @@ void gamedev::GPUParticleSystem::EmitParticle(const ParticleProperties& particle
 
     if (mAlive >= MAX_PARTICLES * 0.8)
     {
+        // Only grow the pool, the vertex buffer is resized on upload (no GL calls, this may run on a worker thread)
         glow::error() << "Too many particles, need to increase storage!";
         MAX_PARTICLES += MAX_PARTICLES * 0.2;
-        SetupParticleCount(MAX_PARTICLES);
+        mParticlePool.resize(MAX_PARTICLES);
     }
 }
 
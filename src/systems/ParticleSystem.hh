@@ -33,12 +33,15 @@ private:
     void Init_PioneerDeathParticles();
     void Init_BuildingDestroyedParticles();
 
-private:
-    void ParticleListener(Event& e);
+    // Emits the particles of all hits & deaths since the last update.
+    void EmitEventParticles();
 
 private:
     std::shared_ptr<EngineECS> mECS;
 
+    EventReader<HitEvent> mHitEvents;
+    EventReader<DeathEvent> mDeathEvents;
+
     std::vector<Particle> mParticlePool;
     std::vector<ParticleAttributes> mParticleAttributes;
 
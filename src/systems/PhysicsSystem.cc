@@ -21,8 +21,6 @@ void gamedev::PhysicsSystem::RemoveAllEntities() { mEntities.clear(); }
 void gamedev::PhysicsSystem::Init(std::shared_ptr<EngineECS>& ecs)
 {
     mECS = ecs;
-
-    mECS->AddFunctionalListener(FUNCTIONAL_LISTENER(EventType::StaticCollision, PhysicsSystem::CollisionListener));
 }
 
 void gamedev::PhysicsSystem::SetTerrain(std::shared_ptr<Terrain>& t) {
@@ -33,22 +31,37 @@ int gamedev::PhysicsSystem::Update(float dt)
 {
     auto t0 = std::chrono::steady_clock::now();
 
-    for (const auto& handle : mEntities)
+    mNumAwake = 0;
+    mNumSleeping = 0;
+
+    mECS->View<Physics>(Exclude<InTower>{}).each([&](InstanceHandle handle, Physics& body)
     {
-        if (mECS->TestSignature<InTower>(handle))
-            continue;
+        auto& xform = mECS->GetInstanceTransform(handle);
+        auto InstanceBody = &body;
 
-        auto& Instance = mECS->GetInstance(handle);
-        auto InstanceBody = mECS->GetComponent<Physics>(handle);
-        InstanceBody->lastPosition = Instance.xform.translation;
+        // Sleeping: nothing to integrate & the ground below didn't change, a move order or any move wakes it
+        if (InstanceBody->velocity == tg::vec3::zero && xform.translation == InstanceBody->restPosition)
+        {
+            if (InstanceBody->idleSteps >= SleepSteps)
+            {
+                mNumSleeping++;
+                return;
+            }
+            InstanceBody->idleSteps++;
+        }
+        else
+            InstanceBody->idleSteps = 0;
+
+        mNumAwake++;
+        InstanceBody->lastPosition = xform.translation;
 
         // Move
         if (InstanceBody->velocity != tg::vec3::zero)
         {
 
             auto move = dt * InstanceBody->velocity;
-            Instance.xform.move_absolute(move);
-            Instance.new_position = true;
+            xform.move_absolute(move);
+            mECS->MarkTransformChanged(handle);
 
             // Gravity
             if (InstanceBody->gravity)
@@ -69,7 +82,7 @@ int gamedev::PhysicsSystem::Update(float dt)
 
                 auto slope = 2.f * a * InstanceBody->arc_x + b;
 
-                Instance.xform.translation.y = a * tg::pow2(InstanceBody->arc_x) + b * InstanceBody->arc_x + c;
+                xform.translation.y = a * tg::pow2(InstanceBody->arc_x) + b * InstanceBody->arc_x + c;
                 InstanceBody->arc_ySlope = slope;
             }
         }
@@ -77,32 +90,17 @@ int gamedev::PhysicsSystem::Update(float dt)
         // Update height
         if (InstanceBody->forceGround)
         {
-            float h = mTerrain->heightAt(tg::pos3::zero + Instance.xform.translation);
-            Instance.xform.translation.y = h;
-        }
-
-        if (Instance.new_position && (mUpdateControl % 10))
-        {
-            auto e = Event(EventType::NewPosition, handle, handle);
-            mECS->SendFunctionalEvent(e);
-            UpdateHashmap(handle, Instance.xform.translation);
+            float h = mTerrain->heightAt(tg::pos3::zero + xform.translation);
+            if (xform.translation.y != h)
+            {
+                xform.translation.y = h;
+                mECS->MarkTransformChanged(handle);
+            }
         }
-    }
 
-    mUpdateControl++;
+        InstanceBody->restPosition = xform.translation;
+    });
 
     auto tn = std::chrono::steady_clock::now();
     return std::chrono::duration_cast<std::chrono::microseconds>(tn - t0).count();
 }
-
-void gamedev::PhysicsSystem::UpdateHashmap(InstanceHandle handle, tg::vec3& translation) { mECS->GetHashMap().UpdateInstance(handle, translation); }
-
-void gamedev::PhysicsSystem::CollisionListener(Event& e)
-{
-    auto physics = mECS->TryGetComponent<Physics>(e.mSubject);
-
-    if (physics)
-    {
-        physics->lastPosition = mECS->GetInstanceTransform(e.mSubject).translation;
-    }
-}
\ No newline at end of file
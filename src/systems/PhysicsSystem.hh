@@ -23,17 +23,18 @@ public:
 
     int Update(float dt);
 
-private:
-    void UpdateHashmap(InstanceHandle handle, tg::vec3& translation);
-    void CollisionListener(Event& e);
+    // Bodies outside of towers of the last update
+    size_t GetNumAwake() const { return mNumAwake; }
+    size_t GetNumSleeping() const { return mNumSleeping; }
 
-private:
-    int mUpdateControl = 0;
+    static constexpr uint16_t SleepSteps = 30; // idle steps before a body is skipped
 
 private:
     const float mGravity = -9.81f;
     const float mDamping = 0.02f;
     float last_dt = 0.0;
+    size_t mNumAwake = 0;
+    size_t mNumSleeping = 0;
 
 private:
     std::shared_ptr<EngineECS> mECS;
@@ -0,0 +1,280 @@
+#include "utility/ContactSolver.hh"
+#include <algorithm>
+#include <assert.h>
+
+void gamedev::ContactSolver::Clear()
+{
+    mShapes.clear();
+    mCorrections.clear();
+    mMovable.clear();
+    mContacts.clear();
+
+    mNumIslands = 0;
+    mNumColors = 0;
+}
+
+uint32_t gamedev::ContactSolver::AddBody(const WorldShape& shape, bool movable)
+{
+    mShapes.push_back(shape);
+    mCorrections.push_back(tg::vec2::zero);
+    mMovable.push_back(movable);
+
+    return uint32_t(mShapes.size() - 1);
+}
+
+void gamedev::ContactSolver::AddContact(uint32_t first, uint32_t second)
+{
+    assert(first < mShapes.size() && second < mShapes.size() && "Unknown body");
+    assert((mMovable[first] || mMovable[second]) && "Contact between two immovable bodies");
+
+    mContacts.push_back({first, second});
+}
+
+uint32_t gamedev::ContactSolver::Find_(uint32_t body)
+{
+    while (mParent[body] != body)
+    {
+        mParent[body] = mParent[mParent[body]];
+        body = mParent[body];
+    }
+    return body;
+}
+
+void gamedev::ContactSolver::BuildIslands_()
+{
+    auto const numBodies = mShapes.size();
+    auto const numContacts = mContacts.size();
+
+    // Link the movable bodies of all contacts
+    mParent.resize(numBodies);
+    for (uint32_t b = 0; b < numBodies; ++b)
+        mParent[b] = b;
+
+    for (auto const& c : mContacts)
+    {
+        if (!mMovable[c.first] || !mMovable[c.second])
+            continue;
+
+        auto const a = Find_(c.first);
+        auto const b = Find_(c.second);
+        if (a < b)
+            mParent[b] = a;
+        else if (b < a)
+            mParent[a] = b;
+    }
+
+    // Islands are numbered by their first contact
+    mIslandOf.assign(numBodies, Invalid);
+    mIslands.resize(numContacts);
+    mIslandStart.clear();
+    mNumIslands = 0;
+
+    for (size_t i = 0; i < numContacts; ++i)
+    {
+        auto const& c = mContacts[i];
+        auto const root = Find_(mMovable[c.first] ? c.first : c.second);
+
+        if (mIslandOf[root] == Invalid)
+        {
+            mIslandOf[root] = uint32_t(mNumIslands++);
+            mIslandStart.push_back(0);
+        }
+
+        mIslands[i] = mIslandOf[root];
+        ++mIslandStart[mIslands[i]];
+    }
+
+    // Counting sort by island, stable
+    uint32_t offset = 0;
+    for (auto& start : mIslandStart)
+    {
+        auto const count = start;
+        start = offset;
+        offset += count;
+    }
+    mIslandStart.push_back(offset);
+
+    mOrder.resize(numContacts);
+    std::vector<uint32_t> next(mIslandStart.begin(), mIslandStart.end() - 1);
+    for (uint32_t i = 0; i < numContacts; ++i)
+        mOrder[next[mIslands[i]]++] = i;
+
+    // Consecutive small islands share a task, large islands are coloured instead
+    size_t small = 0;
+    for (size_t i = 0; i < mNumIslands; ++i)
+    {
+        auto const size = mIslandStart[i + 1] - mIslandStart[i];
+        if (size <= ColoringThreshold)
+            small += size;
+    }
+
+    auto const batchSize = std::max(MinTaskContacts, small / (4 * mNumThreads) + 1);
+
+    mIslandBatches.clear();
+    Batch batch = {0, 0};
+    for (size_t i = 0; i < mNumIslands; ++i)
+    {
+        auto const begin = mIslandStart[i];
+        auto const end = mIslandStart[i + 1];
+
+        if (end - begin > ColoringThreshold)
+        {
+            if (batch.end > batch.begin)
+                mIslandBatches.push_back(batch);
+            batch = {end, end};
+            continue;
+        }
+
+        batch.end = end;
+        if (batch.end - batch.begin >= batchSize)
+        {
+            mIslandBatches.push_back(batch);
+            batch = {end, end};
+        }
+    }
+    if (batch.end > batch.begin)
+        mIslandBatches.push_back(batch);
+}
+
+void gamedev::ContactSolver::ColorIslands_()
+{
+    mColorMasks.assign(mShapes.size(), 0);
+    mColorOf.assign(mContacts.size(), Invalid);
+    mColored.clear();
+    mColorBatches.clear();
+    mColorBatchStart.clear();
+    mNumColors = 0;
+
+    // Greedy: the lowest colour which none of the movable bodies of a contact uses yet
+    std::vector<uint32_t> counts(Overflow + 1, 0);
+    for (size_t i = 0; i < mNumIslands; ++i)
+    {
+        if (mIslandStart[i + 1] - mIslandStart[i] <= ColoringThreshold)
+            continue;
+
+        for (auto k = mIslandStart[i]; k < mIslandStart[i + 1]; ++k)
+        {
+            auto const& c = mContacts[mOrder[k]];
+            uint64_t const used = (mMovable[c.first] ? mColorMasks[c.first] : 0) | (mMovable[c.second] ? mColorMasks[c.second] : 0);
+
+            uint32_t color = 0;
+            while (color < Overflow && (used >> color & 1))
+                ++color;
+
+            if (color < Overflow)
+            {
+                if (mMovable[c.first])
+                    mColorMasks[c.first] |= uint64_t(1) << color;
+                if (mMovable[c.second])
+                    mColorMasks[c.second] |= uint64_t(1) << color;
+            }
+
+            mColorOf[mOrder[k]] = color;
+            ++counts[color];
+            mNumColors = std::max(mNumColors, size_t(color) + 1);
+        }
+    }
+
+    if (mNumColors == 0)
+        return;
+
+    // Group by colour (stable), each colour is split into tasks, the overflow stays in one
+    std::vector<size_t> next(mNumColors + 1, 0);
+    for (size_t color = 0; color < mNumColors; ++color)
+        next[color + 1] = next[color] + counts[color];
+
+    mColored.resize(next[mNumColors]);
+    for (auto const i : mOrder)
+        if (mColorOf[i] != Invalid)
+            mColored[next[mColorOf[i]]++] = i;
+
+    size_t begin = 0;
+    for (size_t color = 0; color < mNumColors; ++color)
+    {
+        size_t const count = counts[color];
+        auto const end = begin + count;
+        auto const size = color == Overflow ? count : std::max(MinTaskContacts, (count + mNumThreads - 1) / mNumThreads);
+
+        mColorBatchStart.push_back(uint32_t(mColorBatches.size()));
+        Split_(begin, end, size, mColorBatches);
+        begin = end;
+    }
+    mColorBatchStart.push_back(uint32_t(mColorBatches.size()));
+}
+
+void gamedev::ContactSolver::Project_(uint32_t contact)
+{
+    auto const& c = mContacts[contact];
+
+    auto first = mShapes[c.first];
+    auto second = mShapes[c.second];
+    first.center += mCorrections[c.first];
+    second.center += mCorrections[c.second];
+
+    auto const push = Narrowphase::Push(first, second);
+
+    if (mMovable[c.first] && mMovable[c.second])
+    {
+        mCorrections[c.first] += 0.5f * push;
+        mCorrections[c.second] -= 0.5f * push;
+    }
+    else if (mMovable[c.first])
+        mCorrections[c.first] += push;
+    else
+        mCorrections[c.second] -= push;
+}
+
+void gamedev::ContactSolver::Split_(size_t begin, size_t end, size_t size, std::vector<Batch>& batches) const
+{
+    for (auto b = begin; b < end; b += size)
+        batches.push_back({b, std::min(b + size, end)});
+}
+
+void gamedev::ContactSolver::Run_(ThreadPool* pool, std::vector<uint32_t> const& contacts, Batch const* batches, size_t count, int iterations)
+{
+    auto const project = [this, &contacts, iterations](Batch const& batch)
+    {
+        for (int it = 0; it < iterations; ++it)
+            for (auto k = batch.begin; k < batch.end; ++k)
+                Project_(contacts[k]);
+    };
+
+    if (!pool || count <= 1)
+    {
+        for (size_t i = 0; i < count; ++i)
+            project(batches[i]);
+        return;
+    }
+
+    mTasks.clear();
+    for (size_t i = 0; i < count; ++i)
+        mTasks.push_back([&project, batch = batches[i]] { project(batch); });
+
+    pool->Run(mTasks);
+}
+
+void gamedev::ContactSolver::Solve(ThreadPool* pool)
+{
+    if (mContacts.empty())
+        return;
+
+    // Only the size of the tasks depends on the threads, not the order of the projections
+    mNumThreads = pool ? pool->GetNumThreads() : 1;
+
+    BuildIslands_();
+    ColorIslands_();
+
+    // Small islands run all iterations within their task
+    Run_(pool, mOrder, mIslandBatches.data(), mIslandBatches.size(), Iterations);
+
+    // Large islands colour by colour, every colour depends on the corrections of the previous ones
+    for (int it = 0; it < Iterations; ++it)
+    {
+        for (size_t color = 0; color < mNumColors; ++color)
+        {
+            auto const begin = mColorBatchStart[color];
+            auto const end = mColorBatchStart[color + 1];
+            Run_(pool, mColored, mColorBatches.data() + begin, end - begin, 1);
+        }
+    }
+}
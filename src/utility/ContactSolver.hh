@@ -0,0 +1,108 @@
+#pragma once
+#include "typed-geometry/tg.hh"
+#include "utility/Narrowphase.hh"
+#include "utility/ThreadPool.hh"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Position based contact solver (XZ-plane): pushes overlapping bodies apart with a fixed number of iterations.
+*
+*    - Bodies are gathered first (shape at the start of the solve, movable or not), contacts refer to them by index.
+*    - A contact is projected by re-testing both shapes at their current corrections (Narrowphase::Push) & moving
+*      the movable sides out of each other, half each if both are movable.
+*    - Contacts are projected in the order they were added, one after another (Gauss-Seidel).
+*
+* Contacts which share a movable body are linked into islands, immovable bodies don't link them.
+* Islands don't influence each other, so they are solved in parallel:
+*    - Small islands are grouped into tasks which run all iterations on their own.
+*    - Large islands (e.g. a crowd pressing against a wall) are split by a greedy graph colouring.
+*      Contacts of the same colour share no movable body & run in parallel, colours run in order.
+*
+* The order of projections only depends on the order of the contacts, so the corrections are identical for any number of threads.
+*
+*    mSolver.Clear();
+*    auto a = mSolver.AddBody(shapeOfA, true);
+*    auto b = mSolver.AddBody(shapeOfB, false);
+*    mSolver.AddContact(a, b);
+*    mSolver.Solve(pool);
+*    auto correction = mSolver.GetCorrection(a);
+*
+***/
+class ContactSolver
+{
+public:
+    static constexpr int Iterations = 4;
+    static constexpr size_t ColoringThreshold = 256; // contacts of an island before it is split into colours
+    static constexpr size_t MinTaskContacts = 64;    // per task, smaller batches cost more to hand out than to solve
+
+    void Clear();
+
+    uint32_t AddBody(const WorldShape& shape, bool movable);
+
+    // At least one of the bodies has to be movable.
+    void AddContact(uint32_t first, uint32_t second);
+
+    // Runs on the calling thread without a pool.
+    void Solve(ThreadPool* pool = nullptr);
+
+    const WorldShape& GetShape(uint32_t body) const { return mShapes[body]; }
+    tg::vec2 GetCorrection(uint32_t body) const { return mCorrections[body]; }
+
+    size_t GetNumBodies() const { return mShapes.size(); }
+    size_t GetNumContacts() const { return mContacts.size(); }
+    size_t GetNumIslands() const { return mNumIslands; }
+    size_t GetNumColors() const { return mNumColors; }
+
+private:
+    static constexpr uint32_t Invalid = uint32_t(-1);
+    static constexpr uint32_t Overflow = 64; // colour of contacts whose bodies used up all colours, solved sequentially
+
+    struct Contact
+    {
+        uint32_t first;
+        uint32_t second;
+    };
+
+    // Range of mOrder or mColored, projected by one task
+    struct Batch
+    {
+        size_t begin;
+        size_t end;
+    };
+
+    uint32_t Find_(uint32_t body);
+    void BuildIslands_();
+    void ColorIslands_();
+    void Project_(uint32_t contact);
+    void Split_(size_t begin, size_t end, size_t size, std::vector<Batch>& batches) const;
+    void Run_(ThreadPool* pool, std::vector<uint32_t> const& contacts, Batch const* batches, size_t count, int iterations);
+
+private:
+    std::vector<WorldShape> mShapes;
+    std::vector<tg::vec2> mCorrections;
+    std::vector<uint8_t> mMovable;
+    std::vector<Contact> mContacts;
+
+    std::vector<uint32_t> mParent;      // union-find over the bodies, the root is the smallest body of a set
+    std::vector<uint32_t> mIslandOf;    // by root body
+    std::vector<uint32_t> mIslands;     // by contact
+    std::vector<uint32_t> mIslandStart; // into mOrder, by island (+ end)
+    std::vector<uint32_t> mOrder;       // contacts grouped by island, in contact order within an island
+    size_t mNumIslands = 0;
+
+    std::vector<Batch> mIslandBatches;      // small islands, whole islands per batch
+    std::vector<uint64_t> mColorMasks;      // colours used by a body
+    std::vector<uint32_t> mColorOf;         // by contact
+    std::vector<uint32_t> mColored;         // contacts of the large islands grouped by colour
+    std::vector<Batch> mColorBatches;       // by colour, split into tasks
+    std::vector<uint32_t> mColorBatchStart; // into mColorBatches, by colour (+ end)
+    size_t mNumColors = 0;
+
+    unsigned mNumThreads = 1;
+    std::vector<std::function<void()>> mTasks;
+};
+}
@@ -2,20 +2,50 @@
 #include "advanced/World.hh"
 #include "typed-geometry/tg-lean.hh"
 #include <set>
+#include <vector>
 
 typedef std::pair<tg::ipos2, tg::ipos2> Hash2Indices;
 typedef std::pair<tg::ipos3, tg::ipos3> Hash3Indices;
 
 namespace gamedev
 {
+// Categories (layers) of spatial index entries, combined to a bitmask
+enum SpatialCategory : uint32_t
+{
+    SpatialFriendly = 1u << 0,
+    SpatialHostile = 1u << 1,
+    SpatialUnit = 1u << 2,      // Living
+    SpatialStructure = 1u << 3, // non-living collider (buildings, walls, nature)
+    SpatialItem = 1u << 4,      // everything else (weapons, arrows, ...)
+    SpatialStatic = 1u << 5,    // static collider
+    SpatialDynamic = 1u << 6,   // dynamic collider
+};
+
+using SpatialMask = uint32_t;
+
+// Result of a distance query
+struct SpatialHit
+{
+    InstanceHandle handle;
+    float distance_sqr = 0.f;
+};
+
+// Result of a segment query
+struct SpatialRayHit
+{
+    InstanceHandle handle;
+    float t = 0.f; // entry point along the segment, in [0, 1]
+};
+
 // For 2D Spatial Hash Maps
 struct Hash2Client
 {
     InstanceHandle handle = {std::uint32_t(-1)};
     tg::vec2 translation;
     tg::aabb2 dimensions;
-    Hash2Indices indicies;  // form aabb inside the spatial grid
-    int queryID = -1;       // to deduplicate on retrieval
+    Hash2Indices indicies;       // form aabb inside the spatial grid
+    SpatialMask categories = 0;
+    std::vector<uint32_t> slots; // position inside the list of each covered cell (row by row), for O(1) removal
 
     const bool operator<(const Hash2Client& rhs) const { return handle._value < rhs.handle._value; }
     const bool operator==(const Hash2Client& rhs) const { return handle._value == rhs.handle._value; }
@@ -1,5 +1,5 @@
 #include "utility/HashMap.hh"
-#include <string>
+#include <assert.h>
 
 void gamedev::Hash2D::Init(tg::size2 cellCount, tg::aabb2 bounds)
 {
@@ -8,20 +8,18 @@ void gamedev::Hash2D::Init(tg::size2 cellCount, tg::aabb2 bounds)
     mMaxCells.width -= 1;
     mMaxCells.height -= 1;
     mBounds = bounds;
-}
 
-void gamedev::Hash2D::Init(tg::size2 cellCount, tg::aabb3 bounds)
-{
-    tg::aabb2 bounds2D;
-    bounds2D.min = {bounds.min.x, bounds.min.z};
-    bounds2D.max = {bounds.max.x, bounds.max.z};
+    mCellCount = {int(mMaxCells.width) + 1, int(mMaxCells.height) + 1};
+    assert(mCellCount.width > 0 && mCellCount.height > 0 && mCellCount.width <= 0xFFFF && mCellCount.height <= 0xFFFF && "Invalid grid size.");
 
-    Init(cellCount, bounds2D);
+    mCells.clear();
+    mCells.resize(size_t(mCellCount.width) * size_t(mCellCount.height));
+    mClients.clear();
 }
 
-int gamedev::Hash2D::GetIndexID_(tg::ipos2 pos) { return pos.y * mMaxCells.width + pos.x; }
+int gamedev::Hash2D::GetIndexID_(tg::ipos2 pos) const { return pos.y * mCellCount.width + pos.x; }
 
-tg::ipos2 gamedev::Hash2D::PositionToGrid_(const tg::pos2& position)
+tg::ipos2 gamedev::Hash2D::PositionToGrid_(const tg::pos2& position) const
 {
     tg::vec2 spatial_coordinate;
 
@@ -33,7 +31,7 @@ tg::ipos2 gamedev::Hash2D::PositionToGrid_(const tg::pos2& position)
     return tg::ipos2(spatial_coordinate * mMaxCells);
 }
 
-tg::ipos2 gamedev::Hash2D::PositionToGrid_(const tg::pos3& position)
+tg::ipos2 gamedev::Hash2D::PositionToGrid_(const tg::pos3& position) const
 {
     tg::vec2 spatial_coordinate;
 
@@ -44,170 +42,316 @@ tg::ipos2 gamedev::Hash2D::PositionToGrid_(const tg::pos3& position)
     return tg::ipos2(spatial_coordinate * mMaxCells);
 }
 
+Hash2Indices gamedev::Hash2D::CellsOf_(const Hash2Client& c) const
+{
+    return {PositionToGrid_(c.dimensions.min + c.translation), PositionToGrid_(c.dimensions.max + c.translation)};
+}
+
+gamedev::Hash2Client* gamedev::Hash2D::TryGetClient_(InstanceHandle handle)
+{
+    auto const index = handle.index();
+    if (index >= mClients.size() || !(mClients[index].handle == handle))
+        return nullptr;
+
+    return &mClients[index];
+}
+
 void gamedev::Hash2D::Insert_(Hash2Client& c)
 {
-    auto i1 = PositionToGrid_(c.dimensions.min + c.translation);
-    auto i2 = PositionToGrid_(c.dimensions.max + c.translation);
+    auto const [i1, i2] = c.indicies;
 
-    c.indicies = {i1, i2};
+    c.slots.clear();
 
-    for (int x = i1.x; x <= i2.x; x++)
+    for (int y = i1.y; y <= i2.y; y++)
     {
-        for (int y = i1.y; y <= i2.y; y++)
+        for (int x = i1.x; x <= i2.x; x++)
         {
-            tg::ipos2 pos{x, y};
-            //auto k = _Key(pos);
-            auto k = GetIndexID_(pos);
-
-            if (mBinMap.find(k) == mBinMap.end())
-            {
-                mBinMap.insert({k, std::vector<Hash2Client>()});
-            }
+            auto& cell = mCells[GetIndexID_({x, y})];
 
-            mBinMap[k].push_back(c);
-            mClientMap.insert_or_assign(c.handle, c);
+            c.slots.push_back(uint32_t(cell.size()));
+            cell.push_back({c.handle, uint16_t(i1.x), uint16_t(i1.y), uint16_t(i2.x), uint16_t(i2.y), uint32_t(c.slots.size() - 1), c.categories});
         }
     }
 }
 
 void gamedev::Hash2D::Remove_(Hash2Client& c)
 {
-    auto i1 = c.indicies.first;
-    auto i2 = c.indicies.second;
+    auto const [i1, i2] = c.indicies;
 
-    for (int x = i1.x; x <= i2.x; x++)
+    uint32_t slot = 0;
+    for (int y = i1.y; y <= i2.y; y++)
     {
-        for (int y = i1.y; y <= i2.y; y++)
+        for (int x = i1.x; x <= i2.x; x++)
         {
-            tg::ipos2 pos{x, y};
-            //auto k = _Key(pos);
-            auto k = GetIndexID_(pos);
-
-            auto& container = mBinMap[k];
-            for (int i = 0; i < container.size(); i++)
-            {
-                if (container[i].handle == c.handle)
-                {
-                    std::swap(container[i], container.back());
-                    container.pop_back();
-                }
-            }
+            auto& cell = mCells[GetIndexID_({x, y})];
+            auto const position = c.slots[slot++];
+
+            // Move the last entry into the gap & tell its client
+            auto const& moved = cell.back();
+            mClients[moved.handle.index()].slots[moved.slot] = position;
+            cell[position] = moved;
+            cell.pop_back();
         }
     }
-}
 
-std::string gamedev::Hash2D::Key_(const tg::ipos2& p) { return std::to_string(p.x) + "." + std::to_string(p.y); }
+    c.slots.clear();
+}
 
-void gamedev::Hash2D::AddInstance(const InstanceHandle handle, const tg::vec3& translation, const tg::aabb3& dimensions)
+void gamedev::Hash2D::AddInstance(const InstanceHandle handle, const tg::vec3& translation, const tg::aabb3& dimensions, SpatialMask categories)
 {
-    if (mClientMap.find(handle) != mClientMap.end())
+    if (mCells.empty() || Contains(handle))
         return;
 
-    tg::pos2 min = {dimensions.min.x, dimensions.min.z};
-    tg::pos2 max = {dimensions.max.x, dimensions.max.z};
+    if (handle.index() >= mClients.size())
+        mClients.resize(handle.index() + 1);
 
     // Create a new internal client which holds some easy access information
-    Hash2Client hc2{handle, {translation.x, translation.z}, {min, max}, {}, 0};
-
-    Insert_(hc2);
+    auto& c = mClients[handle.index()];
+    c.handle = handle;
+    c.translation = {translation.x, translation.z};
+    c.dimensions.min = {dimensions.min.x, dimensions.min.z};
+    c.dimensions.max = {dimensions.max.x, dimensions.max.z};
+    c.categories = categories;
+    c.indicies = CellsOf_(c);
+
+    Insert_(c);
 }
 
 void gamedev::Hash2D::UpdateInstance(const InstanceHandle handle, const tg::vec3& translation)
 {
-    if (mClientMap.find(handle) != mClientMap.end())
-    {
-        auto& c = mClientMap[handle];
-        c.translation.x = translation.x;
-        c.translation.y = translation.z;
+    auto c = TryGetClient_(handle);
+    if (!c)
+        return;
 
-        Remove_(c);
-        Insert_(c);
-    }
+    c->translation.x = translation.x;
+    c->translation.y = translation.z;
+
+    // Most moves stay within the covered cells
+    auto const cells = CellsOf_(*c);
+    if (cells == c->indicies)
+        return;
+
+    Remove_(*c);
+    c->indicies = cells;
+    Insert_(*c);
 }
 
 void gamedev::Hash2D::UpdateInstance(const InstanceHandle handle, const tg::vec3& translation, const tg::aabb3& dimensions)
 {
-    if (mClientMap.find(handle) != mClientMap.end())
-    {
-        auto& c = mClientMap[handle];
-        c.translation.x = translation.x;
-        c.translation.y = translation.z;
-        c.dimensions.min = {dimensions.min.x, dimensions.min.z};
-        c.dimensions.max = {dimensions.max.x, dimensions.max.z};
-
-        Remove_(c);
-        Insert_(c);
-    }
+    auto c = TryGetClient_(handle);
+    if (!c)
+        return;
+
+    c->dimensions.min = {dimensions.min.x, dimensions.min.z};
+    c->dimensions.max = {dimensions.max.x, dimensions.max.z};
+
+    UpdateInstance(handle, translation);
 }
 
 void gamedev::Hash2D::RemoveInstance(InstanceHandle handle)
 {
-    if (mClientMap.find(handle) == mClientMap.end())
-    {
+    auto c = TryGetClient_(handle);
+    if (!c)
+        return;
+
+    Remove_(*c);
+    c->handle = {std::uint32_t(-1)};
+}
+
+void gamedev::Hash2D::SetCategories(const InstanceHandle handle, SpatialMask categories)
+{
+    auto c = TryGetClient_(handle);
+    if (!c)
         return;
+
+    c->categories = categories;
+
+    auto const [i1, i2] = c->indicies;
+
+    uint32_t slot = 0;
+    for (int y = i1.y; y <= i2.y; y++)
+    {
+        for (int x = i1.x; x <= i2.x; x++)
+            mCells[GetIndexID_({x, y})][c->slots[slot++]].categories = categories;
     }
+}
 
-    auto c = mClientMap[handle];
-    Remove_(c);
+gamedev::SpatialMask gamedev::Hash2D::GetCategories(const InstanceHandle handle) const
+{
+    return Contains(handle) ? mClients[handle.index()].categories : 0;
 }
 
-std::unordered_set<gamedev::InstanceHandle, gamedev::InstanceHandleHash> gamedev::Hash2D::FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max)
+bool gamedev::Hash2D::Contains(const InstanceHandle handle) const
 {
-    // find area to search for instances
-    auto i1 = PositionToGrid_(min + translation);
-    auto i2 = PositionToGrid_(max + translation);
+    auto const index = handle.index();
+    return index < mClients.size() && mClients[index].handle == handle;
+}
 
-    // instance container
-    std::unordered_set<InstanceHandle, InstanceHandleHash> handles;
+void gamedev::Hash2D::FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, std::vector<InstanceHandle>& result) const
+{
+    result.clear();
+    ForEachNear(translation, min, max, categories, [&](InstanceHandle handle) { result.push_back(handle); });
+}
+
+void gamedev::Hash2D::FindInRadius(const tg::pos3& center, float radius, SpatialMask categories, std::vector<InstanceHandle>& result) const
+{
+    result.clear();
+    ForEachInRadius(center, radius, categories, [&](InstanceHandle handle, float) { result.push_back(handle); });
+}
 
-    // ensure uniqueness
-    int queryID = mQueryIDs++;
+void gamedev::Hash2D::FindNearest(const tg::pos3& center, float maxRadius, SpatialMask categories, size_t k, std::vector<SpatialHit>& result) const
+{
+    result.clear();
 
-    // search whole area
-    for (int x = i1.x; x <= i2.x; x++)
+    if (mCells.empty() || k == 0)
+        return;
+
+    // result is kept as a max-heap of the best k hits, so the farthest one is on top
+    auto const nearer = [](SpatialHit const& a, SpatialHit const& b) { return a.distance_sqr < b.distance_sqr; };
+
+    auto const c = PositionToGrid_(center);
+    auto const radius_sqr = maxRadius * maxRadius;
+
+    // Smallest distance across a cell, a center outside the grid is clamped onto it
+    auto const extent = mBounds.max - mBounds.min;
+    float const cellWidth = mMaxCells.width > 0 ? extent.x / mMaxCells.width : tg::inf<float>;
+    float const cellHeight = mMaxCells.height > 0 ? extent.y / mMaxCells.height : tg::inf<float>;
+    float const cellExtent = tg::min(cellWidth, cellHeight);
+    auto const center2D = tg::pos2(center.x, center.z);
+    auto const clamped = tg::pos2(tg::clamp(center2D.x, mBounds.min.x, mBounds.max.x), tg::clamp(center2D.y, mBounds.min.y, mBounds.max.y));
+    float const offGrid = tg::distance(center2D, clamped);
+
+    for (int r = 0;; ++r)
     {
-        for (int y = i1.y; y <= i2.y; y++)
+        int const x0 = c.x - r, x1 = c.x + r;
+        int const y0 = c.y - r, y1 = c.y + r;
+
+        // Visit the ring of cells at (chebyshev) distance r around the center cell
+        for (int y = std::max(y0, 0); y <= std::min(y1, mCellCount.height - 1); y++)
         {
-            tg::ipos2 pos{x, y};
-            //auto k = _Key(pos);
-            auto k = GetIndexID_(pos);
+            bool const fullRow = (y == y0 || y == y1);
 
-            // sanity check + instance retrieval
-            if (mBinMap.find(k) != mBinMap.end())
+            for (int x = fullRow ? std::max(x0, 0) : x0; x <= x1; x += fullRow ? 1 : x1 - x0)
             {
-                for (auto& v : mBinMap[k])
+                if (x < 0 || x >= mCellCount.width)
+                    continue;
+
+                for (auto const& e : mCells[GetIndexID_({x, y})])
                 {
-                    // uniqueness check: if instance was already added during this query, its queryID will match
-                    if (v.queryID != queryID)
+                    if (!e.Matches(categories))
+                        continue;
+
+                    // Already reported by an inner ring
+                    if (r > 0 && e.firstX < x1 && e.lastX > x0 && e.firstY < y1 && e.lastY > y0)
+                        continue;
+
+                    // The part of the instance inside this ring lies on one of its sides, report it at its first cell
+                    if (x != std::max(int(e.firstX), x0) || y != std::max(int(e.firstY), y0))
+                        continue;
+
+                    auto const distance_sqr = DistanceSqr_(e, center);
+                    if (distance_sqr > radius_sqr)
+                        continue;
+
+                    if (result.size() == k)
                     {
-                        v.queryID = queryID;
-                        handles.insert(v.handle);
+                        if (distance_sqr >= result.front().distance_sqr)
+                            continue;
+
+                        std::pop_heap(result.begin(), result.end(), nearer);
+                        result.pop_back();
                     }
+
+                    result.push_back({e.handle, distance_sqr});
+                    std::push_heap(result.begin(), result.end(), nearer);
                 }
             }
         }
+
+        // Whole grid visited
+        if (x0 <= 0 && y0 <= 0 && x1 >= mCellCount.width - 1 && y1 >= mCellCount.height - 1)
+            break;
+
+        // Early out: every instance in the remaining rings is at least that far away
+        float const bound = r * cellExtent - offGrid;
+        if (bound > maxRadius)
+            break;
+
+        if (result.size() == k && bound > 0.f && result.front().distance_sqr <= bound * bound)
+            break;
     }
 
-    return handles;
+    std::sort_heap(result.begin(), result.end(), nearer);
 }
 
-std::unordered_set<gamedev::InstanceHandle, gamedev::InstanceHandleHash> gamedev::Hash2D::FindNear(const tg::vec3& translation, const tg::aabb3& bounds)
+void gamedev::Hash2D::FindAlongSegment(const tg::pos3& from, const tg::pos3& to, float radius, SpatialMask categories, std::vector<SpatialRayHit>& result) const
 {
-    return FindNear(translation, bounds.min, bounds.max);
-}
+    result.clear();
 
-std::unordered_set<gamedev::InstanceHandle, gamedev::InstanceHandleHash> gamedev::Hash2D::FindNear(const tg::vec3& translation, const tg::size3& bounds)
-{
-    return FindNear(translation, {-bounds.width, 0, -bounds.depth}, {bounds.width, 0, bounds.depth});
-}
+    if (mCells.empty())
+        return;
 
-std::unordered_set<gamedev::InstanceHandle, gamedev::InstanceHandleHash> gamedev::Hash2D::FindNear(const tg::pos3& position)
-{
-    return FindNear(tg::vec3(position), tg::pos3::zero, tg::pos3::zero);
+    auto const from2D = tg::pos2(from.x, from.z);
+    auto const delta = tg::vec2(to.x - from.x, to.z - from.z);
+    auto const grow = tg::vec2(radius, radius);
+
+    // Cells are only narrowed down, the bounds decide; a small margin keeps rounding from skipping a cell
+    auto const margin = radius + 1e-3f;
+    float const rowHeight = (mBounds.max.y - mBounds.min.y) / tg::max(mMaxCells.height, 1.f);
+
+    auto const first = PositionToGrid_(tg::pos2(from2D.x, tg::min(from.z, to.z) - margin)).y;
+    auto const last = PositionToGrid_(tg::pos2(from2D.x, tg::max(from.z, to.z) + margin)).y;
+
+    for (int y = first; y <= last; y++)
+    {
+        // Z-range of the row, the outer rows hold everything beyond the bounds
+        float const z0 = y == 0 ? -tg::inf<float> : mBounds.min.y + y * rowHeight - margin;
+        float const z1 = y == mCellCount.height - 1 ? tg::inf<float> : mBounds.min.y + (y + 1) * rowHeight + margin;
+
+        // Part of the segment within the row
+        float t0 = 0.f;
+        float t1 = 1.f;
+        if (delta.y != 0.f)
+        {
+            auto a = (z0 - from2D.y) / delta.y;
+            auto b = (z1 - from2D.y) / delta.y;
+            if (a > b)
+                std::swap(a, b);
+
+            t0 = tg::max(t0, a);
+            t1 = tg::min(t1, b);
+            if (t0 > t1)
+                continue;
+        }
+
+        auto const x0 = tg::min(from2D.x + t0 * delta.x, from2D.x + t1 * delta.x) - margin;
+        auto const x1 = tg::max(from2D.x + t0 * delta.x, from2D.x + t1 * delta.x) + margin;
+
+        for (int x = PositionToGrid_(tg::pos2(x0, from2D.y)).x; x <= PositionToGrid_(tg::pos2(x1, from2D.y)).x; x++)
+        {
+            for (auto const& e : mCells[GetIndexID_({x, y})])
+            {
+                if (!e.Matches(categories))
+                    continue;
+
+                auto const& c = mClients[e.handle.index()];
+                auto const bounds = tg::aabb2(c.dimensions.min + c.translation - grow, c.dimensions.max + c.translation + grow);
+
+                float t;
+                if (IntersectSegment(bounds, from2D, delta, t))
+                    result.push_back({e.handle, t});
+            }
+        }
+    }
+
+    // Instances spanning several cells are found once per cell
+    SortAlongSegment_(result);
 }
 
 void gamedev::Hash2D::Clear()
 {
-    mBinMap.clear();
-    mClientMap.clear();
-}
\ No newline at end of file
+    for (auto& cell : mCells)
+        cell.clear();
+
+    mClients.clear();
+}
@@ -1,9 +1,11 @@
 #pragma once
 #include "advanced/World.hh"
 #include "utility/HashData.hh"
+#include "utility/SpatialIndex.hh"
 #include "typed-geometry/tg.hh"
-#include <unordered_set>
-#include <unordered_map>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
 #include <set>
 #include <map>
 
@@ -18,37 +20,156 @@ struct less<tg::ipos2>
 
 namespace gamedev
 {
-class Hash2D
+/***
+* Uniform 2D grid (XZ-plane) over a fixed area, every instance is listed in all cells its bounds overlap.
+*
+*    - Cells are a dense array of compact lists (handle + bookkeeping), no hashing on insert or lookup.
+*    - Clients are stored by the slot index of their handle and remember their position inside each cell list,
+*      so removing or moving an instance never scans a cell.
+*    - Moving an instance inside the cells it already covers only updates its translation.
+*    - Queries don't allocate: FindNear() overwrites a caller-owned vector (keep it around to reuse its capacity),
+*      ForEachNear() calls a function per instance. An instance spanning several cells is reported once.
+*    - Every entry carries a category bitmask (see SpatialCategory), queries skip entries which lack
+*      any of the requested categories before touching them (0 requests all).
+*    - FindNearest() visits the cells in rings around the center and stops as soon as no unvisited cell can hold
+*      a closer instance, so target acquisition costs O(local density).
+*
+* Distances are measured in the XZ-plane to the translation of an instance.
+*
+* Queries are const and don't write any state, so they can run in parallel (but not alongside updates).
+*
+***/
+class Hash2D : public SpatialIndex
 {
 public:
-    void Init(tg::size2 cellCount, tg::aabb2 bounds);
-    void Init(tg::size2 cellCount, tg::aabb3 bounds);
-
-    void AddInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions);
-    void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation);
-    void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions);
-    void RemoveInstance(const InstanceHandle identifier);
-    std::unordered_set<gamedev::InstanceHandle, InstanceHandleHash> FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max);
-    std::unordered_set<gamedev::InstanceHandle, InstanceHandleHash> FindNear(const tg::vec3& translation, const tg::aabb3& bounds);
-    std::unordered_set<gamedev::InstanceHandle, InstanceHandleHash> FindNear(const tg::vec3& translation, const tg::size3& bounds);
-    std::unordered_set<gamedev::InstanceHandle, InstanceHandleHash> FindNear(const tg::pos3& position);
-    void Clear();
+    using SpatialIndex::Init;
+    using SpatialIndex::FindNear;
+
+    void Init(tg::size2 cellCount, tg::aabb2 bounds) override;
+
+    void AddInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions, SpatialMask categories = 0) override;
+    void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation) override;
+    void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions) override;
+    void RemoveInstance(const InstanceHandle identifier) override;
+    void SetCategories(const InstanceHandle identifier, SpatialMask categories) override;
+    SpatialMask GetCategories(const InstanceHandle identifier) const override;
+    bool Contains(const InstanceHandle identifier) const override;
+
+    // Calls func(InstanceHandle) for every instance of the categories in the cells covered by the area [translation + min, translation + max].
+    template <typename Func>
+    void ForEachNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, Func&& func) const;
+
+    // Overwrites result with the instances of the categories in the cells covered by the area.
+    void FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, std::vector<InstanceHandle>& result) const override;
+
+    // Calls func(InstanceHandle, float distance_sqr) for every instance of the categories within radius of center.
+    template <typename Func>
+    void ForEachInRadius(const tg::pos3& center, float radius, SpatialMask categories, Func&& func) const;
+
+    // Overwrites result with the instances of the categories within radius of center (unordered).
+    void FindInRadius(const tg::pos3& center, float radius, SpatialMask categories, std::vector<InstanceHandle>& result) const override;
+
+    // Overwrites result with the (up to) k nearest instances of the categories within maxRadius of center, nearest first.
+    void FindNearest(const tg::pos3& center, float maxRadius, SpatialMask categories, size_t k, std::vector<SpatialHit>& result) const override;
+
+    // Visits the cells the segment (grown by radius) spans row by row, ordered along the segment.
+    void FindAlongSegment(const tg::pos3& from, const tg::pos3& to, float radius, SpatialMask categories, std::vector<SpatialRayHit>& result) const override;
+
+    void Clear() override;
 
 private:
-    tg::ipos2 PositionToGrid_(const tg::pos2& spatial_key);
-    tg::ipos2 PositionToGrid_(const tg::pos3& spatial_key);
-    std::string Key_(const tg::ipos2& p);
+    // Entry of a cell list
+    struct CellEntry
+    {
+        InstanceHandle handle;
+        uint16_t firstX = 0; // cells covered by the instance, to report it only once per query
+        uint16_t firstY = 0;
+        uint16_t lastX = 0;
+        uint16_t lastY = 0;
+        uint32_t slot = 0;   // index into Hash2Client::slots
+        SpatialMask categories = 0;
+
+        bool Matches(SpatialMask mask) const { return (categories & mask) == mask; }
+    };
+
+    tg::ipos2 PositionToGrid_(const tg::pos2& spatial_key) const;
+    tg::ipos2 PositionToGrid_(const tg::pos3& spatial_key) const;
     void Insert_(Hash2Client& c);
     void Remove_(Hash2Client& c);
+    Hash2Indices CellsOf_(const Hash2Client& c) const;
 
-    int GetIndexID_(tg::ipos2 pos);
+    int GetIndexID_(tg::ipos2 pos) const;
+    float DistanceSqr_(const CellEntry& e, const tg::pos3& center) const
+    {
+        auto const& t = mClients[e.handle.index()].translation;
+        return (t.x - center.x) * (t.x - center.x) + (t.y - center.z) * (t.y - center.z);
+    }
+    Hash2Client* TryGetClient_(InstanceHandle handle);
 
 
 private:
     tg::size2 mMaxCells;
+    tg::isize2 mCellCount;
     tg::aabb2 mBounds;
-    int mQueryIDs = 1;
-    std::unordered_map<int, std::vector<Hash2Client>> mBinMap;                      // Point -> Instances
-    std::unordered_map<InstanceHandle, Hash2Client, InstanceHandleHash> mClientMap; // Instance -> Hash2Client
+    std::vector<std::vector<CellEntry>> mCells; // row-major
+    std::vector<Hash2Client> mClients;          // by InstanceHandle::index()
 };
+
+template <typename Func>
+void Hash2D::ForEachNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, Func&& func) const
+{
+    if (mCells.empty())
+        return;
+
+    // find area to search for instances
+    auto const i1 = PositionToGrid_(min + translation);
+    auto const i2 = PositionToGrid_(max + translation);
+
+    // search whole area
+    for (int y = i1.y; y <= i2.y; y++)
+    {
+        for (int x = i1.x; x <= i2.x; x++)
+        {
+            for (auto const& e : mCells[GetIndexID_({x, y})])
+            {
+                if (!e.Matches(categories))
+                    continue;
+
+                // uniqueness check: an instance is only reported in the first cell it shares with the search area
+                if (x == std::max(int(e.firstX), i1.x) && y == std::max(int(e.firstY), i1.y))
+                    func(e.handle);
+            }
+        }
+    }
+}
+
+template <typename Func>
+void Hash2D::ForEachInRadius(const tg::pos3& center, float radius, SpatialMask categories, Func&& func) const
+{
+    if (mCells.empty())
+        return;
+
+    auto const i1 = PositionToGrid_(tg::pos3(center.x - radius, center.y, center.z - radius));
+    auto const i2 = PositionToGrid_(tg::pos3(center.x + radius, center.y, center.z + radius));
+    auto const radius_sqr = radius * radius;
+
+    for (int y = i1.y; y <= i2.y; y++)
+    {
+        for (int x = i1.x; x <= i2.x; x++)
+        {
+            for (auto const& e : mCells[GetIndexID_({x, y})])
+            {
+                if (!e.Matches(categories))
+                    continue;
+
+                if (x != std::max(int(e.firstX), i1.x) || y != std::max(int(e.firstY), i1.y))
+                    continue;
+
+                auto const distance_sqr = DistanceSqr_(e, center);
+                if (distance_sqr <= radius_sqr)
+                    func(e.handle, distance_sqr);
+            }
+        }
+    }
+}
 }
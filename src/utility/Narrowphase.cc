@@ -0,0 +1,252 @@
+#include "utility/Narrowphase.hh"
+#include <clean-core/macros.hh>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Lane math of the kernels, also used by the scalar Narrowphase::Push (selects only, no branches).
+// Forced inline, otherwise the kernels call them per lane & don't vectorize.
+CC_FORCE_INLINE void circleCircle(float ax, float az, float ar, float bx, float bz, float br, float& px, float& pz)
+{
+    float const dx = ax - bx;
+    float const dz = az - bz;
+    float const len = std::sqrt(dx * dx + dz * dz);
+    float const depth = ar + br - len;
+
+    // Push along the line of centers, coincident centers are separated along x
+    float const inv = 1.f / (len > 0.f ? len : 1.f);
+    float const nx = len > 0.f ? dx * inv : 1.f;
+    float const nz = dz * inv;
+
+    bool const hit = depth > 0.f;
+    float const x = nx * depth;
+    float const z = nz * depth;
+    px = hit ? x : 0.f;
+    pz = hit ? z : 0.f;
+}
+
+// Push of the circle, sign turns it into the push of the box
+CC_FORCE_INLINE void circleBox(float cx, float cz, float r, float bx, float bz, float ux, float uz, float vx, float vz, float sign, float& px, float& pz)
+{
+    float const dx = cx - bx;
+    float const dz = cz - bz;
+
+    // Bounding circle of the box
+    float const wx = ux + vx, wz = uz + vz;
+    float const reach = std::sqrt(wx * wx + wz * wz) + r;
+    bool hit = dx * dx + dz * dz <= reach * reach;
+
+    float const lu = std::sqrt(ux * ux + uz * uz);
+    float const lv = std::sqrt(vx * vx + vz * vz);
+    hit = hit & (lu > 0.f) & (lv > 0.f);
+
+    // Degenerate axes stay zero
+    float const iu = 1.f / (lu > 0.f ? lu : 1.f);
+    float const iv = 1.f / (lv > 0.f ? lv : 1.f);
+    float const n0x = ux * iu, n0z = uz * iu;
+    float const n1x = vx * iv, n1z = vz * iv;
+
+    // Overlap of the projections on both (unit) box axes, the circle projects to [c - r, c + r]
+    float const e0 = std::abs(ux * n0x + uz * n0z) + std::abs(vx * n0x + vz * n0z);
+    float const d0 = e0 + r - std::abs(dx * n0x + dz * n0z);
+
+    float const e1 = std::abs(ux * n1x + uz * n1z) + std::abs(vx * n1x + vz * n1z);
+    float const d1 = e1 + r - std::abs(dx * n1x + dz * n1z);
+
+    hit = hit & (d0 > 0.f) & (d1 > 0.f);
+
+    // Minimal push, pointing from the box to the circle
+    bool const first = d0 <= d1;
+    float const d = first ? d0 : d1;
+    float const nx = first ? n0x : n1x;
+    float const nz = first ? n0z : n1z;
+    float const side = dx * nx + dz * nz > 0.f ? 1.f : -1.f;
+    float const x = side * sign * d * nx;
+    float const z = side * sign * d * nz;
+
+    px = hit ? x : 0.f;
+    pz = hit ? z : 0.f;
+}
+
+CC_FORCE_INLINE void boxBox(float ax, float az, float aux, float auz, float avx, float avz, float bx, float bz, float bux, float buz, float bvx, float bvz, float& px, float& pz)
+{
+    float const dx = bx - ax;
+    float const dz = bz - az;
+
+    // Bounding circles
+    float const rax = aux + avx, raz = auz + avz;
+    float const rbx = bux + bvx, rbz = buz + bvz;
+    float const reach = std::sqrt(rax * rax + raz * raz) + std::sqrt(rbx * rbx + rbz * rbz);
+    bool hit = dx * dx + dz * dz <= reach * reach;
+
+    float best = INFINITY;
+    float bestX = 0.f;
+    float bestZ = 0.f;
+
+    // SAT on the (unnormalized) half extents of both boxes, the push along an axis is (overlap / |axis|^2) * axis
+    auto const axisTest = [&](float nx, float nz)
+    {
+        float const aa = nx * nx + nz * nz;
+        float const ea = std::abs(aux * nx + auz * nz) + std::abs(avx * nx + avz * nz);
+        float const eb = std::abs(bux * nx + buz * nz) + std::abs(bvx * nx + bvz * nz);
+        float const d = ea + eb - std::abs(dx * nx + dz * nz);
+
+        hit = hit & (aa > 0.f) & (d > 0.f);
+
+        float const t = d / (aa > 0.f ? aa : 1.f);
+        float const length_sqr = t * t * aa;
+        float const x = t * nx;
+        float const z = t * nz;
+
+        bool const better = length_sqr < best;
+        best = better ? length_sqr : best;
+        bestX = better ? x : bestX;
+        bestZ = better ? z : bestZ;
+    };
+
+    axisTest(aux, auz);
+    axisTest(avx, avz);
+    axisTest(bux, buz);
+    axisTest(bvx, bvz);
+
+    // Push the first box away from the second
+    bool const flip = dx * bestX + dz * bestZ > 0.f;
+    px = hit ? (flip ? -bestX : bestX) : 0.f;
+    pz = hit ? (flip ? -bestZ : bestZ) : 0.f;
+}
+}
+
+template <typename Block>
+void gamedev::Narrowphase::Scatter_(Bucket<Block> const& bucket)
+{
+    for (size_t i = 0; i < bucket.count; ++i)
+    {
+        auto const& b = bucket.blocks[i / Lanes];
+        mPush[b.id[i % Lanes]] = {b.px[i % Lanes], b.pz[i % Lanes]};
+    }
+}
+
+void gamedev::Narrowphase::Clear()
+{
+    mCircleCircle.blocks.clear();
+    mCircleCircle.count = 0;
+    mCircleBox.blocks.clear();
+    mCircleBox.count = 0;
+    mBoxBox.blocks.clear();
+    mBoxBox.count = 0;
+
+    mSize = 0;
+}
+
+void gamedev::Narrowphase::Add(uint32_t id, const WorldShape& first, const WorldShape& second)
+{
+    mSize = std::max(mSize, size_t(id) + 1);
+
+    if (first.type == ShapeType::Circle && second.type == ShapeType::Circle)
+    {
+        auto [b, l] = mCircleCircle.Next();
+        b.ax[l] = first.center.x;
+        b.az[l] = first.center.y;
+        b.ar[l] = first.radius;
+        b.bx[l] = second.center.x;
+        b.bz[l] = second.center.y;
+        b.br[l] = second.radius;
+        b.id[l] = id;
+    }
+    else if (first.type == ShapeType::Box && second.type == ShapeType::Box)
+    {
+        auto [b, l] = mBoxBox.Next();
+        b.ax[l] = first.center.x;
+        b.az[l] = first.center.y;
+        b.aux[l] = first.axis0.x;
+        b.auz[l] = first.axis0.y;
+        b.avx[l] = first.axis1.x;
+        b.avz[l] = first.axis1.y;
+        b.bx[l] = second.center.x;
+        b.bz[l] = second.center.y;
+        b.bux[l] = second.axis0.x;
+        b.buz[l] = second.axis0.y;
+        b.bvx[l] = second.axis1.x;
+        b.bvz[l] = second.axis1.y;
+        b.id[l] = id;
+    }
+    else if (first.type != ShapeType::None && second.type != ShapeType::None)
+    {
+        // One circle & one box, the push of the box is the negated push of the circle
+        auto const& circle = first.type == ShapeType::Circle ? first : second;
+        auto const& box = first.type == ShapeType::Box ? first : second;
+
+        auto [b, l] = mCircleBox.Next();
+        b.cx[l] = circle.center.x;
+        b.cz[l] = circle.center.y;
+        b.r[l] = circle.radius;
+        b.bx[l] = box.center.x;
+        b.bz[l] = box.center.y;
+        b.ux[l] = box.axis0.x;
+        b.uz[l] = box.axis0.y;
+        b.vx[l] = box.axis1.x;
+        b.vz[l] = box.axis1.y;
+        b.sign[l] = first.type == ShapeType::Circle ? 1.f : -1.f;
+        b.id[l] = id;
+    }
+}
+
+void gamedev::Narrowphase::Run()
+{
+    for (auto& b : mCircleCircle.blocks)
+        Run_(b);
+    for (auto& b : mCircleBox.blocks)
+        Run_(b);
+    for (auto& b : mBoxBox.blocks)
+        Run_(b);
+
+    // Pairs without shapes are never added, they keep a zero push
+    mPush.assign(mSize, tg::vec2::zero);
+    Scatter_(mCircleCircle);
+    Scatter_(mCircleBox);
+    Scatter_(mBoxBox);
+}
+
+tg::vec2 gamedev::Narrowphase::Push(const WorldShape& first, const WorldShape& second)
+{
+    tg::vec2 push = tg::vec2::zero;
+
+    if (first.type == ShapeType::Circle && second.type == ShapeType::Circle)
+    {
+        circleCircle(first.center.x, first.center.y, first.radius, second.center.x, second.center.y, second.radius, push.x, push.y);
+    }
+    else if (first.type == ShapeType::Box && second.type == ShapeType::Box)
+    {
+        boxBox(first.center.x, first.center.y, first.axis0.x, first.axis0.y, first.axis1.x, first.axis1.y, //
+               second.center.x, second.center.y, second.axis0.x, second.axis0.y, second.axis1.x, second.axis1.y, push.x, push.y);
+    }
+    else if (first.type != ShapeType::None && second.type != ShapeType::None)
+    {
+        auto const& circle = first.type == ShapeType::Circle ? first : second;
+        auto const& box = first.type == ShapeType::Box ? first : second;
+
+        circleBox(circle.center.x, circle.center.y, circle.radius, box.center.x, box.center.y, box.axis0.x, box.axis0.y, box.axis1.x, box.axis1.y,
+                  first.type == ShapeType::Circle ? 1.f : -1.f, push.x, push.y);
+    }
+
+    return push;
+}
+
+void gamedev::Narrowphase::Run_(CircleCircleBlock& b)
+{
+    for (size_t l = 0; l < Lanes; ++l)
+        circleCircle(b.ax[l], b.az[l], b.ar[l], b.bx[l], b.bz[l], b.br[l], b.px[l], b.pz[l]);
+}
+
+void gamedev::Narrowphase::Run_(CircleBoxBlock& b)
+{
+    for (size_t l = 0; l < Lanes; ++l)
+        circleBox(b.cx[l], b.cz[l], b.r[l], b.bx[l], b.bz[l], b.ux[l], b.uz[l], b.vx[l], b.vz[l], b.sign[l], b.px[l], b.pz[l]);
+}
+
+void gamedev::Narrowphase::Run_(BoxBoxBlock& b)
+{
+    for (size_t l = 0; l < Lanes; ++l)
+        boxBox(b.ax[l], b.az[l], b.aux[l], b.auz[l], b.avx[l], b.avz[l], b.bx[l], b.bz[l], b.bux[l], b.buz[l], b.bvx[l], b.bvz[l], b.px[l], b.pz[l]);
+}
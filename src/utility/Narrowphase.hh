@@ -0,0 +1,120 @@
+#pragma once
+#include "typed-geometry/tg.hh"
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace gamedev
+{
+enum class ShapeType : uint8_t
+{
+    None,
+    Circle,
+    Box
+};
+
+// Collision shape in world space (XZ-plane), transformed once per instance & pass
+struct WorldShape
+{
+    ShapeType type = ShapeType::None;
+    tg::pos2 center;
+    tg::vec2 axis0;     // box: half extents
+    tg::vec2 axis1;     //
+    float radius = 0.f; // circle
+};
+
+/***
+* Batched narrowphase: collects the candidate pairs of a pass & computes the minimal push vectors of all of them at once.
+*
+*    - Pairs are bucketed by shape type (circle-circle, circle-box, box-box).
+*    - A bucket is a list of blocks holding Lanes pairs each, every field of a block is an array over its lanes (AoSoA).
+*      The kernels run branch-free over the lanes of a block, so the compiler keeps a block in SIMD registers.
+*    - Box-box & circle-box use SAT on the box axes (circles are tested like a square along these axes),
+*      both are additionally culled by the bounding circles of the boxes.
+*
+*    mNarrowphase.Clear();
+*    mNarrowphase.Add(i, shapeOfFirst, shapeOfSecond);
+*    mNarrowphase.Run();
+*    auto push = mNarrowphase.GetPush(i); // moves first out of second, zero if they don't overlap
+*
+* Push() computes a single pair with the same math, e.g. for iterative solvers which re-test contacts after every step.
+*
+***/
+class Narrowphase
+{
+public:
+    static constexpr size_t Lanes = 8;
+
+    void Clear();
+
+    // id is the index of the pair on the caller side, ids should be dense
+    void Add(uint32_t id, const WorldShape& first, const WorldShape& second);
+
+    void Run();
+
+    tg::vec2 GetPush(uint32_t id) const { return mPush[id]; }
+
+    size_t Size() const { return mSize; }
+
+    // Push of a single pair, the same math as the batched kernels
+    static tg::vec2 Push(const WorldShape& first, const WorldShape& second);
+
+private:
+    // Unused lanes stay zero, zero sized shapes never overlap
+    struct CircleCircleBlock
+    {
+        float ax[Lanes] = {}, az[Lanes] = {}, ar[Lanes] = {}; // first
+        float bx[Lanes] = {}, bz[Lanes] = {}, br[Lanes] = {}; // second
+        float px[Lanes], pz[Lanes];                           // push of first
+        uint32_t id[Lanes];
+    };
+
+    // The circle is pushed, sign turns it into the push of the box
+    struct CircleBoxBlock
+    {
+        float cx[Lanes] = {}, cz[Lanes] = {}, r[Lanes] = {};
+        float bx[Lanes] = {}, bz[Lanes] = {}, ux[Lanes] = {}, uz[Lanes] = {}, vx[Lanes] = {}, vz[Lanes] = {};
+        float sign[Lanes] = {};
+        float px[Lanes], pz[Lanes];
+        uint32_t id[Lanes];
+    };
+
+    struct BoxBoxBlock
+    {
+        float ax[Lanes] = {}, az[Lanes] = {}, aux[Lanes] = {}, auz[Lanes] = {}, avx[Lanes] = {}, avz[Lanes] = {}; // first
+        float bx[Lanes] = {}, bz[Lanes] = {}, bux[Lanes] = {}, buz[Lanes] = {}, bvx[Lanes] = {}, bvz[Lanes] = {}; // second
+        float px[Lanes], pz[Lanes];
+        uint32_t id[Lanes];
+    };
+
+    template <typename Block>
+    struct Bucket
+    {
+        std::vector<Block> blocks;
+        size_t count = 0;
+
+        // Block & lane of the next pair
+        std::pair<Block&, size_t> Next()
+        {
+            if (count % Lanes == 0)
+                blocks.emplace_back();
+            return {blocks.back(), count++ % Lanes};
+        }
+    };
+
+    template <typename Block>
+    void Scatter_(Bucket<Block> const& bucket);
+
+    static void Run_(CircleCircleBlock& b);
+    static void Run_(CircleBoxBlock& b);
+    static void Run_(BoxBoxBlock& b);
+
+private:
+    Bucket<CircleCircleBlock> mCircleCircle;
+    Bucket<CircleBoxBlock> mCircleBox;
+    Bucket<BoxBoxBlock> mBoxBox;
+
+    size_t mSize = 0;            // highest id + 1
+    std::vector<tg::vec2> mPush; // by id, written by Run()
+};
+}
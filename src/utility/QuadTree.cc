@@ -1,170 +1,370 @@
-/*
+#include "utility/QuadTree.hh"
+#include <cmath>
 
-#include "QuadTree.hh"
-#include <typed-geometry/types/objects/line.hh>
+void gamedev::LooseQuadTree::Init(tg::size2 cellCount, tg::aabb2 bounds)
+{
+    assert(cellCount.width >= 1 && cellCount.height >= 1 && "Invalid tree resolution.");
 
+    // Leaves at the deepest level are about the size of a grid cell
+    auto const cells = tg::max(cellCount.width, cellCount.height);
+    mMaxDepth = tg::clamp(int(std::ceil(std::log2(cells))), 0, MaxDepthLimit);
 
-gamedev::QuadTree::QuadTree()
-{
-    mRoot = std::make_shared<QuadTree::Node>();
-    mRoot->mParent = nullptr;
-    mRoot->mRegion = tg::aabb2(tg::pos2::zero, tg::pos2::zero);
+    mNodes.clear();
+    mNodes.emplace_back();
+    mNodes[0].center = tg::centroid_of(bounds);
+    mNodes[0].halfSize = (bounds.max - bounds.min) / 2.f;
+    mNodes[0].looseBounds = {mNodes[0].center - 2.f * mNodes[0].halfSize, mNodes[0].center + 2.f * mNodes[0].halfSize};
+
+    mClients.clear();
 }
 
-gamedev::QuadTree::QuadTree(tg::aabb2 global_region)
+gamedev::LooseQuadTree::Client* gamedev::LooseQuadTree::TryGetClient_(InstanceHandle handle)
 {
-    mRoot = std::make_shared<QuadTree::Node>();
-    mRoot->mParent = nullptr;
-    mRoot->mRegion = global_region;
+    auto const index = handle.index();
+    if (index >= mClients.size() || !(mClients[index].handle == handle))
+        return nullptr;
+
+    return &mClients[index];
 }
 
-void gamedev::QuadTree::init(SharedEngineECS& engineECS) { ecs = engineECS; }
+gamedev::LooseQuadTree::Entry gamedev::LooseQuadTree::MakeEntry_(const Client& c, const tg::vec3& translation, SpatialMask categories) const
+{
+    Entry e;
+    e.handle = c.handle;
+    e.categories = categories;
+    e.translation = {translation.x, translation.z};
+
+    // Distance queries measure to the translation, so the node has to cover it as well
+    e.bounds.min = tg::min(c.dimensions.min + tg::vec2(e.translation), e.translation);
+    e.bounds.max = tg::max(c.dimensions.max + tg::vec2(e.translation), e.translation);
+    return e;
+}
 
-void gamedev::QuadTree::add(InstanceHandle& handle, Shape& shape, SharedNode& node)
+int32_t gamedev::LooseQuadTree::ChildFor_(const Node& node, const tg::aabb2& bounds) const
 {
-    // Go as deep down as possible
-    if (node->hasChildren())
-    {
-        int quadrantID = getQuadrant(shape, node);
-        if (quadrantID != thisNode)
-            return add(handle, shape, node->mChildren[quadrantID]);
-    }
+    auto const center = tg::centroid_of(bounds);
+    auto const halfExtent = (bounds.max - bounds.min) / 2.f;
+    auto const childHalfSize = node.halfSize / 2.f;
+
+    // Too large for a quadrant or outside of this node (only possible for the root)
+    if (halfExtent.x > childHalfSize.x || halfExtent.y > childHalfSize.y)
+        return -1;
+    if (tg::abs(center.x - node.center.x) > node.halfSize.x || tg::abs(center.y - node.center.y) > node.halfSize.y)
+        return -1;
+
+    return node.firstChild + (center.x >= node.center.x ? 1 : 0) + (center.y >= node.center.y ? 2 : 0);
+}
 
-    // Finally insert object
-    node->mObjects.emplace_back(handle);
+int32_t gamedev::LooseQuadTree::FindNode_(const tg::aabb2& bounds) const
+{
+    int32_t index = 0;
 
-    // Check split trigger
-    if (node->mObjects.size() > splitTrigger)
+    while (!mNodes[index].IsLeaf())
     {
-        tg::vec2 quadSize = node->mRegion.max - node->mRegion.min;
+        auto const child = ChildFor_(mNodes[index], bounds);
+        if (child < 0)
+            break;
 
-        // If split possible: split!
-        if ((quadSize.x > minDimension.x) && (quadSize.y > minDimension.y))
-            split(node);
+        index = child;
     }
+
+    return index;
 }
 
-void gamedev::QuadTree::add(InstanceHandle handle)
+void gamedev::LooseQuadTree::Insert_(Entry const& e)
 {
-    // Check if the tree is brand new
-    tg::vec2 treeSize = mRoot->mRegion.max - mRoot->mRegion.min;
-    if (treeSize == tg::vec2::zero)
-        mRoot->mRegion = tg::aabb2(-3000, 3000);
+    auto const index = FindNode_(e.bounds);
+    auto& node = mNodes[index];
 
-    auto& shape = ecs->GetComponent<Shape>(handle);
+    auto& c = mClients[e.handle.index()];
+    c.node = index;
+    c.slot = uint32_t(node.entries.size());
+    node.entries.push_back(e);
+    Count_(index, +1);
 
-    // Now go out into the tree and fulfill your oath!
-    return add(handle, shape, mRoot);
+    if (node.IsLeaf() && node.entries.size() > SplitThreshold && node.depth < mMaxDepth)
+        Split_(index);
 }
 
-int gamedev::QuadTree::getQuadrant(Shape& shape, SharedNode& node)
-{ 
-  auto quadrantSize = (node->mRegion.max - node->mRegion.min) / 2.0;
-
-  auto verticalAxis = tg::line(tg::pos2(node->mRegion.min + quadrantSize), tg::dir2::pos_x);
-  auto horizontalAxis = tg::line(tg::pos2(node->mRegion.min + quadrantSize), tg::dir2::pos_y);
-
-  // Check split axes
-  if (tg::intersects(shape.aabb, verticalAxis))
-      return thisNode;
+void gamedev::LooseQuadTree::Remove_(Client& c)
+{
+    auto& entries = mNodes[c.node].entries;
 
-  if (tg::intersects(shape.aabb, horizontalAxis))
-      return thisNode;
+    // Move the last entry into the gap & tell its client
+    auto const& moved = entries.back();
+    mClients[moved.handle.index()].slot = c.slot;
+    entries[c.slot] = moved;
+    entries.pop_back();
 
-  // Check quadrants
-  for (int i = 0; i < 4; i++)
-      if (tg::intersects(shape.aabb, node->mChildren[i]->mRegion))
-          return i;
+    Count_(c.node, -1);
+    c.node = -1;
+}
 
-  // Object is out of tree space, add to parent (which should be root)
-  return thisNode;
+void gamedev::LooseQuadTree::Count_(int32_t index, int delta)
+{
+    for (; index >= 0; index = mNodes[index].parent)
+        mNodes[index].count += delta;
 }
 
-void gamedev::QuadTree::split(SharedNode& node)
+void gamedev::LooseQuadTree::Split_(int32_t index)
 {
-    // Split
-    for (int i = 0; i < 4; i++)
+    auto const firstChild = int32_t(mNodes.size());
+
+    // mNodes may reallocate, don't hold references across this
+    for (int i = 0; i < 4; ++i)
     {
-        node->mChildren[i] = std::make_shared<QuadTree::Node>();
-        node->mChildren[i]->level = ++node->level;
-        node->mChildren[i]->mParent = node;
+        Node child;
+        child.halfSize = mNodes[index].halfSize / 2.f;
+        child.center = mNodes[index].center + tg::vec2(i & 1 ? child.halfSize.x : -child.halfSize.x, i & 2 ? child.halfSize.y : -child.halfSize.y);
+        child.looseBounds = {child.center - 2.f * child.halfSize, child.center + 2.f * child.halfSize};
+        child.parent = index;
+        child.depth = mNodes[index].depth + 1;
+        mNodes.push_back(std::move(child));
     }
 
-    // Distribute (bottom to front, easier to clear vector)
-    for (int i = node->mObjects.size() - 1; i >= 0; i--)
+    mNodes[index].firstChild = firstChild;
+
+    // Push down everything which fits into a quadrant
+    auto& entries = mNodes[index].entries;
+    for (size_t i = 0; i < entries.size();)
     {
-        auto& handle = node->mObjects[i];
-        auto& shape = ecs->GetComponent<Shape>(handle);
-        int quadrantID = getQuadrant(shape, node);
-        if (quadrantID != thisNode)
+        auto const child = ChildFor_(mNodes[index], entries[i].bounds);
+        if (child < 0)
         {
-            add(handle, shape, node->mChildren[quadrantID]);
-            node->mObjects.pop_back();
+            mClients[entries[i].handle.index()].slot = uint32_t(i);
+            ++i;
+            continue;
         }
+
+        auto& target = mNodes[child].entries;
+        mNodes[child].count++;
+        mClients[entries[i].handle.index()].node = child;
+        mClients[entries[i].handle.index()].slot = uint32_t(target.size());
+        target.push_back(entries[i]);
+
+        entries[i] = entries.back();
+        entries.pop_back();
     }
 
-    // If here, keep
+    // Everything may have ended up in the same quadrant
+    for (int32_t child = firstChild; child < firstChild + 4; ++child)
+    {
+        if (mNodes[child].entries.size() > SplitThreshold && mNodes[child].depth < mMaxDepth)
+            Split_(child);
+    }
 }
 
-void gamedev::QuadTree::remove(InstanceHandle handle)
+void gamedev::LooseQuadTree::AddInstance(const InstanceHandle handle, const tg::vec3& translation, const tg::aabb3& dimensions, SpatialMask categories)
 {
-    auto& shape = ecs->GetComponent<Shape>(handle);
-    remove(handle, shape, mRoot);
+    if (mNodes.empty() || Contains(handle))
+        return;
+
+    if (handle.index() >= mClients.size())
+        mClients.resize(handle.index() + 1);
+
+    auto& c = mClients[handle.index()];
+    c.handle = handle;
+    c.dimensions.min = {dimensions.min.x, dimensions.min.z};
+    c.dimensions.max = {dimensions.max.x, dimensions.max.z};
+
+    Insert_(MakeEntry_(c, translation, categories));
 }
 
-void gamedev::QuadTree::remove(InstanceHandle& handle, Shape& shape, SharedNode& node)
+void gamedev::LooseQuadTree::UpdateInstance(const InstanceHandle handle, const tg::vec3& translation)
 {
-    int quadrantID = getQuadrant(shape, node);
+    auto c = TryGetClient_(handle);
+    if (!c)
+        return;
 
-    // If the object is assumed in this node, search here
-    if ((quadrantID == thisNode) || (node->mChildren[quadrantID] == nullptr))
-    {
-        for (int i = 0; i < node->mChildren.size(); i++)
-        {
-            // Object found! Swap & pop (better for vector)
-            if (node->mObjects[i] == handle)
-            {
-                std::swap(node->mObjects[i], node->mObjects.back());
-                node->mObjects.pop_back();
-                break;
-            }
-        }
-    }
-    // If not, continue search
-    else
+    auto& current = mNodes[c->node].entries[c->slot];
+    auto const e = MakeEntry_(*c, translation, current.categories);
+
+    // Most moves stay within the (loose) node
+    if (FindNode_(e.bounds) == c->node)
     {
-        return remove(handle, shape, node->mChildren[quadrantID]);
+        current = e;
+        return;
     }
+
+    Remove_(*c);
+    Insert_(e);
 }
 
-std::vector<gamedev::InstanceHandle> gamedev::QuadTree::search(Shape& collision_area)
+void gamedev::LooseQuadTree::UpdateInstance(const InstanceHandle handle, const tg::vec3& translation, const tg::aabb3& dimensions)
 {
-    std::vector<InstanceHandle> possible_colliders;
-    search(collision_area, mRoot, possible_colliders);
-    return possible_colliders;
+    auto c = TryGetClient_(handle);
+    if (!c)
+        return;
 
+    c->dimensions.min = {dimensions.min.x, dimensions.min.z};
+    c->dimensions.max = {dimensions.max.x, dimensions.max.z};
+
+    UpdateInstance(handle, translation);
+}
+
+void gamedev::LooseQuadTree::RemoveInstance(const InstanceHandle handle)
+{
+    auto c = TryGetClient_(handle);
+    if (!c)
+        return;
+
+    Remove_(*c);
+    c->handle = {std::uint32_t(-1)};
 }
 
-void gamedev::QuadTree::search(Shape& collision_area, SharedNode& node, std::vector<InstanceHandle>& possible_colliders)
+void gamedev::LooseQuadTree::SetCategories(const InstanceHandle handle, SpatialMask categories)
 {
-    // Gather all objects which do not fit into a single quadrant, as they maybe lie on a splitting axis
-    possible_colliders.insert(possible_colliders.end(), node->mObjects.begin(), node->mObjects.end());
+    auto c = TryGetClient_(handle);
+    if (!c)
+        return;
+
+    mNodes[c->node].entries[c->slot].categories = categories;
+}
+
+gamedev::SpatialMask gamedev::LooseQuadTree::GetCategories(const InstanceHandle handle) const
+{
+    if (!Contains(handle))
+        return 0;
+
+    auto const& c = mClients[handle.index()];
+    return mNodes[c.node].entries[c.slot].categories;
+}
 
-    // If this is no leaf, continue search
-    if (node->mChildren[0] != nullptr)
+bool gamedev::LooseQuadTree::Contains(const InstanceHandle handle) const
+{
+    auto const index = handle.index();
+    return index < mClients.size() && mClients[index].handle == handle;
+}
+
+void gamedev::LooseQuadTree::FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, std::vector<InstanceHandle>& result) const
+{
+    result.clear();
+    ForEachNear(translation, min, max, categories, [&](InstanceHandle handle) { result.push_back(handle); });
+}
+
+void gamedev::LooseQuadTree::FindInRadius(const tg::pos3& center, float radius, SpatialMask categories, std::vector<InstanceHandle>& result) const
+{
+    result.clear();
+    ForEachInRadius(center, radius, categories, [&](InstanceHandle handle, float) { result.push_back(handle); });
+}
+
+void gamedev::LooseQuadTree::FindNearest(const tg::pos3& center, float maxRadius, SpatialMask categories, size_t k, std::vector<SpatialHit>& result) const
+{
+    result.clear();
+
+    if (mNodes.empty() || k == 0)
+        return;
+
+    // result is kept as a max-heap of the best k hits, so the farthest one is on top
+    auto const nearer = [](SpatialHit const& a, SpatialHit const& b) { return a.distance_sqr < b.distance_sqr; };
+    auto const center2D = tg::pos2(center.x, center.z);
+    auto const radius_sqr = maxRadius * maxRadius;
+    auto const bound_sqr = [&] { return result.size() == k ? result.front().distance_sqr : radius_sqr; };
+
+    std::array<int32_t, StackSize> stack;
+    size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
     {
-        int quadrantID = getQuadrant(collision_area, node);
+        auto const index = stack[--top];
+        auto const& node = mNodes[index];
+
+        // The bound may have shrunk since the node was pushed (the root holds instances outside of its bounds)
+        if (index != 0 && DistanceSqr_(center2D, node.looseBounds) > bound_sqr())
+            continue;
 
-        // If thisNode was returned, then the collision_area does not fit completely into a quadrant. Therefore: search all!
-        if (quadrantID == thisNode)
+        for (auto const& e : node.entries)
         {
-            for (int i = 0; i < 4; i++)
+            if (!e.Matches(categories))
+                continue;
+
+            auto const distance_sqr = tg::distance_sqr(e.translation, center2D);
+            if (distance_sqr > radius_sqr || (result.size() == k && distance_sqr >= result.front().distance_sqr))
+                continue;
+
+            if (result.size() == k)
             {
-              
+                std::pop_heap(result.begin(), result.end(), nearer);
+                result.pop_back();
             }
+
+            result.push_back({e.handle, distance_sqr});
+            std::push_heap(result.begin(), result.end(), nearer);
+        }
+
+        if (node.IsLeaf())
+            continue;
+
+        // Visit the nearest quadrant first (pushed last), it tightens the bound the most
+        std::array<std::pair<float, int32_t>, 4> children;
+        for (int i = 0; i < 4; ++i)
+            children[i] = {DistanceSqr_(center2D, mNodes[node.firstChild + i].looseBounds), node.firstChild + i};
+
+        std::sort(children.begin(), children.end(), [](auto const& a, auto const& b) { return a.first > b.first; });
+
+        for (auto const& [distance_sqr, child] : children)
+        {
+            if (mNodes[child].count > 0 && distance_sqr <= bound_sqr())
+                stack[top++] = child;
         }
     }
 
+    std::sort_heap(result.begin(), result.end(), nearer);
+}
+
+void gamedev::LooseQuadTree::FindAlongSegment(const tg::pos3& from, const tg::pos3& to, float radius, SpatialMask categories, std::vector<SpatialRayHit>& result) const
+{
+    result.clear();
+
+    if (mNodes.empty())
+        return;
+
+    auto const from2D = tg::pos2(from.x, from.z);
+    auto const delta = tg::vec2(to.x - from.x, to.z - from.z);
+    auto const grow = tg::vec2(radius, radius);
+
+    std::array<int32_t, StackSize> stack;
+    size_t top = 0;
+    stack[top++] = 0;
+
+    while (top > 0)
+    {
+        auto const& node = mNodes[stack[--top]];
+
+        for (auto const& e : node.entries)
+        {
+            float t;
+            if (e.Matches(categories) && IntersectSegment(tg::aabb2(e.bounds.min - grow, e.bounds.max + grow), from2D, delta, t))
+                result.push_back({e.handle, t});
+        }
+
+        if (node.IsLeaf())
+            continue;
+
+        for (int32_t child = node.firstChild; child < node.firstChild + 4; ++child)
+        {
+            auto const& bounds = mNodes[child].looseBounds;
+
+            float t;
+            if (mNodes[child].count > 0 && IntersectSegment(tg::aabb2(bounds.min - grow, bounds.max + grow), from2D, delta, t))
+                stack[top++] = child;
+        }
+    }
+
+    SortAlongSegment_(result);
+}
+
+void gamedev::LooseQuadTree::Clear()
+{
+    if (mNodes.empty())
+        return;
+
+    // Keep the root, the tree regrows with the next instances
+    mNodes.resize(1);
+    mNodes[0].entries.clear();
+    mNodes[0].firstChild = -1;
+    mNodes[0].count = 0;
 
+    mClients.clear();
 }
-*/
\ No newline at end of file
@@ -1,83 +1,199 @@
 #pragma once
-/*
 #include "advanced/World.hh"
-#include "advanced/transform.hh"
-#include "Component.hh"
-#include "ecs/Engine.hh"
-
-#include <typed-geometry/types/objects/aabb.hh>
-#include <glow/fwd.hh>
-#include <typed-geometry/tg-lean.hh>
+#include "utility/HashData.hh"
+#include "utility/SpatialIndex.hh"
+#include "typed-geometry/tg.hh"
+#include <algorithm>
 #include <array>
+#include <cstdint>
+#include <vector>
+#include <assert.h>
 
 namespace gamedev
 {
-
 // Inspired by https://www.gamedev.net/articles/programming/general-and-gameplay-programming/introduction-to-octrees-r3529/
 //             https://thatgamesguy.co.uk/cpp-game-dev-16/
 
-class QuadTree
+/***
+* Loose quadtree (XZ-plane), same interface as Hash2D but the resolution follows the instances:
+* the crowded fort is subdivided down to cell size, the empty outskirts stay a handful of large nodes.
+*
+*    - Nodes are stored in one vector and refer to their 4 children by index, no pointers.
+*    - Loose factor 2: a node accepts every instance whose center lies in its quadrant and whose extent is at most
+*      the size of the quadrant, so every instance lives in exactly one node and is never split across nodes.
+*    - A leaf splits once it holds more than SplitThreshold instances (down to the grid resolution given to Init()).
+*      Nodes are kept when they run empty, the tree only grows to the shape of the map.
+*    - Clients are stored by the slot index of their handle and remember their node & position inside it,
+*      removing is O(1), a move which stays in its node only overwrites the entry.
+*    - Instances outside of the bounds are kept in the root (and are still found).
+*    - Queries don't allocate and are const, FindNear() only reports instances whose bounds overlap the area.
+*
+***/
+class LooseQuadTree : public SpatialIndex
 {
-    GLOW_SHARED(struct, Node);
-
 public:
-    // Properties
-    const int mMaxObjects = 8;
-    const int mMinSize = 1;
+    using SpatialIndex::Init;
+    using SpatialIndex::FindNear;
 
-public:
-    QuadTree();
-    QuadTree(tg::aabb2 global_region);
+    void Init(tg::size2 cellCount, tg::aabb2 bounds) override;
+
+    void AddInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions, SpatialMask categories = 0) override;
+    void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation) override;
+    void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions) override;
+    void RemoveInstance(const InstanceHandle identifier) override;
+    void SetCategories(const InstanceHandle identifier, SpatialMask categories) override;
+    SpatialMask GetCategories(const InstanceHandle identifier) const override;
+    bool Contains(const InstanceHandle identifier) const override;
+
+    // Calls func(InstanceHandle) for every instance of the categories whose bounds overlap the area [translation + min, translation + max].
+    template <typename Func>
+    void ForEachNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, Func&& func) const;
+
+    void FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, std::vector<InstanceHandle>& result) const override;
+
+    // Calls func(InstanceHandle, float distance_sqr) for every instance of the categories within radius of center.
+    template <typename Func>
+    void ForEachInRadius(const tg::pos3& center, float radius, SpatialMask categories, Func&& func) const;
+
+    void FindInRadius(const tg::pos3& center, float radius, SpatialMask categories, std::vector<InstanceHandle>& result) const override;
+    void FindNearest(const tg::pos3& center, float maxRadius, SpatialMask categories, size_t k, std::vector<SpatialHit>& result) const override;
+    void FindAlongSegment(const tg::pos3& from, const tg::pos3& to, float radius, SpatialMask categories, std::vector<SpatialRayHit>& result) const override;
+
+    void Clear() override;
+
+    size_t GetNodeCount() const { return mNodes.size(); }
 
 private:
-    // 0..3: NE, NW, SW,SE
+    static constexpr size_t SplitThreshold = 8;
+    static constexpr int MaxDepthLimit = 16;
+    static constexpr size_t StackSize = 4 + 3 * MaxDepthLimit; // depth-first traversal, near child last
+
+    struct Entry
+    {
+        InstanceHandle handle;
+        SpatialMask categories = 0;
+        tg::pos2 translation;
+        tg::aabb2 bounds; // world space, always contains the translation
+
+        bool Matches(SpatialMask mask) const { return (categories & mask) == mask; }
+    };
+
     struct Node
     {
-        tg::aabb2 mRegion;                          // defines the quadrant
-        SharedNode mParent;
-        std::array<SharedNode, 4> mChildren;        // points to sub-quadrants (alias: NE, NW, SW, SE)
-        std::vector<InstanceHandle> mObjects; // elements hold by this quadrant (either node is leaf or elements lie on separating axis)
+        tg::pos2 center;
+        tg::vec2 halfSize;       // of the quadrant
+        tg::aabb2 looseBounds;   // twice the quadrant, holds the bounds of all entries in the subtree (but the root)
+        int32_t firstChild = -1; // 4 consecutive nodes, -1 for leaves
+        int32_t parent = -1;
+        int32_t depth = 0;
+        int32_t count = 0;       // entries in the subtree, empty subtrees are skipped by queries
+        std::vector<Entry> entries;
+
+        bool IsLeaf() const { return firstChild < 0; }
+    };
 
-        int level;
-        bool hasChildren() { return mChildren[0] != nullptr; }
+    struct Client
+    {
+        InstanceHandle handle = {std::uint32_t(-1)};
+        tg::aabb2 dimensions; // relative to the translation
+        int32_t node = -1;
+        uint32_t slot = 0;    // index into Node::entries
     };
 
-    std::vector<std::pair<InstanceHandle, tg::aabb2>> _queue;
-    SharedNode mRoot;
+    Entry MakeEntry_(const Client& c, const tg::vec3& translation, SpatialMask categories) const;
+    int32_t FindNode_(const tg::aabb2& bounds) const;
+    int32_t ChildFor_(const Node& node, const tg::aabb2& bounds) const;
+    void Insert_(Entry const& e);
+    void Remove_(Client& c);
+    void Split_(int32_t node);
+    void Count_(int32_t node, int delta);
+    Client* TryGetClient_(InstanceHandle handle);
+
+    static bool Overlaps_(const tg::aabb2& a, const tg::aabb2& b)
+    {
+        return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y;
+    }
+    static float DistanceSqr_(const tg::pos2& p, const tg::aabb2& box)
+    {
+        float const dx = tg::max(tg::max(box.min.x - p.x, p.x - box.max.x), 0.f);
+        float const dy = tg::max(tg::max(box.min.y - p.y, p.y - box.max.y), 0.f);
+        return dx * dx + dy * dy;
+    }
+
+private:
+    int mMaxDepth = 0;
+    std::vector<Node> mNodes;     // [0] is the root
+    std::vector<Client> mClients; // by InstanceHandle::index()
+};
 
-    bool mTreeReady;
-    bool mTreeBuilt;
+template <typename Func>
+void LooseQuadTree::ForEachNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, Func&& func) const
+{
+    if (mNodes.empty())
+        return;
 
-    public:
-    void init(SharedEngineECS& engineECS);
+    auto const area = tg::aabb2({min.x + translation.x, min.z + translation.z}, {max.x + translation.x, max.z + translation.z});
 
-    void add(InstanceHandle handle);
-    void remove(InstanceHandle handle);
-    std::vector<InstanceHandle> search(Shape& collision_area);
-    void clearTree();
-    void buildTree();
-    void getBounds();
+    std::array<int32_t, StackSize> stack;
+    size_t top = 0;
+    stack[top++] = 0;
 
-    private:
-    void add(InstanceHandle& handle, Shape& shape, SharedNode& node);
-    void remove(InstanceHandle& handle, Shape& shape, SharedNode& node);
-    void search(Shape& collision_area, SharedNode& node, std::vector<InstanceHandle>& possible_colliders);
+    while (top > 0)
+    {
+        auto const& node = mNodes[stack[--top]];
+
+        for (auto const& e : node.entries)
+        {
+            if (e.Matches(categories) && Overlaps_(e.bounds, area))
+                func(e.handle);
+        }
+
+        if (node.IsLeaf())
+            continue;
+
+        for (int32_t child = node.firstChild; child < node.firstChild + 4; ++child)
+        {
+            if (mNodes[child].count > 0 && Overlaps_(mNodes[child].looseBounds, area))
+                stack[top++] = child;
+        }
+    }
+}
 
-    int getQuadrant(Shape& shape, SharedNode& node);
-    void getBounds(SharedNode& node);
-    void split(SharedNode& node);
+template <typename Func>
+void LooseQuadTree::ForEachInRadius(const tg::pos3& center, float radius, SpatialMask categories, Func&& func) const
+{
+    if (mNodes.empty())
+        return;
 
-    static const int thisNode = -1;
-    static const int NE = 0;
-    static const int NW = 1;
-    static const int SW = 2;
-    static const int SE = 3;
+    auto const center2D = tg::pos2(center.x, center.z);
+    auto const radius_sqr = radius * radius;
 
-    const int splitTrigger = 4; // Maximum objects before split is done
-    const tg::vec2 minDimension = tg::vec2::one; // Minimum dimension of each node
+    std::array<int32_t, StackSize> stack;
+    size_t top = 0;
+    stack[top++] = 0;
 
-private:
-    SharedEngineECS ecs;
-};
+    while (top > 0)
+    {
+        auto const& node = mNodes[stack[--top]];
+
+        for (auto const& e : node.entries)
+        {
+            if (!e.Matches(categories))
+                continue;
+
+            auto const distance_sqr = tg::distance_sqr(e.translation, center2D);
+            if (distance_sqr <= radius_sqr)
+                func(e.handle, distance_sqr);
+        }
+
+        if (node.IsLeaf())
+            continue;
+
+        for (int32_t child = node.firstChild; child < node.firstChild + 4; ++child)
+        {
+            if (mNodes[child].count > 0 && DistanceSqr_(center2D, mNodes[child].looseBounds) <= radius_sqr)
+                stack[top++] = child;
+        }
+    }
+}
 }
-*/
\ No newline at end of file
@@ -3,9 +3,10 @@
 
 float gamedev::RandomFloat()
 {
-    static auto seed_generator = std::random_device();
-    static auto number_generator = std::mt19937(seed_generator());
-    static auto distribution = std::uniform_real_distribution<float>(0.0, std::nextafterf(1.f, 11.f));
+    // One generator per thread, systems may run in parallel (see ecs/Scheduler.hh)
+    static thread_local auto seed_generator = std::random_device();
+    static thread_local auto number_generator = std::mt19937(seed_generator());
+    static thread_local auto distribution = std::uniform_real_distribution<float>(0.0, std::nextafterf(1.f, 11.f));
 
     return distribution(number_generator);
 }
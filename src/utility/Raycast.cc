@@ -0,0 +1,108 @@
+#include "utility/Raycast.hh"
+#include "utility/SpatialIndex.hh"
+#include "Terrain.hh"
+#include <cmath>
+
+bool gamedev::RaycastInstances(EngineECS& ecs, const tg::segment3& segment, float radius, SpatialMask categories, std::vector<SpatialRayHit>& candidates, RaycastHit& hit)
+{
+    auto const delta = segment.pos1 - segment.pos0;
+    auto const grow = tg::vec3(radius, radius, radius);
+
+    ecs.GetHashMap().FindAlongSegment(segment.pos0, segment.pos1, radius, categories, candidates);
+
+    hit.handle = {std::uint32_t(-1)};
+    hit.t = 1.f;
+    bool found = false;
+
+    for (auto const& candidate : candidates)
+    {
+        // The bounds in 3D are entered no earlier than in the XZ-plane
+        if (found && candidate.t > hit.t)
+            break;
+
+        if (!ecs.IsLiveHandle(candidate.handle))
+            continue;
+
+        auto const& translation = ecs.GetInstanceTransform(candidate.handle).translation;
+        auto const& bounds = ecs.GetInstanceBounds(candidate.handle);
+
+        float t;
+        if (!IntersectSegment(tg::aabb3(bounds.min + translation - grow, bounds.max + translation + grow), segment.pos0, delta, t))
+            continue;
+
+        if (!found || t < hit.t)
+        {
+            hit.handle = candidate.handle;
+            hit.t = t;
+            found = true;
+        }
+    }
+
+    if (found)
+        hit.position = segment.pos0 + hit.t * delta;
+
+    return found;
+}
+
+bool gamedev::RaycastTerrain(Terrain& terrain, const tg::segment3& segment, RaycastHit& hit)
+{
+    static constexpr float StepSize = 0.5f; // half the spacing of the height map
+    static constexpr int Refinements = 16;
+
+    auto const delta = segment.pos1 - segment.pos0;
+    auto const size = terrain.GetSize();
+    auto const map = tg::aabb2({size.min.x, size.min.z}, {size.max.x, size.max.z});
+
+    // Only the part of the segment above the map (entered from both ends)
+    float enter, exit;
+    if (!IntersectSegment(map, {segment.pos0.x, segment.pos0.z}, {delta.x, delta.z}, enter))
+        return false;
+    IntersectSegment(map, {segment.pos1.x, segment.pos1.z}, {-delta.x, -delta.z}, exit);
+    exit = 1.f - exit;
+
+    auto const above = [&](float t)
+    {
+        auto const p = segment.pos0 + t * delta;
+        return p.y - terrain.heightAt(p);
+    };
+
+    auto const length = tg::length(tg::vec2(delta.x, delta.z)) * (exit - enter);
+    auto const steps = tg::max(1, int(std::ceil(length / StepSize)));
+
+    float t0 = enter;
+    if (above(t0) > 0.f)
+    {
+        // First sample below the surface
+        float t1 = t0;
+        bool crossed = false;
+        for (int i = 1; i <= steps; ++i)
+        {
+            t1 = enter + (exit - enter) * i / steps;
+            if (above(t1) <= 0.f)
+            {
+                crossed = true;
+                break;
+            }
+            t0 = t1;
+        }
+
+        if (!crossed)
+            return false;
+
+        for (int i = 0; i < Refinements; ++i)
+        {
+            auto const t = (t0 + t1) / 2.f;
+            if (above(t) > 0.f)
+                t0 = t;
+            else
+                t1 = t;
+        }
+        t0 = t1;
+    }
+
+    hit.handle = {std::uint32_t(-1)};
+    hit.t = t0;
+    hit.position = segment.pos0 + t0 * delta;
+    hit.position.y = terrain.heightAt(hit.position);
+    return true;
+}
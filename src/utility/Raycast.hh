@@ -0,0 +1,40 @@
+#pragma once
+#include "advanced/World.hh"
+#include "ecs/Engine.hh"
+#include "utility/HashData.hh"
+#include "typed-geometry/tg.hh"
+#include <vector>
+
+namespace gamedev
+{
+class Terrain;
+
+/***
+* Ray & segment casts on the CPU against the instances of the spatial index and the terrain (no GPU readback).
+*
+*    - The index reports the candidates along the segment in the XZ-plane (SpatialIndex::FindAlongSegment),
+*      they are tested against the world space bounds of the instances in 3D, the first hit along the segment wins.
+*    - Swept tests: the segment from the last to the current position of a moving object (radius: its thickness)
+*      can't pass through a target between two frames, no matter the time step.
+*    - The terrain is sampled along the segment (Terrain::heightAt) and the crossing is refined by bisection.
+*
+*    RaycastHit hit;
+*    if (RaycastInstances(*mECS, {lastPosition, position}, 0.05f, SpatialUnit | SpatialHostile, mCandidates, hit))
+*        ...
+*
+* candidates is caller-owned scratch space (keep it around to reuse its capacity).
+*
+***/
+struct RaycastHit
+{
+    InstanceHandle handle = {std::uint32_t(-1)}; // invalid for terrain hits
+    float t = 1.f;                               // along the segment, in [0, 1]
+    tg::pos3 position;
+};
+
+// First instance of the categories whose bounds (grown by radius) the segment enters.
+bool RaycastInstances(EngineECS& ecs, const tg::segment3& segment, float radius, SpatialMask categories, std::vector<SpatialRayHit>& candidates, RaycastHit& hit);
+
+// First point where the segment passes below the terrain surface.
+bool RaycastTerrain(Terrain& terrain, const tg::segment3& segment, RaycastHit& hit);
+}
@@ -0,0 +1,22 @@
+#include "utility/SpatialIndex.hh"
+#include "utility/HashMap.hh"
+#include "utility/QuadTree.hh"
+#include <algorithm>
+
+std::unique_ptr<gamedev::SpatialIndex> gamedev::CreateSpatialIndex(SpatialIndexType type)
+{
+    switch (type)
+    {
+    case SpatialIndexType::LooseQuadTree:
+        return std::make_unique<LooseQuadTree>();
+    case SpatialIndexType::Grid:
+    default:
+        return std::make_unique<Hash2D>();
+    }
+}
+
+void gamedev::SpatialIndex::SortAlongSegment_(std::vector<SpatialRayHit>& result)
+{
+    std::sort(result.begin(), result.end(), [](SpatialRayHit const& l, SpatialRayHit const& r) { return l.t < r.t || (l.t == r.t && l.handle < r.handle); });
+    result.erase(std::unique(result.begin(), result.end(), [](SpatialRayHit const& l, SpatialRayHit const& r) { return l.handle == r.handle; }), result.end());
+}
@@ -0,0 +1,116 @@
+#pragma once
+#include "advanced/World.hh"
+#include "utility/HashData.hh"
+#include "typed-geometry/tg.hh"
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Common interface of the broadphase structures (XZ-plane), so every user can pick the one which suits its distribution:
+*    - Hash2D:        uniform grid, best for evenly spread instances of similar size.
+*    - LooseQuadTree: adapts to clustered instances (e.g. everything crowding the fort) and mixed sizes.
+*
+*    auto index = CreateSpatialIndex(SpatialIndexType::LooseQuadTree);
+*    index->Init(cellCount, bounds);
+*    index->AddInstance(handle, translation, bounds, SpatialUnit | SpatialHostile);
+*    index->FindNearest(position, range, SpatialUnit | SpatialHostile, 1, hits);
+*
+* Queries write into caller-owned vectors (reuse them to avoid allocations) and don't modify the index.
+* Distances are measured in the XZ-plane to the translation of an instance.
+* Every query takes a category mask, only entries with all of the requested categories are reported (0 reports all).
+* Segment queries test the bounds of the instances and report them in the order the segment enters them,
+* the index has no heights, utility/Raycast.hh refines the hits in 3D (instance bounds & terrain).
+*
+* There is one index for all systems (EngineECS::GetHashMap). Factories add the instances they create (at their final position),
+* moves are applied once per frame from the transform change log by CollisionSystem::UpdateSpatialIndex.
+*
+***/
+enum class SpatialIndexType
+{
+    Grid,
+    LooseQuadTree
+};
+
+class SpatialIndex
+{
+public:
+    virtual ~SpatialIndex() = default;
+
+    // cellCount: resolution of the grid, the quadtree uses it as its finest level
+    virtual void Init(tg::size2 cellCount, tg::aabb2 bounds) = 0;
+    void Init(tg::size2 cellCount, tg::aabb3 bounds) { Init(cellCount, tg::aabb2({bounds.min.x, bounds.min.z}, {bounds.max.x, bounds.max.z})); }
+
+    virtual void AddInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions, SpatialMask categories = 0) = 0;
+    virtual void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation) = 0;
+    virtual void UpdateInstance(const InstanceHandle identifier, const tg::vec3& translation, const tg::aabb3& dimensions) = 0;
+    virtual void RemoveInstance(const InstanceHandle identifier) = 0;
+    virtual void SetCategories(const InstanceHandle identifier, SpatialMask categories) = 0;
+    virtual SpatialMask GetCategories(const InstanceHandle identifier) const = 0;
+    virtual bool Contains(const InstanceHandle identifier) const = 0;
+
+    // Overwrites result with the instances of the categories near the area [translation + min, translation + max] (may contain a few more).
+    virtual void FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, SpatialMask categories, std::vector<InstanceHandle>& result) const = 0;
+    void FindNear(const tg::vec3& translation, const tg::pos3& min, const tg::pos3& max, std::vector<InstanceHandle>& result) const { FindNear(translation, min, max, 0, result); }
+    void FindNear(const tg::vec3& translation, const tg::aabb3& bounds, SpatialMask categories, std::vector<InstanceHandle>& result) const { FindNear(translation, bounds.min, bounds.max, categories, result); }
+    void FindNear(const tg::vec3& translation, const tg::aabb3& bounds, std::vector<InstanceHandle>& result) const { FindNear(translation, bounds.min, bounds.max, 0, result); }
+    void FindNear(const tg::vec3& translation, const tg::size3& bounds, std::vector<InstanceHandle>& result) const { FindNear(translation, {-bounds.width, 0, -bounds.depth}, {bounds.width, 0, bounds.depth}, result); }
+    void FindNear(const tg::pos3& position, std::vector<InstanceHandle>& result) const { FindNear(tg::vec3(position), tg::pos3::zero, tg::pos3::zero, result); }
+
+    // Overwrites result with the instances of the categories within radius of center (unordered, 0 requests all categories).
+    virtual void FindInRadius(const tg::pos3& center, float radius, SpatialMask categories, std::vector<InstanceHandle>& result) const = 0;
+
+    // Overwrites result with the (up to) k nearest instances of the categories within maxRadius of center, nearest first.
+    virtual void FindNearest(const tg::pos3& center, float maxRadius, SpatialMask categories, size_t k, std::vector<SpatialHit>& result) const = 0;
+
+    // Overwrites result with the instances of the categories whose bounds (grown by radius) the segment from -> to crosses
+    // in the XZ-plane, ordered by the entry point along the segment (t = 0 if from lies inside).
+    virtual void FindAlongSegment(const tg::pos3& from, const tg::pos3& to, float radius, SpatialMask categories, std::vector<SpatialRayHit>& result) const = 0;
+    void FindAlongRay(const tg::pos3& origin, const tg::dir3& direction, float maxDistance, SpatialMask categories, std::vector<SpatialRayHit>& result) const
+    {
+        FindAlongSegment(origin, origin + maxDistance * direction, 0.f, categories, result); // t relative to maxDistance
+    }
+
+    virtual void Clear() = 0;
+
+protected:
+    // By t, duplicates (same handle, same t) end up next to each other & are dropped
+    static void SortAlongSegment_(std::vector<SpatialRayHit>& result);
+};
+
+// Slab test of the segment from + t * delta (t in [0, 1]) against box, t of the entry point (0 if from lies inside)
+template <int D>
+bool IntersectSegment(const tg::aabb<D, float>& box, const tg::pos<D, float>& from, const tg::vec<D, float>& delta, float& t)
+{
+    float enter = 0.f;
+    float exit = 1.f;
+
+    for (int i = 0; i < D; ++i)
+    {
+        if (delta[i] == 0.f)
+        {
+            if (from[i] < box.min[i] || from[i] > box.max[i])
+                return false;
+            continue;
+        }
+
+        auto const inv = 1.f / delta[i];
+        auto t0 = (box.min[i] - from[i]) * inv;
+        auto t1 = (box.max[i] - from[i]) * inv;
+        if (t0 > t1)
+            std::swap(t0, t1);
+
+        enter = tg::max(enter, t0);
+        exit = tg::min(exit, t1);
+        if (enter > exit)
+            return false;
+    }
+
+    t = enter;
+    return true;
+}
+
+std::unique_ptr<SpatialIndex> CreateSpatialIndex(SpatialIndexType type);
+}
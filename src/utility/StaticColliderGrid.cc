@@ -0,0 +1,251 @@
+#include "utility/StaticColliderGrid.hh"
+#include <assert.h>
+#include <cmath>
+
+void gamedev::StaticColliderGrid::Add(const InstanceHandle handle, const tg::aabb2& bounds, const WorldShape& shape)
+{
+    if (Contains(handle))
+        return;
+
+    // Stale handle of a destroyed instance in the same slot
+    if (handle.index() < mSourceOf.size() && mSourceOf[handle.index()] != InvalidSlot)
+        Remove(mSources[mSourceOf[handle.index()]].handle);
+
+    uint32_t slot;
+    if (!mFreeSources.empty())
+    {
+        slot = mFreeSources.back();
+        mFreeSources.pop_back();
+    }
+    else
+    {
+        slot = uint32_t(mSources.size());
+        mSources.emplace_back();
+    }
+
+    mSources[slot] = {handle, bounds, shape};
+
+    if (handle.index() >= mSourceOf.size())
+        mSourceOf.resize(handle.index() + 1, InvalidSlot);
+    mSourceOf[handle.index()] = slot;
+
+    mChanged.push_back(handle);
+    mDirty = true;
+}
+
+void gamedev::StaticColliderGrid::Move(const InstanceHandle handle, const tg::aabb2& bounds, const WorldShape& shape)
+{
+    if (!Contains(handle))
+        return;
+
+    auto& s = mSources[mSourceOf[handle.index()]];
+    s.bounds = bounds;
+    s.shape = shape;
+
+    mChanged.push_back(handle);
+    mDirty = true;
+}
+
+void gamedev::StaticColliderGrid::Remove(const InstanceHandle handle)
+{
+    if (!Contains(handle))
+        return;
+
+    auto const slot = mSourceOf[handle.index()];
+    mSources[slot].handle = {std::uint32_t(-1)};
+    mFreeSources.push_back(slot);
+    mSourceOf[handle.index()] = InvalidSlot;
+
+    mChanged.push_back(handle);
+    mDirty = true;
+}
+
+bool gamedev::StaticColliderGrid::Contains(const InstanceHandle handle) const
+{
+    auto const index = handle.index();
+    return index < mSourceOf.size() && mSourceOf[index] != InvalidSlot && mSources[mSourceOf[index]].handle == handle;
+}
+
+void gamedev::StaticColliderGrid::Clear()
+{
+    mSources.clear();
+    mSourceOf.clear();
+    mFreeSources.clear();
+    mChanged.clear();
+
+    mColliders.clear();
+    mColliderOf.clear();
+    mCellStart.clear();
+    mCellItems.clear();
+    mPatchHead.clear();
+    mPatchItems.clear();
+    mNumPatched = 0;
+    mNumDead = 0;
+    mChangedAreas.clear();
+    mCellCount = {0, 0};
+
+    mDirty = false;
+}
+
+tg::ipos2 gamedev::StaticColliderGrid::CellOf_(const tg::pos2& p) const
+{
+    auto const x = int(std::floor((p.x - mOrigin.x) * mInvCellSize));
+    auto const y = int(std::floor((p.y - mOrigin.y) * mInvCellSize));
+
+    return {tg::clamp(x, 0, mCellCount.width - 1), tg::clamp(y, 0, mCellCount.height - 1)};
+}
+
+void gamedev::StaticColliderGrid::Build()
+{
+    mDirty = false;
+    mChangedAreas.clear();
+
+    // Each changed slot once (a stale handle & its successor share it), in order of the slots
+    auto const byIndex = [](InstanceHandle l, InstanceHandle r) { return l.index() < r.index(); };
+    std::sort(mChanged.begin(), mChanged.end(), byIndex);
+    mChanged.erase(std::unique(mChanged.begin(), mChanged.end(), [](InstanceHandle l, InstanceHandle r) { return l.index() == r.index(); }), mChanged.end());
+
+    for (auto const handle : mChanged)
+    {
+        auto const index = handle.index();
+        if (index < mColliderOf.size() && mColliderOf[index] != InvalidSlot)
+            mChangedAreas.push_back(mColliders[mColliderOf[index]].bounds);
+
+        if (index < mSourceOf.size() && mSourceOf[index] != InvalidSlot)
+            mChangedAreas.push_back(mSources[mSourceOf[index]].bounds);
+    }
+
+    // Patch single changes in, bake again once they add up
+    if (mCellCount.width > 0 && mNumPatched + mNumDead + mChanged.size() <= std::max(MinPatches, Size() / 8))
+    {
+        for (auto const handle : mChanged)
+        {
+            auto const index = handle.index();
+            Kill_(index);
+
+            if (index < mSourceOf.size() && mSourceOf[index] != InvalidSlot)
+                Patch_(mSources[mSourceOf[index]]);
+        }
+    }
+    else
+        Bake_();
+
+    mChanged.clear();
+}
+
+void gamedev::StaticColliderGrid::Kill_(uint32_t index)
+{
+    if (index >= mColliderOf.size() || mColliderOf[index] == InvalidSlot)
+        return;
+
+    mColliders[mColliderOf[index]].handle = {std::uint32_t(-1)};
+    mColliderOf[index] = InvalidSlot;
+    ++mNumDead;
+}
+
+void gamedev::StaticColliderGrid::Patch_(const Source& source)
+{
+    auto const collider = uint32_t(mColliders.size());
+    mColliders.push_back({source.handle, source.bounds, source.shape});
+
+    if (source.handle.index() >= mColliderOf.size())
+        mColliderOf.resize(source.handle.index() + 1, InvalidSlot);
+    mColliderOf[source.handle.index()] = collider;
+
+    // Outside of the baked extent the border cells hold the collider (queries are clamped the same way)
+    auto const i1 = CellOf_(source.bounds.min);
+    auto const i2 = CellOf_(source.bounds.max);
+
+    for (int y = i1.y; y <= i2.y; y++)
+    {
+        for (int x = i1.x; x <= i2.x; x++)
+        {
+            auto& head = mPatchHead[y * mCellCount.width + x];
+            mPatchItems.push_back({{source.bounds, collider, uint16_t(i1.x), uint16_t(i1.y)}, head});
+            head = uint32_t(mPatchItems.size() - 1);
+        }
+    }
+
+    ++mNumPatched;
+}
+
+void gamedev::StaticColliderGrid::Bake_()
+{
+    // Pack the colliders, ordered by handle so the query order doesn't depend on the order of changes
+    mColliders.clear();
+    for (auto const& s : mSources)
+    {
+        if (s.handle.is_valid())
+            mColliders.push_back({s.handle, s.bounds, s.shape});
+    }
+
+    std::sort(mColliders.begin(), mColliders.end(), [](Collider const& l, Collider const& r) { return l.handle < r.handle; });
+
+    std::fill(mColliderOf.begin(), mColliderOf.end(), InvalidSlot);
+    for (uint32_t i = 0; i < mColliders.size(); ++i)
+    {
+        auto const index = mColliders[i].handle.index();
+        if (index >= mColliderOf.size())
+            mColliderOf.resize(index + 1, InvalidSlot);
+        mColliderOf[index] = i;
+    }
+
+    mCellStart.clear();
+    mCellItems.clear();
+    mPatchHead.clear();
+    mPatchItems.clear();
+    mNumPatched = 0;
+    mNumDead = 0;
+    mCellCount = {0, 0};
+
+    if (mColliders.empty())
+        return;
+
+    // Grid over the extent of all colliders, cells of about the average collider size
+    auto extent = mColliders[0].bounds;
+    float size = 0.f;
+    for (auto const& c : mColliders)
+    {
+        extent.min = tg::min(extent.min, c.bounds.min);
+        extent.max = tg::max(extent.max, c.bounds.max);
+        size += tg::max(c.bounds.max.x - c.bounds.min.x, c.bounds.max.y - c.bounds.min.y);
+    }
+
+    auto const width = extent.max.x - extent.min.x;
+    auto const depth = extent.max.y - extent.min.y;
+    auto const cellSize = tg::max(size / mColliders.size(), tg::max(width, depth) / MaxCells, 1e-3f);
+
+    mOrigin = extent.min;
+    mInvCellSize = 1.f / cellSize;
+    mCellCount.width = tg::clamp(int(std::ceil(width * mInvCellSize)), 1, MaxCells);
+    mCellCount.height = tg::clamp(int(std::ceil(depth * mInvCellSize)), 1, MaxCells);
+
+    // Counting sort into the cells
+    mCellStart.assign(mCellCount.width * mCellCount.height + 1, 0);
+    mPatchHead.assign(mCellCount.width * mCellCount.height, InvalidSlot);
+    for (auto const& c : mColliders)
+    {
+        auto const i1 = CellOf_(c.bounds.min);
+        auto const i2 = CellOf_(c.bounds.max);
+
+        for (int y = i1.y; y <= i2.y; y++)
+            for (int x = i1.x; x <= i2.x; x++)
+                ++mCellStart[y * mCellCount.width + x + 1];
+    }
+
+    for (size_t i = 1; i < mCellStart.size(); ++i)
+        mCellStart[i] += mCellStart[i - 1];
+
+    std::vector<uint32_t> next(mCellStart.begin(), mCellStart.end() - 1);
+    mCellItems.resize(mCellStart.back());
+    for (uint32_t i = 0; i < mColliders.size(); ++i)
+    {
+        auto const& bounds = mColliders[i].bounds;
+        auto const i1 = CellOf_(bounds.min);
+        auto const i2 = CellOf_(bounds.max);
+
+        for (int y = i1.y; y <= i2.y; y++)
+            for (int x = i1.x; x <= i2.x; x++)
+                mCellItems[next[y * mCellCount.width + x]++] = {bounds, i, uint16_t(i1.x), uint16_t(i1.y)};
+    }
+}
@@ -0,0 +1,163 @@
+#pragma once
+#include "advanced/World.hh"
+#include "typed-geometry/tg.hh"
+#include "utility/Narrowphase.hh"
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Baked acceleration structure of the static colliders (XZ-plane): walls, towers, fences, nature.
+*
+*    - Changes (Add, Move, Remove) are staged & applied by Build(), it never runs while nothing changed.
+*    - Baking packs the colliders (ordered by handle) with their world space bounds & shape into one array and sorts them
+*      into the cells of a uniform grid over their extent (counting sort, the cells are ranges of one item array).
+*      Items carry a copy of the bounds, a query scans its cells sequentially & only touches the colliders it reports.
+*    - The cell size follows the average collider size, every collider covers only a few cells.
+*    - Build() patches single changes in: the old entry of a moved or removed collider is dropped (tombstone), a new or
+*      moved collider is linked into the patch lists of only the cells it covers (reported after the baked items of a
+*      cell). Once the patches add up to an eighth of the colliders, everything is baked again.
+*    - GetChangedAreas() lists the old & new bounds of the colliders changed by the last Build(), to wake the units there.
+*    - Queries are const & don't allocate, any number of threads can query the baked grid at the same time.
+*      A collider covering several cells is reported once, touching bounds don't overlap.
+*
+*    mStatics.Add(handle, bounds, shape);
+*    mStatics.Build(); // once per frame, if IsDirty()
+*    mStatics.ForEachOverlap(bounds, [&](StaticColliderGrid::Collider const& c) { ... });
+*
+***/
+class StaticColliderGrid
+{
+public:
+    struct Collider
+    {
+        InstanceHandle handle;
+        tg::aabb2 bounds; // world space
+        WorldShape shape;
+    };
+
+    void Add(const InstanceHandle handle, const tg::aabb2& bounds, const WorldShape& shape);
+    void Move(const InstanceHandle handle, const tg::aabb2& bounds, const WorldShape& shape);
+    void Remove(const InstanceHandle handle);
+    bool Contains(const InstanceHandle handle) const;
+    void Clear();
+
+    // Applies the staged changes, the queries only see the colliders of the last Build().
+    void Build();
+    bool IsDirty() const { return mDirty; }
+
+    // Bounds of the colliders added, moved (before & after) or removed by the last Build().
+    const std::vector<tg::aabb2>& GetChangedAreas() const { return mChangedAreas; }
+
+    // Calls func(Collider const&) for every baked collider whose bounds overlap the area.
+    template <typename Func>
+    void ForEachOverlap(const tg::aabb2& area, Func&& func) const;
+
+    size_t Size() const { return mColliders.size() - mNumDead; }
+    tg::isize2 GetCellCount() const { return mCellCount; }
+
+private:
+    static constexpr uint32_t InvalidSlot = uint32_t(-1);
+    static constexpr int MaxCells = 1024;    // per axis
+    static constexpr size_t MinPatches = 64; // patched & dead colliders before everything is baked again
+
+    // Entry of a cell
+    struct Item
+    {
+        tg::aabb2 bounds;
+        uint32_t collider;   // into mColliders
+        uint16_t firstX = 0; // first cell covered, to report the collider only once per query
+        uint16_t firstY = 0;
+    };
+
+    // Entry of a cell added after baking, linked per cell
+    struct PatchItem
+    {
+        Item item;
+        uint32_t next; // into mPatchItems, InvalidSlot ends the list
+    };
+
+    struct Source
+    {
+        InstanceHandle handle;
+        tg::aabb2 bounds;
+        WorldShape shape;
+    };
+
+    static bool Overlaps_(const tg::aabb2& a, const tg::aabb2& b)
+    {
+        return a.min.x < b.max.x && b.min.x < a.max.x && a.min.y < b.max.y && b.min.y < a.max.y;
+    }
+
+    tg::ipos2 CellOf_(const tg::pos2& p) const;
+
+    void Bake_();
+    void Patch_(const Source& source);
+    void Kill_(uint32_t index); // drops the baked or patched collider of the slot
+
+    template <typename Func>
+    void VisitItem_(const Item& item, int x, int y, const tg::ipos2& i1, const tg::aabb2& area, Func& func) const;
+
+private:
+    // Staged, by InstanceHandle::index()
+    std::vector<Source> mSources;
+    std::vector<uint32_t> mSourceOf;
+    std::vector<uint32_t> mFreeSources;
+    std::vector<InstanceHandle> mChanged; // since the last Build()
+    bool mDirty = false;
+
+    // Baked & patched
+    std::vector<Collider> mColliders; // a removed collider keeps its entry with an invalid handle until the next bake
+    std::vector<uint32_t> mColliderOf; // into mColliders, by InstanceHandle::index()
+    std::vector<uint32_t> mCellStart;  // into mCellItems, by cell (+ end), row-major
+    std::vector<Item> mCellItems;
+    std::vector<uint32_t> mPatchHead; // into mPatchItems, by cell
+    std::vector<PatchItem> mPatchItems;
+    size_t mNumPatched = 0;
+    size_t mNumDead = 0;
+    std::vector<tg::aabb2> mChangedAreas;
+    tg::pos2 mOrigin;
+    float mInvCellSize = 1.f;
+    tg::isize2 mCellCount = {0, 0};
+};
+
+template <typename Func>
+void StaticColliderGrid::ForEachOverlap(const tg::aabb2& area, Func&& func) const
+{
+    if (mColliders.empty())
+        return;
+
+    auto const i1 = CellOf_(area.min);
+    auto const i2 = CellOf_(area.max);
+
+    for (int y = i1.y; y <= i2.y; y++)
+    {
+        for (int x = i1.x; x <= i2.x; x++)
+        {
+            auto const cell = y * mCellCount.width + x;
+            for (auto k = mCellStart[cell]; k < mCellStart[cell + 1]; ++k)
+                VisitItem_(mCellItems[k], x, y, i1, area, func);
+
+            for (auto k = mPatchHead[cell]; k != InvalidSlot; k = mPatchItems[k].next)
+                VisitItem_(mPatchItems[k].item, x, y, i1, area, func);
+        }
+    }
+}
+
+template <typename Func>
+void StaticColliderGrid::VisitItem_(const Item& item, int x, int y, const tg::ipos2& i1, const tg::aabb2& area, Func& func) const
+{
+    // uniqueness check: a collider is only reported in the first cell it shares with the area
+    if (x != std::max(int(item.firstX), i1.x) || y != std::max(int(item.firstY), i1.y))
+        return;
+
+    if (!Overlaps_(item.bounds, area))
+        return;
+
+    auto const& collider = mColliders[item.collider];
+    if (collider.handle.is_valid())
+        func(collider);
+}
+}
@@ -0,0 +1,315 @@
+#include "utility/SweepAndPrune.hh"
+#include <algorithm>
+#include <assert.h>
+
+void gamedev::SweepAndPrune::Add(const InstanceHandle handle, const tg::aabb2& bounds, bool dynamic)
+{
+    if (Contains(handle))
+        return;
+
+    // Stale handle of a destroyed instance in the same slot
+    if (handle.index() < mBoxOf.size() && mBoxOf[handle.index()] != InvalidBox)
+        Remove(mBoxes[mBoxOf[handle.index()]].handle);
+
+    uint32_t box;
+    if (!mFreeBoxes.empty())
+    {
+        box = mFreeBoxes.back();
+        mFreeBoxes.pop_back();
+    }
+    else
+    {
+        box = uint32_t(mBoxes.size());
+        mBoxes.emplace_back();
+    }
+
+    auto& b = mBoxes[box];
+    b.handle = handle;
+    b.dynamic = dynamic;
+    b.removed = false;
+    b.min[0] = bounds.min.x;
+    b.min[1] = bounds.min.y;
+    b.max[0] = bounds.max.x;
+    b.max[1] = bounds.max.y;
+
+    if (handle.index() >= mBoxOf.size())
+        mBoxOf.resize(handle.index() + 1, InvalidBox);
+    mBoxOf[handle.index()] = box;
+
+    // Sorted into place (and paired) by the next Update()
+    for (auto& endpoints : mEndpoints)
+    {
+        endpoints.push_back({0.f, box << 1});
+        endpoints.push_back({0.f, box << 1 | 1});
+    }
+    ++mAdded;
+}
+
+void gamedev::SweepAndPrune::Move(const InstanceHandle handle, const tg::aabb2& bounds)
+{
+    if (!Contains(handle))
+        return;
+
+    auto& b = mBoxes[mBoxOf[handle.index()]];
+    b.min[0] = bounds.min.x;
+    b.min[1] = bounds.min.y;
+    b.max[0] = bounds.max.x;
+    b.max[1] = bounds.max.y;
+}
+
+void gamedev::SweepAndPrune::SetDynamic(const InstanceHandle handle, bool dynamic)
+{
+    if (!Contains(handle) || mBoxes[mBoxOf[handle.index()]].dynamic == dynamic)
+        return;
+
+    // Pairs with static instances were never tracked, re-add the instance to find them
+    auto const& b = mBoxes[mBoxOf[handle.index()]];
+    auto const bounds = tg::aabb2({b.min[0], b.min[1]}, {b.max[0], b.max[1]});
+
+    Remove(handle);
+    Add(handle, bounds, dynamic);
+}
+
+void gamedev::SweepAndPrune::Remove(const InstanceHandle handle)
+{
+    if (!Contains(handle))
+        return;
+
+    // The endpoints move to the end of the lists on the next Update(), which ends all pairs of the box
+    auto const box = mBoxOf[handle.index()];
+    mBoxes[box].removed = true;
+    mRemovedBoxes.push_back(box);
+    mBoxOf[handle.index()] = InvalidBox;
+}
+
+bool gamedev::SweepAndPrune::Contains(const InstanceHandle handle) const
+{
+    auto const index = handle.index();
+    return index < mBoxOf.size() && mBoxOf[index] != InvalidBox && mBoxes[mBoxOf[index]].handle == handle;
+}
+
+void gamedev::SweepAndPrune::Clear()
+{
+    mBoxes.clear();
+    mFreeBoxes.clear();
+    mRemovedBoxes.clear();
+    mBoxOf.clear();
+    for (auto& endpoints : mEndpoints)
+        endpoints.clear();
+
+    mPairSet.clear();
+    mBegan.clear();
+    mEnded.clear();
+    mPairs.clear();
+    mBeganPairs.clear();
+    mEndedPairs.clear();
+    mAdded = 0;
+}
+
+bool gamedev::SweepAndPrune::Overlaps_(uint32_t boxA, uint32_t boxB) const
+{
+    auto const& a = mBoxes[boxA];
+    auto const& b = mBoxes[boxB];
+
+    if (a.removed || b.removed || !(a.dynamic || b.dynamic))
+        return false;
+
+    return a.min[0] < b.max[0] && b.min[0] < a.max[0] && a.min[1] < b.max[1] && b.min[1] < a.max[1];
+}
+
+bool gamedev::SweepAndPrune::MayOverlap_(uint32_t boxA, uint32_t boxB, int axis) const
+{
+    auto const& a = mBoxes[boxA];
+    auto const& b = mBoxes[boxB];
+
+    // Bounds apart on z are either not paired or separate on z as well, which is sorted later & ends the pair
+    if (axis == 0 && !a.removed && !b.removed)
+        return a.min[1] < b.max[1] && b.min[1] < a.max[1];
+
+    return true;
+}
+
+void gamedev::SweepAndPrune::Refresh_(int axis)
+{
+    for (auto& e : mEndpoints[axis])
+    {
+        auto const& b = mBoxes[e.Box()];
+        e.value = b.removed ? tg::inf<float> : (e.IsMax() ? b.max[axis] : b.min[axis]);
+    }
+}
+
+void gamedev::SweepAndPrune::SortAxis_(int axis)
+{
+    auto& endpoints = mEndpoints[axis];
+
+    for (size_t i = 1; i < endpoints.size(); ++i)
+    {
+        auto const e = endpoints[i];
+        size_t j = i;
+
+        while (j > 0 && Less_(e, endpoints[j - 1]))
+        {
+            auto const& other = endpoints[j - 1];
+
+            // A min passing a max to the left: the bounds start to overlap on this axis
+            if (!e.IsMax() && other.IsMax())
+            {
+                if (Overlaps_(e.Box(), other.Box()) && mPairSet.insert(Key_(e.Box(), other.Box())).second)
+                    mBegan.push_back(Key_(e.Box(), other.Box()));
+            }
+            // A max passing a min to the left: they no longer overlap
+            else if (e.IsMax() && !other.IsMax() && MayOverlap_(e.Box(), other.Box(), axis))
+            {
+                if (mPairSet.erase(Key_(e.Box(), other.Box())))
+                    mEnded.push_back(Key_(e.Box(), other.Box()));
+            }
+
+            endpoints[j] = other;
+            --j;
+        }
+
+        endpoints[j] = e;
+    }
+}
+
+void gamedev::SweepAndPrune::Rebuild_()
+{
+    // The values are already refreshed, the endpoints only need to be ordered
+    for (auto& endpoints : mEndpoints)
+        std::sort(endpoints.begin(), endpoints.end(), Less_);
+
+    // Sweep along x, the active boxes are tested on z
+    mKeys.clear();
+    mActive.clear();
+    for (auto const& e : mEndpoints[0])
+    {
+        auto const box = e.Box();
+        if (mBoxes[box].removed)
+            continue;
+
+        if (e.IsMax())
+        {
+            mActive.erase(std::find(mActive.begin(), mActive.end(), box));
+            continue;
+        }
+
+        for (auto other : mActive)
+            if (Overlaps_(box, other))
+                mKeys.push_back(Key_(box, other));
+
+        mActive.push_back(box);
+    }
+
+    // Differences to the previous pairs
+    std::sort(mKeys.begin(), mKeys.end());
+    for (auto key : mKeys)
+        if (mPairSet.erase(key) == 0)
+            mBegan.push_back(key);
+
+    for (auto key : mPairSet)
+        mEnded.push_back(key);
+
+    mPairSet.clear();
+    mPairSet.insert(mKeys.begin(), mKeys.end());
+}
+
+gamedev::SweepAndPrune::Pair gamedev::SweepAndPrune::PairOf_(uint64_t key) const
+{
+    auto const& a = mBoxes[uint32_t(key >> 32)];
+    auto const& b = mBoxes[uint32_t(key)];
+
+    if (a.handle < b.handle)
+        return {a.handle, b.handle, a.dynamic, b.dynamic};
+    return {b.handle, a.handle, b.dynamic, a.dynamic};
+}
+
+void gamedev::SweepAndPrune::Collect_(std::vector<uint64_t> const& keys, std::vector<Pair>& pairs) const
+{
+    pairs.clear();
+    for (auto key : keys)
+        pairs.push_back(PairOf_(key));
+
+    std::sort(pairs.begin(), pairs.end(), PairLess_);
+}
+
+void gamedev::SweepAndPrune::DropUnchanged_()
+{
+    size_t began = 0, ended = 0;
+    size_t keptBegan = 0, keptEnded = 0;
+
+    while (began < mBeganPairs.size() || ended < mEndedPairs.size())
+    {
+        if (ended == mEndedPairs.size() || (began < mBeganPairs.size() && PairLess_(mBeganPairs[began], mEndedPairs[ended])))
+            mBeganPairs[keptBegan++] = mBeganPairs[began++];
+        else if (began == mBeganPairs.size() || PairLess_(mEndedPairs[ended], mBeganPairs[began]))
+            mEndedPairs[keptEnded++] = mEndedPairs[ended++];
+        else
+        {
+            ++began;
+            ++ended;
+        }
+    }
+
+    mBeganPairs.resize(keptBegan);
+    mEndedPairs.resize(keptEnded);
+}
+
+void gamedev::SweepAndPrune::Update()
+{
+    mBegan.clear();
+    mEnded.clear();
+
+    Refresh_(0);
+    Refresh_(1);
+
+    // Many new boxes (e.g. the first frame or a wave spawning) would each travel through the whole lists
+    if (mAdded > RebuildThreshold && mAdded * 4 > Size())
+        Rebuild_();
+    else
+    {
+        SortAxis_(0);
+        SortAxis_(1);
+    }
+    mAdded = 0;
+
+    // Drop the endpoints of removed boxes (sorted to the end)
+    if (!mRemovedBoxes.empty())
+    {
+        for (auto& endpoints : mEndpoints)
+            endpoints.erase(std::remove_if(endpoints.begin(), endpoints.end(), [&](Endpoint const& e) { return mBoxes[e.Box()].removed; }), endpoints.end());
+    }
+
+    Collect_(mBegan, mBeganPairs);
+    Collect_(mEnded, mEndedPairs);
+
+    // pairs = pairs - ended + began, all sorted
+    if (!mEndedPairs.empty())
+    {
+        size_t next = 0;
+        mPairs.erase(std::remove_if(mPairs.begin(), mPairs.end(), [&](Pair const& p)
+        {
+            while (next < mEndedPairs.size() && PairLess_(mEndedPairs[next], p))
+                ++next;
+            return next < mEndedPairs.size() && !PairLess_(p, mEndedPairs[next]);
+        }), mPairs.end());
+    }
+
+    if (!mBeganPairs.empty())
+    {
+        auto const middle = mPairs.size();
+        mPairs.insert(mPairs.end(), mBeganPairs.begin(), mBeganPairs.end());
+        std::inplace_merge(mPairs.begin(), mPairs.begin() + middle, mPairs.end(), PairLess_);
+    }
+
+    // SetDynamic() re-adds the box, its pairs end & begin again although they only changed their flags (updated above)
+    if (!mBeganPairs.empty() && !mEndedPairs.empty())
+        DropUnchanged_();
+
+    // Nothing refers to the removed boxes anymore
+    for (auto box : mRemovedBoxes)
+    {
+        mBoxes[box].handle = {std::uint32_t(-1)};
+        mFreeBoxes.push_back(box);
+    }
+    mRemovedBoxes.clear();
+}
@@ -0,0 +1,119 @@
+#pragma once
+#include "advanced/World.hh"
+#include "typed-geometry/tg.hh"
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Sweep-and-prune broadphase (XZ-plane) which keeps the overlapping pairs of bounds between frames.
+*
+*    - Both axes keep a sorted list of the bound endpoints. Update() re-sorts them with an insertion sort,
+*      which costs O(n + swaps) because instances move only a bit from one frame to the next.
+*      Many new instances at once (first frame, spawned waves) are sorted from scratch & paired by a single sweep instead.
+*    - Overlaps only start or end where a min endpoint passes a max endpoint, only those swaps touch the pair set.
+*    - Every overlapping pair is listed once, pairs of two static instances are never reported.
+*    - GetPairs() is ordered by the handles, so the order of resolution does not depend on the insertion history.
+*    - GetBeganPairs() & GetEndedPairs() list the changes of the last Update() (also ordered),
+*      a pair which persists through SetDynamic() is in neither.
+*
+*    mBroadphase.Add(handle, bounds, dynamic);
+*    mBroadphase.Move(handle, bounds);
+*    mBroadphase.Update();
+*    for (auto const& pair : mBroadphase.GetPairs())
+*        narrowphase(pair.a, pair.b);
+*
+* Bounds are world space, touching bounds don't overlap.
+*
+***/
+class SweepAndPrune
+{
+public:
+    // a < b
+    struct Pair
+    {
+        InstanceHandle a;
+        InstanceHandle b;
+        bool dynamicA = false;
+        bool dynamicB = false;
+    };
+
+    void Add(const InstanceHandle handle, const tg::aabb2& bounds, bool dynamic);
+    void Move(const InstanceHandle handle, const tg::aabb2& bounds);
+    void SetDynamic(const InstanceHandle handle, bool dynamic);
+    void Remove(const InstanceHandle handle);
+    bool Contains(const InstanceHandle handle) const;
+    void Clear();
+
+    // Sorts the endpoints after the moves & updates the pairs, call once per frame.
+    void Update();
+
+    const std::vector<Pair>& GetPairs() const { return mPairs; }
+    const std::vector<Pair>& GetBeganPairs() const { return mBeganPairs; }
+    const std::vector<Pair>& GetEndedPairs() const { return mEndedPairs; }
+
+    size_t Size() const { return mBoxes.size() - mFreeBoxes.size(); }
+
+private:
+    static constexpr uint32_t InvalidBox = uint32_t(-1);
+    static constexpr size_t RebuildThreshold = 64; // new boxes per Update() before sorting from scratch
+
+    struct Box
+    {
+        InstanceHandle handle = {std::uint32_t(-1)};
+        float min[2] = {0, 0};
+        float max[2] = {0, 0};
+        bool dynamic = false;
+        bool removed = true;
+    };
+
+    // box << 1 | isMax, the value is refreshed from the box on every Update()
+    struct Endpoint
+    {
+        float value;
+        uint32_t data;
+
+        uint32_t Box() const { return data >> 1; }
+        bool IsMax() const { return data & 1; }
+    };
+
+    // Sort order, on equal values max endpoints come first (touching bounds don't overlap)
+    static bool Less_(const Endpoint& a, const Endpoint& b) { return a.value < b.value || (a.value == b.value && a.IsMax() && !b.IsMax()); }
+
+    static uint64_t Key_(uint32_t boxA, uint32_t boxB)
+    {
+        return boxA < boxB ? (uint64_t(boxA) << 32 | boxB) : (uint64_t(boxB) << 32 | boxA);
+    }
+
+    static bool PairLess_(const Pair& l, const Pair& r) { return l.a < r.a || (l.a == r.a && l.b < r.b); }
+
+    bool Overlaps_(uint32_t boxA, uint32_t boxB) const;
+    bool MayOverlap_(uint32_t boxA, uint32_t boxB, int axis) const;
+    void Refresh_(int axis);
+    void SortAxis_(int axis);
+    void Rebuild_();
+    Pair PairOf_(uint64_t key) const;
+    void Collect_(std::vector<uint64_t> const& keys, std::vector<Pair>& pairs) const;
+    void DropUnchanged_();
+
+private:
+    std::vector<Box> mBoxes;
+    std::vector<uint32_t> mFreeBoxes;
+    std::vector<uint32_t> mRemovedBoxes; // removed since the last Update(), released by it
+    std::vector<uint32_t> mBoxOf;        // by InstanceHandle::index()
+    std::vector<Endpoint> mEndpoints[2]; // x, z
+
+    std::unordered_set<uint64_t> mPairSet; // box pairs
+    std::vector<uint64_t> mBegan;
+    std::vector<uint64_t> mEnded;
+    std::vector<uint64_t> mKeys;   // scratch of Rebuild_()
+    std::vector<uint32_t> mActive; // scratch of Rebuild_()
+    size_t mAdded = 0;             // boxes added since the last Update()
+
+    std::vector<Pair> mPairs;
+    std::vector<Pair> mBeganPairs;
+    std::vector<Pair> mEndedPairs;
+};
+}
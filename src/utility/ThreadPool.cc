@@ -0,0 +1,94 @@
+#include "utility/ThreadPool.hh"
+#include <algorithm>
+
+gamedev::ThreadPool::ThreadPool(unsigned numThreads)
+{
+    if (numThreads == 0)
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+
+    for (unsigned i = 1; i < numThreads; ++i)
+        mWorkers.emplace_back([this] { WorkerLoop(); });
+}
+
+gamedev::ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWakeUp.notify_all();
+
+    for (auto& worker : mWorkers)
+        worker.join();
+}
+
+void gamedev::ThreadPool::Run(std::vector<std::function<void()>> const& tasks)
+{
+    if (tasks.empty())
+        return;
+
+    // Nothing to distribute
+    if (tasks.size() == 1 || mWorkers.empty())
+    {
+        for (auto const& task : tasks)
+            task();
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTasks = &tasks;
+        mNextTask = 0;
+        mPendingTasks = tasks.size();
+        ++mBatch;
+    }
+    mWakeUp.notify_all();
+
+    ExecuteTasks(tasks);
+
+    // Workers may still hold a reference to the batch until they are inactive again
+    std::unique_lock<std::mutex> lock(mMutex);
+    mFinished.wait(lock, [this] { return mPendingTasks == 0 && mActiveWorkers == 0; });
+    mTasks = nullptr;
+}
+
+void gamedev::ThreadPool::WorkerLoop()
+{
+    uint64_t lastBatch = 0;
+
+    while (true)
+    {
+        std::vector<std::function<void()>> const* tasks = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWakeUp.wait(lock, [&] { return mStop || (mTasks && mBatch != lastBatch); });
+
+            if (mStop)
+                return;
+
+            lastBatch = mBatch;
+            tasks = mTasks;
+            ++mActiveWorkers;
+        }
+
+        ExecuteTasks(*tasks);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mActiveWorkers;
+        }
+        mFinished.notify_all();
+    }
+}
+
+void gamedev::ThreadPool::ExecuteTasks(std::vector<std::function<void()>> const& tasks)
+{
+    for (size_t i = mNextTask++; i < tasks.size(); i = mNextTask++)
+    {
+        tasks[i]();
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (--mPendingTasks == 0)
+            mFinished.notify_all();
+    }
+}
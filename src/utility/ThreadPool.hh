@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace gamedev
+{
+/***
+* Fixed set of worker threads which execute a batch of tasks.
+*
+* Run() hands out the tasks of one batch to the workers & the calling thread and returns once all of them finished.
+* There is no task queue beyond the current batch, so a task must not call Run() itself.
+* A batch of a single task runs on the calling thread without involving the workers, such a task may use the pool again.
+*
+***/
+class ThreadPool
+{
+public:
+    // 0 threads: use all hardware threads (the calling thread counts as one of them)
+    explicit ThreadPool(unsigned numThreads = 0);
+    ~ThreadPool();
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    // Executes all tasks in parallel, blocks until they are done.
+    void Run(std::vector<std::function<void()>> const& tasks);
+
+    // Worker threads + the calling thread
+    unsigned GetNumThreads() const { return unsigned(mWorkers.size()) + 1; }
+
+private:
+    void WorkerLoop();
+    void ExecuteTasks(std::vector<std::function<void()>> const& tasks);
+
+private:
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mMutex;
+    std::condition_variable mWakeUp;
+    std::condition_variable mFinished;
+
+    // Current batch, only valid while Run() is executing
+    std::vector<std::function<void()>> const* mTasks = nullptr;
+    std::atomic<size_t> mNextTask = 0;
+    size_t mPendingTasks = 0;
+    unsigned mActiveWorkers = 0;
+    uint64_t mBatch = 0;
+
+    bool mStop = false;
+};
+}
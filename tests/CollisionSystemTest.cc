@@ -0,0 +1,216 @@
+#include "Test.hh"
+#include "systems/CollisionSystem.hh"
+
+using namespace gamedev;
+
+namespace
+{
+constexpr int FramesToSleep = 40; // more than CollisionSystem::SleepFrames
+
+struct Scene
+{
+    std::shared_ptr<EngineECS> ecs;
+    std::shared_ptr<CollisionSystem> collision;
+
+    Scene()
+    {
+        auto& world = *new World; // owned by the ECS
+        world.initialize(1024);
+
+        ecs = std::make_shared<EngineECS>();
+        ecs->Init(world);
+        ecs->InitSpatialIndex(tg::size2(64, 64), tg::aabb2({-32, -32}, {32, 32}));
+
+        ecs->RegisterComponent<Prototype>();
+        ecs->RegisterComponent<Collider>();
+        ecs->RegisterComponent<CircleShape>();
+        ecs->RegisterComponent<BoxShape>();
+        ecs->RegisterComponent<Destructible>();
+        ecs->RegisterComponent<InTower>();
+        ecs->RegisterComponent<Physics>();
+        ecs->RegisterEvent<CollisionEvent>();
+
+        collision = ecs->RegisterSystem<CollisionSystem>();
+        Signature signature;
+        signature.set(ecs->GetComponentType<Collider>());
+        ecs->SetSystemSignature<CollisionSystem>(signature);
+        collision->Init(ecs);
+    }
+
+    // Unit: circle of radius 0.5
+    InstanceHandle CreateUnit(tg::vec3 translation)
+    {
+        auto handle = CreateInstance_(translation, tg::aabb3({-0.5f, 0, -0.5f}, {0.5f, 1, 0.5f}));
+
+        CircleShape shape;
+        shape.circle = tg::sphere3(tg::pos3::zero, 0.5f);
+        ecs->AddComponent(handle, shape);
+
+        Collider collider;
+        collider.dynamic = true;
+        ecs->AddComponent(handle, collider);
+        return handle;
+    }
+
+    // Wall: box of 1 x 4 units (x, z)
+    InstanceHandle CreateWall(tg::vec3 translation)
+    {
+        auto handle = CreateInstance_(translation, tg::aabb3({-0.5f, 0, -2}, {0.5f, 2, 2}));
+
+        BoxShape shape;
+        shape.box.center = tg::pos3::zero;
+        shape.box.half_extents[0] = tg::vec3(0.5f, 0, 0);
+        shape.box.half_extents[1] = tg::vec3::zero;
+        shape.box.half_extents[2] = tg::vec3(0, 0, 2);
+        ecs->AddComponent(handle, shape);
+
+        ecs->AddComponent(handle, Collider{});
+        return handle;
+    }
+
+    void MoveTo(InstanceHandle handle, tg::vec3 translation)
+    {
+        ecs->GetInstanceTransform(handle).translation = translation;
+        ecs->MarkTransformChanged(handle);
+    }
+
+    float X(InstanceHandle handle) { return ecs->GetInstanceTransform(handle).translation.x; }
+
+    void Update(int frames = 1)
+    {
+        for (int i = 0; i < frames; ++i)
+            collision->Update(0.02f);
+    }
+
+private:
+    InstanceHandle CreateInstance_(tg::vec3 translation, tg::aabb3 bounds)
+    {
+        auto handle = ecs->CreateInstance(nullptr, nullptr, nullptr, nullptr);
+        ecs->GetInstanceTransform(handle).translation = translation;
+        ecs->GetInstanceBounds(handle) = bounds;
+        ecs->GetHashMap().AddInstance(handle, translation, bounds);
+        return handle;
+    }
+};
+
+// Idle units fall asleep, moved units wake up, units in towers are not counted
+void TestCounts()
+{
+    Scene scene;
+
+    std::vector<InstanceHandle> units;
+    for (int i = 0; i < 10; ++i)
+        units.push_back(scene.CreateUnit({-20.f + 4.f * i, 0, 10}));
+
+    scene.Update();
+    CHECK(scene.collision->GetNumAwake() == 10);
+    CHECK(scene.collision->GetNumSleeping() == 0);
+
+    scene.Update(FramesToSleep);
+    CHECK(scene.collision->GetNumAwake() == 0);
+    CHECK(scene.collision->GetNumSleeping() == 10);
+
+    scene.MoveTo(units[3], {-8, 0, 12});
+    scene.Update();
+    CHECK(scene.collision->GetNumAwake() == 1);
+    CHECK(scene.collision->GetNumSleeping() == 9);
+
+    scene.ecs->CreateComponent<InTower>(units[5]);
+    scene.Update();
+    CHECK(scene.collision->GetNumAwake() + scene.collision->GetNumSleeping() == 9);
+
+    scene.Update(FramesToSleep);
+    CHECK(scene.collision->GetNumAwake() == 0);
+}
+
+// An awake unit moving into a sleeping one wakes it in the same frame, both are pushed apart
+void TestWakeByContact()
+{
+    Scene scene;
+
+    auto const sleeper = scene.CreateUnit({0, 0, 0});
+    auto const mover = scene.CreateUnit({-5, 0, 0});
+
+    scene.Update(FramesToSleep);
+    CHECK(scene.collision->GetNumSleeping() == 2);
+
+    scene.MoveTo(mover, {-0.8f, 0, 0});
+    scene.Update();
+    CHECK(scene.collision->GetNumAwake() == 2);
+    CHECK(scene.X(sleeper) > 0.f);
+    CHECK(scene.X(mover) < -0.8f);
+
+    // Sleeping units close to each other but not touching stay asleep
+    scene.MoveTo(mover, {-3, 0, 0});
+    scene.Update(FramesToSleep);
+    CHECK(scene.collision->GetNumSleeping() == 2);
+}
+
+// A sleeper woken by an awake unit also gets its static contacts in that frame
+void TestWokenSleeperHitsStatics()
+{
+    Scene scene;
+
+    scene.CreateWall({10, 0, 0}); // x in [9.5, 10.5]
+    auto const sleeper = scene.CreateUnit({8.5f, 0, 0});
+    auto const mover = scene.CreateUnit({0, 0, 0});
+
+    scene.Update(FramesToSleep);
+    CHECK(scene.collision->GetNumSleeping() == 2);
+
+    // Resting against the wall with some penetration left (not marked, the unit keeps sleeping)
+    scene.ecs->GetInstanceTransform(sleeper).translation.x = 9.1f;
+    scene.Update();
+    CHECK(scene.collision->GetNumSleeping() == 2);
+    CHECK(scene.X(sleeper) == 9.1f);
+
+    // Pushed into the wall by the mover: the wall contact pushes it back out in the same frame
+    scene.MoveTo(mover, {8.3f, 0, 0});
+    scene.Update();
+    CHECK(scene.collision->GetNumAwake() == 2);
+    CHECK(scene.X(sleeper) < 9.1f);
+    CHECK(scene.X(mover) < 8.3f);
+}
+
+// Building, moving or destroying a wall only wakes the units touching it
+void TestWakeByStaticChange()
+{
+    Scene scene;
+
+    auto const near = scene.CreateUnit({0, 0, 0});
+    auto const far = scene.CreateUnit({20, 0, 0});
+
+    scene.Update(FramesToSleep);
+    CHECK(scene.collision->GetNumSleeping() == 2);
+
+    // Far from both
+    auto const wall = scene.CreateWall({-15, 0, 10});
+    scene.Update();
+    CHECK(scene.collision->GetNumSleeping() == 2);
+
+    // Moved onto the near unit: it is pushed out in the same frame, the far one keeps sleeping
+    scene.MoveTo(wall, {0.6f, 0, 0});
+    scene.Update();
+    CHECK(scene.collision->GetNumAwake() == 1);
+    CHECK(scene.X(near) < 0.f);
+    CHECK(scene.X(far) == 20.f);
+
+    scene.Update(FramesToSleep);
+    CHECK(scene.collision->GetNumSleeping() == 2);
+
+    // Destroyed next to the near unit
+    scene.ecs->DestroyInstance(wall);
+    scene.Update();
+    CHECK(scene.collision->GetNumAwake() == 1);
+}
+}
+
+int main()
+{
+    TestCounts();
+    TestWakeByContact();
+    TestWokenSleeperHitsStatics();
+    TestWakeByStaticChange();
+
+    return gamedev::test::Result();
+}
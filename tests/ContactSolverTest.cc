@@ -0,0 +1,178 @@
+#include "Test.hh"
+#include "utility/ContactSolver.hh"
+#include "utility/Narrowphase.hh"
+#include "utility/ThreadPool.hh"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <unordered_map>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+constexpr int Frames = 20;
+
+// A crowd of circles packed in rows, the left half marching left & the right half right into a wall of boxes
+// (the pile-up of bench/ContactSolverBench.cc). Pairs come from a uniform grid of 1 x 1 cells.
+struct Scene
+{
+    std::vector<tg::pos2> positions;
+    std::vector<float> radii;
+    std::vector<float> directions;
+    std::vector<WorldShape> walls;
+    std::vector<std::pair<uint32_t, uint32_t>> contacts;
+
+    explicit Scene(int numMonsters)
+    {
+        std::mt19937 rng(21);
+        std::uniform_real_distribution<float> unit(0, 1);
+
+        auto const side = int(std::sqrt(float(numMonsters)));
+        for (int i = 0; i < numMonsters; ++i)
+        {
+            auto const x = float(i % side) * 0.9f - float(side) * 0.45f + 0.1f * unit(rng);
+            auto const z = float(i / side) * 0.9f + 0.1f * unit(rng);
+            positions.push_back({x, z});
+            radii.push_back(0.4f + 0.1f * unit(rng));
+            directions.push_back(x < 0 ? -1.f : 1.f);
+        }
+
+        auto const half = float(side) * 0.45f + 2.f;
+        for (int k = 0; k < side; ++k)
+            for (float sign : {-1.f, 1.f})
+            {
+                WorldShape wall;
+                wall.type = ShapeType::Box;
+                wall.center = {sign * (half + 0.5f), float(k) * 0.9f + 0.45f};
+                wall.axis0 = {0.5f, 0};
+                wall.axis1 = {0, 0.45f};
+                walls.push_back(wall);
+            }
+    }
+
+    WorldShape Monster(uint32_t i) const
+    {
+        WorldShape shape;
+        shape.type = ShapeType::Circle;
+        shape.center = positions[i];
+        shape.radius = radii[i];
+        return shape;
+    }
+
+    void Step()
+    {
+        for (size_t i = 0; i < positions.size(); ++i)
+            positions[i].x += 0.05f * directions[i];
+
+        auto const key = [](int x, int z) { return (int64_t(x) << 32) ^ uint32_t(z); };
+        std::unordered_map<int64_t, std::vector<uint32_t>> cells;
+        for (uint32_t i = 0; i < positions.size(); ++i)
+            cells[key(int(std::floor(positions[i].x)), int(std::floor(positions[i].y)))].push_back(i);
+
+        auto const numMonsters = uint32_t(positions.size());
+        contacts.clear();
+        for (uint32_t i = 0; i < numMonsters; ++i)
+        {
+            auto const shape = Monster(i);
+            auto const x = int(std::floor(positions[i].x));
+            auto const z = int(std::floor(positions[i].y));
+            for (int dx = -1; dx <= 1; ++dx)
+                for (int dz = -1; dz <= 1; ++dz)
+                {
+                    auto const cell = cells.find(key(x + dx, z + dz));
+                    if (cell == cells.end())
+                        continue;
+
+                    for (auto const j : cell->second)
+                        if (j > i && Narrowphase::Push(shape, Monster(j)) != tg::vec2::zero)
+                            contacts.push_back({i, j});
+                }
+
+            for (uint32_t w = 0; w < walls.size(); ++w)
+                if (Narrowphase::Push(shape, walls[w]) != tg::vec2::zero)
+                    contacts.push_back({i, numMonsters + w});
+        }
+    }
+
+    void Fill(ContactSolver& solver) const
+    {
+        solver.Clear();
+        for (uint32_t i = 0; i < positions.size(); ++i)
+            solver.AddBody(Monster(i), true);
+        for (auto const& wall : walls)
+            solver.AddBody(wall, false);
+        for (auto const& [first, second] : contacts)
+            solver.AddContact(first, second);
+    }
+
+    void Apply(const ContactSolver& solver)
+    {
+        for (uint32_t i = 0; i < positions.size(); ++i)
+            positions[i] += solver.GetCorrection(i);
+    }
+
+    // Over the bits of the positions, equal hashes mean bitwise identical results
+    uint64_t Hash() const
+    {
+        uint64_t hash = 1469598103934665603ull;
+        for (auto const& p : positions)
+        {
+            uint32_t bits[2];
+            std::memcpy(bits, &p, sizeof(bits));
+            hash = (hash ^ bits[0]) * 1099511628211ull;
+            hash = (hash ^ bits[1]) * 1099511628211ull;
+        }
+        return hash;
+    }
+};
+
+struct Result
+{
+    uint64_t hash;
+    size_t colors;
+};
+
+// Final positions & the most colours of a frame after simulating all frames (inline without a pool)
+Result Simulate(int numMonsters, ThreadPool* pool)
+{
+    Scene scene(numMonsters);
+    ContactSolver solver;
+    size_t colors = 0;
+    for (int frame = 0; frame < Frames; ++frame)
+    {
+        scene.Step();
+        scene.Fill(solver);
+        solver.Solve(pool);
+        scene.Apply(solver);
+        colors = std::max(colors, solver.GetNumColors());
+    }
+    return {scene.Hash(), colors};
+}
+
+// The pool only changes who projects a contact, never the order, so the positions are bitwise identical
+void TestDeterminism(int numMonsters)
+{
+    auto const reference = Simulate(numMonsters, nullptr);
+
+    // The pile-up has to be large enough to be split into colours, not only into islands
+    CHECK(reference.colors > 0);
+
+    for (unsigned threads : {1u, 2u, 8u})
+    {
+        ThreadPool pool(threads);
+        auto const result = Simulate(numMonsters, &pool);
+        CHECK(result.hash == reference.hash);
+        CHECK(result.colors == reference.colors);
+    }
+}
+}
+
+int main()
+{
+    TestDeterminism(2000);
+
+    return gamedev::test::Result();
+}
@@ -0,0 +1,129 @@
+#include "Test.hh"
+#include "advanced/World.hh"
+#include "Components.hh"
+#include "ecs/PrefabStore.hh"
+#include <cstring>
+#include <filesystem>
+
+using namespace gamedev;
+
+namespace
+{
+constexpr ComponentType LivingType = 0;
+constexpr ComponentType ControlType = 1;
+constexpr ComponentType CircleType = 2;
+
+void RegisterComponents(PrefabStore& store)
+{
+    store.RegisterComponent<Living>(LivingType);
+    store.RegisterComponent<ForeignControl>(ControlType);
+    store.RegisterComponent<CircleShape>(CircleType);
+}
+
+template <typename CompT>
+bool SameBytes(CompT const* a, CompT const* b)
+{
+    return a && b && std::memcmp(a, b, sizeof(CompT)) == 0;
+}
+
+// Two prefabs, one unit with a route & one plain circle, saved & loaded into a second store
+void TestRoundTrip(std::filesystem::path const& path)
+{
+    PrefabStore store;
+    RegisterComponents(store);
+
+    Living living;
+    living.handle_value = 7;
+    living.friendly = true;
+    std::strncpy(living.name, "Hans", Living::MaxName - 1);
+
+    ForeignControl control;
+    control.waypoints[0] = {1, 0, 2};
+    control.waypoints[1] = {3, 0, 4};
+    control.numWaypoints = 2;
+
+    CircleShape circle;
+    circle.circle = tg::sphere3({0, 1, 0}, 0.5f);
+
+    PrefabInstance unit;
+    unit.xform.translation = {1, 2, 3};
+    unit.xform.scaling = {2, 2, 2};
+    unit.max_bounds = tg::aabb3({-1, 0, -1}, {1, 2, 1});
+    unit.render.mesh = store.GetAssetId("../data/meshes/units/person.obj");
+    unit.render.texAlbedo = store.GetAssetId("bigpalette");
+    unit.render.albedoBias = 0x11223344;
+
+    Signature unitComponents;
+    unitComponents.set(LivingType).set(ControlType).set(CircleType);
+    ComponentSources unitSources{};
+    unitSources[LivingType] = &living;
+    unitSources[ControlType] = &control;
+    unitSources[CircleType] = &circle;
+
+    PrefabInstance rock;
+    rock.render.mesh = store.GetAssetId("../data/meshes/nature/rock.obj");
+    rock.render.texAlbedo = store.GetAssetId("bigpalette");
+
+    Signature rockComponents;
+    rockComponents.set(CircleType);
+    ComponentSources rockSources{};
+    rockSources[CircleType] = &circle;
+
+    auto const unitPrefab = store.Create(unit, unitComponents, unitSources);
+    auto const rockPrefab = store.Create(rock, rockComponents, rockSources);
+    CHECK(store.GetAssetId("bigpalette") == unit.render.texAlbedo);
+    CHECK(store.TryGetComponent<Living>(unitPrefab, LivingType)->handle_value == uint32_t(-1));
+
+    CHECK(store.Save(path));
+
+    PrefabStore loaded;
+    RegisterComponents(loaded);
+    CHECK(loaded.Load(path));
+    CHECK(loaded.Size() == 2);
+    if (loaded.Size() != 2)
+        return;
+
+    auto const& loadedUnit = loaded.GetInstance(unitPrefab);
+    CHECK(std::memcmp(&loadedUnit, &store.GetInstance(unitPrefab), sizeof(PrefabInstance)) == 0);
+    CHECK(loaded.GetAssetName(loadedUnit.render.mesh) == "../data/meshes/units/person.obj");
+    CHECK(loaded.GetAssetName(loadedUnit.render.texAlbedo) == "bigpalette");
+    CHECK(loaded.GetAssetName(loaded.GetInstance(rockPrefab).render.mesh) == "../data/meshes/nature/rock.obj");
+
+    CHECK(loaded.GetSignature(unitPrefab) == unitComponents);
+    CHECK(loaded.GetSignature(rockPrefab) == rockComponents);
+    CHECK(SameBytes(loaded.TryGetComponent<Living>(unitPrefab, LivingType), store.TryGetComponent<Living>(unitPrefab, LivingType)));
+    CHECK(SameBytes(loaded.TryGetComponent<ForeignControl>(unitPrefab, ControlType), store.TryGetComponent<ForeignControl>(unitPrefab, ControlType)));
+    CHECK(SameBytes(loaded.TryGetComponent<CircleShape>(rockPrefab, CircleType), store.TryGetComponent<CircleShape>(rockPrefab, CircleType)));
+    CHECK(loaded.TryGetComponent<Living>(rockPrefab, LivingType) == nullptr);
+
+    auto const* loadedLiving = loaded.TryGetComponent<Living>(unitPrefab, LivingType);
+    CHECK(std::strcmp(loadedLiving->name, "Hans") == 0);
+    CHECK(loaded.TryGetComponent<ForeignControl>(unitPrefab, ControlType)->numWaypoints == 2);
+}
+
+// A store which lacks a component type of the file (or a missing file) loads nothing
+void TestRejectedFiles(std::filesystem::path const& path)
+{
+    PrefabStore store;
+    store.RegisterComponent<Living>(LivingType);
+    store.RegisterComponent<ForeignControl>(ControlType);
+
+    CHECK(!store.Load(path));
+    CHECK(store.Size() == 0);
+
+    CHECK(!store.Load(path.string() + ".missing"));
+    CHECK(store.Size() == 0);
+}
+}
+
+int main()
+{
+    auto const path = std::filesystem::temp_directory_path() / "PrefabStoreTest.prefabs";
+
+    TestRoundTrip(path);
+    TestRejectedFiles(path);
+
+    std::filesystem::remove(path);
+
+    return gamedev::test::Result();
+}
@@ -0,0 +1,166 @@
+#include "Test.hh"
+#include "Terrain.hh"
+#include "utility/Raycast.hh"
+#include <random>
+
+using namespace gamedev;
+
+namespace
+{
+InstanceHandle CreateBox(EngineECS& ecs, tg::vec3 translation, SpatialMask categories)
+{
+    auto handle = ecs.CreateInstance(nullptr, nullptr, nullptr, nullptr);
+    ecs.GetInstanceTransform(handle).translation = translation;
+    ecs.GetInstanceBounds(handle) = tg::aabb3({-0.5f, 0, -0.5f}, {0.5f, 2, 0.5f});
+    ecs.GetHashMap().AddInstance(handle, translation, ecs.GetInstanceBounds(handle), categories);
+    return handle;
+}
+
+void TestInstances()
+{
+    auto& world = *new World; // owned by the ECS
+    world.initialize(64);
+
+    auto ecs = std::make_shared<EngineECS>();
+    ecs->Init(world);
+    ecs->InitSpatialIndex(tg::size2(32, 32), tg::aabb2({-16, -16}, {16, 16}));
+
+    auto const far = CreateBox(*ecs, {10, 0, 0}, SpatialUnit | SpatialHostile);
+    auto const friendly = CreateBox(*ecs, {6, 0, 0}, SpatialUnit | SpatialFriendly);
+    auto const near = CreateBox(*ecs, {2, 0, 0}, SpatialUnit | SpatialHostile);
+    auto const low = CreateBox(*ecs, {2, -1.5f, 4}, SpatialUnit | SpatialHostile); // top at y = 0.5
+
+    std::vector<SpatialRayHit> candidates;
+    RaycastHit hit;
+
+    // First instance along the segment
+    CHECK(RaycastInstances(*ecs, {{0, 1, 0}, {12, 1, 0}}, 0.f, 0, candidates, hit));
+    CHECK(hit.handle == near);
+    CHECK(tg::abs(hit.t - 1.5f / 12.f) < 1e-5f);
+    CHECK(tg::distance(hit.position, tg::pos3(1.5f, 1, 0)) < 1e-4f);
+
+    // Category filter
+    CHECK(RaycastInstances(*ecs, {{0, 1, 0}, {12, 1, 0}}, 0.f, SpatialFriendly, candidates, hit));
+    CHECK(hit.handle == friendly);
+
+    // The bounds are tested in 3D: above the boxes nothing is hit, the radius reaches down to them
+    CHECK(!RaycastInstances(*ecs, {{0, 2.2f, 0}, {12, 2.2f, 0}}, 0.f, 0, candidates, hit));
+    CHECK(RaycastInstances(*ecs, {{0, 2.2f, 0}, {12, 2.2f, 0}}, 0.3f, 0, candidates, hit));
+    CHECK(hit.handle == near);
+
+    // Passes over the low box in the XZ-plane, but above it
+    CHECK(!RaycastInstances(*ecs, {{2, 1, 2}, {2, 1, 6}}, 0.f, 0, candidates, hit));
+    CHECK(RaycastInstances(*ecs, {{2, 0.2f, 2}, {2, 0.2f, 6}}, 0.f, 0, candidates, hit));
+    CHECK(hit.handle == low);
+
+    // Swept: one large step through a target
+    CHECK(RaycastInstances(*ecs, {{8, 1, 0}, {30, 1, 0}}, 0.05f, SpatialHostile, candidates, hit));
+    CHECK(hit.handle == far);
+
+    // Destroyed instances are skipped, even if the index still lists them
+    ecs->DestroyInstance(near);
+    CHECK(RaycastInstances(*ecs, {{0, 1, 0}, {12, 1, 0}}, 0.f, SpatialHostile, candidates, hit));
+    CHECK(hit.handle == far);
+}
+
+// Switching the structure behind the index of the ECS keeps the listed instances & their categories
+void TestIndexSwitch()
+{
+    auto& world = *new World; // owned by the ECS
+    world.initialize(64);
+
+    auto ecs = std::make_shared<EngineECS>();
+    ecs->Init(world);
+    ecs->InitSpatialIndex(tg::size2(32, 32), tg::aabb2({-16, -16}, {16, 16}));
+
+    auto const hostile = CreateBox(*ecs, {10, 0, 0}, SpatialUnit | SpatialHostile);
+    auto const friendly = CreateBox(*ecs, {6, 0, 0}, SpatialUnit | SpatialFriendly);
+    auto const unlisted = ecs->CreateInstance(nullptr, nullptr, nullptr, nullptr);
+
+    std::vector<SpatialRayHit> candidates;
+    RaycastHit hit;
+
+    for (auto type : {SpatialIndexType::LooseQuadTree, SpatialIndexType::Grid})
+    {
+        ecs->SetSpatialIndexType(type);
+        CHECK(ecs->GetSpatialIndexType() == type);
+
+        CHECK(ecs->GetHashMap().Contains(hostile) && ecs->GetHashMap().Contains(friendly));
+        CHECK(!ecs->GetHashMap().Contains(unlisted));
+        CHECK(ecs->GetHashMap().GetCategories(friendly) == (SpatialUnit | SpatialFriendly));
+
+        CHECK(RaycastInstances(*ecs, {{0, 1, 0}, {12, 1, 0}}, 0.f, SpatialHostile, candidates, hit));
+        CHECK(hit.handle == hostile);
+    }
+}
+
+// 40 x 40 units, a ramp along x with a bump in the middle
+float Height(float x, float z) { return 0.1f * x + 3.f * tg::max(0.f, 1.f - (x * x + z * z) / 36.f); }
+
+void TestTerrain()
+{
+    Mesh3D mesh;
+    std::vector<pm::vertex_handle> vertices;
+    for (int z = -20; z <= 20; ++z)
+        for (int x = -20; x <= 20; ++x)
+        {
+            auto v = mesh.vertices().add();
+            mesh.position[v] = tg::pos3(float(x), Height(float(x), float(z)), float(z));
+            vertices.push_back(v);
+        }
+
+    for (int z = 0; z < 40; ++z)
+        for (int x = 0; x < 40; ++x)
+        {
+            auto const v = [&](int dx, int dz) { return vertices[(z + dz) * 41 + x + dx]; };
+            mesh.faces().add(v(0, 0), v(1, 0), v(1, 1));
+            mesh.faces().add(v(0, 0), v(1, 1), v(0, 1));
+        }
+
+    Terrain terrain;
+    terrain.setHeightmap(mesh, gamedev::transform());
+
+    RaycastHit hit;
+
+    // Straight down
+    CHECK(RaycastTerrain(terrain, {{4.3f, 30, -7.6f}, {4.3f, -30, -7.6f}}, hit));
+    CHECK(tg::abs(hit.position.y - terrain.heightAt(hit.position)) < 1e-3f);
+    CHECK(!(hit.handle.is_valid()));
+
+    // Above the surface or outside of the map
+    CHECK(!RaycastTerrain(terrain, {{-15, 30, 0}, {15, 30, 5}}, hit));
+    CHECK(!RaycastTerrain(terrain, {{60, 30, 60}, {60, -30, 60}}, hit));
+
+    // Random casts against dense sampling of the first crossing
+    std::mt19937 rng(3);
+    std::uniform_real_distribution<float> position(-18, 18);
+    for (int i = 0; i < 500; ++i)
+    {
+        tg::segment3 const segment{{position(rng), 20, position(rng)}, {position(rng), -10, position(rng)}};
+
+        float expected = -1.f;
+        for (int k = 0; k <= 100000; ++k)
+        {
+            auto const t = k / 100000.f;
+            auto const p = segment.pos0 + t * (segment.pos1 - segment.pos0);
+            if (p.y <= terrain.heightAt(p))
+            {
+                expected = t;
+                break;
+            }
+        }
+
+        CHECK(RaycastTerrain(terrain, segment, hit));
+        CHECK(expected >= 0.f && tg::abs(hit.t - expected) < 2e-3f);
+    }
+}
+}
+
+int main()
+{
+    TestInstances();
+    TestIndexSwitch();
+    TestTerrain();
+
+    return gamedev::test::Result();
+}
@@ -0,0 +1,173 @@
+#include "Test.hh"
+#include "utility/SpatialIndex.hh"
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace gamedev;
+
+namespace
+{
+struct Entry
+{
+    tg::vec3 translation;
+    tg::aabb3 dimensions;
+    SpatialMask categories = 0;
+};
+
+// Every instance the segment enters in the XZ-plane, without any index
+std::vector<SpatialRayHit> BruteForce(const std::map<uint32_t, Entry>& entries, tg::pos3 from, tg::pos3 to, float radius, SpatialMask categories)
+{
+    std::vector<SpatialRayHit> hits;
+    for (auto const& [index, entry] : entries)
+    {
+        if ((entry.categories & categories) != categories)
+            continue;
+
+        auto const& t = entry.translation;
+        auto const& d = entry.dimensions;
+        tg::aabb2 const bounds({d.min.x + t.x - radius, d.min.z + t.z - radius}, {d.max.x + t.x + radius, d.max.z + t.z + radius});
+
+        float entry_t;
+        if (IntersectSegment(bounds, tg::pos2(from.x, from.z), tg::vec2(to.x - from.x, to.z - from.z), entry_t))
+            hits.push_back({InstanceHandle{index}, entry_t});
+    }
+    return hits;
+}
+
+void TestOrderedHits(SpatialIndexType type)
+{
+    auto index = CreateSpatialIndex(type);
+    index->Init(tg::size2(32, 32), tg::aabb2({-16, -16}, {16, 16}));
+
+    // Three boxes along +x, the one in the middle is of another category
+    tg::aabb3 const box({-0.5f, 0, -0.5f}, {0.5f, 2, 0.5f});
+    index->AddInstance(InstanceHandle{0}, {10, 0, 0}, box, SpatialUnit | SpatialHostile);
+    index->AddInstance(InstanceHandle{1}, {6, 0, 0}, box, SpatialUnit | SpatialFriendly);
+    index->AddInstance(InstanceHandle{2}, {2, 0, 0}, box, SpatialUnit | SpatialHostile);
+    index->AddInstance(InstanceHandle{3}, {2, 0, 5}, box, SpatialUnit | SpatialHostile); // off the segment
+
+    std::vector<SpatialRayHit> hits;
+    index->FindAlongSegment({0, 1, 0}, {12, 1, 0}, 0.f, 0, hits);
+    CHECK(hits.size() == 3);
+    if (hits.size() == 3)
+    {
+        CHECK(hits[0].handle == InstanceHandle{2});
+        CHECK(hits[1].handle == InstanceHandle{1});
+        CHECK(hits[2].handle == InstanceHandle{0});
+        CHECK(tg::abs(hits[0].t - 1.5f / 12.f) < 1e-5f);
+    }
+
+    // Category filter
+    index->FindAlongSegment({0, 1, 0}, {12, 1, 0}, 0.f, SpatialFriendly, hits);
+    CHECK(hits.size() == 1 && hits[0].handle == InstanceHandle{1});
+
+    // The radius grows the boxes, the instance off the segment is entered
+    index->FindAlongSegment({0, 1, 4}, {12, 1, 4}, 0.6f, 0, hits);
+    CHECK(hits.size() == 1 && hits[0].handle == InstanceHandle{3});
+    index->FindAlongSegment({0, 1, 4}, {12, 1, 4}, 0.f, 0, hits);
+    CHECK(hits.empty());
+
+    // Ray: t is relative to the maximum distance
+    index->FindAlongRay({12, 1, 0}, tg::dir3(-1, 0, 0), 4.f, 0, hits);
+    CHECK(hits.size() == 1 && hits[0].handle == InstanceHandle{0});
+
+    // Removed & moved instances
+    index->RemoveInstance(InstanceHandle{1});
+    index->UpdateInstance(InstanceHandle{2}, {2, 0, 8});
+    index->FindAlongSegment({0, 1, 0}, {12, 1, 0}, 0.f, 0, hits);
+    CHECK(hits.size() == 1 && hits[0].handle == InstanceHandle{0});
+}
+
+// Random instances & segments (vertical, axis aligned, with and without radius) against the brute force result
+void TestAgainstBruteForce(SpatialIndexType type)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> position(-60, 60), extent(0.1f, 3.f), radius(0.f, 0.5f);
+
+    for (int round = 0; round < 20; ++round)
+    {
+        auto index = CreateSpatialIndex(type);
+        index->Init(tg::size2(round % 5 == 0 ? 1 : 32, round % 7 == 0 ? 1 : 24), tg::aabb2({-50, -50}, {50, 50}));
+
+        std::map<uint32_t, Entry> entries;
+        for (uint32_t i = 0; i < 400; ++i)
+        {
+            Entry entry;
+            entry.translation = {position(rng), 0, position(rng)};
+            entry.dimensions = tg::aabb3({-extent(rng), 0, -extent(rng)}, {extent(rng), 2, extent(rng)});
+            entry.categories = SpatialMask(1u << (rng() % 3));
+
+            index->AddInstance(InstanceHandle{i}, entry.translation, entry.dimensions, entry.categories);
+            entries[i] = entry;
+        }
+
+        for (int k = 0; k < 200; ++k)
+        {
+            uint32_t const i = rng() % 400;
+            entries[i].translation = {position(rng), 0, position(rng)};
+            index->UpdateInstance(InstanceHandle{i}, entries[i].translation);
+        }
+
+        std::vector<SpatialRayHit> hits;
+        for (int q = 0; q < 200; ++q)
+        {
+            tg::pos3 from(position(rng), 0, position(rng)), to(position(rng), 0, position(rng));
+            if (q % 10 == 0)
+                to = from + tg::vec3(0, 1, 0);
+            if (q % 10 == 1)
+                to.z = from.z;
+
+            float const r = q % 3 ? radius(rng) : 0.f;
+            SpatialMask const categories = q % 4 ? SpatialMask(1u << (rng() % 3)) : 0;
+
+            index->FindAlongSegment(from, to, r, categories, hits);
+            auto const expected = BruteForce(entries, from, to, r, categories);
+
+            // Every instance is reported once, ordered along the segment. The quadtree may report a few more.
+            for (auto const& e : expected)
+            {
+                auto const it = std::find_if(hits.begin(), hits.end(), [&](SpatialRayHit const& h) { return h.handle == e.handle; });
+                CHECK(it != hits.end());
+                if (it != hits.end() && type == SpatialIndexType::Grid)
+                    CHECK(it->t == e.t);
+            }
+
+            if (type == SpatialIndexType::Grid)
+                CHECK(hits.size() == expected.size());
+
+            for (size_t k = 1; k < hits.size(); ++k)
+                CHECK(hits[k - 1].t <= hits[k].t);
+
+            for (size_t k = 0; k < hits.size(); ++k)
+                for (size_t j = k + 1; j < hits.size(); ++j)
+                    CHECK(!(hits[k].handle == hits[j].handle));
+        }
+    }
+}
+
+// A swept segment can't pass through a thin target at a large step
+void TestSweptSegment()
+{
+    tg::aabb3 const target({9.9f, 0, -0.2f}, {10.1f, 2, 0.2f});
+
+    float t;
+    CHECK(IntersectSegment(target, tg::pos3(0, 1, 0), tg::vec3(30, 0, 0), t));
+    CHECK(tg::abs(t - 9.9f / 30.f) < 1e-6f);
+    CHECK(!IntersectSegment(target, tg::pos3(0, 3, 0), tg::vec3(30, 0, 0), t));
+    CHECK(!IntersectSegment(target, tg::pos3(0, 1, 0), tg::vec3(9, 0, 0), t));
+}
+}
+
+int main()
+{
+    for (auto type : {SpatialIndexType::Grid, SpatialIndexType::LooseQuadTree})
+    {
+        TestOrderedHits(type);
+        TestAgainstBruteForce(type);
+    }
+
+    TestSweptSegment();
+
+    return gamedev::test::Result();
+}
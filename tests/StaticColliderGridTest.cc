@@ -0,0 +1,150 @@
+#include "Test.hh"
+#include "utility/StaticColliderGrid.hh"
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace gamedev;
+
+namespace
+{
+InstanceHandle Handle(uint32_t index, uint32_t generation) { return InstanceHandle{(generation << 20) | index}; }
+
+bool Overlaps(const tg::aabb2& a, const tg::aabb2& b) { return a.min.x < b.max.x && b.min.x < a.max.x && a.min.y < b.max.y && b.min.y < a.max.y; }
+
+// Every collider is reported once & exactly the ones overlapping the area
+void CheckQueries(const StaticColliderGrid& grid, const std::map<uint32_t, std::pair<InstanceHandle, tg::aabb2>>& colliders, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> position(-70, 70), extent(0.f, 10.f);
+
+    CHECK(grid.Size() == colliders.size());
+
+    std::vector<uint32_t> found, expected;
+    for (int q = 0; q < 50; ++q)
+    {
+        tg::pos2 const min(position(rng), position(rng));
+        tg::aabb2 const area(min, min + tg::vec2(extent(rng), extent(rng)));
+
+        found.clear();
+        grid.ForEachOverlap(area, [&](StaticColliderGrid::Collider const& c)
+        {
+            auto const it = colliders.find(c.handle.index());
+            CHECK(it != colliders.end() && it->second.first == c.handle && it->second.second == c.bounds);
+            found.push_back(c.handle.index());
+        });
+
+        expected.clear();
+        for (auto const& [index, collider] : colliders)
+            if (Overlaps(collider.second, area))
+                expected.push_back(index);
+
+        std::sort(found.begin(), found.end());
+        CHECK(found == expected);
+    }
+}
+
+// Random changes applied one or a few per Build(), through the patch lists & full bakes, against brute force
+void TestAgainstBruteForce()
+{
+    std::mt19937 rng(11);
+    std::uniform_real_distribution<float> position(-50, 50), extent(0.2f, 4.f);
+    auto const randomBounds = [&]()
+    {
+        tg::pos2 const min(position(rng), position(rng));
+        return tg::aabb2(min, min + tg::vec2(extent(rng), extent(rng)));
+    };
+
+    StaticColliderGrid grid;
+    std::map<uint32_t, std::pair<InstanceHandle, tg::aabb2>> colliders; // by index
+    std::vector<uint32_t> generations(600, 0);
+
+    for (uint32_t i = 0; i < 400; ++i)
+    {
+        colliders[i] = {Handle(i, 0), randomBounds()};
+        grid.Add(colliders[i].first, colliders[i].second, {});
+    }
+    grid.Build();
+    CheckQueries(grid, colliders, rng);
+
+    for (int round = 0; round < 300; ++round)
+    {
+        // Mostly single changes, sometimes a burst which is baked again
+        int const changes = round % 25 == 0 ? 100 : 1 + int(rng() % 3);
+        for (int k = 0; k < changes; ++k)
+        {
+            uint32_t const index = rng() % uint32_t(generations.size());
+            auto const it = colliders.find(index);
+            auto const op = rng() % 3;
+
+            if (it == colliders.end())
+            {
+                // Add into a freed slot, the generation sometimes wraps below the old one
+                generations[index] = op == 0 ? 0 : generations[index] + 1;
+                colliders[index] = {Handle(index, generations[index]), randomBounds()};
+                grid.Add(colliders[index].first, colliders[index].second, {});
+            }
+            else if (op == 0)
+            {
+                grid.Remove(it->second.first);
+                colliders.erase(it);
+            }
+            else if (op == 1)
+            {
+                it->second.second = randomBounds();
+                grid.Move(it->second.first, it->second.second, {});
+            }
+            else
+            {
+                // Destroyed & the slot reused in the same frame
+                grid.Remove(it->second.first);
+                generations[index] = (generations[index] + 1) % 4;
+                it->second = {Handle(index, generations[index]), randomBounds()};
+                grid.Add(it->second.first, it->second.second, {});
+            }
+        }
+
+        grid.Build();
+        CHECK(!grid.IsDirty());
+        CheckQueries(grid, colliders, rng);
+    }
+
+    // Far outside of the baked extent: still found, through the border cells
+    colliders[599] = {Handle(599, 9), tg::aabb2({300, 300}, {302, 301})};
+    grid.Add(colliders[599].first, colliders[599].second, {});
+    grid.Build();
+
+    size_t found = 0;
+    grid.ForEachOverlap(tg::aabb2({299, 299}, {301, 301}), [&](StaticColliderGrid::Collider const& c) { found += c.handle == colliders[599].first; });
+    CHECK(found == 1);
+}
+
+// The changed areas are the old & new bounds of the changed colliders
+void TestChangedAreas()
+{
+    StaticColliderGrid grid;
+    tg::aabb2 const a({0, 0}, {1, 1}), b({10, 10}, {12, 11}), c({-5, 3}, {-4, 4});
+
+    grid.Add(Handle(0, 0), a, {});
+    grid.Add(Handle(1, 0), b, {});
+    grid.Build();
+    CHECK(grid.GetChangedAreas().size() == 2);
+
+    grid.Move(Handle(1, 0), c, {});
+    grid.Build();
+    auto const& areas = grid.GetChangedAreas();
+    CHECK(areas.size() == 2 && std::count(areas.begin(), areas.end(), b) == 1 && std::count(areas.begin(), areas.end(), c) == 1);
+
+    grid.Remove(Handle(0, 0));
+    grid.Build();
+    CHECK(grid.GetChangedAreas().size() == 1 && grid.GetChangedAreas()[0] == a);
+    CHECK(grid.Size() == 1);
+}
+}
+
+int main()
+{
+    TestAgainstBruteForce();
+    TestChangedAreas();
+
+    return gamedev::test::Result();
+}
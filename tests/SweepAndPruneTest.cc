@@ -0,0 +1,157 @@
+#include "Test.hh"
+#include "utility/SweepAndPrune.hh"
+#include <algorithm>
+#include <iterator>
+#include <map>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace gamedev;
+
+namespace
+{
+using PairList = std::vector<std::pair<uint32_t, uint32_t>>;
+
+struct Entry
+{
+    tg::aabb2 bounds;
+    bool dynamic = false;
+};
+
+// Every overlapping pair with at least one dynamic box, ordered by the handles (touching bounds don't overlap)
+PairList BruteForce(std::map<uint32_t, Entry> const& entries)
+{
+    PairList pairs;
+    for (auto a = entries.begin(); a != entries.end(); ++a)
+        for (auto b = std::next(a); b != entries.end(); ++b)
+        {
+            auto const& l = a->second.bounds;
+            auto const& r = b->second.bounds;
+            if (!(a->second.dynamic || b->second.dynamic))
+                continue;
+
+            if (l.min.x < r.max.x && r.min.x < l.max.x && l.min.y < r.max.y && r.min.y < l.max.y)
+                pairs.push_back({a->first, b->first});
+        }
+    return pairs;
+}
+
+// Handles of the pairs, also checks the order (& the dynamic flags against the entries, if given)
+PairList ToList(std::vector<SweepAndPrune::Pair> const& pairs, std::map<uint32_t, Entry> const* entries = nullptr)
+{
+    PairList list;
+    for (auto const& pair : pairs)
+    {
+        CHECK(pair.a < pair.b);
+        if (entries)
+        {
+            CHECK(pair.dynamicA == entries->at(pair.a._value).dynamic);
+            CHECK(pair.dynamicB == entries->at(pair.b._value).dynamic);
+        }
+
+        list.push_back({pair.a._value, pair.b._value});
+    }
+
+    CHECK(std::is_sorted(list.begin(), list.end()));
+    return list;
+}
+
+// first - second, both ordered
+PairList Difference(PairList const& first, PairList const& second)
+{
+    PairList difference;
+    std::set_difference(first.begin(), first.end(), second.begin(), second.end(), std::back_inserter(difference));
+    return difference;
+}
+
+// Random boxes moving a bit every frame (the insertion sort), with waves of new boxes (sorted from scratch),
+// single adds, removals & boxes turning dynamic or static in between.
+void TestRandomFrames()
+{
+    std::mt19937 rng(19);
+    std::uniform_real_distribution<float> position(-20, 20);
+    std::uniform_real_distribution<float> extent(0.25f, 1.5f);
+    std::uniform_real_distribution<float> step(-0.4f, 0.4f);
+    std::uniform_real_distribution<float> unit(0, 1);
+
+    SweepAndPrune broadphase;
+    std::map<uint32_t, Entry> entries;
+    uint32_t nextHandle = 0;
+
+    auto const add = [&](int count)
+    {
+        for (int i = 0; i < count; ++i)
+        {
+            auto const center = tg::pos2(position(rng), position(rng));
+            auto const half = tg::vec2(extent(rng), extent(rng));
+
+            Entry entry;
+            entry.bounds = tg::aabb2(center - half, center + half);
+            entry.dynamic = unit(rng) < 0.7f;
+
+            auto const handle = nextHandle++;
+            broadphase.Add(InstanceHandle{handle}, entry.bounds, entry.dynamic);
+            entries[handle] = entry;
+        }
+    };
+
+    PairList previous;
+    for (int frame = 0; frame < 60; ++frame)
+    {
+        if (frame == 0)
+            add(400); // first frame, sorted from scratch
+        else if (frame == 30)
+            add(200); // a wave
+        else if (frame % 5 == 0)
+            add(3);
+
+        for (auto it = entries.begin(); it != entries.end();)
+        {
+            auto& [handle, entry] = *it;
+            auto const roll = unit(rng);
+
+            if (roll < 0.01f)
+            {
+                broadphase.Remove(InstanceHandle{handle});
+                it = entries.erase(it);
+                continue;
+            }
+
+            if (roll < 0.02f)
+            {
+                entry.dynamic = !entry.dynamic;
+                broadphase.SetDynamic(InstanceHandle{handle}, entry.dynamic);
+            }
+
+            if (entry.dynamic)
+            {
+                auto const delta = tg::vec2(step(rng), step(rng));
+                entry.bounds = tg::aabb2(entry.bounds.min + delta, entry.bounds.max + delta);
+                broadphase.Move(InstanceHandle{handle}, entry.bounds);
+            }
+            ++it;
+        }
+
+        broadphase.Update();
+
+        auto const expected = BruteForce(entries);
+        auto const pairs = ToList(broadphase.GetPairs(), &entries);
+        CHECK(broadphase.Size() == entries.size());
+        CHECK(pairs == expected);
+
+        // Ended pairs may refer to removed boxes, their flags are not checked
+        CHECK(ToList(broadphase.GetBeganPairs(), &entries) == Difference(expected, previous));
+        CHECK(ToList(broadphase.GetEndedPairs()) == Difference(previous, expected));
+
+        previous = expected;
+    }
+}
+}
+
+int main()
+{
+    TestRandomFrames();
+
+    return gamedev::test::Result();
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdio>
+
+/***
+* Minimal checks for the headless tests (no window, GL context or audio device).
+*
+* A failed CHECK is reported and the test goes on, main() returns gamedev::test::Result()
+* so ctest sees the failure:
+*
+*    CHECK(hit.handle == target);
+*    return gamedev::test::Result();
+*
+***/
+namespace gamedev
+{
+namespace test
+{
+inline int& Failures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+inline int Result()
+{
+    if (Failures())
+        std::printf("%d check(s) failed\n", Failures());
+    else
+        std::printf("all checks passed\n");
+
+    return Failures() ? 1 : 0;
+}
+}
+}
+
+#define CHECK(condition)                                                                  \
+    do                                                                                    \
+    {                                                                                     \
+        if (!(condition))                                                                 \
+        {                                                                                 \
+            std::printf("%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #condition);    \
+            ++gamedev::test::Failures();                                                  \
+        }                                                                                 \
+    } while (false)